@@ -1,25 +1,20 @@
-module;
-
-#include <stdio.h>
-
 export module UtlFile;
 
 import std;
 
 export auto UTIL_LoadFile(std::filesystem::path const& Path) noexcept -> std::pair<std::unique_ptr<char[]>, size_t>
 {
-	if (auto f = _wfopen(Path.c_str(), L"rb"); f != nullptr)
+	// ifstream takes the native path type, so wide paths keep working on Windows.
+	if (std::ifstream f{ Path, std::ios::binary | std::ios::ate }; f)
 	{
-		std::fseek(f, 0, SEEK_END);
-		auto const iLength = (size_t)std::ftell(f);
+		auto const iLength = (size_t)f.tellg();
 
 		auto buf = std::make_unique<char[]>(iLength + 1);
-		std::fseek(f, 0, SEEK_SET);
+		f.seekg(0, std::ios::beg);
 
-		std::fread(buf.get(), sizeof(char), iLength, f);
+		f.read(buf.get(), (std::streamsize)iLength);
 		buf[iLength] = '\0';
 
-		std::fclose(f);
 		return { std::move(buf), iLength };
 	}
 
@@ -0,0 +1,407 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#endif
+
+export module UtlLog;
+
+import std;
+
+// Producers format into a per-thread single-producer single-consumer ring and never block.
+// One background thread drains every ring, prints in batches and keeps a bounded history for the UI. It also frees the
+// rings of the threads that exited, and reports what the rate limiter swallowed once the call site went quiet.
+
+export enum struct ELogLevel : std::uint8_t { Trace, Info, Warning, Error, };
+export enum struct ELogCategory : std::uint8_t { General, Database, Resource, Render, COUNT, };
+
+export [[nodiscard]] constexpr auto UTIL_LogLevelName(ELogLevel Level) noexcept -> std::string_view
+{
+	constexpr std::array NAMES{ "trace", "info", "warning", "error" };
+	return NAMES[(std::size_t)Level];
+}
+
+export [[nodiscard]] constexpr auto UTIL_LogCategoryName(ELogCategory Category) noexcept -> std::string_view
+{
+	constexpr std::array NAMES{ "General", "Database", "Resource", "Render" };
+	return NAMES[(std::size_t)Category];
+}
+
+export struct CLogEntry final
+{
+	std::uint64_t m_Sequence{};
+	double m_Time{};				// Seconds since the logger started.
+	ELogLevel m_Level{};
+	ELogCategory m_Category{};
+	std::uint32_t m_Thread{};		// Order of the first log call of the thread, not the OS id.
+	std::uint32_t m_Suppressed{};	// Repeats of the same call site swallowed right before this one.
+	std::string m_Text{};
+};
+
+inline constexpr std::size_t LOG_MESSAGE_MAX = 224;	// Longer messages are truncated.
+inline constexpr std::uint32_t LOG_RING_CAPACITY = 512;	// Power of two.
+inline constexpr std::uint32_t LOG_RATE_LIMIT = 16;		// Per call site per second, per thread.
+inline constexpr std::size_t LOG_HISTORY_MAX = 8192;
+
+struct CLogSlot final
+{
+	std::int64_t m_Ticks{};
+	ELogLevel m_Level{};
+	ELogCategory m_Category{};
+	std::uint16_t m_Length{};
+	std::uint32_t m_Suppressed{};
+	char m_Text[LOG_MESSAGE_MAX]{};
+};
+
+// Rate limiter state of the call sites of one thread. Only the producer changes the site, the consumer reads it to
+// report the repeats left over when the second ends without another call.
+struct CLogSite final
+{
+	std::atomic<char const*> m_Format{};	// Published last, the fields below go with it.
+	std::atomic<std::int64_t> m_Window{};
+	std::atomic<ELogLevel> m_Level{};
+	std::atomic<ELogCategory> m_Category{};
+	std::uint32_t m_Count{};	// Producer only.
+	std::atomic<std::uint32_t> m_Suppressed{};	// Whichever side reports them takes them.
+};
+
+struct CLogRing final
+{
+	std::array<CLogSlot, LOG_RING_CAPACITY> m_Slots{};
+	std::array<CLogSite, 64> m_Sites{};
+	std::uint32_t m_Thread{};
+
+	alignas(64) std::atomic<std::uint32_t> m_Head{};	// Written by the producer only.
+	alignas(64) std::atomic<std::uint32_t> m_Tail{};	// Written by the consumer only.
+	std::atomic<std::uint32_t> m_Dropped{};
+	std::atomic<bool> m_bRetired{};	// The thread exited, nothing is written anymore.
+};
+
+[[nodiscard]] inline auto LogWindow() noexcept -> std::int64_t
+{
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct CLogger final
+{
+	std::chrono::steady_clock::time_point const m_Start{ std::chrono::steady_clock::now() };
+	std::atomic<ELogLevel> m_MinLevel{ ELogLevel::Info };
+	std::atomic<bool> m_Console{ true };
+
+	std::mutex m_RingsMutex{};	// Guards m_Rings and serializes consumers. Producers only take it once per thread.
+	std::vector<std::unique_ptr<CLogRing>> m_Rings{};
+	std::uint32_t m_NextThread{};	// Rings are freed, their index is no thread number.
+
+	std::mutex m_HistoryMutex{};
+	std::deque<CLogEntry> m_History{};
+	std::uint64_t m_NextSequence{};
+
+	std::jthread m_Drain{};
+
+	~CLogger() noexcept
+	{
+		if (m_Drain.joinable())
+		{
+			m_Drain.request_stop();
+			m_Drain.join();
+		}
+
+		Drain();
+	}
+
+	auto Register() noexcept -> CLogRing*
+	{
+		std::scoped_lock Lock{ m_RingsMutex };
+
+		auto& pRing = m_Rings.emplace_back(std::make_unique<CLogRing>());
+		pRing->m_Thread = m_NextThread++;
+
+		if (!m_Drain.joinable())
+		{
+			m_Drain = std::jthread{
+				[this](std::stop_token Token) noexcept
+				{
+					while (!Token.stop_requested())
+					{
+						std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+						Drain();
+					}
+				}
+			};
+		}
+
+		return pRing.get();
+	}
+
+	void DrainRing(CLogRing& Ring, bool bRetired, std::vector<CLogEntry>* pBatch) noexcept
+	{
+		auto const iTail = Ring.m_Tail.load(std::memory_order_relaxed);
+		auto const iHead = Ring.m_Head.load(std::memory_order_acquire);
+
+		for (auto i = iTail; i != iHead; ++i)
+		{
+			auto const& Slot = Ring.m_Slots[i % LOG_RING_CAPACITY];
+
+			pBatch->push_back(
+				CLogEntry{
+					.m_Time = std::chrono::duration<double>(std::chrono::steady_clock::duration{ Slot.m_Ticks }).count(),
+					.m_Level = Slot.m_Level,
+					.m_Category = Slot.m_Category,
+					.m_Thread = Ring.m_Thread,
+					.m_Suppressed = Slot.m_Suppressed,
+					.m_Text{ Slot.m_Text, Slot.m_Length },
+				}
+			);
+		}
+
+		Ring.m_Tail.store(iHead, std::memory_order_release);
+
+		auto const flNow = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_Start).count();
+
+		if (auto const iDropped = Ring.m_Dropped.exchange(0, std::memory_order_relaxed); iDropped) [[unlikely]]
+		{
+			pBatch->push_back(
+				CLogEntry{
+					.m_Time = flNow,
+					.m_Level = ELogLevel::Warning,
+					.m_Category = ELogCategory::General,
+					.m_Thread = Ring.m_Thread,
+					.m_Text = std::format("{} messages dropped, the log ring of this thread was full.", iDropped),
+				}
+			);
+		}
+
+		// Otherwise the count waits for the next call of the same site, which may never come. A site still in its second
+		// may keep suppressing, it is left to the producer unless the thread is gone.
+		auto const iWindow = LogWindow();
+
+		for (auto&& Site : Ring.m_Sites)
+		{
+			auto const pszFormat = Site.m_Format.load(std::memory_order_acquire);
+
+			if (Site.m_Suppressed.load(std::memory_order_relaxed) == 0 || (!bRetired && Site.m_Window.load(std::memory_order_relaxed) >= iWindow))
+				continue;
+
+			auto const Level = Site.m_Level.load(std::memory_order_relaxed);
+			auto const Category = Site.m_Category.load(std::memory_order_relaxed);
+			auto const iSuppressed = Site.m_Suppressed.exchange(0, std::memory_order_relaxed);
+
+			// The producer moved the site to another format meanwhile, the count is its business now.
+			if (Site.m_Format.load(std::memory_order_acquire) != pszFormat) [[unlikely]]
+			{
+				Site.m_Suppressed.fetch_add(iSuppressed, std::memory_order_relaxed);
+				continue;
+			}
+
+			if (iSuppressed)
+			{
+				pBatch->push_back(
+					CLogEntry{
+						.m_Time = flNow,
+						.m_Level = Level,
+						.m_Category = Category,
+						.m_Thread = Ring.m_Thread,
+						.m_Suppressed = iSuppressed,
+						.m_Text = std::format("Rate limited: {}", pszFormat),
+					}
+				);
+			}
+		}
+	}
+
+	void Drain() noexcept
+	{
+		std::vector<CLogEntry> rgBatch{};
+
+		{
+			std::scoped_lock Lock{ m_RingsMutex };
+
+			for (auto it = m_Rings.begin(); it != m_Rings.end();)
+			{
+				// Before the head: a retired ring is empty once drained, its last message included.
+				auto const bRetired = (*it)->m_bRetired.load(std::memory_order_acquire);
+
+				DrainRing(**it, bRetired, &rgBatch);
+				it = bRetired ? m_Rings.erase(it) : std::next(it);
+			}
+		}
+
+		if (rgBatch.empty())
+			return;
+
+		std::ranges::stable_sort(rgBatch, {}, &CLogEntry::m_Time);
+
+		if (m_Console.load(std::memory_order_relaxed))
+		{
+			std::string szOutput{};
+
+			for (auto&& Entry : rgBatch)
+			{
+				std::format_to(std::back_inserter(szOutput), "[{:8.3f}] [{}] [{}] {}",
+					Entry.m_Time, UTIL_LogLevelName(Entry.m_Level), UTIL_LogCategoryName(Entry.m_Category), Entry.m_Text);
+
+				if (Entry.m_Suppressed)
+					std::format_to(std::back_inserter(szOutput), " (+{} similar suppressed)", Entry.m_Suppressed);
+
+				szOutput.push_back('\n');
+			}
+
+			// One write per batch instead of one flush per message.
+			std::print("{}", szOutput);
+		}
+
+		std::scoped_lock Lock{ m_HistoryMutex };
+
+		for (auto&& Entry : rgBatch)
+		{
+			Entry.m_Sequence = m_NextSequence++;
+			m_History.push_back(std::move(Entry));
+		}
+
+		while (m_History.size() > LOG_HISTORY_MAX)
+			m_History.pop_front();
+	}
+};
+
+CLogger g_Logger{};
+
+// The logger owns the ring. This only tells the drain thread when the thread is gone, so that it frees the ring.
+struct CLogRingOwner final
+{
+	CLogRing* m_pRing{};
+
+	~CLogRingOwner() noexcept
+	{
+		// A log from a later thread_local destructor registers a new ring rather than writing to a freed one.
+		if (auto const pRing = std::exchange(m_pRing, nullptr); pRing)
+			pRing->m_bRetired.store(true, std::memory_order_release);
+	}
+};
+
+thread_local CLogRingOwner t_Ring{};
+
+[[nodiscard]] inline auto ThisThreadRing() noexcept -> CLogRing*
+{
+	if (!t_Ring.m_pRing) [[unlikely]]
+		t_Ring.m_pRing = g_Logger.Register();
+
+	return t_Ring.m_pRing;
+}
+
+// Returns the number of suppressed repeats to report with the message, or -1 if the message should be skipped.
+[[nodiscard]] auto LogAdmit(ELogLevel Level, ELogCategory Category, char const* pszFormat) noexcept -> std::int64_t
+{
+	if (Level < g_Logger.m_MinLevel.load(std::memory_order_relaxed))
+		return -1;
+
+	auto const iWindow = LogWindow();
+	auto& Sites = ThisThreadRing()->m_Sites;
+	auto& Site = Sites[(std::bit_cast<std::uintptr_t>(pszFormat) >> 4) % Sites.size()];
+	auto const bSameFormat = Site.m_Format.load(std::memory_order_relaxed) == pszFormat;
+
+	if (!bSameFormat || Site.m_Window.load(std::memory_order_relaxed) != iWindow)
+	{
+		// Whatever the drain thread did not report yet. Collisions simply restart the count, they only make the limiter
+		// more lenient.
+		auto const iSuppressed = Site.m_Suppressed.exchange(0, std::memory_order_relaxed);
+
+		Site.m_Window.store(iWindow, std::memory_order_relaxed);
+		Site.m_Level.store(Level, std::memory_order_relaxed);
+		Site.m_Category.store(Category, std::memory_order_relaxed);
+		Site.m_Count = 1;
+		Site.m_Format.store(pszFormat, std::memory_order_release);
+
+		return bSameFormat ? iSuppressed : 0;
+	}
+
+	if (Site.m_Count >= LOG_RATE_LIMIT)
+	{
+		Site.m_Suppressed.fetch_add(1, std::memory_order_relaxed);
+		return -1;
+	}
+
+	++Site.m_Count;
+	return 0;
+}
+
+void LogCommit(ELogLevel Level, ELogCategory Category, std::uint32_t iSuppressed, std::string_view szText) noexcept
+{
+	auto const pRing = ThisThreadRing();
+	auto const iHead = pRing->m_Head.load(std::memory_order_relaxed);
+
+	if (iHead - pRing->m_Tail.load(std::memory_order_acquire) >= LOG_RING_CAPACITY) [[unlikely]]
+	{
+		pRing->m_Dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	auto& Slot = pRing->m_Slots[iHead % LOG_RING_CAPACITY];
+	Slot.m_Ticks = (std::chrono::steady_clock::now() - g_Logger.m_Start).count();
+	Slot.m_Level = Level;
+	Slot.m_Category = Category;
+	Slot.m_Suppressed = iSuppressed;
+	Slot.m_Length = static_cast<std::uint16_t>(std::min(szText.size(), LOG_MESSAGE_MAX));
+	std::memcpy(Slot.m_Text, szText.data(), Slot.m_Length);
+
+	pRing->m_Head.store(iHead + 1, std::memory_order_release);
+}
+
+// Formats on the stack, no allocation. Cheap enough for loops in loaders.
+export template <typename... Args>
+void UTIL_Log(ELogLevel Level, ELogCategory Category, std::format_string<Args...> Format, Args&&... args) noexcept
+{
+	auto const iSuppressed = LogAdmit(Level, Category, Format.get().data());
+	if (iSuppressed < 0)
+		return;
+
+	char szBuffer[LOG_MESSAGE_MAX];
+	auto const Result = std::format_to_n(szBuffer, std::size(szBuffer), Format, std::forward<Args>(args)...);
+
+	LogCommit(Level, Category, static_cast<std::uint32_t>(iSuppressed), std::string_view{ szBuffer, std::min<std::size_t>(Result.size, std::size(szBuffer)) });
+}
+
+export template <typename... Args>
+void UTIL_LogInfo(ELogCategory Category, std::format_string<Args...> Format, Args&&... args) noexcept
+{
+	UTIL_Log(ELogLevel::Info, Category, Format, std::forward<Args>(args)...);
+}
+
+export template <typename... Args>
+void UTIL_LogWarning(ELogCategory Category, std::format_string<Args...> Format, Args&&... args) noexcept
+{
+	UTIL_Log(ELogLevel::Warning, Category, Format, std::forward<Args>(args)...);
+}
+
+export template <typename... Args>
+void UTIL_LogError(ELogCategory Category, std::format_string<Args...> Format, Args&&... args) noexcept
+{
+	UTIL_Log(ELogLevel::Error, Category, Format, std::forward<Args>(args)...);
+}
+
+export void UTIL_LogSetLevel(ELogLevel Level) noexcept
+{
+	g_Logger.m_MinLevel.store(Level, std::memory_order_relaxed);
+}
+
+// Mirror to stdout, on by default.
+export void UTIL_LogSetConsole(bool bEnabled) noexcept
+{
+	g_Logger.m_Console.store(bEnabled, std::memory_order_relaxed);
+}
+
+// Drains on the calling thread. Call before printing anything that must come after the log, or before exiting.
+export void UTIL_LogFlush() noexcept
+{
+	g_Logger.Drain();
+}
+
+// Appends every history entry from sequence iFrom on to pOut, returns the sequence to pass next time.
+export auto UTIL_LogCopy(std::vector<CLogEntry>* pOut, std::uint64_t iFrom) noexcept -> std::uint64_t
+{
+	std::scoped_lock Lock{ g_Logger.m_HistoryMutex };
+
+	auto const it = std::ranges::lower_bound(g_Logger.m_History, iFrom, {}, &CLogEntry::m_Sequence);
+	pOut->append_range(std::ranges::subrange(it, g_Logger.m_History.end()));
+
+	return g_Logger.m_NextSequence;
+}
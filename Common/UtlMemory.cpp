@@ -0,0 +1,49 @@
+#ifndef __INTELLISENSE__
+import std.compat;
+#else
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+import UtlMemory;
+
+// Replaces every global operator new/delete of the program, so each container and std::string is attributed to the tag of the thread allocating it.
+// Must stay a plain translation unit, replacement allocation functions cannot be attached to a module.
+
+[[nodiscard]] static void* TaggedNew(std::size_t iSize, std::size_t iAlign)
+{
+	if (auto const p = UTIL_MemoryAlloc(iSize ? iSize : 1, iAlign, UTIL_MemoryCurrentTag())) [[likely]]
+		return p;
+
+	throw std::bad_alloc{};
+}
+
+[[nodiscard]] static void* TaggedNewNoThrow(std::size_t iSize, std::size_t iAlign) noexcept
+{
+	return UTIL_MemoryAlloc(iSize ? iSize : 1, iAlign, UTIL_MemoryCurrentTag());
+}
+
+void* operator new(std::size_t iSize) { return TaggedNew(iSize, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t iSize) { return TaggedNew(iSize, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t iSize, std::align_val_t iAlign) { return TaggedNew(iSize, (std::size_t)iAlign); }
+void* operator new[](std::size_t iSize, std::align_val_t iAlign) { return TaggedNew(iSize, (std::size_t)iAlign); }
+
+void* operator new(std::size_t iSize, std::nothrow_t const&) noexcept { return TaggedNewNoThrow(iSize, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t iSize, std::nothrow_t const&) noexcept { return TaggedNewNoThrow(iSize, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t iSize, std::align_val_t iAlign, std::nothrow_t const&) noexcept { return TaggedNewNoThrow(iSize, (std::size_t)iAlign); }
+void* operator new[](std::size_t iSize, std::align_val_t iAlign, std::nothrow_t const&) noexcept { return TaggedNewNoThrow(iSize, (std::size_t)iAlign); }
+
+// The header knows the size, tag and alignment offset, every delete ends up in the same place.
+void operator delete(void* p) noexcept { UTIL_MemoryFree(p); }
+void operator delete[](void* p) noexcept { UTIL_MemoryFree(p); }
+void operator delete(void* p, std::size_t) noexcept { UTIL_MemoryFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { UTIL_MemoryFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { UTIL_MemoryFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { UTIL_MemoryFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { UTIL_MemoryFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { UTIL_MemoryFree(p); }
+void operator delete(void* p, std::nothrow_t const&) noexcept { UTIL_MemoryFree(p); }
+void operator delete[](void* p, std::nothrow_t const&) noexcept { UTIL_MemoryFree(p); }
+void operator delete(void* p, std::align_val_t, std::nothrow_t const&) noexcept { UTIL_MemoryFree(p); }
+void operator delete[](void* p, std::align_val_t, std::nothrow_t const&) noexcept { UTIL_MemoryFree(p); }
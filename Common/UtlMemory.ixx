@@ -0,0 +1,284 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#endif
+
+export module UtlMemory;
+
+import std;
+
+// Host bytes per subsystem, counted by the replaced global operator new (UtlMemory.cpp) under the tag of the calling thread,
+// or by TTaggedAllocator and the stb_image hooks regardless of the thread tag. GPU bytes are counted per GL object.
+// Worker threads of the parallel algorithms start untagged, their allocations show as Untagged.
+
+export enum struct EMemoryTag : std::uint8_t { Untagged, Marshal, RxDatabase, RawPbs, LinkedPbs, ImageDecode, PainterMirror, COUNT, };
+export enum struct EGpuMemory : std::uint8_t { Textures, Buffers, COUNT, };
+
+export [[nodiscard]] constexpr auto UTIL_MemoryTagName(EMemoryTag Tag) noexcept -> std::string_view
+{
+	constexpr std::array NAMES{ "Untagged", "Marshal reader", "RX database", "Raw PBS", "Linked PBS", "Image decode", "Painter mirror" };
+	return NAMES[(std::size_t)Tag];
+}
+
+export [[nodiscard]] constexpr auto UTIL_GpuMemoryName(EGpuMemory Kind) noexcept -> std::string_view
+{
+	constexpr std::array NAMES{ "Textures", "Buffers" };
+	return NAMES[(std::size_t)Kind];
+}
+
+export struct CMemoryStat final
+{
+	std::int64_t m_Live{};
+	std::int64_t m_Peak{};
+	std::uint64_t m_Allocations{};	// Since startup, frees are not subtracted.
+};
+
+struct alignas(64) CMemoryCounter final
+{
+	std::atomic<std::int64_t> m_Live{};
+	std::atomic<std::int64_t> m_Peak{};
+	std::atomic<std::uint64_t> m_Allocations{};
+
+	void Add(std::int64_t iBytes) noexcept
+	{
+		m_Allocations.fetch_add(1, std::memory_order_relaxed);
+		Resize(iBytes);
+	}
+
+	void Sub(std::int64_t iBytes) noexcept
+	{
+		m_Live.fetch_sub(iBytes, std::memory_order_relaxed);
+	}
+
+	// Live bytes only, the allocation count is left alone.
+	void Resize(std::int64_t iDelta) noexcept
+	{
+		auto const iLive = m_Live.fetch_add(iDelta, std::memory_order_relaxed) + iDelta;
+
+		auto iPeak = m_Peak.load(std::memory_order_relaxed);
+		while (iLive > iPeak && !m_Peak.compare_exchange_weak(iPeak, iLive, std::memory_order_relaxed)) {}
+	}
+
+	[[nodiscard]] auto Get() const noexcept -> CMemoryStat
+	{
+		return {
+			.m_Live = m_Live.load(std::memory_order_relaxed),
+			.m_Peak = m_Peak.load(std::memory_order_relaxed),
+			.m_Allocations = m_Allocations.load(std::memory_order_relaxed),
+		};
+	}
+};
+
+// Must be usable before any dynamic initializer runs, operator new is called from them.
+constinit std::array<CMemoryCounter, (std::size_t)EMemoryTag::COUNT> g_HostMemory{};
+constinit std::array<CMemoryCounter, (std::size_t)EGpuMemory::COUNT> g_GpuMemory{};
+
+constinit thread_local EMemoryTag t_MemoryTag{ EMemoryTag::Untagged };
+
+// In front of every tracked block. The offset leads back to the pointer returned by malloc.
+struct CMemoryHeader final
+{
+	std::uint64_t m_Size{};
+	std::uint32_t m_Offset{};
+	EMemoryTag m_Tag{};
+};
+
+static_assert(sizeof(CMemoryHeader) <= 16);
+
+inline constexpr std::size_t MEMORY_HEADER_SPACE = 16;
+inline constexpr std::size_t MEMORY_MALLOC_ALIGN = alignof(std::max_align_t) < 16 ? 16 : alignof(std::max_align_t);	// x64 malloc, both CRTs.
+
+export [[nodiscard]] auto UTIL_MemoryCurrentTag() noexcept -> EMemoryTag
+{
+	return t_MemoryTag;
+}
+
+// Usage: CMemoryScope Scope{ EMemoryTag::RawPbs };
+// Allocations of this thread are attributed to the tag until the scope ends. Scopes nest.
+export struct CMemoryScope final
+{
+	EMemoryTag m_Previous{};
+
+	explicit CMemoryScope(EMemoryTag Tag) noexcept : m_Previous{ std::exchange(t_MemoryTag, Tag) } {}
+
+	CMemoryScope(CMemoryScope const&) noexcept = delete;
+	CMemoryScope(CMemoryScope&&) noexcept = delete;
+	CMemoryScope& operator=(CMemoryScope const&) noexcept = delete;
+	CMemoryScope& operator=(CMemoryScope&&) noexcept = delete;
+
+	~CMemoryScope() noexcept { t_MemoryTag = m_Previous; }
+};
+
+// nullptr on failure, like malloc. iAlign must be a power of two.
+export [[nodiscard]] auto UTIL_MemoryAlloc(std::size_t iSize, std::size_t iAlign, EMemoryTag Tag) noexcept -> void*
+{
+	// malloc already aligns to MEMORY_MALLOC_ALIGN, larger alignments take some slack.
+	auto const iSlack = iAlign > MEMORY_MALLOC_ALIGN ? iAlign : 0;
+	auto const pRaw = static_cast<std::byte*>(std::malloc(iSize + MEMORY_HEADER_SPACE + iSlack));
+
+	if (!pRaw) [[unlikely]]
+		return nullptr;
+
+	auto pUser = pRaw + MEMORY_HEADER_SPACE;
+	if (iSlack)
+		pUser = reinterpret_cast<std::byte*>((reinterpret_cast<std::uintptr_t>(pUser) + iAlign - 1) & ~(iAlign - 1));
+
+	std::construct_at(reinterpret_cast<CMemoryHeader*>(pUser - MEMORY_HEADER_SPACE), iSize, static_cast<std::uint32_t>(pUser - pRaw), Tag);
+	g_HostMemory[(std::size_t)Tag].Add(static_cast<std::int64_t>(iSize));
+
+	return pUser;
+}
+
+// Null is ignored. The tag is the one of the allocation, not the current one.
+export void UTIL_MemoryFree(void* p) noexcept
+{
+	if (!p)
+		return;
+
+	auto const pUser = static_cast<std::byte*>(p);
+	auto const pHeader = reinterpret_cast<CMemoryHeader*>(pUser - MEMORY_HEADER_SPACE);
+
+	g_HostMemory[(std::size_t)pHeader->m_Tag].Sub(static_cast<std::int64_t>(pHeader->m_Size));
+	std::free(pUser - pHeader->m_Offset);
+}
+
+// Same contract as realloc. Always moves, only used by stb_image on a few large buffers.
+export [[nodiscard]] auto UTIL_MemoryRealloc(void* p, std::size_t iSize, EMemoryTag Tag) noexcept -> void*
+{
+	if (!p)
+		return UTIL_MemoryAlloc(iSize, MEMORY_MALLOC_ALIGN, Tag);
+
+	auto const pHeader = reinterpret_cast<CMemoryHeader*>(static_cast<std::byte*>(p) - MEMORY_HEADER_SPACE);
+	auto const pNew = UTIL_MemoryAlloc(iSize, MEMORY_MALLOC_ALIGN, pHeader->m_Tag);
+
+	if (!pNew) [[unlikely]]
+		return nullptr;
+
+	std::memcpy(pNew, p, std::min<std::size_t>(iSize, pHeader->m_Size));
+	UTIL_MemoryFree(p);
+
+	return pNew;
+}
+
+// Counting allocator for containers that always belong to one subsystem, whichever thread fills them.
+// Not final, libstdc++ containers derive from their allocator.
+export template <typename T, EMemoryTag Tag>
+struct TTaggedAllocator
+{
+	using value_type = T;
+
+	template <typename U>
+	struct rebind { using other = TTaggedAllocator<U, Tag>; };
+
+	constexpr TTaggedAllocator() noexcept = default;
+	template <typename U> constexpr TTaggedAllocator(TTaggedAllocator<U, Tag> const&) noexcept {}
+
+	[[nodiscard]] T* allocate(std::size_t n)
+	{
+		if (auto const p = UTIL_MemoryAlloc(n * sizeof(T), alignof(T), Tag)) [[likely]]
+			return static_cast<T*>(p);
+
+		throw std::bad_alloc{};
+	}
+
+	void deallocate(T* p, std::size_t) noexcept { UTIL_MemoryFree(p); }
+
+	template <typename U>
+	constexpr bool operator==(TTaggedAllocator<U, Tag> const&) const noexcept { return true; }
+};
+
+export [[nodiscard]] auto UTIL_MemoryStat(EMemoryTag Tag) noexcept -> CMemoryStat
+{
+	return g_HostMemory[(std::size_t)Tag].Get();
+}
+
+export [[nodiscard]] auto UTIL_GpuMemoryStat(EGpuMemory Kind) noexcept -> CMemoryStat
+{
+	return g_GpuMemory[(std::size_t)Kind].Get();
+}
+
+// Peaks restart from the current live bytes, e.g. to measure one reload.
+export void UTIL_MemoryResetPeaks() noexcept
+{
+	for (auto&& Counter : g_HostMemory)
+		Counter.m_Peak.store(Counter.m_Live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	for (auto&& Counter : g_GpuMemory)
+		Counter.m_Peak.store(Counter.m_Live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+struct CGpuRegistry final
+{
+	std::mutex m_Mutex{};
+	std::unordered_map<std::uint64_t, std::int64_t> m_Objects{};	// (kind << 32 | GL name) to bytes.
+};
+
+[[nodiscard]] static auto GpuRegistry() noexcept -> CGpuRegistry&
+{
+	static CGpuRegistry Registry{};
+	return Registry;
+}
+
+// Call after every glTexImage*/glBufferData. Reallocating the storage of an object replaces its previous size.
+export void UTIL_GpuMemorySet(EGpuMemory Kind, std::uint32_t iObject, std::int64_t iBytes) noexcept
+{
+	auto& Registry = GpuRegistry();
+	auto& Counter = g_GpuMemory[(std::size_t)Kind];
+
+	std::scoped_lock Lock{ Registry.m_Mutex };
+
+	auto const [it, bNew] = Registry.m_Objects.try_emplace((std::uint64_t)Kind << 32 | iObject, iBytes);
+
+	// Only a new object counts as an upload, re-specifying the storage just moves the live bytes.
+	if (bNew)
+		Counter.Add(iBytes);
+	else
+	{
+		Counter.Resize(iBytes - it->second);
+		it->second = iBytes;
+	}
+}
+
+// Call before glDeleteTextures/glDeleteBuffers. Objects never set are ignored.
+export void UTIL_GpuMemoryRelease(EGpuMemory Kind, std::uint32_t iObject) noexcept
+{
+	auto& Registry = GpuRegistry();
+
+	std::scoped_lock Lock{ Registry.m_Mutex };
+
+	if (auto const it = Registry.m_Objects.find((std::uint64_t)Kind << 32 | iObject); it != Registry.m_Objects.end())
+	{
+		g_GpuMemory[(std::size_t)Kind].Sub(it->second);
+		Registry.m_Objects.erase(it);
+	}
+}
+
+// Bytes last set for one object, 0 if never set.
+export [[nodiscard]] auto UTIL_GpuMemoryOf(EGpuMemory Kind, std::uint32_t iObject) noexcept -> std::int64_t
+{
+	auto& Registry = GpuRegistry();
+
+	std::scoped_lock Lock{ Registry.m_Mutex };
+
+	if (auto const it = Registry.m_Objects.find((std::uint64_t)Kind << 32 | iObject); it != Registry.m_Objects.end())
+		return it->second;
+
+	return 0;
+}
+
+// "12.3 MiB"
+export [[nodiscard]] auto UTIL_MemoryFormatBytes(std::int64_t iBytes) noexcept -> std::string
+{
+	constexpr std::array UNITS{ "B", "KiB", "MiB", "GiB" };
+
+	auto flValue = static_cast<double>(iBytes);
+	std::size_t iUnit = 0;
+
+	while (std::abs(flValue) >= 1024.0 && iUnit + 1 < UNITS.size())
+	{
+		flValue /= 1024.0;
+		++iUnit;
+	}
+
+	return iUnit == 0 ? std::format("{} B", iBytes) : std::format("{:.1f} {}", flValue, UNITS[iUnit]);
+}
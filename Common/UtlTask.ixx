@@ -0,0 +1,373 @@
+module;
+
+#include <assert.h>
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#endif
+
+export module UtlTask;
+
+import std;
+
+import UtlLog;
+import UtlTrace;
+
+// Work-stealing thread pool and a small dependency graph on top of it.
+// Each worker owns a deque: it pushes and pops at the back, idle workers steal from the front of the others.
+// Tasks submitted from outside the pool go to a shared injection queue.
+
+export using fnTask_t = std::move_only_function<void() noexcept>;
+
+struct CTaskQueue final
+{
+	std::mutex m_Mutex{};	// Only contended while someone steals.
+	std::deque<fnTask_t> m_Tasks{};
+};
+
+export struct CThreadPool final
+{
+	explicit CThreadPool(std::size_t iThreads) noexcept
+	{
+		iThreads = std::max<std::size_t>(iThreads, 1);
+
+		for (std::size_t i = 0; i < iThreads; ++i)
+			m_Queues.emplace_back(std::make_unique<CTaskQueue>());
+
+		// Queues are all in place before the first worker may steal.
+		for (std::size_t i = 0; i < iThreads; ++i)
+			m_Threads.emplace_back([this, i] noexcept { WorkerMain(i); });
+	}
+
+	CThreadPool(CThreadPool const&) noexcept = delete;
+	CThreadPool(CThreadPool&&) noexcept = delete;
+	CThreadPool& operator=(CThreadPool const&) noexcept = delete;
+	CThreadPool& operator=(CThreadPool&&) noexcept = delete;
+
+	// Tasks already queued still run.
+	~CThreadPool() noexcept
+	{
+		m_Stop.store(true, std::memory_order_relaxed);
+		m_Queued.fetch_add(1, std::memory_order_release);
+		m_Queued.notify_all();
+		m_Threads.clear();
+	}
+
+	void Submit(fnTask_t fnTask) noexcept
+	{
+		if (t_pOwner == this)
+		{
+			std::scoped_lock Lock{ m_Queues[t_iWorker]->m_Mutex };
+			m_Queues[t_iWorker]->m_Tasks.push_back(std::move(fnTask));
+		}
+		else
+		{
+			std::scoped_lock Lock{ m_Injected.m_Mutex };
+			m_Injected.m_Tasks.push_back(std::move(fnTask));
+		}
+
+		m_Queued.fetch_add(1, std::memory_order_release);
+		m_Queued.notify_one();
+	}
+
+	[[nodiscard]] auto ThreadCount() const noexcept { return m_Threads.size(); }
+
+private:
+	std::vector<std::unique_ptr<CTaskQueue>> m_Queues{};
+	CTaskQueue m_Injected{};
+	std::atomic<std::uint32_t> m_Queued{};	// Tasks waiting in any queue, the idle workers sleep on it.
+	std::atomic<bool> m_Stop{};
+	std::vector<std::jthread> m_Threads{};	// Last, joined before the queues go away.
+
+	static inline thread_local CThreadPool* t_pOwner{};
+	static inline thread_local std::size_t t_iWorker{};
+
+	[[nodiscard]] auto TryPop(std::size_t iWorker) noexcept -> std::optional<fnTask_t>
+	{
+		// Own queue, newest first, for cache locality.
+		{
+			auto& Own = *m_Queues[iWorker];
+			std::scoped_lock Lock{ Own.m_Mutex };
+			if (!Own.m_Tasks.empty())
+			{
+				auto fn = std::move(Own.m_Tasks.back());
+				Own.m_Tasks.pop_back();
+				return fn;
+			}
+		}
+
+		// Outside submissions, oldest first.
+		{
+			std::scoped_lock Lock{ m_Injected.m_Mutex };
+			if (!m_Injected.m_Tasks.empty())
+			{
+				auto fn = std::move(m_Injected.m_Tasks.front());
+				m_Injected.m_Tasks.pop_front();
+				return fn;
+			}
+		}
+
+		// Steal the oldest task of another worker, it is the most likely to spawn more.
+		for (std::size_t i = 1; i < m_Queues.size(); ++i)
+		{
+			auto& Victim = *m_Queues[(iWorker + i) % m_Queues.size()];
+
+			std::unique_lock Lock{ Victim.m_Mutex, std::try_to_lock };
+			if (Lock && !Victim.m_Tasks.empty())
+			{
+				auto fn = std::move(Victim.m_Tasks.front());
+				Victim.m_Tasks.pop_front();
+				return fn;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	void WorkerMain(std::size_t iWorker) noexcept
+	{
+		t_pOwner = this;
+		t_iWorker = iWorker;
+		UTIL_TraceSetThreadName(std::format("Worker {}", iWorker));
+
+		for (;;)
+		{
+			if (auto fn = TryPop(iWorker))
+			{
+				m_Queued.fetch_sub(1, std::memory_order_relaxed);
+				(*fn)();
+				continue;
+			}
+
+			if (m_Stop.load(std::memory_order_relaxed))
+				break;
+
+			// Something is queued but another worker holds the lock, or is about to take it.
+			if (auto const iQueued = m_Queued.load(std::memory_order_acquire); iQueued != 0)
+				std::this_thread::yield();
+			else
+				m_Queued.wait(0, std::memory_order_acquire);
+		}
+	}
+};
+
+// One fewer than the hardware threads, the main thread has its own work.
+export [[nodiscard]] auto UTIL_ThreadPool() noexcept -> CThreadPool&
+{
+	static CThreadPool Pool{ std::max(std::thread::hardware_concurrency(), 2u) - 1 };
+	return Pool;
+}
+
+export enum struct ETaskAffinity : std::uint8_t
+{
+	Any,	// Any worker of the pool.
+	Main,	// The thread calling CTaskGraph::Wait(), e.g. the one owning the GL context.
+};
+
+export struct CTaskNode final
+{
+	std::string_view m_Name{};	// Also the trace zone name, literals only.
+	ETaskAffinity m_Affinity{};
+	ELogCategory m_Category{};
+	fnTask_t m_Task{};
+	std::vector<std::size_t> m_Successors{};
+	std::size_t m_Dependencies{};
+
+	std::atomic<std::size_t> m_Remaining{};
+	std::chrono::steady_clock::time_point m_Begin{};
+	std::chrono::steady_clock::time_point m_End{};
+};
+
+// Usage:
+//	CTaskGraph Graph{};
+//	auto const hLoad = Graph.Add("Load", ETaskAffinity::Any, ELogCategory::Database, [] noexcept { ... });
+//	Graph.Add("Upload", ETaskAffinity::Main, ELogCategory::Render, [] noexcept { ... }, { hLoad });
+//	Graph.Launch(UTIL_ThreadPool());
+//	... other work on this thread ...
+//	Graph.Wait();	// Runs the Main tasks here.
+// Tasks become ready as soon as all their dependencies are done. A graph runs once.
+export struct CTaskGraph final
+{
+	CTaskGraph() noexcept = default;
+	CTaskGraph(CTaskGraph const&) noexcept = delete;
+	CTaskGraph(CTaskGraph&&) noexcept = delete;
+	CTaskGraph& operator=(CTaskGraph const&) noexcept = delete;
+	CTaskGraph& operator=(CTaskGraph&&) noexcept = delete;
+	~CTaskGraph() noexcept { assert(m_Unfinished.load() == 0); }
+
+	// Dependencies must be added before their successors, which also rules out cycles.
+	auto Add(std::string_view szName, ETaskAffinity Affinity, ELogCategory Category, fnTask_t fnTask, std::initializer_list<std::size_t> rgDependencies = {}) noexcept -> std::size_t
+	{
+		assert(!m_pPool);
+
+		auto const iNode = m_Nodes.size();
+		auto& Node = m_Nodes.emplace_back();
+		Node.m_Name = szName;
+		Node.m_Affinity = Affinity;
+		Node.m_Category = Category;
+		Node.m_Task = std::move(fnTask);
+		Node.m_Dependencies = rgDependencies.size();
+
+		for (auto&& iDependency : rgDependencies)
+		{
+			assert(iDependency < iNode);
+			m_Nodes[iDependency].m_Successors.push_back(iNode);
+		}
+
+		return iNode;
+	}
+
+	// Starts every task without dependency. Main tasks only run inside Wait().
+	void Launch(CThreadPool& Pool) noexcept
+	{
+		m_pPool = &Pool;
+		m_Start = std::chrono::steady_clock::now();
+		m_Unfinished.store(m_Nodes.size(), std::memory_order_relaxed);
+
+		for (auto&& Node : m_Nodes)
+			Node.m_Remaining.store(Node.m_Dependencies, std::memory_order_relaxed);
+
+		for (std::size_t i = 0; i < m_Nodes.size(); ++i)
+		{
+			if (m_Nodes[i].m_Dependencies == 0)
+				Schedule(i);
+		}
+
+		if (m_Nodes.empty())
+		{
+			std::scoped_lock Lock{ m_MainMutex };
+			m_bDone = true;
+		}
+	}
+
+	// Runs the Main tasks on the calling thread as they become ready, returns when every task is done.
+	void Wait() noexcept
+	{
+		CTraceZone Zone{ "Wait for task graph" };
+		std::unique_lock Lock{ m_MainMutex };
+
+		for (;;)
+		{
+			m_Wakeup.wait(Lock, [this] noexcept { return !m_MainReady.empty() || m_bDone; });
+
+			if (m_MainReady.empty())
+				break;
+
+			auto const iNode = m_MainReady.front();
+			m_MainReady.pop_front();
+
+			Lock.unlock();
+			Run(iNode);
+			Lock.lock();
+		}
+	}
+
+	// The longest chain of dependent tasks, by their measured durations. Only valid after Wait().
+	// The wall time of the graph cannot be shorter than this, whatever the thread count.
+	[[nodiscard]] auto CriticalPath() const noexcept -> std::pair<std::vector<std::size_t>, std::chrono::nanoseconds>
+	{
+		std::vector<std::chrono::nanoseconds> rgFinish(m_Nodes.size());
+		std::vector<std::size_t> rgPrevious(m_Nodes.size(), std::numeric_limits<std::size_t>::max());
+
+		// Nodes are in topological order by construction.
+		for (std::size_t i = 0; i < m_Nodes.size(); ++i)
+		{
+			rgFinish[i] += m_Nodes[i].m_End - m_Nodes[i].m_Begin;
+
+			for (auto&& iSuccessor : m_Nodes[i].m_Successors)
+			{
+				if (rgFinish[i] > rgFinish[iSuccessor])
+				{
+					rgFinish[iSuccessor] = rgFinish[i];
+					rgPrevious[iSuccessor] = i;
+				}
+			}
+		}
+
+		std::vector<std::size_t> rgPath{};
+		if (m_Nodes.empty())
+			return { rgPath, {} };
+
+		auto i = (std::size_t)std::ranges::distance(rgFinish.begin(), std::ranges::max_element(rgFinish));
+		auto const Length = rgFinish[i];
+
+		for (; i != std::numeric_limits<std::size_t>::max(); i = rgPrevious[i])
+			rgPath.push_back(i);
+
+		std::ranges::reverse(rgPath);
+		return { std::move(rgPath), Length };
+	}
+
+	// Sum of the durations of every task, what a serial run would take.
+	[[nodiscard]] auto TotalWork() const noexcept -> std::chrono::nanoseconds
+	{
+		std::chrono::nanoseconds Total{};
+		for (auto&& Node : m_Nodes)
+			Total += Node.m_End - Node.m_Begin;
+
+		return Total;
+	}
+
+	[[nodiscard]] auto WallTime() const noexcept -> std::chrono::nanoseconds
+	{
+		auto Last = m_Start;
+		for (auto&& Node : m_Nodes)
+			Last = std::max(Last, Node.m_End);
+
+		return Last - m_Start;
+	}
+
+	[[nodiscard]] auto Nodes() const noexcept -> std::deque<CTaskNode> const& { return m_Nodes; }
+
+private:
+	std::deque<CTaskNode> m_Nodes{};	// Stable addresses, nodes hold atomics.
+	CThreadPool* m_pPool{};
+	std::chrono::steady_clock::time_point m_Start{};
+
+	std::atomic<std::size_t> m_Unfinished{};
+
+	// Notified under the lock: once Wait() holds it again the last worker no longer touches the graph, which may then be destroyed.
+	std::mutex m_MainMutex{};
+	std::condition_variable m_Wakeup{};
+	std::deque<std::size_t> m_MainReady{};
+	bool m_bDone{};
+
+	void Schedule(std::size_t iNode) noexcept
+	{
+		if (m_Nodes[iNode].m_Affinity == ETaskAffinity::Main)
+		{
+			std::scoped_lock Lock{ m_MainMutex };
+			m_MainReady.push_back(iNode);
+			m_Wakeup.notify_all();
+		}
+		else
+		{
+			m_pPool->Submit([this, iNode] noexcept { Run(iNode); });
+		}
+	}
+
+	void Run(std::size_t iNode) noexcept
+	{
+		auto& Node = m_Nodes[iNode];
+
+		Node.m_Begin = std::chrono::steady_clock::now();
+		{
+			CTraceZone Zone{ Node.m_Name, Node.m_Category };
+			Node.m_Task();
+		}
+		Node.m_End = std::chrono::steady_clock::now();
+
+		for (auto&& iSuccessor : Node.m_Successors)
+		{
+			if (m_Nodes[iSuccessor].m_Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				Schedule(iSuccessor);
+		}
+
+		if (m_Unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			std::scoped_lock Lock{ m_MainMutex };
+			m_bDone = true;
+			m_Wakeup.notify_all();
+		}
+	}
+};
@@ -0,0 +1,277 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#endif
+
+export module UtlTrace;
+
+import std;
+
+import UtlLog;
+
+// Scoped zones, recorded per thread and exported as Chrome trace_event JSON (chrome://tracing, ui.perfetto.dev).
+// When tracing is off a zone costs one relaxed load and a few stores.
+
+export struct CTraceEvent final
+{
+	std::string_view m_Name{};	// Static storage, always a string literal.
+	std::string m_Detail{};		// e.g. the file being loaded. Empty for most zones.
+	std::int64_t m_Begin{};		// Nanoseconds since the tracer started.
+	std::int64_t m_End{};
+	std::uint32_t m_Thread{};	// Order of the first zone of the thread, not the OS id.
+	std::uint16_t m_Depth{};	// Nesting level within the thread.
+	ELogCategory m_Category{};
+};
+
+export struct CTraceThread final
+{
+	std::uint32_t m_Thread{};
+	std::string m_Name{};
+};
+
+inline constexpr std::size_t TRACE_EVENTS_MAX = 1 << 16;	// Per thread. Once full, each new zone overwrites the oldest one.
+
+struct CTraceBuffer final
+{
+	std::mutex m_Mutex{};	// Only contended while someone takes a snapshot.
+	std::vector<CTraceEvent> m_Events{};	// Ring buffer once it reaches TRACE_EVENTS_MAX.
+	std::size_t m_iOldest{};				// Where the next zone goes when full. Zero until then.
+	std::string m_Name{};
+	std::uint32_t m_Thread{};
+};
+
+struct CTracer final
+{
+	std::chrono::steady_clock::time_point const m_Start{ std::chrono::steady_clock::now() };
+	std::atomic<bool> m_Enabled{ false };
+
+	std::mutex m_BuffersMutex{};
+	std::vector<std::unique_ptr<CTraceBuffer>> m_Buffers{};
+
+	auto Register() noexcept -> CTraceBuffer*
+	{
+		std::scoped_lock Lock{ m_BuffersMutex };
+
+		auto& pBuffer = m_Buffers.emplace_back(std::make_unique<CTraceBuffer>());
+		pBuffer->m_Thread = static_cast<std::uint32_t>(m_Buffers.size() - 1);
+		pBuffer->m_Events.reserve(1024);
+
+		return pBuffer.get();
+	}
+
+	[[nodiscard]] auto Now() const noexcept -> std::int64_t
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start).count();
+	}
+};
+
+CTracer g_Tracer{};
+
+thread_local CTraceBuffer* t_pTraceBuffer{};
+thread_local std::uint16_t t_iTraceDepth{};
+
+[[nodiscard]] auto TraceBuffer() noexcept -> CTraceBuffer*
+{
+	if (!t_pTraceBuffer) [[unlikely]]
+		t_pTraceBuffer = g_Tracer.Register();
+
+	return t_pTraceBuffer;
+}
+
+export [[nodiscard]] inline bool UTIL_TraceEnabled() noexcept
+{
+	return g_Tracer.m_Enabled.load(std::memory_order_relaxed);
+}
+
+// Zones opened before the switch are still closed properly, zones opened while off are never recorded.
+export void UTIL_TraceSetEnabled(bool bEnabled) noexcept
+{
+	g_Tracer.m_Enabled.store(bEnabled, std::memory_order_relaxed);
+}
+
+// Shown as the lane title. Threads without a name are shown as "Thread N".
+export void UTIL_TraceSetThreadName(std::string_view szName) noexcept
+{
+	auto const pBuffer = TraceBuffer();
+
+	std::scoped_lock Lock{ pBuffer->m_Mutex };
+	pBuffer->m_Name = szName;
+}
+
+// Usage: CTraceZone Zone{ "LoadTilesets", ELogCategory::Resource };
+// The name must outlive the tracer, use string literals only.
+export struct CTraceZone final
+{
+	std::string_view m_Name{};
+	std::string m_Detail{};
+	std::int64_t m_Begin{ -1 };	// Negative if tracing was off when the zone opened.
+	ELogCategory m_Category{};
+
+	explicit CTraceZone(std::string_view szName, ELogCategory Category = ELogCategory::General) noexcept
+		: m_Name{ szName }, m_Category{ Category }
+	{
+		if (UTIL_TraceEnabled()) [[unlikely]]
+		{
+			++t_iTraceDepth;
+			m_Begin = g_Tracer.Now();
+		}
+	}
+
+	// The detail is only copied when tracing is on.
+	CTraceZone(std::string_view szName, ELogCategory Category, std::string_view szDetail) noexcept
+		: CTraceZone{ szName, Category }
+	{
+		if (m_Begin >= 0) [[unlikely]]
+			m_Detail = szDetail;
+	}
+
+	// Same, but the path is only converted when tracing is on.
+	CTraceZone(std::string_view szName, ELogCategory Category, std::filesystem::path const& Path) noexcept
+		: CTraceZone{ szName, Category }
+	{
+		if (m_Begin >= 0) [[unlikely]]
+			m_Detail = Path.u8string();
+	}
+
+	CTraceZone(CTraceZone const&) noexcept = delete;
+	CTraceZone(CTraceZone&&) noexcept = delete;
+	CTraceZone& operator=(CTraceZone const&) noexcept = delete;
+	CTraceZone& operator=(CTraceZone&&) noexcept = delete;
+
+	~CTraceZone() noexcept
+	{
+		if (m_Begin < 0) [[likely]]
+			return;
+
+		auto const iEnd = g_Tracer.Now();
+		auto const pBuffer = TraceBuffer();
+
+		std::scoped_lock Lock{ pBuffer->m_Mutex };
+
+		CTraceEvent Event{
+			.m_Name = m_Name,
+			.m_Detail = std::move(m_Detail),
+			.m_Begin = m_Begin,
+			.m_End = iEnd,
+			.m_Thread = pBuffer->m_Thread,
+			.m_Depth = --t_iTraceDepth,
+			.m_Category = m_Category,
+		};
+
+		if (pBuffer->m_Events.size() < TRACE_EVENTS_MAX) [[likely]]
+			pBuffer->m_Events.push_back(std::move(Event));
+		else
+		{
+			pBuffer->m_Events[pBuffer->m_iOldest] = std::move(Event);
+			pBuffer->m_iOldest = (pBuffer->m_iOldest + 1) % TRACE_EVENTS_MAX;
+		}
+	}
+};
+
+export void UTIL_TraceClear() noexcept
+{
+	std::scoped_lock Lock{ g_Tracer.m_BuffersMutex };
+
+	for (auto&& pBuffer : g_Tracer.m_Buffers)
+	{
+		std::scoped_lock Lock2{ pBuffer->m_Mutex };
+		pBuffer->m_Events.clear();
+		pBuffer->m_iOldest = 0;
+	}
+}
+
+// Every recorded zone, sorted by begin time. Zones still open are not included.
+export void UTIL_TraceSnapshot(std::vector<CTraceEvent>* pEvents, std::vector<CTraceThread>* pThreads) noexcept
+{
+	pEvents->clear();
+	pThreads->clear();
+
+	{
+		std::scoped_lock Lock{ g_Tracer.m_BuffersMutex };
+
+		for (auto&& pBuffer : g_Tracer.m_Buffers)
+		{
+			std::scoped_lock Lock2{ pBuffer->m_Mutex };
+
+			// Oldest first. The sort below does not care, but stable input keeps it cheap.
+			pEvents->append_range(pBuffer->m_Events | std::views::drop(pBuffer->m_iOldest));
+			pEvents->append_range(pBuffer->m_Events | std::views::take(pBuffer->m_iOldest));
+			pThreads->emplace_back(pBuffer->m_Thread, pBuffer->m_Name.empty() ? std::format("Thread {}", pBuffer->m_Thread) : pBuffer->m_Name);
+		}
+	}
+
+	std::ranges::sort(*pEvents, {}, &CTraceEvent::m_Begin);
+}
+
+static void TraceEscape(std::string* pOut, std::string_view sz) noexcept
+{
+	for (auto&& c : sz)
+	{
+		switch (c)
+		{
+		case '"': pOut->append(R"(\")"); break;
+		case '\\': pOut->append(R"(\\)"); break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+				std::format_to(std::back_inserter(*pOut), "\\u{:04x}", static_cast<unsigned char>(c));
+			else
+				pOut->push_back(c);
+			break;
+		}
+	}
+}
+
+// Chrome trace_event format, complete events ("ph":"X") plus thread names. Returns the number of zones written.
+export auto UTIL_TraceWriteChrome(std::filesystem::path const& File) noexcept -> std::expected<std::size_t, std::string>
+{
+	std::vector<CTraceEvent> rgEvents{};
+	std::vector<CTraceThread> rgThreads{};
+	UTIL_TraceSnapshot(&rgEvents, &rgThreads);
+
+	std::string szOutput{ R"({"displayTimeUnit":"ms","traceEvents":[)" "\n" };
+	szOutput.reserve(rgEvents.size() * 128);
+
+	for (auto&& Thread : rgThreads)
+	{
+		std::format_to(std::back_inserter(szOutput), R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":")", Thread.m_Thread);
+		TraceEscape(&szOutput, Thread.m_Name);
+		szOutput.append("\"}},\n");
+	}
+
+	for (auto&& Event : rgEvents)
+	{
+		// Microseconds, with nanosecond precision kept in the fraction.
+		std::format_to(std::back_inserter(szOutput), R"({{"ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f},"cat":"{}","name":")",
+			Event.m_Thread, Event.m_Begin / 1000.0, (Event.m_End - Event.m_Begin) / 1000.0, UTIL_LogCategoryName(Event.m_Category));
+		TraceEscape(&szOutput, Event.m_Name);
+		szOutput.push_back('"');
+
+		if (!Event.m_Detail.empty())
+		{
+			szOutput.append(R"(,"args":{"detail":")");
+			TraceEscape(&szOutput, Event.m_Detail);
+			szOutput.append("\"}");
+		}
+
+		szOutput.append("},\n");
+	}
+
+	// Trailing comma is tolerated by the viewers but not by strict parsers.
+	if (szOutput.ends_with(",\n"))
+		szOutput.erase(szOutput.size() - 2, 1);
+
+	szOutput.append("]}\n");
+
+	std::ofstream Stream{ File, std::ios::binary | std::ios::trunc };
+	if (!Stream)
+		return std::unexpected(std::format("Cannot open '{}' for writing", File.u8string()));
+
+	Stream.write(szOutput.data(), std::ssize(szOutput));
+	Stream.close();
+
+	if (Stream.fail())
+		return std::unexpected(std::format("Failed to write '{}'", File.u8string()));
+
+	return rgEvents.size();
+}
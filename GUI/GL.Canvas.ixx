@@ -16,6 +16,9 @@ export module GL.Canvas;
 import std.compat;
 #endif
 
+import UtlLog;
+import UtlMemory;
+
 import GL.Texture;
 
 export struct CGlCanvas final
@@ -35,13 +38,14 @@ export struct CGlCanvas final
 		// Texture already generated in m_Texture's constructor
 		glBindTexture(GL_TEXTURE_2D, (GLuint)m_Texture);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		UTIL_GpuMemorySet(EGpuMemory::Textures, (GLuint)m_Texture, (std::int64_t)m_Width * m_Height * 4);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, (GLuint)m_Texture, 0);
 
 		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-			std::println("Framebuffer is not complete!");
+			UTIL_LogError(ELogCategory::Render, "Framebuffer is not complete!");
 
 		glBindFramebuffer(GL_FRAMEBUFFER, 0); // Unbind the framebuffer
 	}
@@ -117,7 +121,7 @@ export struct CGlCanvas final
 		auto const error = glGetError();
 		if (error != GL_NO_ERROR)
 		{
-			std::println("OpenGL error when reading pixels: 0x{:X}", error);
+			UTIL_LogError(ELogCategory::Render, "OpenGL error when reading pixels: 0x{:X}", error);
 			glBindFramebuffer(GL_FRAMEBUFFER, 0);
 			return false;
 		}
@@ -149,11 +153,11 @@ export struct CGlCanvas final
 		
 		if (result == 0)
 		{
-			std::println("Failed to write PNG file: {}", filePath.u8string());
+			UTIL_LogError(ELogCategory::Render, "Failed to write PNG file: {}", filePath.u8string());
 			return false;
 		}
 		
-		std::println("Successfully saved PNG: {}", filePath.u8string());
+		UTIL_LogInfo(ELogCategory::Render, "Successfully saved PNG: {}", filePath.u8string());
 		return true;
 	}
 
@@ -14,6 +14,8 @@ export module GL.GameMap;
 import std.compat;
 #endif
 
+import UtlLog;
+
 import GL.Canvas;
 import GL.Painter;
 import GL.Shader;
@@ -35,7 +37,7 @@ export struct CGlGameMap final
 	static constexpr auto CELL_WIDTH = CTilesetImage::TILE_WIDTH;
 	static constexpr auto CELL_HEIGHT = CTilesetImage::TILE_HEIGHT;
 
-	static constexpr auto VERTEX_ELEM_COUNT = 5;	// Each vertex has 5 components: x, y, u, v, texid
+	static constexpr auto VERTEX_ELEM_COUNT = 8;	// Each vertex has 8 components: x, y, u, v, layer, frame count, frames per second, EAtlasTexture
 
 	static constexpr auto TOTAL_LAYERS = 3;	// RPG Maker XP has 3 layers of tiles. Events is excluded for now.
 
@@ -45,7 +47,7 @@ export struct CGlGameMap final
 	{
 		if (m_Rows * CELL_HEIGHT != iHeight || m_Columns * CELL_WIDTH != iWidth) [[unlikely]]
 		{
-			std::println("Map size {}x{} is not a multiple of tile size {}x{}",
+			UTIL_LogWarning(ELogCategory::Render, "Map size {}x{} is not a multiple of tile size {}x{}",
 				iWidth, iHeight, CELL_WIDTH, CELL_HEIGHT
 			);
 		}
@@ -67,37 +69,33 @@ export struct CGlGameMap final
 	CGlGameMap& operator=(CGlGameMap&&) noexcept = default;
 	~CGlGameMap() noexcept = default;
 
-	void Render() const noexcept
+	// flTime in seconds, picks the frame of the animated tiles.
+	void Render(float flTime = 0.f) const noexcept
 	{
 		if (m_pTileset == nullptr) [[unlikely]]
 		{
-			std::println("No tileset image loaded for this map.");
+			UTIL_LogError(ELogCategory::Render, "No tileset image loaded for this map.");
 			return;
 		}
 
+		// Reloading after an eviction. Nothing is drawn rather than a map with holes, the canvas keeps the last frame.
+		auto const pMain = m_pTileset->GetMainTilesetObject();
+		if (!pMain && m_pTileset->m_Atlas.m_rgPages[0].m_iFirstLayer >= 0) [[unlikely]]
+			return;
+
 		m_Canvas.Bind();
 
 		//glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
-		g_pGlobalShader->Use();
-
-		for (int i = 1; i < (int)m_pTileset->m_rgpTilesetTextures.size(); ++i)
-		{
-			glActiveTexture(GL_TEXTURE0 + i);
-			glBindTexture(GL_TEXTURE_2D, m_pTileset->GetTextureIdAt(i));
-		}
+		// The main tileset as it was loaded, BC1/BC3 included, and the atlas for the other pages.
+		g_pTilemapShader->Use();
+		glUniform1f(g_iTilemapTimeUniform, flTime);
 
 		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D_ARRAY, m_pTileset->GetTextureIdAt(0));
-
-		for (int i = 0; i < (int)m_pTileset->m_rgpTilesetTextures.size(); ++i)
-		{
-			auto const sz = std::format("ourTexture{}", i);
-			glUniform1i(glGetUniformLocation(g_pGlobalShader->m_ProgramId, sz.c_str()), i);
-		}
-
-		if (auto const pMainTilesetObject = m_pTileset->GetMainTilesetObject(); pMainTilesetObject != nullptr) [[likely]]
-			glUniform1f(glGetUniformLocation(g_pGlobalShader->m_ProgramId, "layerHeight"), pMainTilesetObject->m_LayerHeightV);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, m_pTileset->m_Atlas.Use());
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, pMain ? (GLuint)pMain->m_Texture : 0);
+		glActiveTexture(GL_TEXTURE0);
 
 		m_Painter.Paint();
 
@@ -112,7 +110,7 @@ export struct CGlGameMap final
 	{
 		if (x >= m_Columns || y >= m_Rows || iTileIndex < 0) [[unlikely]]
 		{
-			std::println("Invalid tile assignment: x={}, y={}, iTileIndex={}", x, y, iTileIndex);
+			UTIL_LogWarning(ELogCategory::Render, "Invalid tile assignment: x={}, y={}, iTileIndex={}", x, y, iTileIndex);
 			return;
 		}
 
@@ -121,27 +119,26 @@ export struct CGlGameMap final
 		// Now that we determind which tileset image to use, we need to normalize the tile index to fit in that image.
 		iTileIndex = m_pTileset->GetNormalizedTileIndex(iTileIndex);
 
-		auto const [iTilesetWidth, iTilesetHeight] = m_pTileset->GetTextureDimensionsAt(iTilesetPageIndex);
-		auto const [iTilesetCols, iTilesetRows] = m_pTileset->GetTilesetDimensionsAt(iTilesetPageIndex);
+		// The atlas is built before the tiles are added. A page without image leaves the cell empty, as an unbound texture did.
+		auto const Tile = m_pTileset->m_Atlas.TileOf(iTilesetPageIndex, iTileIndex);
 
-		auto const iTileX = iTileIndex % iTilesetCols;
-		auto const iTileY = iTileIndex / iTilesetCols;
+		if (!Tile) [[unlikely]]
+			return;
 
 		auto const flLeft = (float)(x * CELL_WIDTH) / m_Canvas.m_Width * 2.f - 1.f;
 		auto const flTop = -((float)(y * CELL_HEIGHT) / m_Canvas.m_Height * 2.f - 1.f);	// Watch out this negation!
 		auto const flRight = (float)((x + 1) * CELL_WIDTH) / m_Canvas.m_Width * 2.f - 1.f;
 		auto const flBottom = -((float)((y + 1) * CELL_HEIGHT) / m_Canvas.m_Height * 2.f - 1.f);
 
-		auto const flLeftUV = (float)(iTileX * CTilesetImage::TILE_WIDTH) / (float)iTilesetWidth;
-		auto const flTopUV = -(float)(iTileY * CTilesetImage::TILE_HEIGHT) / (float)iTilesetHeight;
-		auto const flRightUV = (float)((iTileX + 1) * CTilesetImage::TILE_WIDTH) / (float)iTilesetWidth;
-		auto const flBottomUV = -(float)((iTileY + 1) * CTilesetImage::TILE_HEIGHT) / (float)iTilesetHeight;
+		auto const flFrames = Tile->m_flFrames;
+		auto const flSpeed = Tile->m_flFramesPerSecond;
+		auto const flTexture = Tile->m_flTexture;
 
 		std::array const rgflVertexData{
-			flLeft,  flTop,    flLeftUV,  flTopUV,    (float)iTilesetPageIndex,	// Top-Left
-			flRight, flTop,    flRightUV, flTopUV,    (float)iTilesetPageIndex,	// Top-Right
-			flLeft,  flBottom, flLeftUV,  flBottomUV, (float)iTilesetPageIndex,	// Bottom-Left
-			flRight, flBottom, flRightUV, flBottomUV, (float)iTilesetPageIndex,	// Bottom-Right
+			flLeft,  flTop,    Tile->m_flLeft,  Tile->m_flTop,    Tile->m_flLayer, flFrames, flSpeed, flTexture,	// Top-Left
+			flRight, flTop,    Tile->m_flRight, Tile->m_flTop,    Tile->m_flLayer, flFrames, flSpeed, flTexture,	// Top-Right
+			flLeft,  flBottom, Tile->m_flLeft,  Tile->m_flBottom, Tile->m_flLayer, flFrames, flSpeed, flTexture,	// Bottom-Left
+			flRight, flBottom, Tile->m_flRight, Tile->m_flBottom, Tile->m_flLayer, flFrames, flSpeed, flTexture,	// Bottom-Right
 		};
 
 		auto const index_offset = (GLuint)m_Painter.m_Vertices.size() / VERTEX_ELEM_COUNT;
@@ -14,10 +14,15 @@ export module GL.Painter;
 import std.compat;
 #endif
 
+import UtlLog;
+import UtlMemory;
+import UtlTrace;
+
 export struct CGlPainter2D final
 {
-	std::vector<float> m_Vertices{};
-	std::vector<GLuint> m_Indices{};
+	// CPU mirrors of the GL buffers, counted as painter memory whichever thread fills them.
+	std::vector<float, TTaggedAllocator<float, EMemoryTag::PainterMirror>> m_Vertices{};
+	std::vector<GLuint, TTaggedAllocator<GLuint, EMemoryTag::PainterMirror>> m_Indices{};
 
 	GLuint m_vbo{}, m_vao{}, m_ebo{};
 
@@ -49,12 +54,14 @@ export struct CGlPainter2D final
 
 			if (m_vbo != 0)
 			{
+				UTIL_GpuMemoryRelease(EGpuMemory::Buffers, m_vbo);
 				glDeleteBuffers(1, &m_vbo);
 				m_vbo = 0;
 			}
 
 			if (m_ebo != 0)
 			{
+				UTIL_GpuMemoryRelease(EGpuMemory::Buffers, m_ebo);
 				glDeleteBuffers(1, &m_ebo);
 				m_ebo = 0;
 			}
@@ -83,12 +90,14 @@ export struct CGlPainter2D final
 
 		if (m_vbo != 0)
 		{
+			UTIL_GpuMemoryRelease(EGpuMemory::Buffers, m_vbo);
 			glDeleteBuffers(1, &m_vbo);
 			m_vbo = 0;
 		}
 
 		if (m_ebo != 0)
 		{
+			UTIL_GpuMemoryRelease(EGpuMemory::Buffers, m_ebo);
 			glDeleteBuffers(1, &m_ebo);
 			m_ebo = 0;
 		}
@@ -96,14 +105,18 @@ export struct CGlPainter2D final
 
 	void Commit(int iStride) const noexcept
 	{
+		CTraceZone Zone{ "Buffer upload", ELogCategory::Render };
+
 		glBindVertexArray(m_vao);
 
 		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
 		glBufferData(GL_ARRAY_BUFFER, m_Vertices.size() * sizeof(decltype(m_Vertices)::value_type), m_Vertices.data(), GL_STATIC_DRAW);
+		UTIL_GpuMemorySet(EGpuMemory::Buffers, m_vbo, std::ssize(m_Vertices) * (std::int64_t)sizeof(decltype(m_Vertices)::value_type));
 
 		// 3. 复制我们的索引数组到一个索引缓冲中，供OpenGL使用
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Indices.size() * sizeof(decltype(m_Indices)::value_type), m_Indices.data(), GL_STATIC_DRAW);
+		UTIL_GpuMemorySet(EGpuMemory::Buffers, m_ebo, std::ssize(m_Indices) * (std::int64_t)sizeof(decltype(m_Indices)::value_type));
 
 		// 4. 设置顶点属性指针
 		glVertexAttribPointer(
@@ -127,10 +140,10 @@ export struct CGlPainter2D final
 		);
 		glEnableVertexAttribArray(1);
 
-		// texture id attribute
+		// texture id attribute, or whatever else follows the texture coord, up to 4 floats.
 		glVertexAttribPointer(
 			2,                  // attribute 2
-			1,                  // size
+			iStride - 4,        // size
 			GL_FLOAT,    // type
 			GL_FALSE,           // normalized?
 			iStride * sizeof(decltype(m_Vertices)::value_type),   // stride
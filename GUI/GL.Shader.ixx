@@ -14,6 +14,8 @@ export module GL.Shader;
 import std.compat;
 #endif
 
+import UtlLog;
+
 export struct CGlShader final
 {
 	GLuint m_ProgramId{};
@@ -110,109 +112,73 @@ export struct CGlShader final
 		if (m_ProgramId != 0) [[likely]]
 			glUseProgram(m_ProgramId);
 		else
-			std::println("Shader program is not initialized.");
+			UTIL_LogError(ELogCategory::Render, "Shader program is not initialized.");
 	}
 };
 
-export inline std::optional<CGlShader> g_pGlobalShader = std::nullopt;
+export inline std::optional<CGlShader> g_pTilemapShader = std::nullopt;	// Draws a map from its tileset texture and tile atlas.
+export inline GLint g_iTilemapTimeUniform = -1;	// Set every draw, looked up once with the shader.
 
-#pragma region Default Shader
+#pragma region Tilemap Shader
 
-inline constexpr char VERTEX_SHADER[] = R"(
+// Position and texture coordinates, then the first layer of the tile, its frame count, its frames per second and the
+// texture it is in (EAtlasTexture). The frames of an animated tile are consecutive layers, picked here from the time in
+// seconds. See CGlTileAtlas.
+inline constexpr char TILEMAP_VERTEX_SHADER[] = R"(
 #version 330 core
 
 layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec2 aTexCoord;
-layout (location = 2) in float aTextureId;
+layout (location = 2) in vec4 aFrames;
+
+uniform float time;
 
-out vec2 TexCoord;
-flat out int TextureId;
+out vec3 AtlasCoord;
+flat out int Source;
 
 void main()
 {
 	gl_Position = vec4(aPos, 0.0, 1.0);
-	TexCoord = aTexCoord;
-	TextureId = int(aTextureId);
+
+	float frame = mod(floor(time * aFrames.z), aFrames.y);
+	AtlasCoord = vec3(aTexCoord, aFrames.x + frame);
+	Source = int(aFrames.w);
 }
 )";
 
-inline constexpr char FRAGMENT_SHADER[] = R"(
+// The tileset array may be BC1/BC3, the atlas is always RGBA8, see CGlTileAtlas for why they are not one array. Still one
+// fetch per fragment: Source is flat, the branch is uniform across a quad and only diverges where two sources meet.
+inline constexpr char TILEMAP_FRAGMENT_SHADER[] = R"(
 #version 330 core
 
-uniform sampler2DArray ourTexture0;
-uniform sampler2D ourTexture1;
-uniform sampler2D ourTexture2;
-uniform sampler2D ourTexture3;
-uniform sampler2D ourTexture4;
-uniform sampler2D ourTexture5;
-uniform sampler2D ourTexture6;
-uniform sampler2D ourTexture7;
-
-uniform float layerHeight;  // Height of each layer in UV space (e.g., 256/29216 = 0.00876...)
+uniform sampler2DArray atlas;
+uniform sampler2DArray tileset;
 
-in vec2 TexCoord;
-flat in int TextureId;
+in vec3 AtlasCoord;
+flat in int Source;
 
 out vec4 FragColor;
 
 void main()
 {
-	switch (TextureId)
-	{
-		case 0:
-		default:
-		{
-			// Get the texture array dimensions directly
-			ivec3 textureArraySize = textureSize(ourTexture0, 0);
-			int totalLayers = textureArraySize.z;  // z component contains the number of layers
-
-			// Convert global V coordinate to layer index and local V coordinate
-			// Calculate which layer this UV falls into
-			float layerFloat = -TexCoord.y / layerHeight;	// Negate Y because TexCoord.y is from top to bottom, and consistent with other GL-generated textures
-			int layerIndex = int(floor(layerFloat));
-
-			// Clamp layer index to valid range
-			layerIndex = clamp(layerIndex, 0, totalLayers - 1);
-
-			// Calculate local V coordinate within the layer (0.0 to 1.0)
-			float localV = fract(layerFloat);
-
-			// U coordinate remains the same
-			float localU = TexCoord.x;
-
-			// Sample from the texture array
-			vec3 LocalTexCoord = vec3(localU, localV, float(layerIndex));
-			FragColor = texture(ourTexture0, LocalTexCoord);
-			break;
-		}
-		case 1:
-			FragColor = texture(ourTexture1, TexCoord);
-			break;
-		case 2:
-			FragColor = texture(ourTexture2, TexCoord);
-			break;
-		case 3:
-			FragColor = texture(ourTexture3, TexCoord);
-			break;
-		case 4:
-			FragColor = texture(ourTexture4, TexCoord);
-			break;
-		case 5:
-			FragColor = texture(ourTexture5, TexCoord);
-			break;
-		case 6:
-			FragColor = texture(ourTexture6, TexCoord);
-			break;
-		case 7:
-			FragColor = texture(ourTexture7, TexCoord);
-			break;
-	}
+	if (Source == 0)
+		FragColor = texture(tileset, AtlasCoord);
+	else
+		FragColor = texture(atlas, AtlasCoord);
 }
 )";
 
-#pragma endregion Default Shader
+#pragma endregion Tilemap Shader
 
 export inline void CompileBuiltinShader() noexcept
 {
-	g_pGlobalShader.emplace(VERTEX_SHADER, FRAGMENT_SHADER);
+	g_pTilemapShader.emplace(TILEMAP_VERTEX_SHADER, TILEMAP_FRAGMENT_SHADER);
+
+	// The atlas always sits on unit 0 and the tileset on unit 1, set once.
+	g_pTilemapShader->Use();
+	glUniform1i(glGetUniformLocation(g_pTilemapShader->m_ProgramId, "atlas"), 0);
+	glUniform1i(glGetUniformLocation(g_pTilemapShader->m_ProgramId, "tileset"), 1);
+	glUseProgram(0);
+
+	g_iTilemapTimeUniform = glGetUniformLocation(g_pTilemapShader->m_ProgramId, "time");
 }
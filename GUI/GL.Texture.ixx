@@ -16,6 +16,8 @@ export module GL.Texture;
 import std.compat;
 #endif
 
+import UtlMemory;
+
 export inline constexpr auto HYDROGENIUM_GL_TEXTURE_WRAPPER = HYDROGENIUM_GL_TEXTURE_WRAPPER_MACRO;
 
 export struct CGlTexture final
@@ -97,6 +99,7 @@ public:
 	{
 		if (m_TextureId != 0 && --(*m_RefCount) == 0)
 		{
+			UTIL_GpuMemoryRelease(EGpuMemory::Textures, m_TextureId);
 			glDeleteTextures(1, &m_TextureId);
 			m_RefCount.reset();	// release the shared_ptr
 		}
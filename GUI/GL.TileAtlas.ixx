@@ -0,0 +1,216 @@
+module;
+
+#include <gl/glew.h>
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module GL.TileAtlas;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+import UtlLog;
+import UtlMemory;
+import UtlTrace;
+
+import GL.Texture;
+import Image.Cache;
+import Image.Tilesets;
+
+// The autotile sheets and animated tiles of a tileset in one GL_TEXTURE_2D_ARRAY, one layer per frame. The main tileset
+// is not copied: the tilemap samples its own texture array, BC1/BC3 or RGBA, and this array for the other pages. Which
+// one, the layer and how the frames advance from a time uniform all come with the vertex. In every layer of both, row 0
+// is the top row of the source image.
+// Two arrays rather than one on purpose. A texture array has a single internal format, so the main layers would have to be
+// either decompressed into RGBA8, four to eight times the VRAM of the compressed tileset and a second copy of it, or the
+// autotiles compressed on every build. The price is a second bound texture per map, and a branch in the fragment shader
+// that is uniform over each quad.
+// Built once per tileset. The atlas counts against the texture budget like the images it is built from, and is evicted
+// along with the main tileset. Once evicted, the pages are kept and Build() gives back the same layout, the vertices of a
+// map stay valid.
+
+// A 2D texture to copy a page from, row 0 at the top. Frame i is the region of the page size at i times the step.
+export struct CAtlasSource final
+{
+	GLuint m_Texture{};
+	int m_Width{};	// Of one frame
+	int m_Height{};
+	int m_Frames{ 1 };
+	int m_FrameStepX{};
+	int m_FrameStepY{};
+};
+
+export enum struct EAtlasTexture : std::uint8_t { Tileset, Atlas, };
+
+export struct CAtlasPage final
+{
+	int m_iFirstLayer{ -1 };	// -1 if the page has no image.
+	int m_Width{};	// Content, in pixels. The rest of the layer is never sampled.
+	int m_Height{};
+	int m_Frames{ 1 };	// Consecutive layers.
+	EAtlasTexture m_Texture{ EAtlasTexture::Atlas };	// Layers above are in this one.
+};
+
+export struct CAtlasTile final
+{
+	float m_flLeft{};
+	float m_flTop{};
+	float m_flRight{};
+	float m_flBottom{};
+	float m_flLayer{};	// Of the first frame
+	float m_flFrames{};
+	float m_flFramesPerSecond{};
+	float m_flTexture{};	// EAtlasTexture
+};
+
+export struct CGlTileAtlas final : CCachedImage
+{
+	static constexpr auto LAYER_HEIGHT = 256;	// Same cut as the main tileset texture array, so that a tile is found the same way in both.
+	static constexpr auto PAGE_COUNT = 8;	// Main tileset plus 7 autotiles, like CTileset.
+	static constexpr auto FRAMES_PER_SECOND = 2.5f;	// RMXP advances the autotiles every 16 frames, at 40 FPS.
+
+	mutable CGlTexture m_Texture{};	// Empty once evicted.
+	int m_Width{};	// Of the atlas array. The main tileset page has its own width.
+	int m_Layers{};
+	std::array<CAtlasPage, PAGE_COUNT> m_rgPages{};
+	mutable bool m_bBuilt{};	// A tileset without autotiles is built without any texture.
+
+	CGlTileAtlas() noexcept = default;
+	~CGlTileAtlas() noexcept { m_Texture = {}; }
+
+	// GL thread. rgSources are the autotile and animated tile pages, already expanded. pMainHandle is the cache entry of
+	// the main tileset, the atlas goes when it goes.
+	void Build(CCachedImage const* pMainHandle, CTilesetImage const* pMain, std::array<std::optional<CAtlasSource>, PAGE_COUNT - 1> const& rgSources) noexcept
+	{
+		CTraceZone Zone{ "Build tile atlas", ELogCategory::Render };
+
+		OnUnloaded();
+		m_pBuiltFrom = pMainHandle;
+		m_bBuilt = true;
+		m_Texture = {};
+		m_rgPages = {};
+		m_Width = CTilesetImage::TILE_WIDTH;
+		m_Layers = 0;
+
+		if (pMain && pMain->m_Texture)
+			m_rgPages[0] = { .m_iFirstLayer = 0, .m_Width = pMain->m_Width, .m_Height = pMain->m_Height, .m_Texture = EAtlasTexture::Tileset };
+
+		for (auto&& [iIndex, Source] : std::views::enumerate(rgSources))
+		{
+			if (!Source || !Source->m_Texture || Source->m_Height > LAYER_HEIGHT)
+				continue;
+
+			m_rgPages[iIndex + 1] = {
+				.m_iFirstLayer = m_Layers, .m_Width = Source->m_Width, .m_Height = Source->m_Height, .m_Frames = std::max(Source->m_Frames, 1)
+			};
+			m_Width = std::max(m_Width, Source->m_Width);
+			m_Layers += m_rgPages[iIndex + 1].m_Frames;
+		}
+
+		// A tileset without autotiles only samples its own texture.
+		if (m_Layers == 0)
+			return;
+
+		m_Texture.Emplace();
+		glBindTexture(GL_TEXTURE_2D_ARRAY, (GLuint)m_Texture);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, m_Width, LAYER_HEIGHT, m_Layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		UTIL_GpuMemorySet(EGpuMemory::Textures, (GLuint)m_Texture, (std::int64_t)m_Width * LAYER_HEIGHT * m_Layers * 4);
+
+		std::array<GLuint, 2> rgFbo{};	// Draw, read
+		glGenFramebuffers((GLsizei)rgFbo.size(), rgFbo.data());
+
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, rgFbo[0]);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, rgFbo[1]);
+
+		for (auto&& [iIndex, Source] : std::views::enumerate(rgSources))
+		{
+			auto const& Page = m_rgPages[iIndex + 1];
+
+			if (Page.m_iFirstLayer < 0)
+				continue;
+
+			glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, Source->m_Texture, 0);
+
+			// Baked once, playing them costs nothing but the time uniform.
+			for (int iFrame = 0; iFrame < Page.m_Frames; ++iFrame)
+			{
+				auto const x = iFrame * Source->m_FrameStepX;
+				auto const y = iFrame * Source->m_FrameStepY;
+
+				glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, (GLuint)m_Texture, 0, Page.m_iFirstLayer + iFrame);
+				glBlitFramebuffer(
+					x, y, x + Page.m_Width, y + Page.m_Height,
+					0, 0, Page.m_Width, Page.m_Height,
+					GL_COLOR_BUFFER_BIT, GL_NEAREST
+				);
+			}
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers((GLsizei)rgFbo.size(), rgFbo.data());
+
+		if (auto const iErrorCode = glGetError(); iErrorCode != GL_NO_ERROR) [[unlikely]]
+			UTIL_LogError(ELogCategory::Render, "OpenGL error {} while building the tile atlas.", iErrorCode);
+
+		Touch();
+		OnLoaded(UTIL_GpuMemoryOf(EGpuMemory::Textures, (GLuint)m_Texture));
+	}
+
+	// For drawing, keeps the atlas resident through this frame. 0 once evicted, build it again first.
+	[[nodiscard]] auto Use() const noexcept -> GLuint
+	{
+		Touch();
+		return (GLuint)m_Texture;
+	}
+
+	[[nodiscard]] auto IsResident() const noexcept -> bool { return m_bBuilt; }
+
+	void Evict() const noexcept override
+	{
+		m_Texture = {};
+		m_bBuilt = false;
+	}
+
+	// Where a tile of a page sits. Past the last row of a page it wraps around, as an animated tile is a single tile
+	// for every autotile shape. nullopt if the page has no image.
+	[[nodiscard]] auto TileOf(int iPage, int iTileIndex) const noexcept -> std::optional<CAtlasTile>
+	{
+		if (iPage < 0 || iPage >= PAGE_COUNT || m_rgPages[iPage].m_iFirstLayer < 0)
+			return std::nullopt;
+
+		auto const& Page = m_rgPages[iPage];
+		auto const iTextureWidth = Page.m_Texture == EAtlasTexture::Tileset ? Page.m_Width : m_Width;
+		auto const iColumns = std::max(Page.m_Width / CTilesetImage::TILE_WIDTH, 1);
+		auto const iRows = std::max(Page.m_Height / CTilesetImage::TILE_HEIGHT, 1);
+
+		auto const x = (iTileIndex % iColumns) * CTilesetImage::TILE_WIDTH;
+		auto const y = (iTileIndex / iColumns % iRows) * CTilesetImage::TILE_HEIGHT;
+		auto const yInLayer = y % LAYER_HEIGHT;	// A tile never straddles two layers, 256 is a multiple of 32.
+
+		return CAtlasTile{
+			.m_flLeft = (float)x / (float)iTextureWidth,
+			.m_flTop = (float)yInLayer / (float)LAYER_HEIGHT,
+			.m_flRight = (float)(x + CTilesetImage::TILE_WIDTH) / (float)iTextureWidth,
+			.m_flBottom = (float)(yInLayer + CTilesetImage::TILE_HEIGHT) / (float)LAYER_HEIGHT,
+			.m_flLayer = (float)(Page.m_iFirstLayer + y / LAYER_HEIGHT),
+			.m_flFrames = (float)Page.m_Frames,
+			.m_flFramesPerSecond = Page.m_Frames > 1 ? FRAMES_PER_SECOND : 0.f,
+			.m_flTexture = (float)Page.m_Texture,
+		};
+	}
+
+	// Whether a map drawn from it changes over time.
+	[[nodiscard]] auto IsAnimated() const noexcept -> bool
+	{
+		return std::ranges::any_of(m_rgPages, [](CAtlasPage const& Page) noexcept { return Page.m_iFirstLayer >= 0 && Page.m_Frames > 1; });
+	}
+};
@@ -0,0 +1,366 @@
+module;
+
+#include <gl/glew.h>
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module GL.UploadRing;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+import UtlLog;
+import UtlMemory;
+import UtlTask;
+import UtlTrace;
+
+// Pixel unpack buffer, persistently mapped and carved as a ring. Any thread reserves a slice and writes straight into it,
+// then submits the GL command that reads from the slice. The GL thread runs the commands in Pump(), once per frame,
+// and fences each batch. A slice goes back to the ring when its fence has passed, in reservation order.
+// Producers wait while the ring is full, so decoding never runs further ahead of the GL thread than the ring. What cannot
+// go through the ring at all is posted from client memory, under a byte budget of the same size. The GL thread never waits.
+
+export struct CUploadSlice final
+{
+	std::uint64_t m_iTicket{};
+	std::size_t m_iOffset{};	// In the buffer
+	std::span<std::uint8_t> m_Bytes{};
+};
+
+// Called on the GL thread with nothing bound to GL_PIXEL_UNPACK_BUFFER, so that glTexImage*(nullptr) still allocates.
+// Bind iBuffer around the copy, iOffset is the pixel pointer.
+export using fnUploadCommand_t = std::move_only_function<void(std::uint32_t iBuffer, std::size_t iOffset) noexcept>;
+
+export struct CGlUploadRing final
+{
+	static constexpr std::size_t ALIGNMENT = 256;
+
+	struct CSliceRecord final
+	{
+		std::size_t m_iBegin{};
+		std::size_t m_iEnd{};
+		bool m_bIssued{};
+		std::shared_ptr<__GLsync> m_pFence{};	// One per batch, shared by its slices. Null once issued: no GPU read.
+	};
+
+	struct CCommand final
+	{
+		std::uint64_t m_iTicket{};
+		std::size_t m_iOffset{};
+		fnUploadCommand_t m_fnCommand{};
+	};
+
+	struct CPosted final
+	{
+		std::size_t m_iBytes{};	// Client memory held until it runs.
+		fnTask_t m_fnTask{};
+	};
+
+	GLuint m_Buffer{};
+	std::uint8_t* m_pMapped{};
+	std::size_t m_iCapacity{};
+
+	std::mutex m_Mutex{};
+	std::deque<CSliceRecord> m_Slices{};	// Reservation order, m_Slices[i] is ticket m_iFrontTicket + i.
+	std::uint64_t m_iFrontTicket{};
+	std::vector<CCommand> m_Commands{};
+	std::vector<CPosted> m_Posted{};
+	std::size_t m_iPostedBytes{};
+	std::size_t m_iPostedBudget{};
+	std::condition_variable m_Retired{};	// Slices or posted bytes went back, or Close() ran.
+	bool m_bClosed{};
+
+	// GL thread. Without ARB_buffer_storage the ring stays empty and every Reserve() fails.
+	explicit CGlUploadRing(std::size_t iCapacity) noexcept
+		: m_iPostedBudget{ iCapacity }
+	{
+		if (!GLEW_ARB_buffer_storage || !GLEW_ARB_sync)
+		{
+			UTIL_LogWarning(ELogCategory::Render, "Persistent mapping unavailable, textures are uploaded from client memory.");
+			return;
+		}
+
+		static constexpr GLbitfield MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glGenBuffers(1, &m_Buffer);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Buffer);
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)iCapacity, nullptr, MAP_FLAGS);
+		m_pMapped = static_cast<std::uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)iCapacity, MAP_FLAGS));
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		if (!m_pMapped) [[unlikely]]
+		{
+			UTIL_LogError(ELogCategory::Render, "Cannot map the upload ring, GL error {}.", glGetError());
+			glDeleteBuffers(1, &m_Buffer);
+			m_Buffer = 0;
+			return;
+		}
+
+		m_iCapacity = iCapacity;
+		UTIL_GpuMemorySet(EGpuMemory::Buffers, m_Buffer, (std::int64_t)iCapacity);
+	}
+
+	CGlUploadRing(CGlUploadRing const&) noexcept = delete;
+	CGlUploadRing(CGlUploadRing&&) noexcept = delete;
+	CGlUploadRing& operator=(CGlUploadRing const&) noexcept = delete;
+	CGlUploadRing& operator=(CGlUploadRing&&) noexcept = delete;
+
+	// GL thread, after every producer is gone.
+	~CGlUploadRing() noexcept
+	{
+		m_Slices.clear();	// Drops the fences.
+
+		if (m_Buffer)
+		{
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Buffer);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+			UTIL_GpuMemoryRelease(EGpuMemory::Buffers, m_Buffer);
+			glDeleteBuffers(1, &m_Buffer);
+		}
+	}
+
+	// Any thread but the GL one. Waits for Pump() to retire enough of the ring. Fails at once when the ring is unavailable
+	// or too small for iBytes, and once Close() ran.
+	[[nodiscard]] auto Reserve(std::size_t iBytes) noexcept -> std::optional<CUploadSlice>
+	{
+		iBytes = (iBytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+		if (!m_pMapped || iBytes == 0 || iBytes > m_iCapacity)
+			return std::nullopt;
+
+		std::unique_lock Lock{ m_Mutex };
+		std::optional<CUploadSlice> ret{};
+
+		m_Retired.wait(Lock, [&] noexcept { return m_bClosed || (ret = ReserveLocked(iBytes)).has_value(); });
+
+		return ret;
+	}
+
+	// Any thread, once the slice is written. The command runs in the next Pump().
+	void Submit(CUploadSlice const& Slice, fnUploadCommand_t fnCommand) noexcept
+	{
+		std::scoped_lock Lock{ m_Mutex };
+		m_Commands.push_back({ .m_iTicket = Slice.m_iTicket, .m_iOffset = Slice.m_iOffset, .m_fnCommand = std::move(fnCommand) });
+	}
+
+	// Any thread but the GL one. Plain GL thread work, for the uploads that could not get a slice. Runs in the next Pump(),
+	// unbound. iBytes is the client memory it holds: past the budget, waits for Pump() to run the earlier posts. A post
+	// larger than the whole budget waits until it is alone. Dropped once Close() ran.
+	void Post(std::size_t iBytes, fnTask_t fnTask) noexcept
+	{
+		std::unique_lock Lock{ m_Mutex };
+
+		m_Retired.wait(Lock, [&] noexcept { return m_bClosed || m_iPostedBytes == 0 || m_iPostedBytes + iBytes <= m_iPostedBudget; });
+
+		if (m_bClosed)
+			return;
+
+		m_iPostedBytes += iBytes;
+		m_Posted.push_back({ .m_iBytes = iBytes, .m_fnTask = std::move(fnTask) });
+	}
+
+	// GL thread. Wakes every waiting producer, Reserve() fails and Post() drops from now on.
+	void Close() noexcept
+	{
+		{
+			std::scoped_lock Lock{ m_Mutex };
+			m_bClosed = true;
+		}
+
+		m_Retired.notify_all();
+	}
+
+	// GL thread, once per frame. Never waits on the GPU.
+	void Pump() noexcept
+	{
+		std::vector<CCommand> rgCommands{};
+		std::vector<CPosted> rgPosted{};
+
+		{
+			std::scoped_lock Lock{ m_Mutex };
+			rgCommands.swap(m_Commands);
+			rgPosted.swap(m_Posted);
+		}
+
+		if (!rgCommands.empty())
+		{
+			CTraceZone Zone{ "Upload ring", ELogCategory::Render };
+
+			for (auto&& Command : rgCommands)
+				Command.m_fnCommand(m_Buffer, Command.m_iOffset);
+
+			std::shared_ptr<__GLsync> pFence{ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), [](GLsync p) static noexcept { glDeleteSync(p); } };
+
+			std::scoped_lock Lock{ m_Mutex };
+
+			for (auto&& Command : rgCommands)
+			{
+				auto& Record = m_Slices[Command.m_iTicket - m_iFrontTicket];
+				Record.m_bIssued = true;
+				Record.m_pFence = pFence;
+			}
+		}
+
+		if (!rgPosted.empty())
+		{
+			std::size_t iBytes{};
+
+			for (auto&& Posted : rgPosted)
+			{
+				Posted.m_fnTask();
+				iBytes += Posted.m_iBytes;
+			}
+
+			rgPosted.clear();	// The client memory goes before the producers are woken.
+
+			{
+				std::scoped_lock Lock{ m_Mutex };
+				m_iPostedBytes -= iBytes;
+			}
+
+			m_Retired.notify_all();
+		}
+
+		Retire();
+	}
+
+	[[nodiscard]] auto Available() const noexcept -> bool { return m_pMapped != nullptr; }
+
+private:
+	// m_Mutex held. nullopt while the ring is too full for iBytes, already aligned.
+	[[nodiscard]] auto ReserveLocked(std::size_t iBytes) noexcept -> std::optional<CUploadSlice>
+	{
+		std::size_t iBegin{};
+
+		if (m_Slices.empty())
+			iBegin = 0;
+		else if (auto const& Front = m_Slices.front(), &Back = m_Slices.back(); Back.m_iBegin >= Front.m_iBegin)
+		{
+			// Not wrapped: free space after the back, then before the front.
+			if (Back.m_iEnd + iBytes <= m_iCapacity)
+				iBegin = Back.m_iEnd;
+			else if (iBytes <= Front.m_iBegin)
+				iBegin = 0;
+			else
+				return std::nullopt;
+		}
+		else
+		{
+			// Wrapped: free space between the back and the front.
+			if (Back.m_iEnd + iBytes <= Front.m_iBegin)
+				iBegin = Back.m_iEnd;
+			else
+				return std::nullopt;
+		}
+
+		m_Slices.push_back({ .m_iBegin = iBegin, .m_iEnd = iBegin + iBytes });
+
+		return CUploadSlice{
+			.m_iTicket = m_iFrontTicket + m_Slices.size() - 1,
+			.m_iOffset = iBegin,
+			.m_Bytes = { m_pMapped + iBegin, iBytes },
+		};
+	}
+
+	void Retire() noexcept
+	{
+		bool bRetired{};
+
+		{
+			std::scoped_lock Lock{ m_Mutex };
+
+			while (!m_Slices.empty() && m_Slices.front().m_bIssued)
+			{
+				if (auto const& pFence = m_Slices.front().m_pFence)
+				{
+					if (auto const iStatus = glClientWaitSync(pFence.get(), 0, 0); iStatus != GL_ALREADY_SIGNALED && iStatus != GL_CONDITION_SATISFIED)
+						break;
+				}
+
+				m_Slices.pop_front();
+				++m_iFrontTicket;
+				bRetired = true;
+			}
+		}
+
+		if (bRetired)
+			m_Retired.notify_all();
+	}
+};
+
+// Created with the GL context, 64 MiB holds the tallest tileset we know of (256x29216) twice.
+export inline std::optional<CGlUploadRing> g_UploadRing = std::nullopt;
+
+inline std::mutex g_UploadRingUsersMutex{};
+inline std::condition_variable g_UploadRingUsersIdle{};
+inline std::size_t g_iUploadRingUsers{};
+inline bool g_bUploadRingClosed{};
+
+// Producers off the GL thread hold one for as long as they touch the ring. Empty once DestroyUploadRing() started,
+// the producer then drops its work: nobody is left to receive it.
+export struct CUploadRingLease final
+{
+	CGlUploadRing* m_pRing{};
+
+	CUploadRingLease() noexcept
+	{
+		std::scoped_lock Lock{ g_UploadRingUsersMutex };
+
+		if (g_bUploadRingClosed || !g_UploadRing)
+			return;
+
+		++g_iUploadRingUsers;
+		m_pRing = &*g_UploadRing;
+	}
+
+	CUploadRingLease(CUploadRingLease const&) noexcept = delete;
+	CUploadRingLease(CUploadRingLease&&) noexcept = delete;
+	CUploadRingLease& operator=(CUploadRingLease const&) noexcept = delete;
+	CUploadRingLease& operator=(CUploadRingLease&&) noexcept = delete;
+
+	~CUploadRingLease() noexcept
+	{
+		if (!m_pRing)
+			return;
+
+		std::scoped_lock Lock{ g_UploadRingUsersMutex };
+
+		if (--g_iUploadRingUsers == 0)
+			g_UploadRingUsersIdle.notify_all();
+	}
+
+	explicit operator bool() const noexcept { return m_pRing != nullptr; }
+	auto operator*() const noexcept -> CGlUploadRing& { return *m_pRing; }
+};
+
+export inline void CreateUploadRing() noexcept
+{
+	g_UploadRing.emplace(64u << 20);
+}
+
+// GL thread, before the context goes. Wakes the producers waiting on the ring, waits for those still decoding, then
+// unmaps and deletes the buffer. Commands and posted work never pumped are dropped with it.
+export inline void DestroyUploadRing() noexcept
+{
+	{
+		std::scoped_lock Lock{ g_UploadRingUsersMutex };
+		g_bUploadRingClosed = true;
+	}
+
+	if (g_UploadRing)
+		g_UploadRing->Close();
+
+	{
+		std::unique_lock Lock{ g_UploadRingUsersMutex };
+		g_UploadRingUsersIdle.wait(Lock, [] static noexcept { return g_iUploadRingUsers == 0; });
+	}
+
+	g_UploadRing.reset();
+}
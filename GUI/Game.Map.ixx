@@ -12,6 +12,9 @@ export module Game.Map;
 import std.compat;
 #endif
 
+import UtlLog;
+import UtlTrace;
+
 import Database.RX;
 import GL.GameMap;
 import Game.Tilesets;
@@ -31,6 +34,11 @@ export struct CMap final
 		m_pTileset{ &Game::Tilesets.at(m_pMapDatum->m_tileset_id) },
 		m_GameMap{ m_pMapDatum->m_width * CTilesetImage::TILE_WIDTH, m_pMapDatum->m_height * CTilesetImage::TILE_HEIGHT, m_pTileset }
 	{
+		CTraceZone Zone{ "CMap", ELogCategory::Render, m_Name };
+
+		// The tiles are placed by their position in the atlas.
+		m_pTileset->BuildAtlas();
+
 		for (int x = 0; x < m_pMapDatum->m_width; ++x)
 		{
 			for (int y = 0; y < m_pMapDatum->m_height; ++y)
@@ -48,7 +56,6 @@ export struct CMap final
 		}
 
 		m_GameMap.CommitVerticesChanges();
-		m_pTileset->RenderAll();	// Or we just get pitch black.
 		m_GameMap.Render();
 	}
 
@@ -58,6 +65,18 @@ export struct CMap final
 	CMap& operator=(CMap&&) noexcept = default;
 	~CMap() noexcept = default;
 
+	// Redraws the map at flTime seconds if any of its tiles are animated. A single draw call, the shader picks the frames.
+	void Animate(float flTime) const noexcept
+	{
+		if (!m_pTileset->m_Atlas.IsAnimated())
+			return;
+
+		// Evicted with its tileset or over the budget, the layout comes back the same.
+		m_pTileset->BuildAtlas();
+
+		m_GameMap.Render(flTime);
+	}
+
 	[[nodiscard]] inline auto GetTextureId() const noexcept -> GLuint
 	{
 		return m_GameMap.m_Canvas.GetTextureId();
@@ -12,32 +12,38 @@ export module Game.Path;
 import std.compat;
 #endif
 
+import UtlLog;
+
 namespace PokemonEssentials
 {
+#ifdef _WIN32
 	export inline std::filesystem::path GamePath{ LR"(C:\Users\Hydrogen\Documents\GitHub\Pokemon Essentials\)" };
+#else
+	export inline std::filesystem::path GamePath{ "." };	// Working directory.
+#endif
 
 	export bool AssignGamePath(std::filesystem::path NewPath) noexcept
 	{
-		if (!std::filesystem::is_directory(NewPath / L"Data/"))
+		if (!std::filesystem::is_directory(NewPath / "Data"))
 		{
-			std::println("'Data' folder no found!");
+			UTIL_LogError(ELogCategory::General, "'Data' folder no found!");
 			return false;
 		}
 
-		if (!std::filesystem::is_directory(NewPath / L"PBS/"))
+		if (!std::filesystem::is_directory(NewPath / "PBS"))
 		{
-			std::println("'PBS' folder no found!");
+			UTIL_LogError(ELogCategory::General, "'PBS' folder no found!");
 			return false;
 		}
 
-		if (!std::filesystem::is_directory(NewPath / L"Graphics/"))
+		if (!std::filesystem::is_directory(NewPath / "Graphics"))
 		{
-			std::println("'Graphics' folder no found!");
+			UTIL_LogError(ELogCategory::General, "'Graphics' folder no found!");
 			return false;
 		}
 
 		GamePath = std::move(NewPath);
-		std::println("Game path set to '{}'", GamePath.u8string());
+		UTIL_LogInfo(ELogCategory::General, "Game path set to '{}'", GamePath.u8string());
 		return true;
 	}
 }
@@ -14,21 +14,32 @@ export module Game.Tilesets;
 import std.compat;
 #endif
 
+import UtlLog;
 import UtlString;
+import UtlTrace;
 import Database.RX;
 import Game.Path;
+import GL.TileAtlas;
+import Image.Cache;
 import Image.Query;
 import Image.Resources;
 import Image.Tilesets;
 
 
+// Holds handles, every accessor goes through Get() so the images load, and stay resident, only while a map uses them.
 export struct CTileset final
 {
 	std::string_view m_Name{};
 	Database::RX::Tileset const* m_pTilesetDatabase{};
-	std::array<std::variant<CTilesetImage const*, CAutotileImage const*, CAnimatedTileImage const*, std::nullptr_t>, 8> m_rgpTilesetTextures{
+	std::array<std::variant<
+		PokemonEssentials::Resources::TilesetHandle_t const*,
+		PokemonEssentials::Resources::AutotileHandle_t const*,
+		PokemonEssentials::Resources::AnimatedTileHandle_t const*,
+		std::nullptr_t
+	>, 8> m_rgpTilesetTextures{
 		nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
 	};
+	mutable CGlTileAtlas m_Atlas{};	// Built by BuildAtlas(), again only after an eviction.
 
 	CTileset(Database::RX::Tileset const* pTilesetDatabase) noexcept
 		: m_Name{ pTilesetDatabase->m_name }, m_pTilesetDatabase{ pTilesetDatabase }
@@ -60,10 +71,96 @@ export struct CTileset final
 	CTileset& operator=(CTileset&&) noexcept = default;
 	~CTileset() noexcept = default;
 
+	// Starts every image that is not resident yet, without waiting. True once all of them are resident or have failed.
+	// Call each frame until then, the main tileset streams through the upload ring.
+	[[nodiscard]] auto RequestAll() const noexcept -> bool
+	{
+		bool bReady = true;
+
+		for (auto&& pTexture : m_rgpTilesetTextures)
+		{
+			std::visit(
+				[&]<typename T>(T&& pTexture) noexcept
+				{
+					if constexpr (requires { pTexture->Request(); })
+					{
+						if (pTexture)
+							bReady = pTexture->Request() && bReady;
+					}
+				}, pTexture
+			);
+		}
+
+		return bReady;
+	}
+
+	// Every frame of the animated tiles and of the animated autotiles gets its own layer. Does nothing while the atlas is
+	// resident, the copies in it do not change when the autotile images are reloaded.
+	void BuildAtlas() const noexcept
+	{
+		if (m_Atlas.IsResident())
+			return;
+
+		std::array<std::optional<CAtlasSource>, CGlTileAtlas::PAGE_COUNT - 1> rgSources{};
+
+		for (int i = 1; i < std::ssize(m_rgpTilesetTextures); ++i)
+		{
+			rgSources[i - 1] = std::visit(
+				[]<typename T>(T&& pTexture) static noexcept -> std::optional<CAtlasSource>
+				{
+					if constexpr (std::is_same_v<std::remove_cvref_t<T>, std::nullptr_t>)
+					{
+						return std::nullopt;
+					}
+					else
+					{
+						auto const pImage = pTexture ? pTexture->Get() : nullptr;
+
+						if (!pImage || !pImage->m_Texture)
+							return std::nullopt;
+
+						using image_t = std::remove_cvref_t<decltype(*pImage)>;
+
+						if constexpr (std::is_same_v<image_t, CAnimatedTileImage>)
+						{
+							auto const [iWidth, iHeight] = image_t::GetOutputTextureDimension();
+							return CAtlasSource{
+								.m_Texture = pImage->GetOutputTextureId(),
+								.m_Width = iWidth,
+								.m_Height = iHeight,
+								.m_Frames = pImage->m_FrameCount,
+								.m_FrameStepX = iWidth,
+							};
+						}
+						else if constexpr (std::is_same_v<image_t, CAutotileImage>)
+						{
+							// The sheets of all frames, top to bottom.
+							auto const [iWidth, iHeight] = image_t::GetOutputTextureDimension();
+							return CAtlasSource{
+								.m_Texture = pImage->GetOutputTextureId(),
+								.m_Width = iWidth,
+								.m_Height = iHeight,
+								.m_Frames = pImage->m_FrameCount,
+								.m_FrameStepY = iHeight,
+							};
+						}
+						else
+						{
+							return std::nullopt;
+						}
+					}
+				}, m_rgpTilesetTextures[i]
+			);
+		}
+
+		auto const ppMainHandle = std::get_if<PokemonEssentials::Resources::TilesetHandle_t const*>(&m_rgpTilesetTextures[0]);
+		m_Atlas.Build(ppMainHandle ? *ppMainHandle : nullptr, GetMainTilesetObject(), rgSources);
+	}
+
 	[[nodiscard]] auto GetMainTilesetObject() const noexcept -> CTilesetImage const*
 	{
-		if (auto ptr = std::get_if<CTilesetImage const*>(&m_rgpTilesetTextures[0]); ptr && *ptr) [[likely]]
-			return *ptr;
+		if (auto ptr = std::get_if<PokemonEssentials::Resources::TilesetHandle_t const*>(&m_rgpTilesetTextures[0]); ptr && *ptr) [[likely]]
+			return (*ptr)->Get();
 
 		return nullptr;
 	}
@@ -82,8 +179,8 @@ export struct CTileset final
 				}
 				else
 				{
-					if (pTexture)
-						return pTexture->GetOutputTextureId();
+					if (auto const pImage = pTexture ? pTexture->Get() : nullptr)
+						return pImage->GetOutputTextureId();
 
 					return 0;
 				}
@@ -115,8 +212,8 @@ export struct CTileset final
 				}
 				else
 				{
-					if (pTexture)
-						return pTexture->GetOutputTextureDimension();
+					if (auto const pImage = pTexture ? pTexture->Get() : nullptr)
+						return pImage->GetOutputTextureDimension();
 
 					return { 0, 0 };
 				}
@@ -138,8 +235,8 @@ export struct CTileset final
 				}
 				else
 				{
-					if (pTexture)
-						return pTexture->GetOutputTilesetDimension();
+					if (auto const pImage = pTexture ? pTexture->Get() : nullptr)
+						return pImage->GetOutputTilesetDimension();
 
 					return { 0, 0 };
 				}
@@ -157,32 +254,6 @@ export struct CTileset final
 
 		return iTileIndex % Database::RX::Tileset::AUTOTILE_TILE;	// Auto-tile or animated tile image.
 	}
-
-	void RenderAll() const noexcept
-	{
-		for (auto&& pTexture : m_rgpTilesetTextures)
-		{
-			std::visit(
-				[]<typename T>(T&& pTexture) static noexcept
-				{
-					if constexpr (requires { pTexture->Render(); })
-					{
-						if (pTexture)
-							pTexture->Render();
-					}
-					else if constexpr (requires { pTexture->Render(0); })
-					{
-						if (pTexture)
-							pTexture->Render(0);	// Render the first frame.
-					}
-					else
-					{
-						// Do nothing.
-					}
-				}, pTexture
-			);
-		}
-	}
 };
 
 namespace Game
@@ -191,6 +262,8 @@ namespace Game
 
 	export void CompileTilesets() noexcept
 	{
+		CTraceZone Zone{ "CompileTilesets", ELogCategory::Render };
+
 		Tilesets.clear();
 
 		for (auto&& TilesetMetaData : Database::RX::Tilesets)
@@ -26,9 +26,17 @@
 import std.compat;
 #endif
 
+import UtlLog;
+import UtlTask;
+import UtlTrace;
+
 import GL.Shader;
+import GL.UploadRing;
 import Game.Tilesets;
 import Game.Path;
+import Image.Cache;
+import Image.Decode;
+import Image.Resources;
 import Database.Raw.PBS;
 import Database.RX;
 import Database.PBS;
@@ -94,8 +102,9 @@ namespace TestWindow
 
 namespace PokemonEssentials::Resources
 {
-	extern void LoadAutotiles() noexcept;
-	extern void LoadTilesets() noexcept;
+	extern void DiscoverAutotiles(CImageDiscovery* pDiscovery) noexcept;
+	extern void DiscoverTilesets(CImageDiscovery* pDiscovery) noexcept;
+	extern void IndexImages(CImageDiscovery* pDiscovery) noexcept;
 }
 
 namespace Window
@@ -106,11 +115,20 @@ namespace Window
 	extern void MapDisplay() noexcept;
 	extern void TypeInfo() noexcept;
 	extern void Pokemons() noexcept;
+	extern void Query() noexcept;
+	extern void Log() noexcept;
+	extern void Profiler() noexcept;
+	extern void Memory() noexcept;
 }
 
 // Main code
 int main(int argc, char* argv[]) noexcept
 {
+	// On from the start so the Profiler window can show where startup went.
+	UTIL_TraceSetEnabled(true);
+	UTIL_TraceSetThreadName("Main");
+	std::optional<CTraceZone> StartupZone{ std::in_place, "Startup" };
+
 	if (argc == 2)
 	{
 		std::filesystem::path Candidate{ argv[1] };
@@ -120,11 +138,34 @@ int main(int argc, char* argv[]) noexcept
 	}
 	else
 	{
-		std::println("Default game path is used: '{}'", PokemonEssentials::GamePath.u8string());
+		UTIL_LogInfo(ELogCategory::General, "Default game path is used: '{}'", PokemonEssentials::GamePath.u8string());
+	}
+
+	// The CPU side of the startup runs on the pool right away, overlapping the window and GL setup below.
+	// GL tasks are pinned to this thread and run in StartupGraph.Wait(), once the context exists.
+	PokemonEssentials::Resources::CImageDiscovery ImageDiscovery{};
+	CTaskGraph StartupGraph{};
+	{
+		using enum ETaskAffinity;
+		using namespace PokemonEssentials::Resources;
+
+		auto const hLoadPbs = StartupGraph.Add("Load PBS", Any, ELogCategory::Database, [] static noexcept { PBS::Load(PokemonEssentials::GamePath); });
+		StartupGraph.Add("Build PBS", Any, ELogCategory::Database, [] static noexcept { Database::PBS::Build(); }, { hLoadPbs });
+		auto const hLoadRx = StartupGraph.Add("Load RX", Any, ELogCategory::Database, [] static noexcept { Database::RX::Load(PokemonEssentials::GamePath); });
+		auto const hFindAutotiles = StartupGraph.Add("Discover autotiles", Any, ELogCategory::Resource, [&ImageDiscovery] noexcept { DiscoverAutotiles(&ImageDiscovery); });
+		auto const hFindTilesets = StartupGraph.Add("Discover tilesets", Any, ELogCategory::Resource, [&ImageDiscovery] noexcept { DiscoverTilesets(&ImageDiscovery); });
+
+		// Only the headers are read, textures load on first use. See Image.Cache.
+		auto const hIndex = StartupGraph.Add("Index images", Any, ELogCategory::Resource, [&ImageDiscovery] noexcept { IndexImages(&ImageDiscovery); }, { hFindAutotiles, hFindTilesets });
+		StartupGraph.Add("Compile tilesets", Any, ELogCategory::Render, [] static noexcept { Game::CompileTilesets(); }, { hLoadRx, hIndex });
+
+		StartupGraph.Add("Compile shaders", Main, ELogCategory::Render, [] static noexcept { CompileBuiltinShader(); });
+		StartupGraph.Add("Create upload ring", Main, ELogCategory::Render, [] static noexcept { CreateUploadRing(); });
 	}
+	StartupGraph.Launch(UTIL_ThreadPool());
 
-	std::jthread thread_LoadPBS{ [] static noexcept { PBS::Load(PokemonEssentials::GamePath); Database::PBS::Build(); } },
-		thread_LoadRxData{ [] static noexcept { Database::RX::Load(PokemonEssentials::GamePath); } };
+	// Pool tasks still reference this frame, returning from main() would pull it from under them.
+	static constexpr auto fnStartupFailed = [] static noexcept { std::quick_exit(1); };
 
 	glfwSetErrorCallback(
 		[](int error, const char* description) {
@@ -132,7 +173,7 @@ int main(int argc, char* argv[]) noexcept
 		}
 	);
 	if (!glfwInit())
-		return 1;
+		fnStartupFailed();
 
 	// GL 3.0 + GLSL 130
 	static constexpr char glsl_version[] = "#version 130";
@@ -143,7 +184,7 @@ int main(int argc, char* argv[]) noexcept
 	auto const main_scale = ImGui_ImplGlfw_GetContentScaleForMonitor(glfwGetPrimaryMonitor()); // Valid on GLFW 3.3+ only
 	auto const window = glfwCreateWindow((int)(1280 * main_scale), (int)(800 * main_scale), "Dear ImGui GLFW+OpenGL3 example", nullptr, nullptr);
 	if (window == nullptr)
-		return 1;
+		fnStartupFailed();
 
 	glfwMakeContextCurrent(window);
 	glfwSwapInterval(1); // Enable vsync
@@ -153,7 +194,7 @@ int main(int argc, char* argv[]) noexcept
 		fprintf(stderr, "Failed to initialize GLEW\n");
 		getchar();
 		glfwTerminate();
-		return -1;
+		fnStartupFailed();
 	}
 
 	// Setup Dear ImGui context
@@ -214,16 +255,23 @@ int main(int argc, char* argv[]) noexcept
 	// Our state
 	static constexpr ImVec4 clear_color{ 0.45f, 0.55f, 0.60f, 1.00f };
 
-	CompileBuiltinShader();
+	// SYNC POINT
+	StartupGraph.Wait();
+	StartupZone.reset();
 
-	PokemonEssentials::Resources::LoadAutotiles();
-	PokemonEssentials::Resources::LoadTilesets();
+	{
+		using Milliseconds = std::chrono::duration<double, std::milli>;
 
-	// SYNC POINT
-	thread_LoadPBS.join();
-	thread_LoadRxData.join();
+		auto const [rgCriticalPath, CriticalLength] = StartupGraph.CriticalPath();
+		auto const szCriticalPath = rgCriticalPath
+			| std::views::transform([&](std::size_t i) noexcept { return StartupGraph.Nodes()[i].m_Name; })
+			| std::views::join_with(std::string_view{ " > " })
+			| std::ranges::to<std::string>();
 
-	Game::CompileTilesets();
+		UTIL_LogInfo(ELogCategory::General, "Startup tasks done in {:.1f} ms, {:.1f} ms of work on {} workers. Critical path {:.1f} ms: {}",
+			Milliseconds{ StartupGraph.WallTime() }.count(), Milliseconds{ StartupGraph.TotalWork() }.count(), UTIL_ThreadPool().ThreadCount(),
+			Milliseconds{ CriticalLength }.count(), szCriticalPath);
+	}
 
 	// Main loop
 	while (!glfwWindowShouldClose(window))
@@ -240,6 +288,12 @@ int main(int argc, char* argv[]) noexcept
 			continue;
 		}
 
+		CTraceZone FrameZone{ "Frame", ELogCategory::Render };
+
+		// Streamed textures land before anything of this frame asks for them.
+		g_UploadRing->Pump();
+		PokemonEssentials::Resources::TextureCacheNewFrame();
+
 		// Start the Dear ImGui frame
 		ImGui_ImplOpenGL3_NewFrame();
 		ImGui_ImplGlfw_NewFrame();
@@ -253,6 +307,10 @@ int main(int argc, char* argv[]) noexcept
 		Window::MapList();
 		Window::MapDisplay();
 		Window::Pokemons();
+		Window::Query();
+		Window::Log();
+		Window::Profiler();
+		Window::Memory();
 
 		// Rendering
 		ImGui::Render();
@@ -281,6 +339,9 @@ int main(int argc, char* argv[]) noexcept
 #endif
 
 	// Cleanup
+	LogImageDiskCacheStat();
+	DestroyUploadRing();	// Its buffer is a GL object, the context must still be current.
+
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
@@ -0,0 +1,227 @@
+module;
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HYDROGENIUM_SSE2 1
+#endif
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module Image.Autotile;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+import UtlLog;
+import UtlTrace;
+import Image.Decode;
+
+// Expansion of an RPG Maker XP autotile into the sheet of its 48 shapes, on the CPU. No GL call, safe on any thread.
+// Each shape is four 16x16 components picked from the 96x128 source, see AUTOTILE_SHAPE_INFO.
+
+// For indexing AUTOTILE_SHAPE_INFO below.
+enum EAutotileShapes : std::uint8_t
+{
+	AT_Bordering_None,
+	AT_Bordering_UL,
+	AT_Bordering_UR,
+	AT_Bordering_UL_UR,
+	AT_Bordering_DR,
+	AT_Bordering_UL_DR,
+	AT_Bordering_UR_DR,
+	AT_Bordering_UL_UR_DR,
+
+	AT_Bordering_DL,
+	AT_Bordering_UL_DL,
+	AT_Bordering_UR_DL,
+	AT_Bordering_UL_UR_DL,
+	AT_Bordering_DL_DR,
+	AT_Bordering_UL_DL_DR,
+	AT_Bordering_UR_DL_DR,
+	AT_Bordering_UL_UR_DL_DR,	// 'crossroad' shape, all 4 sides connected
+
+	AT_Bordering_L,
+	AT_Bordering_L_UR,
+	AT_Bordering_L_DR,
+	AT_Bordering_L_UR_DR,
+	AT_Bordering_U,
+	AT_Bordering_U_DR,
+	AT_Bordering_U_DL,
+	AT_Bordering_U_DR_DL,
+
+	AT_Bordering_R,
+	AT_Bordering_R_DL,
+	AT_Bordering_R_UL,
+	AT_Bordering_R_UL_DL,
+	AT_Bordering_D,
+	AT_Bordering_D_UL,
+	AT_Bordering_D_UR,
+	AT_Bordering_D_UL_DR,
+
+	AT_Bordering_L_R,
+	AT_Bordering_U_D,
+	AT_Bordering_U_L,
+	AT_Bordering_U_L_DR,
+	AT_Bordering_U_R,
+	AT_Bordering_U_R_DL,
+	AT_Bordering_D_R,
+	AT_Bordering_D_R_UL,
+
+	AT_Bordering_D_L,
+	AT_Bordering_D_L_UR,
+	AT_Bordering_U_L_R,
+	AT_Bordering_U_D_L,
+	AT_Bordering_D_L_R,
+	AT_Bordering_U_D_R,
+	AT_Bordering_U_D_L_R,	// 'enclosed' shape, all 4 sides are adjacent to other tile types.
+	AT_Bordering_UNUSED,
+
+	AT_COUNT,
+};
+
+// arr[I] represents a full tile
+// arr[I][J] represents a component of that tile, as {column, row} of 16x16 components in the source
+export inline constexpr std::array AUTOTILE_SHAPE_INFO
+{
+	std::array{ std::array{2, 4}, std::array{3, 4}, std::array{2, 5}, std::array{3, 5}, },	// AT_Bordering_None,
+	std::array{ std::array{4, 0}, std::array{3, 4}, std::array{2, 5}, std::array{3, 5}, },	// AT_Bordering_UL,
+	std::array{ std::array{2, 4}, std::array{5, 0}, std::array{2, 5}, std::array{3, 5}, },	// AT_Bordering_UR,
+	std::array{ std::array{4, 0}, std::array{5, 0}, std::array{2, 5}, std::array{3, 5}, },	// AT_Bordering_UL_UR,
+	std::array{ std::array{2, 4}, std::array{3, 4}, std::array{2, 5}, std::array{5, 1}, },	// AT_Bordering_DR,
+	std::array{ std::array{4, 0}, std::array{3, 4}, std::array{2, 5}, std::array{5, 1}, },	// AT_Bordering_UL_DR,
+	std::array{ std::array{2, 4}, std::array{5, 0}, std::array{2, 5}, std::array{5, 1}, },	// AT_Bordering_UR_DR,
+	std::array{ std::array{4, 0}, std::array{5, 0}, std::array{2, 5}, std::array{5, 1}, },	// AT_Bordering_UL_UR_DR,
+
+	std::array{ std::array{2, 4}, std::array{3, 4}, std::array{4, 1}, std::array{3, 5}, },	// AT_Bordering_DL,
+	std::array{ std::array{4, 0}, std::array{3, 4}, std::array{4, 1}, std::array{3, 5}, },	// AT_Bordering_UL_DL,
+	std::array{ std::array{2, 4}, std::array{5, 0}, std::array{4, 1}, std::array{3, 5}, },	// AT_Bordering_UR_DL,
+	std::array{ std::array{4, 0}, std::array{5, 0}, std::array{4, 1}, std::array{3, 5}, },	// AT_Bordering_UL_UR_DL,
+	std::array{ std::array{2, 4}, std::array{3, 4}, std::array{4, 1}, std::array{5, 1}, },	// AT_Bordering_DL_DR,
+	std::array{ std::array{4, 0}, std::array{3, 4}, std::array{4, 1}, std::array{5, 1}, },	// AT_Bordering_UL_DL_DR,
+	std::array{ std::array{2, 4}, std::array{5, 0}, std::array{4, 1}, std::array{5, 1}, },	// AT_Bordering_UR_DL_DR,
+	std::array{ std::array{4, 0}, std::array{5, 0}, std::array{4, 1}, std::array{5, 1}, },	// AT_Bordering_UL_UR_DL_DR,
+
+	std::array{ std::array{0, 4}, std::array{1, 4}, std::array{0, 5}, std::array{1, 5}, },	// AT_Bordering_L,
+	std::array{ std::array{0, 4}, std::array{5, 0}, std::array{0, 5}, std::array{1, 5}, },	// AT_Bordering_L_UR,
+	std::array{ std::array{0, 4}, std::array{1, 4}, std::array{0, 5}, std::array{5, 1}, },	// AT_Bordering_L_DR,
+	std::array{ std::array{0, 4}, std::array{5, 0}, std::array{0, 5}, std::array{5, 1}, },	// AT_Bordering_L_UR_DR,
+	std::array{ std::array{2, 2}, std::array{3, 2}, std::array{2, 3}, std::array{3, 3}, },	// AT_Bordering_U,
+	std::array{ std::array{2, 2}, std::array{3, 2}, std::array{2, 3}, std::array{5, 1}, },	// AT_Bordering_U_DR,
+	std::array{ std::array{2, 2}, std::array{3, 2}, std::array{4, 1}, std::array{3, 3}, },	// AT_Bordering_U_DL,
+	std::array{ std::array{2, 2}, std::array{3, 2}, std::array{4, 1}, std::array{5, 1}, },	// AT_Bordering_U_DR_DL,
+
+	std::array{ std::array{4, 4}, std::array{5, 4}, std::array{4, 5}, std::array{5, 5}, },	// AT_Bordering_R,
+	std::array{ std::array{4, 4}, std::array{5, 4}, std::array{4, 1}, std::array{5, 5}, },	// AT_Bordering_R_DL,
+	std::array{ std::array{4, 0}, std::array{5, 4}, std::array{4, 5}, std::array{5, 5}, },	// AT_Bordering_R_UL,
+	std::array{ std::array{4, 0}, std::array{5, 4}, std::array{4, 1}, std::array{5, 5}, },	// AT_Bordering_R_UL_DL,
+	std::array{ std::array{2, 6}, std::array{3, 6}, std::array{2, 7}, std::array{3, 7}, },	// AT_Bordering_D,
+	std::array{ std::array{4, 0}, std::array{3, 6}, std::array{2, 7}, std::array{3, 7}, },	// AT_Bordering_D_UL,
+	std::array{ std::array{2, 6}, std::array{5, 0}, std::array{2, 7}, std::array{3, 7}, },	// AT_Bordering_D_UR,
+	std::array{ std::array{4, 0}, std::array{5, 0}, std::array{2, 7}, std::array{3, 7}, },	// AT_Bordering_D_UL_DR,
+
+	std::array{ std::array{0, 4}, std::array{5, 4}, std::array{0, 5}, std::array{5, 5}, },	// AT_Bordering_L_R,
+	std::array{ std::array{2, 2}, std::array{3, 2}, std::array{2, 7}, std::array{3, 7}, },	// AT_Bordering_U_D,
+	std::array{ std::array{0, 2}, std::array{1, 2}, std::array{0, 3}, std::array{1, 3}, },	// AT_Bordering_U_L,
+	std::array{ std::array{0, 2}, std::array{1, 2}, std::array{0, 3}, std::array{5, 1}, },	// AT_Bordering_U_L_DR,
+	std::array{ std::array{4, 2}, std::array{5, 2}, std::array{4, 3}, std::array{5, 3}, },	// AT_Bordering_U_R,
+	std::array{ std::array{4, 2}, std::array{5, 2}, std::array{4, 1}, std::array{5, 3}, },	// AT_Bordering_U_R_DL,
+	std::array{ std::array{4, 6}, std::array{5, 6}, std::array{4, 7}, std::array{5, 7}, },	// AT_Bordering_D_R,
+	std::array{ std::array{4, 0}, std::array{5, 6}, std::array{4, 7}, std::array{5, 7}, },	// AT_Bordering_D_R_UL,
+
+	std::array{ std::array{0, 6}, std::array{1, 6}, std::array{0, 7}, std::array{1, 7}, },	// AT_Bordering_D_L,
+	std::array{ std::array{0, 6}, std::array{5, 0}, std::array{0, 7}, std::array{1, 7}, },	// AT_Bordering_D_L_UR,
+	std::array{ std::array{0, 2}, std::array{5, 2}, std::array{0, 3}, std::array{5, 3}, },	// AT_Bordering_U_L_R,
+	std::array{ std::array{0, 2}, std::array{1, 2}, std::array{0, 7}, std::array{1, 7}, },	// AT_Bordering_U_D_L,
+	std::array{ std::array{0, 6}, std::array{5, 6}, std::array{0, 7}, std::array{5, 7}, },	// AT_Bordering_D_L_R,
+	std::array{ std::array{4, 2}, std::array{5, 2}, std::array{4, 7}, std::array{5, 7}, },	// AT_Bordering_U_D_R,
+	std::array{ std::array{0, 2}, std::array{5, 2}, std::array{0, 7}, std::array{5, 7}, },	// AT_Bordering_U_D_L_R,
+	std::array{ std::array{0, 0}, std::array{1, 0}, std::array{0, 1}, std::array{1, 1}, },	// AT_Bordering_UNUSED,
+};
+
+export inline constexpr auto AUTOTILE_SOURCE_WIDTH = 96;	// One frame of the source, animated autotiles have them side by side.
+export inline constexpr auto AUTOTILE_SOURCE_HEIGHT = 128;
+export inline constexpr auto AUTOTILE_SHEET_COLUMNS = 8;
+export inline constexpr auto AUTOTILE_SHEET_ROWS = 6;
+export inline constexpr auto AUTOTILE_SHEET_WIDTH = AUTOTILE_SHEET_COLUMNS * 32;
+export inline constexpr auto AUTOTILE_SHEET_HEIGHT = AUTOTILE_SHEET_ROWS * 32;
+
+inline constexpr auto COMPONENT_SIZE = 16;
+
+static_assert(AUTOTILE_SHAPE_INFO.size() == AUTOTILE_SHEET_COLUMNS * AUTOTILE_SHEET_ROWS);
+
+// 16 rows of 64 bytes, the rows of both sides are pitch bytes apart.
+inline void CopyComponent(std::uint8_t const* pSource, std::size_t iSourcePitch, std::uint8_t* pDest, std::size_t iDestPitch) noexcept
+{
+	for (int y = 0; y < COMPONENT_SIZE; ++y, pSource += iSourcePitch, pDest += iDestPitch)
+	{
+#ifdef HYDROGENIUM_SSE2
+		auto const r0 = _mm_loadu_si128((__m128i const*)(pSource + 0));
+		auto const r1 = _mm_loadu_si128((__m128i const*)(pSource + 16));
+		auto const r2 = _mm_loadu_si128((__m128i const*)(pSource + 32));
+		auto const r3 = _mm_loadu_si128((__m128i const*)(pSource + 48));
+
+		_mm_storeu_si128((__m128i*)(pDest + 0), r0);
+		_mm_storeu_si128((__m128i*)(pDest + 16), r1);
+		_mm_storeu_si128((__m128i*)(pDest + 32), r2);
+		_mm_storeu_si128((__m128i*)(pDest + 48), r3);
+#else
+		std::memcpy(pDest, pSource, COMPONENT_SIZE * 4);
+#endif
+	}
+}
+
+// The sheets of all frames stacked top to bottom: 256 wide, 192 tall per frame, row 0 is the top of frame 0.
+// Shape i of a frame is tile (i % 8, i / 8) of its sheet. The source must be RGBA8 and not flipped.
+export [[nodiscard]] auto ExpandAutotile(CDecodedImage const& Source) noexcept -> std::expected<CDecodedImage, std::string_view>
+{
+	CTraceZone Zone{ "ExpandAutotile", ELogCategory::Resource, Source.m_Path };
+
+	if (!Source.Data() || Source.m_Width <= 0 || Source.m_Width % AUTOTILE_SOURCE_WIDTH != 0 || Source.m_Height != AUTOTILE_SOURCE_HEIGHT) [[unlikely]]
+		return std::unexpected("Not an autotile: width must be a multiple of 96, height exactly 128");
+
+	auto const iFrames = Source.m_Width / AUTOTILE_SOURCE_WIDTH;
+	auto const iSourcePitch = (std::size_t)Source.m_Width * 4;
+	auto const iSheetPitch = (std::size_t)AUTOTILE_SHEET_WIDTH * 4;
+
+	// Derived pixels are owned through m_pMapping, like a disk cache view.
+	auto pPixels = std::make_shared_for_overwrite<std::uint8_t[]>(iSheetPitch * AUTOTILE_SHEET_HEIGHT * iFrames);
+
+	// Serial: the whole sheet is a few hundred KiB of copies, less than dispatching it. Autotiles expand in parallel
+	// with each other instead, see CAutotileImage::Stream().
+	for (int iFrame = 0; iFrame < iFrames; ++iFrame)
+	{
+		for (auto&& [iShape, Shape] : std::views::enumerate(AUTOTILE_SHAPE_INFO))
+		{
+			auto const iTileX = (int)(iShape % AUTOTILE_SHEET_COLUMNS);
+			auto const iTileY = iFrame * AUTOTILE_SHEET_ROWS + (int)(iShape / AUTOTILE_SHEET_COLUMNS);
+
+			for (auto&& [iComp, CompUV] : std::views::enumerate(Shape))
+			{
+				auto const xSource = iFrame * AUTOTILE_SOURCE_WIDTH + CompUV[0] * COMPONENT_SIZE;
+				auto const ySource = CompUV[1] * COMPONENT_SIZE;
+				auto const xDest = iTileX * 32 + (int)(iComp % 2) * COMPONENT_SIZE;
+				auto const yDest = iTileY * 32 + (int)(iComp / 2) * COMPONENT_SIZE;
+
+				CopyComponent(
+					Source.Data() + ySource * iSourcePitch + (std::size_t)xSource * 4, iSourcePitch,
+					pPixels.get() + yDest * iSheetPitch + (std::size_t)xDest * 4, iSheetPitch
+				);
+			}
+		}
+	}
+
+	CDecodedImage ret{
+		.m_Path = Source.m_Path,
+		.m_pMappedPixels = pPixels.get(),
+		.m_Width = AUTOTILE_SHEET_WIDTH,
+		.m_Height = AUTOTILE_SHEET_HEIGHT * iFrames,
+	};
+	ret.m_pMapping = std::move(pPixels);
+
+	return ret;
+}
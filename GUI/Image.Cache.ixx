@@ -0,0 +1,289 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module Image.Cache;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+import UtlLog;
+import UtlMemory;
+import UtlTrace;
+import GL.UploadRing;
+import Image.Decode;
+
+// Images are only known by their file header until something asks for them. The first Get() reads, decodes and uploads,
+// the GPU bytes it took are measured by the UtlMemory counters. Past the budget, the least recently used images are dropped
+// and load again on their next Get().
+// GL thread only. An image used during the current frame is never evicted, so a pointer from Get() stays valid until the
+// next TextureCacheNewFrame(), even if the frame alone goes past the budget.
+// Textures built from images, like the tile atlas, derive from CCachedImage as well and share the budget. They leave the
+// cache with the image they are built from.
+
+export struct CTextureCacheStat final
+{
+	std::int64_t m_Budget{};
+	std::int64_t m_Bytes{};	// Resident, GPU
+	std::size_t m_Resident{};
+	std::uint64_t m_Loads{};	// Since startup, reloads after an eviction included.
+	std::uint64_t m_Evictions{};
+};
+
+export struct CCachedImage;
+
+struct CTextureCache final
+{
+	std::int64_t m_Budget{ 256ll << 20 };
+	std::int64_t m_Bytes{};
+	std::uint64_t m_Frame{ 1 };
+	std::vector<CCachedImage const*> m_Resident{};
+	std::uint64_t m_Loads{};
+	std::uint64_t m_Evictions{};
+};
+
+CTextureCache g_TextureCache{};
+
+void TrimTextureCache() noexcept;
+
+// Bookkeeping shared by every TLazyImage<T>, the cache only sees this part.
+export struct CCachedImage
+{
+	mutable std::int64_t m_Bytes{};
+	mutable std::uint64_t m_LastUsedFrame{};
+	CCachedImage const* m_pBuiltFrom{};	// Only compared, never dereferenced.
+
+	virtual void Evict() const noexcept = 0;
+
+protected:
+	CCachedImage() noexcept = default;
+	CCachedImage(CCachedImage const&) noexcept = delete;
+	CCachedImage& operator=(CCachedImage const&) noexcept = delete;
+
+	// The derived class has already dropped its image.
+	~CCachedImage() noexcept
+	{
+		OnUnloaded();
+	}
+
+	void Touch() const noexcept
+	{
+		m_LastUsedFrame = g_TextureCache.m_Frame;
+	}
+
+	void OnLoaded(std::int64_t iBytes) const noexcept
+	{
+		m_Bytes = iBytes;
+
+		g_TextureCache.m_Bytes += iBytes;
+		g_TextureCache.m_Resident.push_back(this);
+		++g_TextureCache.m_Loads;
+
+		TrimTextureCache();
+	}
+
+	// Leaves the cache without counting an eviction, e.g. before building again.
+	void OnUnloaded() const noexcept
+	{
+		if (std::erase(g_TextureCache.m_Resident, this))
+			g_TextureCache.m_Bytes -= m_Bytes;
+
+		m_Bytes = 0;
+	}
+};
+
+// Drop the oldest images until the budget fits. Images of this frame stay.
+void TrimTextureCache() noexcept
+{
+	auto& Cache = g_TextureCache;
+
+	while (Cache.m_Bytes > Cache.m_Budget)
+	{
+		auto const it = std::ranges::min_element(Cache.m_Resident, {}, &CCachedImage::m_LastUsedFrame);
+
+		if (it == Cache.m_Resident.end() || (*it)->m_LastUsedFrame >= Cache.m_Frame)
+			break;
+
+		auto const pImage = *it;
+		Cache.m_Resident.erase(it);
+		Cache.m_Bytes -= pImage->m_Bytes;
+		++Cache.m_Evictions;
+
+		pImage->Evict();
+		pImage->m_Bytes = 0;
+
+		// Would be built again from a reloaded image anyway.
+		std::erase_if(Cache.m_Resident,
+			[&](CCachedImage const* pBuilt) noexcept
+			{
+				if (pBuilt->m_pBuiltFrom != pImage || pBuilt->m_LastUsedFrame >= Cache.m_Frame)
+					return false;
+
+				Cache.m_Bytes -= pBuilt->m_Bytes;
+				++Cache.m_Evictions;
+
+				pBuilt->Evict();
+				pBuilt->m_Bytes = 0;
+				return true;
+			}
+		);
+	}
+}
+
+// T is CTilesetImage, CAutotileImage or CAnimatedTileImage: a static Upload(CEncodedImage const&) on the GL thread,
+// and a constructor from its result and the file path. A T with a static Stream(path, fnDone) can also load through the
+// upload ring with Request(), the frame goes on meanwhile. fnDone is given the same result as Upload() returns.
+// Lives in a node based container, the cache holds its address.
+export template <typename T>
+struct TLazyImage final : CCachedImage
+{
+	std::filesystem::path m_Path{};
+	int m_Width{};	// From the file header, known without loading.
+	int m_Height{};
+
+	TLazyImage(std::filesystem::path Path, int iWidth, int iHeight) noexcept
+		: m_Path{ std::move(Path) }, m_Width{ iWidth }, m_Height{ iHeight } {}
+
+	TLazyImage(TLazyImage const&) noexcept = delete;
+	TLazyImage(TLazyImage&&) noexcept = delete;
+	TLazyImage& operator=(TLazyImage const&) noexcept = delete;
+	TLazyImage& operator=(TLazyImage&&) noexcept = delete;
+	~TLazyImage() noexcept { m_Image.reset(); }
+
+	// Loads on the first call, and on the first call after an eviction. nullptr if the file cannot be loaded, reported once.
+	// Also nullptr while a Request() is in flight, the upload ring delivers it in the Pump() of a later frame.
+	[[nodiscard]] auto Get() const noexcept -> T const*
+	{
+		Touch();
+
+		if (m_Image) [[likely]]
+			return std::addressof(*m_Image);
+
+		if (m_pStreaming || m_bFailed)
+			return nullptr;
+
+		return Load();
+	}
+
+	// Non-blocking Get(), true once the image is resident or has failed. Loads synchronously when T cannot stream.
+	auto Request() const noexcept -> bool
+	{
+		Touch();
+
+		if (m_Image || m_bFailed)
+			return true;
+
+		if constexpr (requires { &T::Stream; })
+		{
+			if (!m_pStreaming)
+			{
+				m_pStreaming = std::make_shared<TLazyImage const*>(this);
+
+				// Finishes in the Pump() of a later frame. If this handle is gone by then, the texture goes with a temporary T.
+				T::Stream(m_Path,
+					[pWeak = std::weak_ptr{ m_pStreaming }, Path = m_Path](auto const& Result) noexcept
+					{
+						if (auto const pStreaming = pWeak.lock())
+							(*pStreaming)->OnStreamed(Result);
+						else if (Result)
+							T{ Result, Path };
+					}
+				);
+			}
+
+			return false;
+		}
+		else
+		{
+			std::ignore = Load();
+			return true;
+		}
+	}
+
+	[[nodiscard]] auto IsResident() const noexcept -> bool { return m_Image.has_value(); }
+	[[nodiscard]] auto HasFailed() const noexcept -> bool { return m_bFailed; }
+
+	void Evict() const noexcept override { m_Image.reset(); }
+
+private:
+	mutable std::optional<T> m_Image{};
+	mutable bool m_bFailed{};
+	mutable std::shared_ptr<TLazyImage const*> m_pStreaming{};	// Set while a Request() is in flight, the callback holds a weak_ptr.
+
+	// Whatever an image allocates besides its texture counts as well.
+	[[nodiscard]] static auto GpuBytes() noexcept -> std::int64_t
+	{
+		return UTIL_GpuMemoryStat(EGpuMemory::Textures).m_Live + UTIL_GpuMemoryStat(EGpuMemory::Buffers).m_Live;
+	}
+
+	template <typename Result_t>
+	void OnStreamed(Result_t const& Result) const noexcept
+	{
+		m_pStreaming.reset();
+
+		if (!Result) [[unlikely]]
+		{
+			UTIL_LogWarning(ELogCategory::Resource, "Cannot load '{}': {}", m_Path.filename().u8string(), Result.error());
+			m_bFailed = true;
+			return;
+		}
+
+		// The texture was allocated in the Pump(), before this measure could start.
+		auto const iBefore = GpuBytes();
+		m_Image.emplace(Result, m_Path);
+		OnLoaded(UTIL_GpuMemoryOf(EGpuMemory::Textures, std::get<0>(*Result)) + GpuBytes() - iBefore);
+	}
+
+	auto Load() const noexcept -> T const*
+	{
+		CTraceZone Zone{ "Load image", ELogCategory::Resource, m_Path };
+
+		auto const iBefore = GpuBytes();
+		auto const Uploaded = ReadImageFile(m_Path)
+			.and_then([](CEncodedImage const& Encoded) static noexcept { return T::Upload(Encoded); });
+
+		if (!Uploaded) [[unlikely]]
+		{
+			UTIL_LogWarning(ELogCategory::Resource, "Cannot load '{}': {}", m_Path.filename().u8string(), Uploaded.error());
+			m_bFailed = true;
+			return nullptr;
+		}
+
+		m_Image.emplace(*Uploaded, m_Path);
+		OnLoaded(GpuBytes() - iBefore);
+
+		return std::addressof(*m_Image);
+	}
+};
+
+namespace PokemonEssentials::Resources
+{
+	// Call once per frame, before any Get(). Images unused since the previous frame become evictable.
+	export void TextureCacheNewFrame() noexcept
+	{
+		++g_TextureCache.m_Frame;
+		TrimTextureCache();
+	}
+
+	export void SetTextureBudget(std::int64_t iBytes) noexcept
+	{
+		g_TextureCache.m_Budget = std::max<std::int64_t>(iBytes, 0);
+		TrimTextureCache();
+	}
+
+	export [[nodiscard]] auto TextureCacheStat() noexcept -> CTextureCacheStat
+	{
+		return {
+			.m_Budget = g_TextureCache.m_Budget,
+			.m_Bytes = g_TextureCache.m_Bytes,
+			.m_Resident = g_TextureCache.m_Resident.size(),
+			.m_Loads = g_TextureCache.m_Loads,
+			.m_Evictions = g_TextureCache.m_Evictions,
+		};
+	}
+}
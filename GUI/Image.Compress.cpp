@@ -0,0 +1,217 @@
+#include "stb_dxt.h"
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import UtlLog;
+import UtlTrace;
+import Image.Decode;
+
+static constinit std::atomic<bool> s_bCompressionEnabled{ false };
+
+void SetTextureCompressionEnabled(bool bEnabled) noexcept
+{
+	s_bCompressionEnabled.store(bEnabled, std::memory_order_relaxed);
+}
+
+auto IsTextureCompressionEnabled() noexcept -> bool
+{
+	return s_bCompressionEnabled.load(std::memory_order_relaxed);
+}
+
+using Block_t = std::array<std::uint8_t, 4 * 4 * 4>;	// 4x4 RGBA8, row-major
+
+// Pixels past the image are transparent, same as the padding of UploadTextureArray().
+[[nodiscard]] static auto GatherBlock(CDecodedImage const& Image, int x, int y) noexcept -> Block_t
+{
+	Block_t ret{};
+
+	for (int dy = 0; dy < 4 && y + dy < Image.m_Height; ++dy)
+	{
+		auto const iCount = std::min(4, Image.m_Width - x);
+		std::memcpy(&ret[dy * 16], Image.Data() + ((std::size_t)(y + dy) * Image.m_Width + x) * 4, (std::size_t)iCount * 4);
+	}
+
+	return ret;
+}
+
+// The decoders only serve the PSNR, the GPU does the real decoding.
+static void DecodeColorBlock(std::uint8_t const* pBlock, bool bFourColorsOnly, Block_t& Out) noexcept
+{
+	auto const c0 = (std::uint16_t)(pBlock[0] | pBlock[1] << 8);
+	auto const c1 = (std::uint16_t)(pBlock[2] | pBlock[3] << 8);
+
+	static constexpr auto fnExpand = [](std::uint16_t c) static noexcept -> std::array<int, 3>
+	{
+		auto const r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+		return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+	};
+
+	auto const rgc0 = fnExpand(c0), rgc1 = fnExpand(c1);
+	std::array<std::array<int, 4>, 4> rgPalette{};
+
+	for (int i = 0; i < 3; ++i)
+	{
+		rgPalette[0][i] = rgc0[i];
+		rgPalette[1][i] = rgc1[i];
+
+		if (bFourColorsOnly || c0 > c1)
+		{
+			rgPalette[2][i] = (2 * rgc0[i] + rgc1[i]) / 3;
+			rgPalette[3][i] = (rgc0[i] + 2 * rgc1[i]) / 3;
+		}
+		else
+		{
+			rgPalette[2][i] = (rgc0[i] + rgc1[i]) / 2;
+			rgPalette[3][i] = 0;
+		}
+	}
+
+	rgPalette[0][3] = rgPalette[1][3] = rgPalette[2][3] = 255;
+	rgPalette[3][3] = (bFourColorsOnly || c0 > c1) ? 255 : 0;
+
+	auto const iIndices = (std::uint32_t)(pBlock[4] | pBlock[5] << 8 | pBlock[6] << 16 | (std::uint32_t)pBlock[7] << 24);
+
+	for (int i = 0; i < 16; ++i)
+	{
+		auto const& Color = rgPalette[(iIndices >> (i * 2)) & 3];
+		for (int c = 0; c < 4; ++c)
+			Out[i * 4 + c] = (std::uint8_t)Color[c];
+	}
+}
+
+static void DecodeAlphaBlock(std::uint8_t const* pBlock, Block_t& Out) noexcept
+{
+	int const a0 = pBlock[0], a1 = pBlock[1];
+	std::array<int, 8> rgAlpha{ a0, a1 };
+
+	if (a0 > a1)
+	{
+		for (int i = 1; i < 7; ++i)
+			rgAlpha[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+	}
+	else
+	{
+		for (int i = 1; i < 5; ++i)
+			rgAlpha[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+
+		rgAlpha[6] = 0;
+		rgAlpha[7] = 255;
+	}
+
+	std::uint64_t iIndices{};
+	for (int i = 0; i < 6; ++i)
+		iIndices |= (std::uint64_t)pBlock[2 + i] << (i * 8);
+
+	for (int i = 0; i < 16; ++i)
+		Out[i * 4 + 3] = (std::uint8_t)rgAlpha[(iIndices >> (i * 3)) & 7];
+}
+
+[[nodiscard]] static auto BlockSquaredError(CDecodedImage const& Image, int x, int y, Block_t const& Source, std::uint8_t const* pEncoded, ECompressedFormat Format) noexcept -> double
+{
+	Block_t Decoded{};
+
+	if (Format == ECompressedFormat::BC1)
+		DecodeColorBlock(pEncoded, false, Decoded);
+	else
+	{
+		DecodeColorBlock(pEncoded + 8, true, Decoded);
+		DecodeAlphaBlock(pEncoded, Decoded);
+	}
+
+	double flError{};
+
+	// Padding pixels are not part of the image, they do not count.
+	for (int dy = 0; dy < 4 && y + dy < Image.m_Height; ++dy)
+	{
+		for (int dx = 0; dx < 4 && x + dx < Image.m_Width; ++dx)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				auto const iDiff = (int)Source[(dy * 4 + dx) * 4 + c] - (int)Decoded[(dy * 4 + dx) * 4 + c];
+				flError += iDiff * iDiff;
+			}
+		}
+	}
+
+	return flError;
+}
+
+auto CompressTextureArray(CDecodedImage const& Image, int target_height) noexcept -> std::expected<CCompressedImage, std::string_view>
+{
+	CTraceZone Zone{ "CompressTextureArray", ELogCategory::Resource, Image.m_Path };
+
+	if (Image.m_Width <= 0 || Image.m_Height <= 0 || !Image.Data())
+		return std::unexpected("No pixels to compress");
+	if (target_height <= 0 || target_height % 4 != 0)
+		return std::unexpected("Layer height is not a multiple of 4");
+
+	auto const Start = std::chrono::steady_clock::now();
+
+	auto const pPixels = Image.Data();
+	auto const iPixels = (std::size_t)Image.m_Width * Image.m_Height;
+
+	// stb_dxt has no punch-through alpha, BC1 is only good for opaque images. Tilesets mostly are not.
+	bool bOpaque = true;
+	for (std::size_t i = 0; i < iPixels && bOpaque; ++i)
+		bOpaque = pPixels[i * 4 + 3] == 255;
+
+	CCompressedImage ret{
+		.m_Path = Image.m_Path,
+		.m_Format = bOpaque ? ECompressedFormat::BC1 : ECompressedFormat::BC3,
+		.m_Width = Image.m_Width,
+		.m_Height = Image.m_Height,
+		.m_LayerHeight = target_height,
+		.m_Layers = (Image.m_Height + target_height - 1) / target_height,
+	};
+
+	auto const iBlockBytes = (std::size_t)ret.BlockBytes();
+	auto const iBlocksX = (Image.m_Width + 3) / 4;
+	auto const iBlockRows = ret.m_Layers * (target_height / 4);	// Layers are cut on a block boundary, block row i is pixel row i * 4.
+	auto const iRowBytes = (std::size_t)iBlocksX * iBlockBytes;
+
+	ret.m_Bytes = iRowBytes * iBlockRows;
+	ret.m_Blocks.resize(ret.m_Bytes);
+
+	std::vector<int> rgiRows(iBlockRows);
+	std::iota(rgiRows.begin(), rgiRows.end(), 0);
+
+	std::vector<double> rgflRowErrors(iBlockRows);
+
+	std::for_each(std::execution::par, rgiRows.begin(), rgiRows.end(),
+		[&](int iRow) noexcept
+		{
+			auto const y = iRow * 4;
+			auto pOut = ret.m_Blocks.data() + iRowBytes * iRow;
+
+			for (int iBlockX = 0; iBlockX < iBlocksX; ++iBlockX, pOut += iBlockBytes)
+			{
+				auto Source = GatherBlock(Image, iBlockX * 4, y);
+
+				// BC1 wants a constant alpha, even on the padding.
+				if (bOpaque)
+				{
+					for (int i = 0; i < 16; ++i)
+						Source[i * 4 + 3] = 255;
+				}
+
+				stb_compress_dxt_block(pOut, Source.data(), bOpaque ? 0 : 1, STB_DXT_HIGHQUAL);
+
+				if (y < Image.m_Height)
+					rgflRowErrors[iRow] += BlockSquaredError(Image, iBlockX * 4, y, Source, pOut, ret.m_Format);
+			}
+		}
+	);
+
+	auto const flMse = std::reduce(rgflRowErrors.begin(), rgflRowErrors.end()) / ((double)iPixels * 4.0);
+
+	ret.m_flPsnr = flMse > 0 ? (float)(10.0 * std::log10(255.0 * 255.0 / flMse)) : std::numeric_limits<float>::infinity();
+	ret.m_flEncodeMilliseconds = std::chrono::duration<float, std::milli>{ std::chrono::steady_clock::now() - Start }.count();
+
+	return ret;
+}
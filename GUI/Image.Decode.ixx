@@ -0,0 +1,134 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module Image.Decode;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+// CPU half of the texture loading, free of GL calls and safe on any thread. Implemented in Image.cpp.
+// A file is read once, the header is sniffed from the same bytes that are later decoded.
+
+export struct CEncodedImage final
+{
+	std::filesystem::path m_Path{};
+	std::vector<std::uint8_t> m_Bytes{};
+	int m_Width{};	// From the header, before decoding.
+	int m_Height{};
+};
+
+extern "C++" void FreeDecodedPixels(std::uint8_t* p) noexcept;	// stbi_image_free
+
+export struct CDecodedPixelsDeleter final
+{
+	void operator()(std::uint8_t* p) const noexcept { FreeDecodedPixels(p); }
+};
+
+// Always RGBA8. The pixels are either decoded by stb_image, or a read-only view into a mapped disk cache blob or a
+// derived image such as an expanded autotile.
+export struct CDecodedImage final
+{
+	std::filesystem::path m_Path{};
+	std::unique_ptr<std::uint8_t[], CDecodedPixelsDeleter> m_Pixels{};
+	std::shared_ptr<void const> m_pMapping{};	// Keeps the view below alive.
+	std::uint8_t const* m_pMappedPixels{};
+	int m_Width{};
+	int m_Height{};
+
+	[[nodiscard]] auto Data() const noexcept -> std::uint8_t const* { return m_Pixels ? m_Pixels.get() : m_pMappedPixels; }
+};
+
+export enum struct ECompressedFormat : std::uint8_t { BC1, BC3, };
+
+// A texture array as 4x4 blocks, layer after layer, each layer cut every m_LayerHeight rows of the source image.
+// BC1 for fully opaque images, BC3 as soon as one pixel is not. Owned, or a view into a mapped disk cache blob like above.
+export struct CCompressedImage final
+{
+	std::filesystem::path m_Path{};
+	std::vector<std::uint8_t> m_Blocks{};
+	std::shared_ptr<void const> m_pMapping{};
+	std::uint8_t const* m_pMappedBlocks{};
+	std::size_t m_Bytes{};	// All layers
+	ECompressedFormat m_Format{};
+	int m_Width{};	// Of the source image
+	int m_Height{};
+	int m_LayerHeight{};
+	int m_Layers{};
+
+	// Filled by the encoder, kept in the disk cache blob.
+	float m_flPsnr{};	// dB, over the RGBA channels of the source pixels. Infinite for a lossless result.
+	float m_flEncodeMilliseconds{};
+
+	[[nodiscard]] auto Data() const noexcept -> std::uint8_t const* { return m_pMappedBlocks ? m_pMappedBlocks : m_Blocks.data(); }
+	[[nodiscard]] auto BlockBytes() const noexcept -> int { return m_Format == ECompressedFormat::BC1 ? 8 : 16; }
+	[[nodiscard]] auto LayerBytes() const noexcept -> std::size_t { return m_Bytes / (std::size_t)std::max(m_Layers, 1); }
+};
+
+export struct CImageDiskCacheStat final
+{
+	std::uint64_t m_Hits{};
+	std::uint64_t m_Misses{};	// Decoded, then written.
+	double m_HitMilliseconds{};	// Hash and map, summed
+	double m_MissMilliseconds{};	// Hash, decode and write, summed
+	std::uint64_t m_StaleRemoved{};	// Blobs deleted on lookup: older version, foreign or truncated.
+};
+
+export extern "C++" [[nodiscard]] auto ReadImageFile(std::filesystem::path const& Path) noexcept -> std::expected<CEncodedImage, std::string_view>;
+
+// Size only, m_Bytes is left empty. Reads the first few KiB instead of the whole file.
+export extern "C++" [[nodiscard]] auto ReadImageHeader(std::filesystem::path const& Path) noexcept -> std::expected<CEncodedImage, std::string_view>;
+
+// The flip setting is per thread, concurrent decodes do not interfere.
+export extern "C++" [[nodiscard]] auto DecodeImage(CEncodedImage const& Encoded, bool bFlipY) noexcept -> std::expected<CDecodedImage, std::string_view>;
+
+// DecodeImage() through the disk cache of decoded RGBA, keyed by a hash of the encoded bytes. Implemented in Image.DiskCache.cpp.
+// A hit maps the blob and skips stb_image, a miss decodes and stores a blob for the next launch. Any thread.
+export extern "C++" [[nodiscard]] auto DecodeImageCached(CEncodedImage const& Encoded, bool bFlipY) noexcept -> std::expected<CDecodedImage, std::string_view>;
+
+// Encodes on the parallel algorithms, then measures the PSNR against the source. Implemented in Image.Compress.cpp.
+// target_height must be a multiple of 4.
+export extern "C++" [[nodiscard]] auto CompressTextureArray(CDecodedImage const& Image, int target_height) noexcept -> std::expected<CCompressedImage, std::string_view>;
+
+// Same as above through the disk cache, a hit skips both the PNG decode and the encode.
+export extern "C++" [[nodiscard]] auto CompressTextureArrayCached(CEncodedImage const& Encoded, int target_height, bool bFlipY) noexcept -> std::expected<CCompressedImage, std::string_view>;
+
+export extern "C++" void SetTextureCompressionEnabled(bool bEnabled) noexcept;	// Tilesets only, off by default. Applies to the next load.
+export extern "C++" [[nodiscard]] auto IsTextureCompressionEnabled() noexcept -> bool;
+
+export extern "C++" void SetImageDiskCacheEnabled(bool bEnabled) noexcept;	// Off: always decode, for comparing with a cold start.
+export extern "C++" [[nodiscard]] auto IsImageDiskCacheEnabled() noexcept -> bool;
+export extern "C++" [[nodiscard]] auto ImageDiskCacheStat() noexcept -> CImageDiskCacheStat;
+export extern "C++" void LogImageDiskCacheStat() noexcept;	// Hits against misses, i.e. a warm start against a cold one. Silent if unused.
+
+// GL thread only. Same results as LoadTextureArrayFromFile() and LoadTextureFromFile().
+export extern "C++" [[nodiscard]] auto UploadTextureArray(CDecodedImage const& Image, int target_height) noexcept -> std::expected<std::tuple<std::uint32_t, int, int, int>, std::string_view>;
+export extern "C++" [[nodiscard]] auto UploadTexture(CDecodedImage const& Image) noexcept -> std::expected<std::tuple<std::uint32_t, int, int>, std::string_view>;
+
+// GL thread only. Same result as UploadTextureArray(), fails without EXT_texture_compression_s3tc.
+export extern "C++" [[nodiscard]] auto UploadCompressedTextureArray(CCompressedImage const& Image) noexcept -> std::expected<std::tuple<std::uint32_t, int, int, int>, std::string_view>;
+
+// GL thread only. BC1/BC3 when IsTextureCompressionEnabled() and the driver takes it, logging a size/quality/speed report.
+// RGBA through DecodeImageCached() otherwise.
+export extern "C++" [[nodiscard]] auto UploadEncodedTextureArray(CEncodedImage const& Encoded, int target_height, bool bFlipY) noexcept -> std::expected<std::tuple<std::uint32_t, int, int, int>, std::string_view>;
+
+// Runs on the GL thread, from the Pump() of the upload ring.
+export using fnTextureArrayDone_t = std::move_only_function<void(std::expected<std::tuple<std::uint32_t, int, int, int>, std::string_view> const&) noexcept>;
+
+// Any thread, after CreateUploadRing(). Same texture as UploadEncodedTextureArray(), but reading, decoding or compressing
+// happen on the pool and the texels are written there into the persistently mapped upload ring: the GL thread only
+// allocates and issues one copy from the buffer. The worker waits while the ring is full. An image larger than the ring,
+// or any image without a ring, is uploaded from client memory on the GL thread instead, a bounded number of bytes at a time. fnDone is dropped uncalled once DestroyUploadRing() started.
+export extern "C++" void StreamTextureArray(std::filesystem::path Path, int target_height, bool bFlipY, fnTextureArrayDone_t fnDone) noexcept;
+
+export using fnTextureDone_t = std::move_only_function<void(std::expected<std::tuple<std::uint32_t, int, int>, std::string_view> const&) noexcept>;
+export using fnPixelTransform_t = auto (*)(CDecodedImage const&) noexcept -> std::expected<CDecodedImage, std::string_view>;
+
+// Any thread, after CreateUploadRing(). Same texture as UploadTexture(), read, decoded and passed through pfnTransform
+// (may be null) on the pool. Several calls run on as many workers.
+export extern "C++" void StreamTexture(std::filesystem::path Path, bool bFlipY, fnPixelTransform_t pfnTransform, fnTextureDone_t fnDone) noexcept;
@@ -0,0 +1,504 @@
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#else
+import std.compat;
+#endif
+
+import UtlLog;
+import UtlMemory;
+import UtlTrace;
+import Image.Decode;
+
+// One blob per image: a 64 bytes header, then the payload exactly as the GL upload wants it, i.e. the RGBA8 rows
+// returned by DecodeImage(), or the BC1/BC3 layers of CompressTextureArray().
+// The payload starts on a 64 bytes boundary of a page aligned view, so the mapped blob is handed to glTex*Image as is.
+// The directory is capped: at the first use of a process, the blobs used least recently go until it fits. NTFS often
+// leaves the last access time alone, so a hit touches the write time of its blob instead and that is what is sorted on.
+
+inline constexpr std::uint32_t BLOB_MAGIC = 0x58544550;	// "PETX" on disk
+inline constexpr std::uint32_t BLOB_VERSION = 3;	// 3: real XXH64 for m_SourceHash.
+inline constexpr std::size_t BLOB_PAYLOAD_OFFSET = 64;
+inline constexpr std::uintmax_t CACHE_BYTES_MAX = 1ull << 30;
+
+enum struct EBlobFormat : std::uint32_t { RGBA8, BC1, BC3, };
+inline constexpr std::uint32_t BLOB_FLAG_FLIP_Y = 1 << 0;
+
+struct CBlobHeader final
+{
+	std::uint32_t m_Magic{ BLOB_MAGIC };
+	std::uint32_t m_Version{ BLOB_VERSION };
+	std::uint64_t m_SourceHash{};
+	std::uint64_t m_SourceSize{};	// The hash is not cryptographic, the size is checked as well.
+	std::int32_t m_Width{};
+	std::int32_t m_Height{};
+	EBlobFormat m_Format{};
+	std::uint32_t m_Flags{};
+	std::uint64_t m_PayloadBytes{};
+	std::int32_t m_LayerHeight{};	// Compressed arrays only, from here.
+	std::int32_t m_Layers{};
+	float m_flPsnr{};
+	float m_flEncodeMilliseconds{};
+};
+
+static_assert(sizeof(CBlobHeader) <= BLOB_PAYLOAD_OFFSET && std::is_trivially_copyable_v<CBlobHeader>);
+
+struct CMappedBlob final
+{
+	std::shared_ptr<void const> m_pMapping{};
+	CBlobHeader m_Header{};
+	std::uint8_t const* m_pPayload{};
+};
+
+static constinit std::atomic<bool> s_bEnabled{ true };
+static constinit std::atomic<std::uint64_t> s_iHits{}, s_iMisses{};
+static constinit std::atomic<std::int64_t> s_iHitNanoseconds{}, s_iMissNanoseconds{};
+static constinit std::atomic<std::uint64_t> s_iStaleRemoved{};
+
+// XXH64 with a seed of 0, written from the reference specification. A few GB/s, far below the cost of inflating the PNG.
+[[nodiscard]] static auto HashBytes(std::span<std::uint8_t const> Bytes) noexcept -> std::uint64_t
+{
+	static constexpr std::uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+	static constexpr std::uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+	static constexpr std::uint64_t PRIME3 = 0x165667B19E3779F9ull;
+	static constexpr std::uint64_t PRIME4 = 0x85EBCA77C2B2AE63ull;
+	static constexpr std::uint64_t PRIME5 = 0x27D4EB2F165667C5ull;
+
+	static constexpr auto fnRound = [](std::uint64_t iAcc, std::uint64_t iInput) static noexcept
+	{
+		return std::rotl(iAcc + iInput * PRIME2, 31) * PRIME1;
+	};
+
+	static constexpr auto fnMerge = [](std::uint64_t iAcc, std::uint64_t iLane) static noexcept
+	{
+		return (iAcc ^ fnRound(0, iLane)) * PRIME1 + PRIME4;
+	};
+
+	// Little endian, like the reference.
+	static constexpr auto fnRead64 = [](std::uint8_t const* p) static noexcept
+	{
+		std::uint64_t i{};
+		std::memcpy(&i, p, sizeof(i));
+		return i;
+	};
+
+	static constexpr auto fnRead32 = [](std::uint8_t const* p) static noexcept
+	{
+		std::uint32_t i{};
+		std::memcpy(&i, p, sizeof(i));
+		return (std::uint64_t)i;
+	};
+
+	auto p = Bytes.data();
+	auto const pEnd = p + Bytes.size();
+
+	std::uint64_t iHash{};
+
+	if (Bytes.size() >= 32)
+	{
+		std::array<std::uint64_t, 4> rgLanes{ PRIME1 + PRIME2, PRIME2, 0, 0 - PRIME1 };
+
+		for (; pEnd - p >= 32; p += 32)
+		{
+			for (std::size_t i = 0; i < rgLanes.size(); ++i)
+				rgLanes[i] = fnRound(rgLanes[i], fnRead64(p + i * 8));
+		}
+
+		iHash = std::rotl(rgLanes[0], 1) + std::rotl(rgLanes[1], 7) + std::rotl(rgLanes[2], 12) + std::rotl(rgLanes[3], 18);
+
+		for (auto&& iLane : rgLanes)
+			iHash = fnMerge(iHash, iLane);
+	}
+	else
+		iHash = PRIME5;
+
+	iHash += Bytes.size();
+
+	for (; pEnd - p >= 8; p += 8)
+		iHash = std::rotl(iHash ^ fnRound(0, fnRead64(p)), 27) * PRIME1 + PRIME4;
+
+	if (pEnd - p >= 4)
+	{
+		iHash = std::rotl(iHash ^ (fnRead32(p) * PRIME1), 23) * PRIME2 + PRIME3;
+		p += 4;
+	}
+
+	for (; p < pEnd; ++p)
+		iHash = std::rotl(iHash ^ (*p * PRIME5), 11) * PRIME1;
+
+	iHash ^= iHash >> 33;
+	iHash *= PRIME2;
+	iHash ^= iHash >> 29;
+	iHash *= PRIME3;
+	iHash ^= iHash >> 32;
+
+	return iHash;
+}
+
+// Oldest write time first, see above. Leftover .tmp files of a crashed store go the same way.
+static void TrimCacheDirectory(std::filesystem::path const& Directory) noexcept
+{
+	CTraceZone Zone{ "TrimCacheDirectory", ELogCategory::Resource };
+
+	struct CBlobFile final
+	{
+		std::filesystem::path m_Path{};
+		std::uintmax_t m_Bytes{};
+		std::filesystem::file_time_type m_LastUsed{};
+	};
+
+	std::vector<CBlobFile> rgFiles{};
+	std::uintmax_t iTotal{};
+	std::error_code ec{};
+
+	for (auto&& Entry : std::filesystem::directory_iterator{ Directory, ec })
+	{
+		if (!Entry.is_regular_file(ec))
+			continue;
+
+		auto& File = rgFiles.emplace_back(Entry.path(), Entry.file_size(ec), Entry.last_write_time(ec));
+		iTotal += File.m_Bytes;
+	}
+
+	if (iTotal <= CACHE_BYTES_MAX)
+	{
+		UTIL_LogInfo(ELogCategory::Resource, "Texture disk cache: {} blobs, {}.", rgFiles.size(), UTIL_MemoryFormatBytes((std::int64_t)iTotal));
+		return;
+	}
+
+	std::ranges::sort(rgFiles, {}, &CBlobFile::m_LastUsed);
+
+	std::size_t iRemoved{};
+	std::uintmax_t iRemovedBytes{};
+
+	for (auto&& File : rgFiles)
+	{
+		if (iTotal - iRemovedBytes <= CACHE_BYTES_MAX)
+			break;
+
+		// A blob mapped by another instance stays, it is retried next time.
+		if (std::filesystem::remove(File.m_Path, ec))
+		{
+			++iRemoved;
+			iRemovedBytes += File.m_Bytes;
+		}
+	}
+
+	UTIL_LogInfo(ELogCategory::Resource, "Texture disk cache: {} blobs, {}. Removed the {} least recently used, {}.",
+		rgFiles.size() - iRemoved, UTIL_MemoryFormatBytes((std::int64_t)(iTotal - iRemovedBytes)),
+		iRemoved, UTIL_MemoryFormatBytes((std::int64_t)iRemovedBytes)
+	);
+}
+
+[[nodiscard]] static auto CacheDirectory() noexcept -> std::filesystem::path const&
+{
+	static std::filesystem::path const Directory = []() static noexcept
+	{
+		std::error_code ec{};
+		auto ret = std::filesystem::temp_directory_path(ec);
+
+		if (!ec)
+		{
+			ret /= LR"(PokemonEssentialTools\TextureCache)";
+			std::filesystem::create_directories(ret, ec);
+		}
+
+		if (ec)
+		{
+			UTIL_LogWarning(ELogCategory::Resource, "Texture disk cache disabled, cannot create '{}': {}", ret.u8string(), ec.message());
+			return std::filesystem::path{};
+		}
+
+		TrimCacheDirectory(ret);
+		return ret;
+	}();
+
+	return Directory;
+}
+
+// The handles are closed right away, the view alone keeps the file mapped until the last CDecodedImage lets go of it.
+[[nodiscard]] static auto MapReadOnly(std::filesystem::path const& Path) noexcept -> std::pair<std::shared_ptr<void const>, std::size_t>
+{
+	auto const hFile = ::CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return {};
+
+	LARGE_INTEGER Size{};
+	if (!::GetFileSizeEx(hFile, &Size) || Size.QuadPart <= 0)
+	{
+		::CloseHandle(hFile);
+		return {};
+	}
+
+	auto const hMapping = ::CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	::CloseHandle(hFile);
+
+	if (!hMapping)
+		return {};
+
+	auto const pView = ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	::CloseHandle(hMapping);
+
+	if (!pView)
+		return {};
+
+	return {
+		std::shared_ptr<void const>{ pView, [](void const* p) static noexcept { ::UnmapViewOfFile(p); } },
+		(std::size_t)Size.QuadPart,
+	};
+}
+
+// Unmapped first, Windows refuses to delete a mapped file. The store of the miss that follows writes a fresh blob anyway.
+static void RemoveStaleBlob(std::shared_ptr<void const> pMapping, std::filesystem::path const& BlobPath) noexcept
+{
+	pMapping.reset();
+
+	std::error_code ec{};
+	if (std::filesystem::remove(BlobPath, ec))
+		s_iStaleRemoved.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Checks what both kinds of blobs share, the caller checks the format specific fields. A blob that does not pass, e.g.
+// from an older version or a truncated write, is deleted. On success the blob counts as used now.
+[[nodiscard]] static auto LoadBlob(std::filesystem::path const& BlobPath, CBlobHeader const& Expected) noexcept -> std::optional<CMappedBlob>
+{
+	auto [pMapping, iSize] = MapReadOnly(BlobPath);
+	if (!pMapping)
+		return std::nullopt;
+
+	if (iSize < BLOB_PAYLOAD_OFFSET)
+	{
+		RemoveStaleBlob(std::move(pMapping), BlobPath);
+		return std::nullopt;
+	}
+
+	auto const pBytes = static_cast<std::uint8_t const*>(pMapping.get());
+
+	CBlobHeader Header{};
+	std::memcpy(&Header, pBytes, sizeof(Header));
+
+	if (Header.m_Magic != BLOB_MAGIC || Header.m_Version != BLOB_VERSION
+		|| Header.m_SourceHash != Expected.m_SourceHash || Header.m_SourceSize != Expected.m_SourceSize
+		|| Header.m_Flags != Expected.m_Flags
+		|| Header.m_Width <= 0 || Header.m_Height <= 0
+		|| iSize - BLOB_PAYLOAD_OFFSET < Header.m_PayloadBytes)
+	{
+		RemoveStaleBlob(std::move(pMapping), BlobPath);
+		return std::nullopt;
+	}
+
+	// Attributes only, allowed while the view is open. See TrimCacheDirectory().
+	std::error_code ec{};
+	std::filesystem::last_write_time(BlobPath, std::filesystem::file_time_type::clock::now(), ec);
+
+	return CMappedBlob{ .m_pMapping = std::move(pMapping), .m_Header = Header, .m_pPayload = pBytes + BLOB_PAYLOAD_OFFSET };
+}
+
+// Written next to the final name and renamed, a concurrent reader sees either nothing or a whole blob.
+static void StoreBlob(std::filesystem::path const& BlobPath, CBlobHeader const& Header, std::uint8_t const* pPayload) noexcept
+{
+	auto TempPath = BlobPath;
+	TempPath += std::format(".{}.tmp", std::this_thread::get_id());
+
+	std::error_code ec{};
+
+	{
+		std::ofstream file{ TempPath, std::ios::binary | std::ios::trunc };
+		if (!file)
+			return;
+
+		std::array<char, BLOB_PAYLOAD_OFFSET> rgHeader{};
+		std::memcpy(rgHeader.data(), &Header, sizeof(Header));
+
+		file.write(rgHeader.data(), rgHeader.size());
+		file.write(reinterpret_cast<char const*>(pPayload), (std::streamsize)Header.m_PayloadBytes);
+
+		if (!file)
+		{
+			file.close();
+			std::filesystem::remove(TempPath, ec);
+			return;
+		}
+	}
+
+	// Fails if another thread won the race and the blob is mapped already, the existing blob is just as good.
+	if (std::filesystem::rename(TempPath, BlobPath, ec); ec)
+		std::filesystem::remove(TempPath, ec);
+}
+
+// Nanoseconds since construction.
+struct CStopwatch final
+{
+	std::chrono::steady_clock::time_point m_Start{ std::chrono::steady_clock::now() };
+
+	[[nodiscard]] auto Elapsed() const noexcept -> std::int64_t
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start).count();
+	}
+};
+
+static void CountHit(CStopwatch const& Watch) noexcept
+{
+	s_iHits.fetch_add(1, std::memory_order_relaxed);
+	s_iHitNanoseconds.fetch_add(Watch.Elapsed(), std::memory_order_relaxed);
+}
+
+static void CountMiss(CStopwatch const& Watch) noexcept
+{
+	s_iMisses.fetch_add(1, std::memory_order_relaxed);
+	s_iMissNanoseconds.fetch_add(Watch.Elapsed(), std::memory_order_relaxed);
+}
+
+auto DecodeImageCached(CEncodedImage const& Encoded, bool bFlipY) noexcept -> std::expected<CDecodedImage, std::string_view>
+{
+	if (!s_bEnabled.load(std::memory_order_relaxed) || CacheDirectory().empty())
+		return DecodeImage(Encoded, bFlipY);
+
+	CTraceZone Zone{ "DecodeImageCached", ELogCategory::Resource, Encoded.m_Path };
+	CStopwatch const Watch{};
+
+	CBlobHeader Header{
+		.m_SourceHash = HashBytes(Encoded.m_Bytes),
+		.m_SourceSize = Encoded.m_Bytes.size(),
+		.m_Format = EBlobFormat::RGBA8,
+		.m_Flags = bFlipY ? BLOB_FLAG_FLIP_Y : 0,
+	};
+
+	auto const BlobPath = CacheDirectory() / std::format("{:016x}{}.rgba", Header.m_SourceHash, bFlipY ? "_flip" : "");
+
+	if (auto Blob = LoadBlob(BlobPath, Header);
+		Blob && Blob->m_Header.m_Format == EBlobFormat::RGBA8
+		&& Blob->m_Header.m_PayloadBytes == (std::uint64_t)Blob->m_Header.m_Width * Blob->m_Header.m_Height * 4)
+	{
+		CountHit(Watch);
+
+		return CDecodedImage{
+			.m_Path = Encoded.m_Path,
+			.m_pMapping = std::move(Blob->m_pMapping),
+			.m_pMappedPixels = Blob->m_pPayload,
+			.m_Width = Blob->m_Header.m_Width,
+			.m_Height = Blob->m_Header.m_Height,
+		};
+	}
+
+	auto Decoded = DecodeImage(Encoded, bFlipY);
+
+	if (Decoded)
+	{
+		Header.m_Width = Decoded->m_Width;
+		Header.m_Height = Decoded->m_Height;
+		Header.m_PayloadBytes = (std::uint64_t)Decoded->m_Width * Decoded->m_Height * 4;
+
+		StoreBlob(BlobPath, Header, Decoded->Data());
+		CountMiss(Watch);
+	}
+
+	return Decoded;
+}
+
+auto CompressTextureArrayCached(CEncodedImage const& Encoded, int target_height, bool bFlipY) noexcept -> std::expected<CCompressedImage, std::string_view>
+{
+	auto const bCache = s_bEnabled.load(std::memory_order_relaxed) && !CacheDirectory().empty();
+
+	CTraceZone Zone{ "CompressTextureArrayCached", ELogCategory::Resource, Encoded.m_Path };
+	CStopwatch const Watch{};
+
+	CBlobHeader Header{
+		.m_SourceHash = bCache ? HashBytes(Encoded.m_Bytes) : 0,
+		.m_SourceSize = Encoded.m_Bytes.size(),
+		.m_Flags = bFlipY ? BLOB_FLAG_FLIP_Y : 0,
+		.m_LayerHeight = target_height,
+	};
+
+	// BC1 or BC3 is only known after looking at the pixels, both share one name.
+	auto const BlobPath = bCache
+		? CacheDirectory() / std::format("{:016x}{}_{}.bc", Header.m_SourceHash, bFlipY ? "_flip" : "", target_height)
+		: std::filesystem::path{};
+
+	if (auto Blob = bCache ? LoadBlob(BlobPath, Header) : std::nullopt; Blob
+		&& (Blob->m_Header.m_Format == EBlobFormat::BC1 || Blob->m_Header.m_Format == EBlobFormat::BC3)
+		&& Blob->m_Header.m_LayerHeight == target_height
+		&& Blob->m_Header.m_Layers == (Blob->m_Header.m_Height + target_height - 1) / target_height)
+	{
+		CCompressedImage ret{
+			.m_Path = Encoded.m_Path,
+			.m_pMapping = std::move(Blob->m_pMapping),
+			.m_pMappedBlocks = Blob->m_pPayload,
+			.m_Bytes = (std::size_t)Blob->m_Header.m_PayloadBytes,
+			.m_Format = Blob->m_Header.m_Format == EBlobFormat::BC1 ? ECompressedFormat::BC1 : ECompressedFormat::BC3,
+			.m_Width = Blob->m_Header.m_Width,
+			.m_Height = Blob->m_Header.m_Height,
+			.m_LayerHeight = Blob->m_Header.m_LayerHeight,
+			.m_Layers = Blob->m_Header.m_Layers,
+			.m_flPsnr = Blob->m_Header.m_flPsnr,
+			.m_flEncodeMilliseconds = Blob->m_Header.m_flEncodeMilliseconds,
+		};
+
+		auto const iBlocks = (std::size_t)((ret.m_Width + 3) / 4) * (ret.m_LayerHeight / 4) * ret.m_Layers;
+		if (ret.m_Bytes == iBlocks * ret.BlockBytes())
+		{
+			CountHit(Watch);
+			return ret;
+		}
+	}
+
+	auto Compressed = DecodeImage(Encoded, bFlipY)
+		.and_then([&](CDecodedImage const& Decoded) noexcept { return CompressTextureArray(Decoded, target_height); });
+
+	if (Compressed && bCache)
+	{
+		Header.m_Width = Compressed->m_Width;
+		Header.m_Height = Compressed->m_Height;
+		Header.m_Format = Compressed->m_Format == ECompressedFormat::BC1 ? EBlobFormat::BC1 : EBlobFormat::BC3;
+		Header.m_PayloadBytes = Compressed->m_Bytes;
+		Header.m_Layers = Compressed->m_Layers;
+		Header.m_flPsnr = Compressed->m_flPsnr;
+		Header.m_flEncodeMilliseconds = Compressed->m_flEncodeMilliseconds;
+
+		StoreBlob(BlobPath, Header, Compressed->Data());
+		CountMiss(Watch);
+	}
+
+	return Compressed;
+}
+
+void SetImageDiskCacheEnabled(bool bEnabled) noexcept
+{
+	s_bEnabled.store(bEnabled, std::memory_order_relaxed);
+}
+
+auto IsImageDiskCacheEnabled() noexcept -> bool
+{
+	return s_bEnabled.load(std::memory_order_relaxed);
+}
+
+auto ImageDiskCacheStat() noexcept -> CImageDiskCacheStat
+{
+	return {
+		.m_Hits = s_iHits.load(std::memory_order_relaxed),
+		.m_Misses = s_iMisses.load(std::memory_order_relaxed),
+		.m_HitMilliseconds = (double)s_iHitNanoseconds.load(std::memory_order_relaxed) / 1e6,
+		.m_MissMilliseconds = (double)s_iMissNanoseconds.load(std::memory_order_relaxed) / 1e6,
+		.m_StaleRemoved = s_iStaleRemoved.load(std::memory_order_relaxed),
+	};
+}
+
+void LogImageDiskCacheStat() noexcept
+{
+	auto const Stat = ImageDiskCacheStat();
+
+	if (Stat.m_Hits + Stat.m_Misses == 0)
+		return;
+
+	auto const flHit = Stat.m_Hits ? Stat.m_HitMilliseconds / (double)Stat.m_Hits : 0.0;
+	auto const flMiss = Stat.m_Misses ? Stat.m_MissMilliseconds / (double)Stat.m_Misses : 0.0;
+
+	UTIL_LogInfo(ELogCategory::Resource, "Texture disk cache: {} warm loads at {:.2f} ms, {} cold loads at {:.2f} ms{}. {} stale blobs removed.",
+		Stat.m_Hits, flHit, Stat.m_Misses, flMiss,
+		flHit > 0.0 && flMiss > 0.0 ? std::format(", warm is {:.1f}x faster", flMiss / flHit) : std::string{},
+		Stat.m_StaleRemoved
+	);
+}
@@ -8,10 +8,8 @@
 import std.compat;
 #endif
 
-// Image.cpp
-extern auto GetTextureDimensions(const wchar_t* file_name) noexcept -> std::pair<int, int>;
-//
-
+import UtlLog;
+import UtlTrace;
 import UtlString;
 import Image.Tilesets;
 import Image.Resources;
@@ -19,15 +17,18 @@ import Game.Path;
 
 namespace PokemonEssentials::Resources
 {
-	void LoadAutotiles() noexcept
+	// No GL call, safe on any thread. Files are only listed, IndexImages() sorts them out by size.
+	void DiscoverAutotiles(CImageDiscovery* pDiscovery) noexcept
 	{
+		CTraceZone Zone{ "DiscoverAutotiles", ELogCategory::Resource };
+
 		static std::filesystem::path const AutotilePath{
 			PokemonEssentials::GamePath / LR"(Graphics\Autotiles\)"
 		};
 
 		if (!std::filesystem::exists(AutotilePath) || !std::filesystem::is_directory(AutotilePath))
 		{
-			std::println("Autotile path '{}' does not exist or is not a directory!", AutotilePath.u8string());
+			UTIL_LogError(ELogCategory::Resource, "Autotile path '{}' does not exist or is not a directory!", AutotilePath.u8string());
 			return;
 		}
 
@@ -36,17 +37,7 @@ namespace PokemonEssentials::Resources
 			if (!entry.is_regular_file())
 				continue;
 
-			auto&& [iWidth, iHeight] = GetTextureDimensions(entry.path().c_str());
-			if (iWidth <= 0 || iHeight <= 0)
-			{
-				std::println("Invalid image dimensions for '{}', skipping...", entry.path().filename().u8string());
-				continue;
-			}
-
-			if (CAnimatedTileImage::IsSizeAnimatedTile(iWidth, iHeight))
-				Resources::AnimatedTiles.try_emplace(entry.path().stem().u8string(), entry.path().c_str());
-			else if (CAutotileImage::IsSizeAutotile(iWidth, iHeight))
-				Resources::AutoTiles.try_emplace(entry.path().stem().u8string(), entry.path().c_str());
+			pDiscovery->m_AutoTileFiles.push_back(entry.path());
 		}
 	}
 }
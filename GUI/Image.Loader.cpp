@@ -0,0 +1,110 @@
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import UtlLog;
+import UtlTrace;
+import Image.Cache;
+import Image.Decode;
+import Image.Tilesets;
+import Image.Resources;
+
+
+namespace PokemonEssentials::Resources
+{
+	[[nodiscard]] static auto ClassifyImage(CEncodedImage const& Encoded, bool bTilesetFolder) noexcept -> std::optional<EImageKind>
+	{
+		auto const iWidth = Encoded.m_Width;
+		auto const iHeight = Encoded.m_Height;
+
+		if (iWidth <= 0 || iHeight <= 0)
+		{
+			UTIL_LogWarning(ELogCategory::Resource, "Invalid image dimensions for '{}', skipping...", Encoded.m_Path.filename().u8string());
+			return std::nullopt;
+		}
+
+		if (bTilesetFolder)
+		{
+			if (iWidth % CTilesetImage::TILE_WIDTH != 0 || iHeight % CTilesetImage::TILE_HEIGHT != 0)
+			{
+				UTIL_LogWarning(ELogCategory::Resource, "Image '{}' is not a multiple of tile size {}x{}, skipping...",
+					Encoded.m_Path.filename().u8string(), CTilesetImage::TILE_WIDTH, CTilesetImage::TILE_HEIGHT);
+				return std::nullopt;
+			}
+
+			return EImageKind::Tileset;
+		}
+
+		if (CAnimatedTileImage::IsSizeAnimatedTile(iWidth, iHeight))
+			return EImageKind::AnimatedTile;
+		if (CAutotileImage::IsSizeAutotile(iWidth, iHeight))
+			return EImageKind::AutoTile;
+
+		return std::nullopt;
+	}
+
+	struct CIndexedImage final
+	{
+		EImageKind m_Kind{};
+		CEncodedImage m_Header{};
+	};
+
+	[[nodiscard]] static auto IndexOne(std::filesystem::path const& Path, bool bTilesetFolder) noexcept -> std::optional<CIndexedImage>
+	{
+		auto Header = ReadImageHeader(Path);
+
+		if (!Header)
+		{
+			UTIL_LogWarning(ELogCategory::Resource, "Cannot load '{}': {}", Path.filename().u8string(), Header.error());
+			return std::nullopt;
+		}
+
+		if (auto const Kind = ClassifyImage(*Header, bTilesetFolder))
+			return CIndexedImage{ .m_Kind = *Kind, .m_Header = std::move(*Header) };
+
+		return std::nullopt;
+	}
+
+	// Headers only, the pixels load on first use. No GL call, safe on any thread.
+	void IndexImages(CImageDiscovery* pDiscovery) noexcept
+	{
+		CTraceZone Zone{ "IndexImages", ELogCategory::Resource };
+
+		auto const iTilesets = pDiscovery->m_TilesetFiles.size();
+		std::vector<std::optional<CIndexedImage>> rgIndexed(iTilesets + pDiscovery->m_AutoTileFiles.size());
+
+		std::transform(std::execution::par, pDiscovery->m_TilesetFiles.begin(), pDiscovery->m_TilesetFiles.end(), rgIndexed.begin(),
+			[](std::filesystem::path const& Path) static noexcept { return IndexOne(Path, true); });
+		std::transform(std::execution::par, pDiscovery->m_AutoTileFiles.begin(), pDiscovery->m_AutoTileFiles.end(), rgIndexed.begin() + iTilesets,
+			[](std::filesystem::path const& Path) static noexcept { return IndexOne(Path, false); });
+
+		for (auto&& Indexed : rgIndexed)
+		{
+			if (!Indexed)
+				continue;
+
+			auto& [Kind, Header] = *Indexed;
+			auto szName = Header.m_Path.stem().u8string();
+
+			switch (Kind)
+			{
+			case EImageKind::Tileset:
+				Resources::Tilesets.try_emplace(std::move(szName), std::move(Header.m_Path), Header.m_Width, Header.m_Height);
+				break;
+			case EImageKind::AutoTile:
+				Resources::AutoTiles.try_emplace(std::move(szName), std::move(Header.m_Path), Header.m_Width, Header.m_Height);
+				break;
+			case EImageKind::AnimatedTile:
+				Resources::AnimatedTiles.try_emplace(std::move(szName), std::move(Header.m_Path), Header.m_Width, Header.m_Height);
+				break;
+			}
+		}
+
+		UTIL_LogInfo(ELogCategory::Resource, "Indexed {} tilesets, {} autotiles and {} animated tiles.",
+			Resources::Tilesets.size(), Resources::AutoTiles.size(), Resources::AnimatedTiles.size());
+	}
+}
@@ -18,7 +18,8 @@ import Image.Resources;
 
 namespace Utils::Query
 {
-	export auto tileset_image_by_id(int id) noexcept -> CTilesetImage const*
+	// The handle only, Get() on it loads the texture when the tileset is actually drawn.
+	export auto tileset_image_by_id(int id) noexcept -> PokemonEssentials::Resources::TilesetHandle_t const*
 	{
 		if (auto it = std::ranges::find(Database::RX::Tilesets, id, &Database::RX::Tileset::m_id);
 			it != Database::RX::Tilesets.end())
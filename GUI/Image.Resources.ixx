@@ -13,12 +13,28 @@ import std.compat;
 #endif
 
 import UtlString;
+import Image.Cache;
 import Image.Tilesets;
 
 namespace PokemonEssentials::Resources
 {
-	export inline std::map<std::string, CAnimatedTileImage, sv_less_t> AnimatedTiles;
-	export inline std::map<std::string, CAutotileImage, sv_less_t> AutoTiles;
+	// Handles only, the GPU data loads on first Get() and may be evicted. See Image.Cache.
+	export using TilesetHandle_t = TLazyImage<CTilesetImage>;
+	export using AutotileHandle_t = TLazyImage<CAutotileImage>;
+	export using AnimatedTileHandle_t = TLazyImage<CAnimatedTileImage>;
 
-	export inline std::map<std::string, CTilesetImage, sv_less_t> Tilesets;
+	export inline std::map<std::string, AnimatedTileHandle_t, sv_less_t> AnimatedTiles;
+	export inline std::map<std::string, AutotileHandle_t, sv_less_t> AutoTiles;
+
+	export inline std::map<std::string, TilesetHandle_t, sv_less_t> Tilesets;
+
+	export enum struct EImageKind : std::uint8_t { Tileset, AutoTile, AnimatedTile, };
+
+	// Shared by the startup tasks. Discover* list the files on any thread, IndexImages() reads the header of each of them
+	// and fills the maps above. No pixel is decoded at startup.
+	export struct CImageDiscovery final
+	{
+		std::vector<std::filesystem::path> m_AutoTileFiles{};	// Autotiles and animated tiles, told apart by their size.
+		std::vector<std::filesystem::path> m_TilesetFiles{};
+	};
 }
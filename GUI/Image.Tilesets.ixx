@@ -14,14 +14,18 @@ export module Image.Tilesets;
 import std.compat;
 #endif
 
-import GL.Canvas;
-import GL.Painter;
-import GL.Shader;
+import UtlLog;
+
 import GL.Texture;
+import Image.Autotile;
+import Image.Decode;
 
 extern "C++" auto LoadTextureFromFile(const wchar_t* file_name, bool bFlipY) noexcept -> std::expected<std::tuple<std::uint32_t, int, int>, std::string_view>;
 extern "C++" auto LoadTextureArrayFromFile(const wchar_t* file_name, int target_height, bool bFlipY = false) noexcept -> std::expected<std::tuple<std::uint32_t, int, int, int>, std::string_view>;
 
+using TextureResult_t = std::expected<std::tuple<std::uint32_t, int, int>, std::string_view>;
+using TextureArrayResult_t = std::expected<std::tuple<std::uint32_t, int, int, int>, std::string_view>;
+
 export struct CTileUV final
 {
 	float m_x{}, m_y{};
@@ -80,14 +84,26 @@ export struct CTilesetImage final
 	// Default to flipping Y, as OpenGL's texture coordinate origin is bottom-left, while image files usually have top-left.
 	// This must be aligned with other generated-textures. (Auto-tiles and Animated-tiles)
 	CTilesetImage(const wchar_t* wcsFilename, bool bFlipY = false) noexcept
+		: CTilesetImage{ LoadTextureArrayFromFile(wcsFilename, 256, bFlipY), wcsFilename } {}
+
+	// For TLazyImage. Goes through the disk cache, and through BC1/BC3 when texture compression is on.
+	[[nodiscard]] static auto Upload(CEncodedImage const& Encoded) noexcept -> TextureArrayResult_t
+	{
+		return UploadEncodedTextureArray(Encoded, 256, false);
+	}
+
+	// For TLazyImage::Request(), the same texture through the upload ring.
+	static void Stream(std::filesystem::path const& Path, fnTextureArrayDone_t fnDone) noexcept
 	{
-		auto const res = LoadTextureArrayFromFile(wcsFilename, 256, bFlipY);
+		StreamTextureArray(Path, 256, false, std::move(fnDone));
+	}
 
+	CTilesetImage(TextureArrayResult_t const& res, std::filesystem::path const& FilePath) noexcept
+	{
 		auto const error = glGetError();
 		if (error != GL_NO_ERROR) [[unlikely]]
 		{
-			std::filesystem::path const FilePath{ wcsFilename };
-			std::println("[{}] OpenGL error after texture creation: {}", FilePath.filename().u8string(), error);
+			UTIL_LogError(ELogCategory::Render, "[{}] OpenGL error after texture creation: {}", FilePath.filename().u8string(), error);
 		}
 
 		if (res.has_value())
@@ -101,9 +117,7 @@ export struct CTilesetImage final
 
 		if (m_Width % TILE_WIDTH != 0 || m_Height % TILE_HEIGHT != 0) [[unlikely]]
 		{
-			std::filesystem::path const FilePath{ wcsFilename };
-
-			std::println(u8"Tileset image '{}' has invalid dimensions: {}x{} (must be multiple of {}x{})",
+			UTIL_LogWarning(ELogCategory::Resource, u8"Tileset image '{}' has invalid dimensions: {}x{} (must be multiple of {}x{})",
 				FilePath.u8string(), m_Width, m_Height, TILE_WIDTH, TILE_HEIGHT
 			);
 		}
@@ -139,219 +153,62 @@ export struct CTilesetImage final
 	[[nodiscard]] constexpr auto GetOutputTilesetDimension() const noexcept -> std::pair<int, int> { return { m_Columns, m_Rows }; }
 };
 
-// For indexing AUTOTILE_SHAPE_INFO below.
-enum EAutotileShapes : std::uint8_t
-{
-	AT_Bordering_None,
-	AT_Bordering_UL,
-	AT_Bordering_UR,
-	AT_Bordering_UL_UR,
-	AT_Bordering_DR,
-	AT_Bordering_UL_DR,
-	AT_Bordering_UR_DR,
-	AT_Bordering_UL_UR_DR,
-
-	AT_Bordering_DL,
-	AT_Bordering_UL_DL,
-	AT_Bordering_UR_DL,
-	AT_Bordering_UL_UR_DL,
-	AT_Bordering_DL_DR,
-	AT_Bordering_UL_DL_DR,
-	AT_Bordering_UR_DL_DR,
-	AT_Bordering_UL_UR_DL_DR,	// 'crossroad' shape, all 4 sides connected
-
-	AT_Bordering_L,
-	AT_Bordering_L_UR,
-	AT_Bordering_L_DR,
-	AT_Bordering_L_UR_DR,
-	AT_Bordering_U,
-	AT_Bordering_U_DR,
-	AT_Bordering_U_DL,
-	AT_Bordering_U_DR_DL,
-
-	AT_Bordering_R,
-	AT_Bordering_R_DL,
-	AT_Bordering_R_UL,
-	AT_Bordering_R_UL_DL,
-	AT_Bordering_D,
-	AT_Bordering_D_UL,
-	AT_Bordering_D_UR,
-	AT_Bordering_D_UL_DR,
-
-	AT_Bordering_L_R,
-	AT_Bordering_U_D,
-	AT_Bordering_U_L,
-	AT_Bordering_U_L_DR,
-	AT_Bordering_U_R,
-	AT_Bordering_U_R_DL,
-	AT_Bordering_D_R,
-	AT_Bordering_D_R_UL,
-
-	AT_Bordering_D_L,
-	AT_Bordering_D_L_UR,
-	AT_Bordering_U_L_R,
-	AT_Bordering_U_D_L,
-	AT_Bordering_D_L_R,
-	AT_Bordering_U_D_R,
-	AT_Bordering_U_D_L_R,	// 'enclosed' shape, all 4 sides are adjacent to other tile types.
-	AT_Bordering_UNUSED,
-
-	AT_COUNT,
-};
-
-// arr[I] represents a full tile
-// arr[I][J] represents a component of that tile
-inline constexpr std::array AUTOTILE_SHAPE_INFO
-{
-	std::array{ std::array{2, 4}, std::array{3, 4}, std::array{2, 5}, std::array{3, 5}, },	// AT_Bordering_None,
-	std::array{ std::array{4, 0}, std::array{3, 4}, std::array{2, 5}, std::array{3, 5}, },	// AT_Bordering_UL,
-	std::array{ std::array{2, 4}, std::array{5, 0}, std::array{2, 5}, std::array{3, 5}, },	// AT_Bordering_UR,
-	std::array{ std::array{4, 0}, std::array{5, 0}, std::array{2, 5}, std::array{3, 5}, },	// AT_Bordering_UL_UR,
-	std::array{ std::array{2, 4}, std::array{3, 4}, std::array{2, 5}, std::array{5, 1}, },	// AT_Bordering_DR,
-	std::array{ std::array{4, 0}, std::array{3, 4}, std::array{2, 5}, std::array{5, 1}, },	// AT_Bordering_UL_DR,
-	std::array{ std::array{2, 4}, std::array{5, 0}, std::array{2, 5}, std::array{5, 1}, },	// AT_Bordering_UR_DR,
-	std::array{ std::array{4, 0}, std::array{5, 0}, std::array{2, 5}, std::array{5, 1}, },	// AT_Bordering_UL_UR_DR,
-
-	std::array{ std::array{2, 4}, std::array{3, 4}, std::array{4, 1}, std::array{3, 5}, },	// AT_Bordering_DL,
-	std::array{ std::array{4, 0}, std::array{3, 4}, std::array{4, 1}, std::array{3, 5}, },	// AT_Bordering_UL_DL,
-	std::array{ std::array{2, 4}, std::array{5, 0}, std::array{4, 1}, std::array{3, 5}, },	// AT_Bordering_UR_DL,
-	std::array{ std::array{4, 0}, std::array{5, 0}, std::array{4, 1}, std::array{3, 5}, },	// AT_Bordering_UL_UR_DL,
-	std::array{ std::array{2, 4}, std::array{3, 4}, std::array{4, 1}, std::array{5, 1}, },	// AT_Bordering_DL_DR,
-	std::array{ std::array{4, 0}, std::array{3, 4}, std::array{4, 1}, std::array{5, 1}, },	// AT_Bordering_UL_DL_DR,
-	std::array{ std::array{2, 4}, std::array{5, 0}, std::array{4, 1}, std::array{5, 1}, },	// AT_Bordering_UR_DL_DR,
-	std::array{ std::array{4, 0}, std::array{5, 0}, std::array{4, 1}, std::array{5, 1}, },	// AT_Bordering_UL_UR_DL_DR,
-
-	std::array{ std::array{0, 4}, std::array{1, 4}, std::array{0, 5}, std::array{1, 5}, },	// AT_Bordering_L,
-	std::array{ std::array{0, 4}, std::array{5, 0}, std::array{0, 5}, std::array{1, 5}, },	// AT_Bordering_L_UR,
-	std::array{ std::array{0, 4}, std::array{1, 4}, std::array{0, 5}, std::array{5, 1}, },	// AT_Bordering_L_DR,
-	std::array{ std::array{0, 4}, std::array{5, 0}, std::array{0, 5}, std::array{5, 1}, },	// AT_Bordering_L_UR_DR,
-	std::array{ std::array{2, 2}, std::array{3, 2}, std::array{2, 3}, std::array{3, 3}, },	// AT_Bordering_U,
-	std::array{ std::array{2, 2}, std::array{3, 2}, std::array{2, 3}, std::array{5, 1}, },	// AT_Bordering_U_DR,
-	std::array{ std::array{2, 2}, std::array{3, 2}, std::array{4, 1}, std::array{3, 3}, },	// AT_Bordering_U_DL,
-	std::array{ std::array{2, 2}, std::array{3, 2}, std::array{4, 1}, std::array{5, 1}, },	// AT_Bordering_U_DR_DL,
-
-	std::array{ std::array{4, 4}, std::array{5, 4}, std::array{4, 5}, std::array{5, 5}, },	// AT_Bordering_R,
-	std::array{ std::array{4, 4}, std::array{5, 4}, std::array{4, 1}, std::array{5, 5}, },	// AT_Bordering_R_DL,
-	std::array{ std::array{4, 0}, std::array{5, 4}, std::array{4, 5}, std::array{5, 5}, },	// AT_Bordering_R_UL,
-	std::array{ std::array{4, 0}, std::array{5, 4}, std::array{4, 1}, std::array{5, 5}, },	// AT_Bordering_R_UL_DL,
-	std::array{ std::array{2, 6}, std::array{3, 6}, std::array{2, 7}, std::array{3, 7}, },	// AT_Bordering_D,
-	std::array{ std::array{4, 0}, std::array{3, 6}, std::array{2, 7}, std::array{3, 7}, },	// AT_Bordering_D_UL,
-	std::array{ std::array{2, 6}, std::array{5, 0}, std::array{2, 7}, std::array{3, 7}, },	// AT_Bordering_D_UR,
-	std::array{ std::array{4, 0}, std::array{5, 0}, std::array{2, 7}, std::array{3, 7}, },	// AT_Bordering_D_UL_DR,
-
-	std::array{ std::array{0, 4}, std::array{5, 4}, std::array{0, 5}, std::array{5, 5}, },	// AT_Bordering_L_R,
-	std::array{ std::array{2, 2}, std::array{3, 2}, std::array{2, 7}, std::array{3, 7}, },	// AT_Bordering_U_D,
-	std::array{ std::array{0, 2}, std::array{1, 2}, std::array{0, 3}, std::array{1, 3}, },	// AT_Bordering_U_L,
-	std::array{ std::array{0, 2}, std::array{1, 2}, std::array{0, 3}, std::array{5, 1}, },	// AT_Bordering_U_L_DR,
-	std::array{ std::array{4, 2}, std::array{5, 2}, std::array{4, 3}, std::array{5, 3}, },	// AT_Bordering_U_R,
-	std::array{ std::array{4, 2}, std::array{5, 2}, std::array{4, 1}, std::array{5, 3}, },	// AT_Bordering_U_R_DL,
-	std::array{ std::array{4, 6}, std::array{5, 6}, std::array{4, 7}, std::array{5, 7}, },	// AT_Bordering_D_R,
-	std::array{ std::array{4, 0}, std::array{5, 6}, std::array{4, 7}, std::array{5, 7}, },	// AT_Bordering_D_R_UL,
-
-	std::array{ std::array{0, 6}, std::array{1, 6}, std::array{0, 7}, std::array{1, 7}, },	// AT_Bordering_D_L,
-	std::array{ std::array{0, 6}, std::array{5, 0}, std::array{0, 7}, std::array{1, 7}, },	// AT_Bordering_D_L_UR,
-	std::array{ std::array{0, 2}, std::array{5, 2}, std::array{0, 3}, std::array{5, 3}, },	// AT_Bordering_U_L_R,
-	std::array{ std::array{0, 2}, std::array{1, 2}, std::array{0, 7}, std::array{1, 7}, },	// AT_Bordering_U_D_L,
-	std::array{ std::array{0, 6}, std::array{5, 6}, std::array{0, 7}, std::array{5, 7}, },	// AT_Bordering_D_L_R,
-	std::array{ std::array{4, 2}, std::array{5, 2}, std::array{4, 7}, std::array{5, 7}, },	// AT_Bordering_U_D_R,
-	std::array{ std::array{0, 2}, std::array{5, 2}, std::array{0, 7}, std::array{5, 7}, },	// AT_Bordering_U_D_L_R,
-	std::array{ std::array{0, 0}, std::array{1, 0}, std::array{0, 1}, std::array{1, 1}, },	// AT_Bordering_UNUSED,
-};
-
 export struct CAutotileImage final
 {
-	CGlTexture m_Texture{};	// Do not alloc new GL texture by default, keep it empty.
+	CGlTexture m_Texture{};	// The expanded sheets, see ExpandAutotile(). Do not alloc new GL texture by default, keep it empty.
 
 	static constexpr auto COMPONENT_WIDTH = CTilesetImage::TILE_WIDTH / 2;
 	static constexpr auto COMPONENT_HEIGHT = CTilesetImage::TILE_HEIGHT / 2;
 
-	static constexpr auto AUTOTILE_WIDTH = 96;
-	static constexpr auto AUTOTILE_HEIGHT = 128;
+	static constexpr auto AUTOTILE_WIDTH = AUTOTILE_SOURCE_WIDTH;
+	static constexpr auto AUTOTILE_HEIGHT = AUTOTILE_SOURCE_HEIGHT;
 
-	int m_Width{ AUTOTILE_WIDTH };
-	int m_Height{ AUTOTILE_HEIGHT };
+	int m_FrameCount{ 1 };	// Sheets in m_Texture, top to bottom.
 
 	// Output config
-	static constexpr auto AUTOTILE_OUT_COLUMNS = 8;
-	static constexpr auto AUTOTILE_OUT_ROWS = 6;
+	static constexpr auto AUTOTILE_OUT_COLUMNS = AUTOTILE_SHEET_COLUMNS;
+	static constexpr auto AUTOTILE_OUT_ROWS = AUTOTILE_SHEET_ROWS;
 
 	static constexpr auto AUTOTILE_OUT_WIDTH = AUTOTILE_OUT_COLUMNS * CTilesetImage::TILE_WIDTH;
 	static constexpr auto AUTOTILE_OUT_HEIGHT = AUTOTILE_OUT_ROWS * CTilesetImage::TILE_HEIGHT;
 
-	static constexpr auto AUTOTILE_GL_TEXTURE_CHANNEL = 1;
+	// For TLazyImage. Expanded once on the CPU, the sheets are uploaded as they are.
+	[[nodiscard]] static auto Upload(CEncodedImage const& Encoded) noexcept -> TextureResult_t
+	{
+		return DecodeImageCached(Encoded, false).and_then(&Expand);
+	}
 
-	// Output canvas
-	CGlCanvas m_Canvas{ AUTOTILE_OUT_WIDTH, AUTOTILE_OUT_HEIGHT };
-	CGlPainter2D m_Painter{};	// data for the tile components
+	// For TLazyImage::Request(), read, decoded and expanded on the pool. The autotiles of a tileset expand side by side.
+	static void Stream(std::filesystem::path const& Path, fnTextureDone_t fnDone) noexcept
+	{
+		StreamTexture(Path, false, &ExpandAutotile, std::move(fnDone));
+	}
 
-	static constexpr auto VERTEX_ELEM_COUNT = 5;		// Each vertex has 5 components: x, y, u, v, texid
+	[[nodiscard]] static auto Expand(CDecodedImage const& Image) noexcept -> TextureResult_t
+	{
+		return ExpandAutotile(Image).and_then(&UploadTexture);
+	}
 
-	CAutotileImage(const wchar_t* wcsFilename, bool bFlipY = false) noexcept
+	CAutotileImage(TextureResult_t const& res, std::filesystem::path const& FilePath) noexcept
 	{
-		auto const res = LoadTextureFromFile(wcsFilename, bFlipY);
+		int iWidth{}, iHeight{};
 
 		if (res.has_value())
 		{
 			GLuint textureId{};
-			std::tie(textureId, m_Width, m_Height) = *res;
+			std::tie(textureId, iWidth, iHeight) = *res;
 
 			m_Texture.Emplace(textureId);
 		}
 
-		if (m_Width % AUTOTILE_WIDTH != 0 || m_Height != AUTOTILE_HEIGHT) [[unlikely]]
+		if (iWidth != AUTOTILE_OUT_WIDTH || iHeight <= 0 || iHeight % AUTOTILE_OUT_HEIGHT != 0) [[unlikely]]
 		{
-			std::filesystem::path const FilePath{ wcsFilename };
-
-			std::println(u8"Tileset image '{}' has invalid dimensions: {}x{} (width must be multiple of {}, height must be exactly {})",
-				FilePath.u8string(), m_Width, m_Height, AUTOTILE_WIDTH, AUTOTILE_HEIGHT
+			UTIL_LogWarning(ELogCategory::Resource, u8"Autotile image '{}' cannot be expanded: {}",
+				FilePath.u8string(), res.has_value() ? "unexpected sheet size" : res.error()
 			);
 		}
 
-		// Doubling is because each tile was composed from 4 more small tiles, a.k.a. components.
-		m_Painter.m_Vertices.reserve(static_cast<size_t>(AUTOTILE_OUT_COLUMNS * 2 * AUTOTILE_OUT_ROWS * 2) * 4u * VERTEX_ELEM_COUNT);
-		m_Painter.m_Indices.reserve(static_cast<size_t>(AUTOTILE_OUT_COLUMNS * 2 * AUTOTILE_OUT_ROWS * 2) * 6u);
-
-		auto const CompUF = (float)COMPONENT_WIDTH / (float)m_Width;
-		auto const CompVF = (float)COMPONENT_HEIGHT / (float)m_Height;
-		auto const CompWidthF = (float)COMPONENT_WIDTH / (float)AUTOTILE_OUT_WIDTH * 2.f;
-		auto const CompHeightF = (float)COMPONENT_HEIGHT / (float)AUTOTILE_OUT_HEIGHT * 2.f;	// Because the scale is [-1, 1], so we need to double it.
-
-		for (auto&& [iTileIndex, AutoTileComps] : std::views::enumerate(AUTOTILE_SHAPE_INFO))
-		{
-			for (auto&& [iCompIndex, CompUV_I] : std::views::enumerate(AutoTileComps))
-			{
-				// The coord of this tile in expanded texture of autotile is fixed, and CAN be generate through the algorithm below.
-
-				// Each comp will output to a small square, which later built up to a full tile.
-				auto const [flLeft, flTop] = GetOutputTilesetCoordf(iTileIndex, iCompIndex);
-				auto const flRight = flLeft + CompWidthF;
-				auto const flBottom = flTop - CompHeightF;	// negative Y is down in OpenGL
-
-				auto const flLeftUV = (float)CompUV_I[0] * (float)COMPONENT_WIDTH / (float)m_Width;
-				auto const flTopUV = (float)CompUV_I[1] * (float)COMPONENT_HEIGHT / (float)m_Height;
-				auto const flRightUV = flLeftUV + CompUF;
-				auto const flBottomUV = flTopUV + CompVF;	// For the texture, positive Y is down.
-
-				std::array<float, VERTEX_ELEM_COUNT * 4u> const data{
-					flLeft,  flTop,    flLeftUV,  flTopUV,    (float)AUTOTILE_GL_TEXTURE_CHANNEL,	// Top-Left
-					flRight, flTop,    flRightUV, flTopUV,    (float)AUTOTILE_GL_TEXTURE_CHANNEL,	// Top-Right
-					flLeft,  flBottom, flLeftUV,  flBottomUV, (float)AUTOTILE_GL_TEXTURE_CHANNEL,	// Bottom-Left
-					flRight, flBottom, flRightUV, flBottomUV, (float)AUTOTILE_GL_TEXTURE_CHANNEL,	// Bottom-Right
-				};
-
-				auto const index_offset = (GLuint)m_Painter.m_Vertices.size() / VERTEX_ELEM_COUNT;
-
-				std::array<GLuint, 6u> const indices{
-					index_offset + 0, index_offset + 1, index_offset + 2, // First triangle
-					index_offset + 1, index_offset + 2, index_offset + 3, // Second triangle
-				};
-
-				m_Painter.m_Vertices.append_range(data);
-				m_Painter.m_Indices.append_range(indices);
-			}
-		}
-
-		m_Painter.Commit(VERTEX_ELEM_COUNT);
+		m_FrameCount = std::max(iHeight / AUTOTILE_OUT_HEIGHT, 1);
 	}
 
 	CAutotileImage() noexcept = default;
@@ -366,51 +223,8 @@ export struct CAutotileImage final
 		return (iWidth % AUTOTILE_WIDTH == 0 && iHeight == AUTOTILE_HEIGHT);
 	}
 
-	static constexpr auto GetOutputTilesetCoordf(std::ptrdiff_t iTileIndex, std::ptrdiff_t iCompIndex) noexcept -> std::array<float, 2>
-	{
-		auto const iTileX = iTileIndex % AUTOTILE_OUT_COLUMNS;
-		auto const iTileY = iTileIndex / AUTOTILE_OUT_COLUMNS;
-
-		auto const iCompX = iCompIndex % 2;
-		auto const iCompY = iCompIndex / 2;
-
-		auto const flX = float(iTileX * CTilesetImage::TILE_WIDTH + iCompX * COMPONENT_WIDTH) / float(AUTOTILE_OUT_WIDTH);
-		auto const flY = float(iTileY * CTilesetImage::TILE_HEIGHT + iCompY * COMPONENT_HEIGHT) / float(AUTOTILE_OUT_HEIGHT);
-
-		// Mapping to range [-1, 1]
-		return { flX * 2.f - 1.f, -(flY * 2.f - 1.f) };
-	}
-
-	void Render() const noexcept
-	{
-		if (!m_Texture) [[unlikely]]
-		{
-			std::println("No autotile image loaded.");
-			return;
-		}
-
-		m_Canvas.Bind();
-
-		glActiveTexture(GL_TEXTURE0 + AUTOTILE_GL_TEXTURE_CHANNEL);
-		glBindTexture(GL_TEXTURE_2D, (GLuint)m_Texture);
-
-		g_pGlobalShader->Use();
-
-		static std::string szUniformName{
-			std::format("ourTexture{}", AUTOTILE_GL_TEXTURE_CHANNEL)
-		};
-		glUniform1i(glGetUniformLocation(g_pGlobalShader->m_ProgramId, szUniformName.c_str()), AUTOTILE_GL_TEXTURE_CHANNEL);
-
-		//glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-
-		m_Painter.Paint();
-
-		//glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-
-		m_Canvas.Unbind();
-	}
-
-	[[nodiscard]] auto GetOutputTextureId() const noexcept -> GLuint { return m_Canvas.GetTextureId(); }
+	// Row 0 is the top of frame 0. Frame i is the V range [i, i + 1] / m_FrameCount, the tile atlas bakes each into a layer.
+	[[nodiscard]] auto GetOutputTextureId() const noexcept -> GLuint { return (GLuint)m_Texture; }
 
 	[[nodiscard]] static constexpr auto GetOutputTextureDimension() noexcept -> std::pair<int, int> { return { AUTOTILE_OUT_WIDTH, AUTOTILE_OUT_HEIGHT }; }
 
@@ -419,24 +233,24 @@ export struct CAutotileImage final
 
 export struct CAnimatedTileImage final
 {
-	CGlTexture m_Texture{};	// Do not alloc new GL texture by default, keep it empty.
+	CGlTexture m_Texture{};	// The frames side by side, row 0 at the top. Do not alloc new GL texture by default, keep it empty.
 
 	static constexpr auto FRAME_WIDTH = CTilesetImage::TILE_WIDTH;
 	static constexpr auto FRAME_HEIGHT = CTilesetImage::TILE_HEIGHT;
 
-	static constexpr auto ANIMTILE_GL_TEXTURE_CHANNEL = 1;
-
 	int m_FrameCount{ 1 };
 
-	// Output canvas
-	CGlCanvas m_Canvas{ FRAME_WIDTH, FRAME_HEIGHT };
-	CGlPainter2D m_Painter{};
+	CAnimatedTileImage(const wchar_t* wcsFilename, bool bFlipY = false) noexcept
+		: CAnimatedTileImage{ LoadTextureFromFile(wcsFilename, bFlipY), wcsFilename } {}
 
-	static constexpr auto VERTEX_ELEM_COUNT = 5;		// Each vertex has 5 components: x, y, u, v, texid
+	// For TLazyImage.
+	[[nodiscard]] static auto Upload(CEncodedImage const& Encoded) noexcept -> TextureResult_t
+	{
+		return DecodeImageCached(Encoded, false).and_then(&UploadTexture);
+	}
 
-	CAnimatedTileImage(const wchar_t* wcsFilename, bool bFlipY = false) noexcept
+	CAnimatedTileImage(TextureResult_t const& res, std::filesystem::path const& FilePath) noexcept
 	{
-		auto const res = LoadTextureFromFile(wcsFilename, bFlipY);
 		int iWidth{}, iHeight{};
 
 		if (res.has_value())
@@ -449,51 +263,12 @@ export struct CAnimatedTileImage final
 
 		if (iWidth % FRAME_WIDTH != 0 || iHeight != FRAME_HEIGHT) [[unlikely]]
 		{
-			std::filesystem::path const FilePath{ wcsFilename };
-			std::println(u8"Animated tile image '{}' has invalid dimensions: {}x{} (width must be multiple of {}, height must be exactly {})",
+			UTIL_LogWarning(ELogCategory::Resource, u8"Animated tile image '{}' has invalid dimensions: {}x{} (width must be multiple of {}, height must be exactly {})",
 				FilePath.u8string(), iWidth, iHeight, FRAME_WIDTH, FRAME_HEIGHT
 			);
 		}
 
-		m_FrameCount = iWidth / FRAME_WIDTH;
-
-		// Since it's animated, all frames are rendered on the full canvas.
-
-		static constexpr std::array fcoords{
-			std::array{ -1.0f,  1.0f },	// Top-Left
-			std::array{  1.0f,  1.0f },	// Top-Right
-			std::array{ -1.0f, -1.0f },	// Bottom-Left
-			std::array{  1.0f, -1.0f },	// Bottom-Right
-		};
-
-		// V coord is always the same, because the animated tile is required to be exactly one row.
-		static constexpr float flTopV = 0.f;
-		static constexpr float flBottomV = 1.f;
-
-		for (int u = 0; u < iWidth; u += FRAME_WIDTH)
-		{
-			auto const flLeftU = (float)u / (float)iWidth;
-			auto const flRightU = (float)(u + FRAME_WIDTH) / (float)iWidth;
-
-			std::array<float, VERTEX_ELEM_COUNT * 4u> const data{
-				fcoords[0][0], fcoords[0][1], flLeftU,  flTopV,    (float)ANIMTILE_GL_TEXTURE_CHANNEL,		// Top-Left
-				fcoords[1][0], fcoords[1][1], flRightU, flTopV,    (float)ANIMTILE_GL_TEXTURE_CHANNEL,		// Top-Right
-				fcoords[2][0], fcoords[2][1], flLeftU,  flBottomV, (float)ANIMTILE_GL_TEXTURE_CHANNEL,		// Bottom-Left
-				fcoords[3][0], fcoords[3][1], flRightU, flBottomV, (float)ANIMTILE_GL_TEXTURE_CHANNEL,		// Bottom-Right
-			};
-
-			auto const index_offset = (GLuint)m_Painter.m_Vertices.size() / VERTEX_ELEM_COUNT;
-
-			std::array<GLuint, 6u> const indices{
-				index_offset + 0, index_offset + 1, index_offset + 2, // First triangle
-				index_offset + 1, index_offset + 2, index_offset + 3, // Second triangle
-			};
-
-			m_Painter.m_Vertices.append_range(data);
-			m_Painter.m_Indices.append_range(indices);
-		}
-
-		m_Painter.Commit(VERTEX_ELEM_COUNT);
+		m_FrameCount = std::max(iWidth / FRAME_WIDTH, 1);
 	}
 
 	CAnimatedTileImage() noexcept = default;
@@ -508,34 +283,8 @@ export struct CAnimatedTileImage final
 		return (iWidth % FRAME_WIDTH == 0 && iHeight == FRAME_HEIGHT);
 	}
 
-	void Render(int iFrameIndex) const noexcept
-	{
-		if (!m_Texture || iFrameIndex < 0 || iFrameIndex >= m_FrameCount) [[unlikely]]
-		{
-			std::println("No animated tile image loaded ({}) or invalid frame index ({}).", (GLuint)m_Texture, iFrameIndex);
-			return;
-		}
-
-		m_Canvas.Bind();
-
-		glActiveTexture(GL_TEXTURE0 + ANIMTILE_GL_TEXTURE_CHANNEL);
-		glBindTexture(GL_TEXTURE_2D, (GLuint)m_Texture);
-
-		g_pGlobalShader->Use();
-
-		static std::string szUniformName{
-			std::format("ourTexture{}", ANIMTILE_GL_TEXTURE_CHANNEL)
-		};
-		glUniform1i(glGetUniformLocation(g_pGlobalShader->m_ProgramId, szUniformName.c_str()), ANIMTILE_GL_TEXTURE_CHANNEL);
-
-		m_Painter.Paint(
-			6,				// technicall "(GLsizei)m_Painter.m_Indices.size() / m_FrameCount", but we know it's always 6.
-			iFrameIndex * 6	// Two triangles, 6 indices.
-		);
-		m_Canvas.Unbind();
-	}
-
-	[[nodiscard]] auto GetOutputTextureId() const noexcept -> GLuint { return m_Canvas.GetTextureId(); }
+	// Frames are not drawn anywhere, the tile atlas bakes each of them into a layer. Frame i is the U range [i, i + 1] / m_FrameCount.
+	[[nodiscard]] auto GetOutputTextureId() const noexcept -> GLuint { return (GLuint)m_Texture; }
 
 	[[nodiscard]] static constexpr auto GetOutputTextureDimension() noexcept -> std::pair<int, int> { return { FRAME_WIDTH, FRAME_HEIGHT }; }
 
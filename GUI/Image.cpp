@@ -11,138 +11,464 @@
 import std.compat;
 #endif
 
-// Function to load a tall texture into a texture array
-static auto LoadTextureArrayFromMemory(const void* data, long data_size, int target_height, bool bFlipY = false) noexcept
-	-> std::expected<std::tuple<std::uint32_t, int, int, int>, std::string_view>
-{
-	stbi_set_flip_vertically_on_load(bFlipY);
-
-	// Load the source image
-	int image_width = 0;
-	int image_height = 0;
-	auto const image_data = stbi_load_from_memory(
-		(const unsigned char*)data,
-		data_size,
-		&image_width,
-		&image_height,
-		nullptr,
-		4
-	);
+import UtlLog;
+import UtlMemory;
+import UtlTask;
+import UtlTrace;
+import GL.UploadRing;
+import Image.Decode;
+
+void FreeDecodedPixels(std::uint8_t* p) noexcept
+{
+	stbi_image_free(p);
+}
 
-	if (image_data == nullptr)
-		return std::unexpected("Failed to load image from memory");
+// One read per file. The header is parsed from the same bytes, so the caller can reject an image before paying for the decode.
+auto ReadImageFile(std::filesystem::path const& Path) noexcept -> std::expected<CEncodedImage, std::string_view>
+{
+	CTraceZone Zone{ "ReadImageFile", ELogCategory::Resource, Path };
+	CMemoryScope MemoryScope{ EMemoryTag::ImageDecode };
 
-	// Calculate how many layers we need
-	auto const layers_needed = (image_height + target_height - 1) / target_height; // Ceiling division
+	std::ifstream file{ Path, std::ios::binary | std::ios::ate };
+	if (!file)
+		return std::unexpected("Cannot open file");
 
-	decltype(glGetError()) iErrorCode{};
+	auto const file_size = static_cast<std::streamoff>(file.tellg());
+	if (file_size <= 0 || file_size > std::numeric_limits<int>::max())
+		return std::unexpected("Cannot retrieve file size");
+
+	CEncodedImage ret{ .m_Path = Path };
+	ret.m_Bytes.resize((std::size_t)file_size);
+
+	file.seekg(0, std::ios::beg);
+	if (!file.read(reinterpret_cast<char*>(ret.m_Bytes.data()), file_size))
+		return std::unexpected("Cannot read file");
+
+	if (!stbi_info_from_memory(ret.m_Bytes.data(), (int)ret.m_Bytes.size(), &ret.m_Width, &ret.m_Height, nullptr))
+		return std::unexpected("Unknown image format");
+
+	return ret;
+}
+
+auto ReadImageHeader(std::filesystem::path const& Path) noexcept -> std::expected<CEncodedImage, std::string_view>
+{
+	// PNG keeps its size in the first chunk. Formats that need more than this fall back to a full read.
+	static constexpr std::streamsize HEADER_BYTES = 4096;
+
+	std::ifstream file{ Path, std::ios::binary };
+	if (!file)
+		return std::unexpected("Cannot open file");
+
+	std::array<std::uint8_t, HEADER_BYTES> rgHeader{};
+	file.read(reinterpret_cast<char*>(rgHeader.data()), HEADER_BYTES);
+
+	CEncodedImage ret{ .m_Path = Path };
+	if (stbi_info_from_memory(rgHeader.data(), (int)file.gcount(), &ret.m_Width, &ret.m_Height, nullptr))
+		return ret;
+
+	if (file.gcount() < HEADER_BYTES)
+		return std::unexpected("Unknown image format");
+
+	return ReadImageFile(Path).transform([](CEncodedImage&& Encoded) static noexcept { Encoded.m_Bytes = {}; return std::move(Encoded); });
+}
 
-	// Create a OpenGL texture array
+auto DecodeImage(CEncodedImage const& Encoded, bool bFlipY) noexcept -> std::expected<CDecodedImage, std::string_view>
+{
+	CTraceZone Zone{ "Decode", ELogCategory::Resource, Encoded.m_Path };
+
+	// GL Y is different from image Y for the most of time.
+	// GL coord(0, 0) is the center, while image coord(0, 0) is the top-left corner.
+	stbi_set_flip_vertically_on_load_thread(bFlipY);
+
+	CDecodedImage ret{ .m_Path = Encoded.m_Path };
+	ret.m_Pixels.reset(
+		stbi_load_from_memory(
+			Encoded.m_Bytes.data(),
+			(int)Encoded.m_Bytes.size(),
+			&ret.m_Width,
+			&ret.m_Height,
+			nullptr,
+			4
+		)
+	);
+
+	if (!ret.m_Pixels)
+		return std::unexpected("Failed to decode image");
+
+	return ret;
+}
+
+// Storage only, nothing may be bound to GL_PIXEL_UNPACK_BUFFER. Leaves the texture bound.
+[[nodiscard]] static auto AllocateTextureArray(GLenum iInternalFormat, int iWidth, int iLayerHeight, int iLayers, std::int64_t iBytes) noexcept -> GLuint
+{
 	GLuint texture_array;
 	glGenTextures(1, &texture_array);
 	glBindTexture(GL_TEXTURE_2D_ARRAY, texture_array);
 
-	iErrorCode = glGetError();
-	assert(iErrorCode == GL_NO_ERROR);
-
 	// Setup filtering parameters
 	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
 	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-	iErrorCode = glGetError();
-	assert(iErrorCode == GL_NO_ERROR);
-
 	// Allocate the texture array storage
-	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, image_width, target_height, layers_needed, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	if (iInternalFormat == GL_RGBA)
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, iWidth, iLayerHeight, iLayers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	else
+		glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, 0, iInternalFormat, iWidth, iLayerHeight, iLayers, 0, (GLsizei)iBytes, nullptr);
 
-	iErrorCode = glGetError();
+	UTIL_GpuMemorySet(EGpuMemory::Textures, texture_array, iBytes);
+
+	[[maybe_unused]] auto const iErrorCode = glGetError();
 	assert(iErrorCode == GL_NO_ERROR);
 
-	// Upload each slice
-	for (int layer = 0; layer < layers_needed; ++layer)
-	{
-		auto const src_y_offset = layer * target_height;
-		auto const actual_height = std::min(target_height, image_height - src_y_offset);
-		
-		if (actual_height <= 0) break;
+	return texture_array;
+}
 
-		// Calculate the source data pointer for this layer
-		auto const layer_data = image_data + (src_y_offset * image_width * 4);
+// BC1 is only produced for opaque images, the RGB flavour keeps the 3 colours mode from punching holes.
+[[nodiscard]] static auto CompressedFormatOf(ECompressedFormat Format) noexcept -> GLenum
+{
+	return Format == ECompressedFormat::BC1 ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+}
 
-		// Upload this layer
-		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 
-					   0, 0, layer,                    // x, y, z offsets
-					   image_width, actual_height, 1, // width, height, depth
-					   GL_RGBA, GL_UNSIGNED_BYTE, layer_data);
+static void LogCompressedTileset(CCompressedImage const& Image, bool bFromDiskCache, float flUploadMilliseconds) noexcept
+{
+	auto const iRgbaBytes = (std::int64_t)Image.m_Width * Image.m_LayerHeight * Image.m_Layers * 4;
+
+	UTIL_LogInfo(ELogCategory::Resource, "Tileset '{}': {}, {}x{} in {} layers, {} -> {} ({:.1f}x), PSNR {:.1f} dB, encoded in {:.1f} ms{}, uploaded in {:.1f} ms",
+		Image.m_Path.filename().u8string(), Image.m_Format == ECompressedFormat::BC1 ? "BC1" : "BC3",
+		Image.m_Width, Image.m_Height, Image.m_Layers,
+		UTIL_MemoryFormatBytes(iRgbaBytes), UTIL_MemoryFormatBytes((std::int64_t)Image.m_Bytes),
+		(double)iRgbaBytes / (double)std::max<std::size_t>(Image.m_Bytes, 1),
+		Image.m_flPsnr, Image.m_flEncodeMilliseconds, bFromDiskCache ? " (disk cache)" : "",
+		flUploadMilliseconds
+	);
+}
+
+auto UploadTextureArray(CDecodedImage const& Image, int target_height) noexcept -> std::expected<std::tuple<std::uint32_t, int, int, int>, std::string_view>
+{
+	CTraceZone UploadZone{ "GL upload", ELogCategory::Render };
+
+	auto const image_width = Image.m_Width;
+	auto const image_height = Image.m_Height;
+	auto const image_data = Image.Data();
+
+	// Calculate how many layers we need
+	auto const layers_needed = (image_height + target_height - 1) / target_height; // Ceiling division
+	auto const full_layers = image_height / target_height;
+	auto const remaining_rows = image_height % target_height;
+
+	auto const texture_array = AllocateTextureArray(GL_RGBA, image_width, target_height, layers_needed, (std::int64_t)image_width * target_height * layers_needed * 4);
+
+	decltype(glGetError()) iErrorCode{};
+
+	// The source rows are contiguous, layer after layer: all the full layers in one call.
+	if (full_layers > 0)
+	{
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0,
+					   0, 0, 0,                                // x, y, z offsets
+					   image_width, target_height, full_layers, // width, height, depth
+					   GL_RGBA, GL_UNSIGNED_BYTE, image_data);
 
 		iErrorCode = glGetError();
 		assert(iErrorCode == GL_NO_ERROR);
+	}
+
+	// The last layer is partial, the rest of it is filled with transparent pixels
+	if (remaining_rows > 0)
+	{
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0,
+					   0, 0, full_layers,
+					   image_width, remaining_rows, 1,
+					   GL_RGBA, GL_UNSIGNED_BYTE, image_data + (std::size_t)full_layers * target_height * image_width * 4);
 
-		// If this layer is smaller than target_height, we can fill the rest with transparent pixels
-		if (actual_height < target_height)
+		if (GLEW_ARB_clear_texture)
+		{
+			// A null clear value is zero, no buffer to allocate.
+			glClearTexSubImage(texture_array, 0,
+							   0, remaining_rows, full_layers,
+							   image_width, target_height - remaining_rows, 1,
+							   GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		}
+		else
 		{
-			// Create a buffer of transparent pixels
-			std::vector<unsigned char> transparent_pixels(image_width * (target_height - actual_height) * 4, 0);
-			
+			std::vector<unsigned char> transparent_pixels((std::size_t)image_width * (target_height - remaining_rows) * 4, 0);
+
 			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0,
-						   0, actual_height, layer,                    // x, y, z offsets
-						   image_width, target_height - actual_height, 1, // width, height, depth
+						   0, remaining_rows, full_layers,
+						   image_width, target_height - remaining_rows, 1,
 						   GL_RGBA, GL_UNSIGNED_BYTE, transparent_pixels.data());
+		}
 
-			iErrorCode = glGetError();
-			assert(iErrorCode == GL_NO_ERROR);
+		iErrorCode = glGetError();
+		assert(iErrorCode == GL_NO_ERROR);
+	}
+
+	return std::tuple{ texture_array, image_width, image_height, layers_needed };
+}
+
+auto UploadCompressedTextureArray(CCompressedImage const& Image) noexcept -> std::expected<std::tuple<std::uint32_t, int, int, int>, std::string_view>
+{
+	CTraceZone UploadZone{ "GL upload", ELogCategory::Render };
+
+	if (!GLEW_EXT_texture_compression_s3tc)
+		return std::unexpected("EXT_texture_compression_s3tc not supported");
+
+	auto const iInternalFormat = CompressedFormatOf(Image.m_Format);
+
+	// Block padded, the width of a tileset is already a multiple of 4.
+	auto const texture_array = AllocateTextureArray(iInternalFormat, Image.m_Width, Image.m_LayerHeight, Image.m_Layers, (std::int64_t)Image.m_Bytes);
+
+	// All layers at once, the padding of the last one was encoded as transparent blocks.
+	glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0,
+		0, 0, 0,
+		Image.m_Width, Image.m_LayerHeight, Image.m_Layers,
+		iInternalFormat, (GLsizei)Image.m_Bytes, Image.Data());
+
+	[[maybe_unused]] auto const iErrorCode = glGetError();
+	assert(iErrorCode == GL_NO_ERROR);
+
+	return std::tuple{ texture_array, Image.m_Width, Image.m_Height, Image.m_Layers };
+}
+
+auto UploadEncodedTextureArray(CEncodedImage const& Encoded, int target_height, bool bFlipY) noexcept -> std::expected<std::tuple<std::uint32_t, int, int, int>, std::string_view>
+{
+	if (IsTextureCompressionEnabled() && GLEW_EXT_texture_compression_s3tc)
+	{
+		auto const Compressed = CompressTextureArrayCached(Encoded, target_height, bFlipY);
+
+		if (Compressed)
+		{
+			auto const UploadStart = std::chrono::steady_clock::now();
+			auto ret = UploadCompressedTextureArray(*Compressed);
+			auto const flUploadMilliseconds = std::chrono::duration<float, std::milli>{ std::chrono::steady_clock::now() - UploadStart }.count();
+
+			if (ret)
+			{
+				LogCompressedTileset(*Compressed, Compressed->m_pMapping != nullptr, flUploadMilliseconds);
+				return ret;
+			}
+
+			UTIL_LogWarning(ELogCategory::Resource, "Tileset '{}' falls back to RGBA: {}", Encoded.m_Path.filename().u8string(), ret.error());
 		}
+		else
+			UTIL_LogWarning(ELogCategory::Resource, "Tileset '{}' falls back to RGBA: {}", Encoded.m_Path.filename().u8string(), Compressed.error());
 	}
 
-	stbi_image_free(image_data);
+	return DecodeImageCached(Encoded, bFlipY)
+		.and_then([&](CDecodedImage const& Decoded) noexcept { return UploadTextureArray(Decoded, target_height); });
+}
 
-	return std::tuple{ texture_array, image_width, image_height, layers_needed };
+// Worker side: the texels go into the ring, layer padding included, so that the GL thread issues a single copy.
+static void StreamDecoded(CGlUploadRing& Ring, CDecodedImage Image, int target_height, fnTextureArrayDone_t fnDone) noexcept
+{
+	auto const iLayers = (Image.m_Height + target_height - 1) / target_height;
+	auto const iBytes = (std::size_t)Image.m_Width * target_height * iLayers * 4;
+	auto const Slice = Ring.Reserve(iBytes);
+
+	if (!Slice)
+	{
+		// Larger than the ring or no ring at all, the GL thread uploads it from client memory in one go.
+		auto const iImageBytes = (std::size_t)Image.m_Width * Image.m_Height * 4;
+		Ring.Post(iImageBytes, [Image = std::move(Image), target_height, fnDone = std::move(fnDone)]() mutable noexcept { fnDone(UploadTextureArray(Image, target_height)); });
+		return;
+	}
+
+	auto const iImageBytes = (std::size_t)Image.m_Width * Image.m_Height * 4;
+	std::memcpy(Slice->m_Bytes.data(), Image.Data(), iImageBytes);
+	std::memset(Slice->m_Bytes.data() + iImageBytes, 0, iBytes - iImageBytes);	// Transparent
+
+	Ring.Submit(*Slice,
+		[iWidth = Image.m_Width, iHeight = Image.m_Height, target_height, iLayers, iBytes, fnDone = std::move(fnDone)](std::uint32_t iBuffer, std::size_t iOffset) mutable noexcept
+		{
+			CTraceZone UploadZone{ "GL upload", ELogCategory::Render };
+
+			auto const texture_array = AllocateTextureArray(GL_RGBA, iWidth, target_height, iLayers, (std::int64_t)iBytes);
+
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, iBuffer);
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, iWidth, target_height, iLayers, GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<void const*>(iOffset));
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+			fnDone(std::tuple{ texture_array, iWidth, iHeight, iLayers });
+		}
+	);
 }
 
-// Wrapper function for loading from file
-auto LoadTextureArrayFromFile(const wchar_t* file_name, int target_height, bool bFlipY = false) noexcept -> std::expected<std::tuple<std::uint32_t, int, int, int>, std::string_view>
+static void StreamCompressed(CGlUploadRing& Ring, CCompressedImage Image, fnTextureArrayDone_t fnDone) noexcept
 {
-	auto f = _wfopen(file_name, L"rb");
-	if (f == nullptr)
-		return std::unexpected("Cannot open file");
+	auto const bFromDiskCache = Image.m_pMapping != nullptr;
+	auto const Slice = Ring.Reserve(Image.m_Bytes);
 
-	fseek(f, 0, SEEK_END);
-	auto const file_size = ftell(f);
-	if (file_size < 0)
-		return std::unexpected("Cannot retrieve file size");
+	if (!Slice)
+	{
+		auto const iBytes = Image.m_Bytes;
+		Ring.Post(iBytes,
+			[Image = std::move(Image), bFromDiskCache, fnDone = std::move(fnDone)]() mutable noexcept
+			{
+				auto const UploadStart = std::chrono::steady_clock::now();
+				auto const ret = UploadCompressedTextureArray(Image);
+
+				if (ret)
+					LogCompressedTileset(Image, bFromDiskCache, std::chrono::duration<float, std::milli>{ std::chrono::steady_clock::now() - UploadStart }.count());
+
+				fnDone(ret);
+			}
+		);
+		return;
+	}
+
+	std::memcpy(Slice->m_Bytes.data(), Image.Data(), Image.m_Bytes);
+
+	// Only the description is left to carry to the GL thread.
+	Image.m_Blocks = {};
+	Image.m_pMapping.reset();
+	Image.m_pMappedBlocks = nullptr;
+
+	Ring.Submit(*Slice,
+		[Image = std::move(Image), bFromDiskCache, fnDone = std::move(fnDone)](std::uint32_t iBuffer, std::size_t iOffset) mutable noexcept
+		{
+			CTraceZone UploadZone{ "GL upload", ELogCategory::Render };
+
+			auto const UploadStart = std::chrono::steady_clock::now();
+			auto const iInternalFormat = CompressedFormatOf(Image.m_Format);
+			auto const texture_array = AllocateTextureArray(iInternalFormat, Image.m_Width, Image.m_LayerHeight, Image.m_Layers, (std::int64_t)Image.m_Bytes);
 
-	fseek(f, 0, SEEK_SET);
-	auto file_data = std::make_unique<std::byte[]>((size_t)file_size);
-	fread(file_data.get(), 1, (size_t)file_size, f);
-	fclose(f);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, iBuffer);
+			glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0,
+				0, 0, 0,
+				Image.m_Width, Image.m_LayerHeight, Image.m_Layers,
+				iInternalFormat, (GLsizei)Image.m_Bytes, reinterpret_cast<void const*>(iOffset));
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-	return LoadTextureArrayFromMemory(file_data.get(), file_size, target_height, bFlipY);
+			LogCompressedTileset(Image, bFromDiskCache, std::chrono::duration<float, std::milli>{ std::chrono::steady_clock::now() - UploadStart }.count());
+			fnDone(std::tuple{ texture_array, Image.m_Width, Image.m_Height, Image.m_Layers });
+		}
+	);
 }
 
-// Simple helper function to load an image into a OpenGL texture with common settings
-static auto LoadTextureFromMemory(const void* data, long data_size, bool bFlipY = false) noexcept
-	-> std::expected<std::tuple<std::uint32_t, int, int>, std::string_view>
+void StreamTextureArray(std::filesystem::path Path, int target_height, bool bFlipY, fnTextureArrayDone_t fnDone) noexcept
 {
-	// GL Y is different from image Y for the most of time.
-	// GL coord(0, 0) is the center, while image coord(0, 0) is the top-left corner.
-	stbi_set_flip_vertically_on_load(bFlipY);
-
-	// Load from file
-	int image_width = 0;
-	int image_height = 0;
-	auto const image_data = stbi_load_from_memory(
-		(const unsigned char*)data,
-		data_size,
-		&image_width,
-		&image_height,
-		nullptr,
-		4
+	UTIL_ThreadPool().Submit(
+		[Path = std::move(Path), target_height, bFlipY, fnDone = std::move(fnDone)]() mutable noexcept
+		{
+			CTraceZone Zone{ "StreamTextureArray", ELogCategory::Resource, Path };
+
+			CUploadRingLease const Lease{};
+
+			if (!Lease) [[unlikely]]
+				return;	// Shutting down.
+
+			auto& Ring = *Lease;
+			auto const fnFail = [&](std::string_view szError) noexcept
+			{
+				Ring.Post(0, [fnDone = std::move(fnDone), szError]() mutable noexcept { fnDone(std::unexpected(szError)); });
+			};
+
+			auto const Encoded = ReadImageFile(Path);
+
+			if (!Encoded) [[unlikely]]
+				return fnFail(Encoded.error());
+
+			if (IsTextureCompressionEnabled() && GLEW_EXT_texture_compression_s3tc)
+			{
+				if (auto Compressed = CompressTextureArrayCached(*Encoded, target_height, bFlipY))
+					return StreamCompressed(Ring, std::move(*Compressed), std::move(fnDone));
+				else
+					UTIL_LogWarning(ELogCategory::Resource, "Tileset '{}' falls back to RGBA: {}", Path.filename().u8string(), Compressed.error());
+			}
+
+			auto Decoded = DecodeImageCached(*Encoded, bFlipY);
+
+			if (!Decoded) [[unlikely]]
+				return fnFail(Decoded.error());
+
+			StreamDecoded(Ring, std::move(*Decoded), target_height, std::move(fnDone));
+		}
+	);
+}
+
+// Worker side of StreamTexture(), same texture parameters as UploadTexture().
+static void StreamDecodedTexture(CGlUploadRing& Ring, CDecodedImage Image, fnTextureDone_t fnDone) noexcept
+{
+	auto const iBytes = (std::size_t)Image.m_Width * Image.m_Height * 4;
+	auto const Slice = Ring.Reserve(iBytes);
+
+	if (!Slice)
+	{
+		Ring.Post(iBytes, [Image = std::move(Image), fnDone = std::move(fnDone)]() mutable noexcept { fnDone(UploadTexture(Image)); });
+		return;
+	}
+
+	std::memcpy(Slice->m_Bytes.data(), Image.Data(), iBytes);
+
+	Ring.Submit(*Slice,
+		[iWidth = Image.m_Width, iHeight = Image.m_Height, fnDone = std::move(fnDone)](std::uint32_t iBuffer, std::size_t iOffset) mutable noexcept
+		{
+			CTraceZone UploadZone{ "GL upload", ELogCategory::Render };
+
+			GLuint texture{};
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, iBuffer);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, iWidth, iHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<void const*>(iOffset));
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			UTIL_GpuMemorySet(EGpuMemory::Textures, texture, (std::int64_t)iWidth * iHeight * 4);
+
+			fnDone(std::tuple{ texture, iWidth, iHeight });
+		}
 	);
+}
+
+void StreamTexture(std::filesystem::path Path, bool bFlipY, fnPixelTransform_t pfnTransform, fnTextureDone_t fnDone) noexcept
+{
+	UTIL_ThreadPool().Submit(
+		[Path = std::move(Path), bFlipY, pfnTransform, fnDone = std::move(fnDone)]() mutable noexcept
+		{
+			CTraceZone Zone{ "StreamTexture", ELogCategory::Resource, Path };
+
+			CUploadRingLease const Lease{};
+
+			if (!Lease) [[unlikely]]
+				return;	// Shutting down.
+
+			auto& Ring = *Lease;
 
-	if (image_data == nullptr)
-		return std::unexpected("Fail to load to memory");
+			auto Decoded = ReadImageFile(Path)
+				.and_then([&](CEncodedImage const& Encoded) noexcept { return DecodeImageCached(Encoded, bFlipY); });
+
+			if (Decoded && pfnTransform)
+				Decoded = Decoded.and_then(pfnTransform);
+
+			if (!Decoded) [[unlikely]]
+			{
+				Ring.Post(0, [fnDone = std::move(fnDone), szError = Decoded.error()]() mutable noexcept { fnDone(std::unexpected(szError)); });
+				return;
+			}
+
+			StreamDecodedTexture(Ring, std::move(*Decoded), std::move(fnDone));
+		}
+	);
+}
+
+// Wrapper function for loading from file
+auto LoadTextureArrayFromFile(const wchar_t* file_name, int target_height, bool bFlipY = false) noexcept -> std::expected<std::tuple<std::uint32_t, int, int, int>, std::string_view>
+{
+	CTraceZone Zone{ "LoadTextureArrayFromFile", ELogCategory::Resource, std::filesystem::path{ file_name } };
+
+	return ReadImageFile(file_name)
+		.and_then([&](CEncodedImage const& Encoded) noexcept { return UploadEncodedTextureArray(Encoded, target_height, bFlipY); });
+}
+
+// Simple helper function to load an image into a OpenGL texture with common settings
+auto UploadTexture(CDecodedImage const& Image) noexcept -> std::expected<std::tuple<std::uint32_t, int, int>, std::string_view>
+{
+	CTraceZone UploadZone{ "GL upload", ELogCategory::Render };
 
 	decltype(glGetError()) iErrorCode{};
 
@@ -170,63 +496,21 @@ static auto LoadTextureFromMemory(const void* data, long data_size, bool bFlipY
 
 	// Upload pixels into texture
 	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image_width, image_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image_data);
-	stbi_image_free(image_data);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, Image.m_Width, Image.m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, Image.Data());
+	UTIL_GpuMemorySet(EGpuMemory::Textures, image_texture, (std::int64_t)Image.m_Width * Image.m_Height * 4);
 
 	iErrorCode = glGetError();
 	//assert(iErrorCode == GL_NO_ERROR);
 
-	return std::tuple{ image_texture, image_width, image_height, };
+	return std::tuple{ image_texture, Image.m_Width, Image.m_Height, };
 }
 
-// Open and read a file, then forward to LoadTextureFromMemory()
+// Open and read a file, then forward to UploadTexture()
 auto LoadTextureFromFile(const wchar_t* file_name, bool bFlipY) noexcept -> std::expected<std::tuple<std::uint32_t, int, int>, std::string_view>
 {
-	auto f = _wfopen(file_name, L"rb");
-	if (f == nullptr)
-		return std::unexpected("Cannot open file");
-
-	fseek(f, 0, SEEK_END);
-	auto const file_size = ftell(f);
-	if (file_size < 0)
-		return std::unexpected("Cannot retrieve file size");
-
-	fseek(f, 0, SEEK_SET);
-	auto file_data = std::make_unique<std::byte[]>((size_t)file_size);
-	fread(file_data.get(), 1, (size_t)file_size, f);
-	fclose(f);
-
-	return LoadTextureFromMemory(file_data.get(), file_size, bFlipY);
-}
-
-auto GetTextureDimensions(const wchar_t* file_name) noexcept -> std::pair<int, int>
-{
-	std::ifstream file{ file_name, std::ios::binary };
-
-	if (!file.is_open()) [[unlikely]]
-	{
-		std::filesystem::path const FilePath{ file_name };
-		std::cerr << "Error: Could not open file " << FilePath.u8string() << std::endl;
-		return { 0, 0 };
-	}
-
-	static constexpr unsigned char PNG_SIGNATURE[8] = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
-	unsigned char signature[8]{};
-	file.read(reinterpret_cast<char*>(signature), sizeof(signature));
-
-	if (std::memcmp(signature, PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) != 0)	[[unlikely]]
-	{
-		std::cerr << "Error: Not a valid PNG file." << std::endl;
-		return { 0, 0 };
-	}
-
-	file.seekg(16, std::ios::beg);	// PNG width and height are stored at offset 16
-
-	unsigned char buf[8]{};
-	file.read(reinterpret_cast<char*>(&buf), 8);
-
-	std::uint32_t iWidth = (buf[0] << 24) + (buf[1] << 16) + (buf[2] << 8) + (buf[3] << 0);
-	std::uint32_t iHeight = (buf[4] << 24) + (buf[5] << 16) + (buf[6] << 8) + (buf[7] << 0);
+	CTraceZone Zone{ "LoadTextureFromFile", ELogCategory::Resource, std::filesystem::path{ file_name } };
 
-	return { std::bit_cast<int>(iWidth), std::bit_cast<int>(iHeight) };
+	return ReadImageFile(file_name)
+		.and_then([&](CEncodedImage const& Encoded) noexcept { return DecodeImageCached(Encoded, bFlipY); })
+		.and_then([](CDecodedImage const& Decoded) noexcept { return UploadTexture(Decoded); });
 }
@@ -9,6 +9,7 @@
 import std.compat;
 #endif
 
+import Image.Cache;
 import Image.Resources;
 import Image.Tilesets;
 
@@ -29,16 +30,26 @@ void Window::AutoTiles() noexcept
 			if (ImGui::Selectable(szName.c_str(), s_pSelectedAutoTile == &AutoTile))
 				s_pSelectedAutoTile = &AutoTile;
 
+			// Hovering is what loads the image, expanded on the pool.
 			if (ImGui::BeginItemTooltip())
 			{
-				AutoTile.Render();
+				if (!AutoTile.Request())
+					ImGui::TextDisabled("Loading %s", AutoTile.m_Path.filename().u8string().c_str());
+				else if (auto const pImage = AutoTile.Get())
+				{
+					// Expanded once when loaded, the frames are stacked top to bottom.
+					auto const [iWidth, iHeight] = pImage->GetOutputTextureDimension();
+					auto const iFrame = (int)(glfwGetTime() * 10) % pImage->m_FrameCount;
 
-				ImGui::Image(
-					AutoTile.m_Canvas.GetTextureId(),
-					{ (float)AutoTile.m_Canvas.m_Width * 2.f, (float)AutoTile.m_Canvas.m_Height * 2.f },
-					{ 0, 1 },
-					{ 1, 0 }
-				);
+					ImGui::Image(
+						pImage->GetOutputTextureId(),
+						{ (float)iWidth * 2.f, (float)iHeight * 2.f },
+						{ 0, (float)iFrame / (float)pImage->m_FrameCount },
+						{ 1, (float)(iFrame + 1) / (float)pImage->m_FrameCount }
+					);
+				}
+				else
+					ImGui::TextDisabled("Cannot load %s", AutoTile.m_Path.filename().u8string().c_str());
 
 				ImGui::EndTooltip();
 			}
@@ -52,14 +63,21 @@ void Window::AutoTiles() noexcept
 
 			if (ImGui::BeginItemTooltip())
 			{
-				AnimatedTile.Render((int)(glfwGetTime() * 10) % AnimatedTile.m_FrameCount);
+				if (auto const pImage = AnimatedTile.Get())
+				{
+					// The frames are side by side in the source texture.
+					auto const [iWidth, iHeight] = pImage->GetOutputTextureDimension();
+					auto const iFrame = (int)(glfwGetTime() * 10) % pImage->m_FrameCount;
 
-				ImGui::Image(
-					AnimatedTile.m_Canvas.GetTextureId(),
-					{ (float)AnimatedTile.m_Canvas.m_Width * 2.f, (float)AnimatedTile.m_Canvas.m_Height * 2.f },
-					{ 0, 1 },
-					{ 1, 0 }
-				);
+					ImGui::Image(
+						pImage->GetOutputTextureId(),
+						{ (float)iWidth * 2.f, (float)iHeight * 2.f },
+						{ (float)iFrame / (float)pImage->m_FrameCount, 0 },
+						{ (float)(iFrame + 1) / (float)pImage->m_FrameCount, 1 }
+					);
+				}
+				else
+					ImGui::TextDisabled("Cannot load %s", AnimatedTile.m_Path.filename().u8string().c_str());
 
 				ImGui::EndTooltip();
 			}
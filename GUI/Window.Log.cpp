@@ -0,0 +1,99 @@
+#include <imgui.h>
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import UtlLog;
+
+namespace Window
+{
+	void Log() noexcept
+	{
+		static std::vector<CLogEntry> rgEntries{};
+		static std::uint64_t iNextSequence{};
+
+		// Polling the history is one lock per frame, the producers never see it.
+		iNextSequence = UTIL_LogCopy(&rgEntries, iNextSequence);
+
+		if (rgEntries.size() > 16384)
+			rgEntries.erase(rgEntries.begin(), rgEntries.end() - 8192);
+
+		if (!ImGui::Begin("Log"))
+		{
+			ImGui::End();
+			return;
+		}
+
+		static int iMinLevel = (int)ELogLevel::Info;
+		static std::array<bool, (std::size_t)ELogCategory::COUNT> rgbCategories{ true, true, true, true };
+		static ImGuiTextFilter Filter{};
+		static bool bAutoScroll = true;
+
+		ImGui::SetNextItemWidth(100);
+		ImGui::Combo("##Level", &iMinLevel, "Trace\0Info\0Warning\0Error\0");
+
+		for (auto&& [idx, bShow] : std::views::enumerate(rgbCategories))
+		{
+			ImGui::SameLine();
+			ImGui::Checkbox(UTIL_LogCategoryName((ELogCategory)idx).data(), &bShow);
+		}
+
+		ImGui::SameLine();
+		ImGui::Checkbox("Auto-scroll", &bAutoScroll);
+		ImGui::SameLine();
+		if (ImGui::Button("Clear"))
+			rgEntries.clear();
+
+		Filter.Draw("Filter", 200);
+		ImGui::Separator();
+
+		static std::vector<CLogEntry const*> rgpVisible{};
+		rgpVisible.clear();
+
+		for (auto&& Entry : rgEntries)
+		{
+			if ((int)Entry.m_Level >= iMinLevel
+				&& rgbCategories[(std::size_t)Entry.m_Category]
+				&& Filter.PassFilter(Entry.m_Text.data(), Entry.m_Text.data() + Entry.m_Text.size()))
+			{
+				rgpVisible.push_back(&Entry);
+			}
+		}
+
+		if (ImGui::BeginChild("##LogScroll", {}, ImGuiChildFlags_None, ImGuiWindowFlags_HorizontalScrollbar))
+		{
+			static constexpr std::array LevelColors{
+				ImVec4{ 0.6f, 0.6f, 0.6f, 1 }, ImVec4{ 1, 1, 1, 1 }, ImVec4{ 1, 0.8f, 0.3f, 1 }, ImVec4{ 1, 0.4f, 0.4f, 1 },
+			};
+
+			ImGuiListClipper Clipper{};
+			Clipper.Begin((int)rgpVisible.size());
+
+			while (Clipper.Step())
+			{
+				for (int i = Clipper.DisplayStart; i < Clipper.DisplayEnd; ++i)
+				{
+					auto const pEntry = rgpVisible[i];
+					auto const szLine = pEntry->m_Suppressed
+						? std::format("[{:8.3f}] [{}] [T{}] {} (+{} similar suppressed)", pEntry->m_Time, UTIL_LogCategoryName(pEntry->m_Category), pEntry->m_Thread, pEntry->m_Text, pEntry->m_Suppressed)
+						: std::format("[{:8.3f}] [{}] [T{}] {}", pEntry->m_Time, UTIL_LogCategoryName(pEntry->m_Category), pEntry->m_Thread, pEntry->m_Text);
+
+					ImGui::PushStyleColor(ImGuiCol_Text, LevelColors[(std::size_t)pEntry->m_Level]);
+					ImGui::TextUnformatted(szLine.c_str());
+					ImGui::PopStyleColor();
+				}
+			}
+
+			if (bAutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+				ImGui::SetScrollHereY(1.0f);
+		}
+		ImGui::EndChild();
+
+		ImGui::End();
+	}
+}
@@ -8,14 +8,18 @@
 import std.compat;
 #endif
 
+import UtlLog;
+
 import Database.RX;
 import GL.GameMap;
 import Game.Map;
+import Game.Tilesets;
 import Image.Query;
 import Image.Tilesets;
 
 
 static std::optional<CMap> s_MapOnDisplay = std::nullopt;
+static Database::RX::MapInfo const* s_pMapPending = nullptr;	// Clicked, its tileset images are still streaming.
 
 static void DrawTree(Database::RX::MapInfo const& info, int bitsFlags = ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_DrawLinesToNodes) noexcept
 {
@@ -26,7 +30,7 @@ static void DrawTree(Database::RX::MapInfo const& info, int bitsFlags = ImGuiTre
 	{
 		ImGui::TreeNodeEx(szDisplayName, bitsFlags | ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_Bullet | ImGuiTreeNodeFlags_NoTreePushOnOpen);
 		if (ImGui::IsItemClicked())
-			s_MapOnDisplay.emplace(&info);
+			s_pMapPending = &info;
 	}
 	else
 	{
@@ -49,7 +53,7 @@ static void DrawTree(Database::RX::MapInfo const& info, int bitsFlags = ImGuiTre
 			}
 			else
 			{
-				s_MapOnDisplay.emplace(&info);
+				s_pMapPending = &info;
 			}
 		}
 
@@ -83,9 +87,19 @@ namespace Window
 
 	void MapDisplay() noexcept
 	{
+		// The map is only built once every image of its tileset is in, the frames in between keep drawing.
+		if (s_pMapPending && Game::Tilesets.at(s_pMapPending->m_pMapDatum->m_tileset_id).RequestAll())
+		{
+			s_MapOnDisplay.emplace(std::exchange(s_pMapPending, nullptr));
+		}
+
 		if (ImGui::Begin("Map Display", nullptr, ImGuiWindowFlags_HorizontalScrollbar))
 		{
-			if (s_MapOnDisplay)
+			if (s_pMapPending)
+			{
+				ImGui::TextUnformatted("Loading tileset...");
+			}
+			else if (s_MapOnDisplay)
 			{
 				if (ImGui::Button("Export Map"))
 				{
@@ -93,9 +107,9 @@ namespace Window
 						std::format("Map{0:0>3}_{1}.png", s_MapOnDisplay->m_pMapDatum->m_id, s_MapOnDisplay->m_Name);	// #UPDATE_AT_CPP26 formatting fs::path
 
 					if (s_MapOnDisplay->m_GameMap.m_Canvas.SaveToFile(szPath))
-						std::println("Map exported to '{}'.", szPath);
+						UTIL_LogInfo(ELogCategory::General, "Map exported to '{}'.", szPath);
 					else
-						std::println("Failed to export map to '{}'.", szPath);
+						UTIL_LogError(ELogCategory::General, "Failed to export map to '{}'.", szPath);
 				}
 
 				static float s_flZoom = 1.f;
@@ -109,6 +123,8 @@ namespace Window
 
 				ImGui::SeparatorText("Preview");
 
+				s_MapOnDisplay->Animate((float)ImGui::GetTime());
+
 				// Remember that the texture rendered by OpenGL is upside down.
 				ImGui::Image(
 					s_MapOnDisplay->GetTextureId(),
@@ -0,0 +1,114 @@
+#include <imgui.h>
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import UtlMemory;
+import Image.Cache;
+import Image.Decode;
+
+namespace Window
+{
+	static void MemoryRow(std::string_view szName, CMemoryStat const& Stat) noexcept
+	{
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(szName.data(), szName.data() + szName.size());
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(UTIL_MemoryFormatBytes(Stat.m_Live).c_str());
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(UTIL_MemoryFormatBytes(Stat.m_Peak).c_str());
+		ImGui::TableNextColumn();
+		ImGui::Text("%llu", (unsigned long long)Stat.m_Allocations);
+	}
+
+	static void MemoryTable(char const* pszCountColumn, char const* pszFirstColumn) noexcept
+	{
+		ImGui::TableSetupColumn(pszFirstColumn);
+		ImGui::TableSetupColumn("Live");
+		ImGui::TableSetupColumn("Peak");
+		ImGui::TableSetupColumn(pszCountColumn);
+		ImGui::TableHeadersRow();
+	}
+
+	void Memory() noexcept
+	{
+		if (!ImGui::Begin("Memory"))
+		{
+			ImGui::End();
+			return;
+		}
+
+		if (ImGui::Button("Reset peaks"))
+			UTIL_MemoryResetPeaks();
+
+		ImGui::SameLine();
+		ImGui::TextDisabled("Allocations made on worker threads of parallel algorithms count as Untagged.");
+
+		static constexpr auto TABLE_FLAGS = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchProp;
+
+		if (ImGui::BeginTable("##Host", 4, TABLE_FLAGS))
+		{
+			MemoryTable("Allocations", "Host");
+
+			CMemoryStat Total{};
+			for (std::size_t i = 0; i < (std::size_t)EMemoryTag::COUNT; ++i)
+			{
+				auto const Stat = UTIL_MemoryStat((EMemoryTag)i);
+				MemoryRow(UTIL_MemoryTagName((EMemoryTag)i), Stat);
+
+				Total.m_Live += Stat.m_Live;
+				Total.m_Peak += Stat.m_Peak;
+				Total.m_Allocations += Stat.m_Allocations;
+			}
+
+			// Sum of the per tag peaks, an upper bound of the real peak.
+			MemoryRow("Total", Total);
+
+			ImGui::EndTable();
+		}
+
+		if (ImGui::BeginTable("##Gpu", 4, TABLE_FLAGS))
+		{
+			MemoryTable("Uploads", "GPU");
+
+			for (std::size_t i = 0; i < (std::size_t)EGpuMemory::COUNT; ++i)
+				MemoryRow(UTIL_GpuMemoryName((EGpuMemory)i), UTIL_GpuMemoryStat((EGpuMemory)i));
+
+			ImGui::EndTable();
+		}
+
+		ImGui::SeparatorText("Texture cache");
+
+		auto const Cache = PokemonEssentials::Resources::TextureCacheStat();
+
+		if (int iBudgetMiB = (int)(Cache.m_Budget >> 20); ImGui::SliderInt("Budget", &iBudgetMiB, 16, 4096, "%d MiB", ImGuiSliderFlags_Logarithmic))
+			PokemonEssentials::Resources::SetTextureBudget((std::int64_t)iBudgetMiB << 20);
+
+		ImGui::Text("%s resident in %zu images, %llu loads, %llu evictions.",
+			UTIL_MemoryFormatBytes(Cache.m_Bytes).c_str(), Cache.m_Resident,
+			(unsigned long long)Cache.m_Loads, (unsigned long long)Cache.m_Evictions);
+
+		// Average per image, hits against misses is the warm start against the cold one.
+		if (bool bDiskCache = IsImageDiskCacheEnabled(); ImGui::Checkbox("Disk cache of decoded images", &bDiskCache))
+			SetImageDiskCacheEnabled(bDiskCache);
+
+		ImGui::SameLine();
+		if (bool bCompression = IsTextureCompressionEnabled(); ImGui::Checkbox("BC1/BC3 tilesets", &bCompression))
+			SetTextureCompressionEnabled(bCompression);
+		ImGui::SetItemTooltip("Applies to tilesets loaded from now on. One report per tileset goes to the log.");
+
+		auto const Disk = ImageDiskCacheStat();
+		ImGui::Text("%llu hits, %.2f ms avg. %llu misses, %.2f ms avg. %llu stale blobs removed.",
+			(unsigned long long)Disk.m_Hits, Disk.m_Hits ? Disk.m_HitMilliseconds / (double)Disk.m_Hits : 0.0,
+			(unsigned long long)Disk.m_Misses, Disk.m_Misses ? Disk.m_MissMilliseconds / (double)Disk.m_Misses : 0.0,
+			(unsigned long long)Disk.m_StaleRemoved);
+
+		ImGui::End();
+	}
+}
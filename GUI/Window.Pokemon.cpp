@@ -9,8 +9,9 @@ import std.compat;
 #endif
 
 import Database.PBS;
+import Database.PBS.Search;
 
-static std::vector<decltype(Database::PBS::Species)::value_type const*> s_NationalPokeDex;
+static std::vector<Database::PBS::CPokemonSpecies const*> s_NationalPokeDex;
 
 namespace Window
 {
@@ -24,26 +25,68 @@ namespace Window
 
 		if (s_NationalPokeDex.empty())
 		{
-			s_NationalPokeDex.reserve(Database::PBS::Species.size());
+			s_NationalPokeDex.reserve(Database::PBS::Species.m_NameIndex.size());
 			s_NationalPokeDex.append_range(
 				Database::PBS::Species
+				| std::views::filter([](auto& a) static noexcept { return a.m_FormId == 0; })
 				| std::views::transform([](auto& a) static noexcept { return std::addressof(a); })
 			);
 
 			std::ranges::sort(
 				s_NationalPokeDex,
 				{},
-				[](auto&& a) static noexcept { return a->second.begin()->second.m_NationalDex; }
+				&Database::PBS::CPokemonSpecies::m_NationalDex
 			);
 		}
 
+		static char szQuery[128]{};
+		static std::vector<Database::PBS::CSearchHit> rgHits{};
+		static std::chrono::duration<double, std::micro> SearchTime{};
+
+		if (ImGui::InputTextWithHint("##Search", "Search species, moves, abilities and items", szQuery, std::size(szQuery)))
+		{
+			auto const t0 = std::chrono::high_resolution_clock::now();
+			rgHits = Database::PBS::Search(szQuery);
+			SearchTime = std::chrono::high_resolution_clock::now() - t0;
+		}
+
+		if (szQuery[0] != '\0')
+		{
+			ImGui::Text("%zu hits in %.1f us", rgHits.size(), SearchTime.count());
+			ImGui::Separator();
+
+			for (auto&& Hit : rgHits)
+			{
+				using namespace Database::PBS;
+
+				static constexpr std::array KindNames{ "Species", "Move", "Ability", "Item" };
+				std::string_view szId{}, szName{};
+
+				switch (Hit.m_Kind)
+				{
+				case ERecordKind::Species: szId = Species.m_Records[Hit.m_Record].m_Id; szName = Species.m_Records[Hit.m_Record].m_Name; break;
+				case ERecordKind::Move: szId = Moves.m_Records[Hit.m_Record].m_Id; szName = Moves.m_Records[Hit.m_Record].m_Name; break;
+				case ERecordKind::Ability: szId = Abilities.m_Records[Hit.m_Record].m_Id; szName = Abilities.m_Records[Hit.m_Record].m_Name; break;
+				case ERecordKind::Item: szId = Items.m_Records[Hit.m_Record].m_Id; szName = Items.m_Records[Hit.m_Record].m_Name; break;
+				default: continue;
+				}
+
+				ImGui::TextUnformatted(
+					std::format("[{}] {} ({}) - {:.2f}", KindNames[(std::size_t)Hit.m_Kind], szName, szId, Hit.m_Score).c_str()
+				);
+			}
+
+			ImGui::End();
+			return;
+		}
+
 		for (auto&& [idx, entry] : std::views::enumerate(s_NationalPokeDex))
 		{
 			ImGui::TextUnformatted(
 				std::format(
 					"#{:0>3} - {}",
-					entry->second.begin()->second.m_NationalDex,
-					entry->first
+					entry->m_NationalDex,
+					entry->m_Id
 				).c_str()
 			);
 		}
@@ -0,0 +1,288 @@
+#include <imgui.h>
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import UtlLog;
+import UtlTrace;
+
+namespace Window
+{
+	struct CZoneSummary final
+	{
+		std::string_view m_Name{};
+		std::size_t m_Count{};
+		double m_TotalMs{};
+		double m_MaxMs{};
+	};
+
+	// Returns true if the user zoomed or panned this frame.
+	static bool FlameView(std::span<CTraceEvent const> rgEvents, std::span<CTraceThread const> rgThreads, double* pflViewBegin, double* pflViewEnd) noexcept
+	{
+		static constexpr float ROW_HEIGHT = 18.f;
+		static constexpr float LANE_HEADER = 18.f;
+		static constexpr float LANE_GAP = 6.f;
+
+		// Lanes are indexed by thread, the tracer numbers threads densely from 0.
+		std::vector<int> rgiLaneDepth(rgThreads.size(), 0);
+		for (auto&& Event : rgEvents)
+		{
+			if (Event.m_Thread < rgiLaneDepth.size())
+				rgiLaneDepth[Event.m_Thread] = std::max<int>(rgiLaneDepth[Event.m_Thread], Event.m_Depth + 1);
+		}
+
+		std::vector<float> rgflLaneTop(rgThreads.size(), 0.f);
+		float flHeight = 0.f;
+		for (auto&& [flTop, iDepth] : std::views::zip(rgflLaneTop, rgiLaneDepth))
+		{
+			flTop = flHeight;
+			flHeight += LANE_HEADER + iDepth * ROW_HEIGHT + LANE_GAP;
+		}
+
+		if (!ImGui::BeginChild("##Flame", {}, ImGuiChildFlags_None, ImGuiWindowFlags_NoScrollWithMouse))
+		{
+			ImGui::EndChild();
+			return false;
+		}
+
+		auto const vecOrigin = ImGui::GetCursorScreenPos();
+		auto const flWidth = std::max(ImGui::GetContentRegionAvail().x, 1.f);
+
+		ImGui::InvisibleButton("##Canvas", { flWidth, std::max(flHeight, 1.f) });
+
+		auto& io = ImGui::GetIO();
+		auto flSpan = std::max(*pflViewEnd - *pflViewBegin, 1e-6);
+		bool bMoved = false;
+
+		// Wheel zooms around the cursor, dragging pans.
+		if (ImGui::IsItemHovered() && io.MouseWheel != 0.f)
+		{
+			auto const flRatio = (double)(io.MousePos.x - vecOrigin.x) / flWidth;
+			auto const flPivot = *pflViewBegin + flRatio * flSpan;
+
+			flSpan *= io.MouseWheel > 0.f ? 0.8 : 1.25;
+			*pflViewBegin = flPivot - flRatio * flSpan;
+			*pflViewEnd = *pflViewBegin + flSpan;
+			bMoved = true;
+		}
+
+		if (ImGui::IsItemActive() && ImGui::IsMouseDragging(ImGuiMouseButton_Left, 0.f))
+		{
+			auto const flDelta = (double)io.MouseDelta.x / flWidth * flSpan;
+			*pflViewBegin -= flDelta;
+			*pflViewEnd -= flDelta;
+			bMoved |= flDelta != 0.0;
+		}
+
+		auto const pDrawList = ImGui::GetWindowDrawList();
+		auto const flLeft = vecOrigin.x;
+		auto const flRight = vecOrigin.x + flWidth;
+		auto const fnX = [&](std::int64_t iNanoseconds) noexcept
+		{
+			return flLeft + (float)((iNanoseconds / 1e6 - *pflViewBegin) / flSpan * flWidth);
+		};
+
+		for (auto&& [Thread, flTop] : std::views::zip(rgThreads, rgflLaneTop))
+		{
+			pDrawList->AddText({ flLeft + 2.f, vecOrigin.y + flTop + 2.f }, IM_COL32(200, 200, 200, 255), Thread.m_Name.c_str());
+			pDrawList->AddLine({ flLeft, vecOrigin.y + flTop }, { flRight, vecOrigin.y + flTop }, IM_COL32(90, 90, 90, 255));
+		}
+
+		CTraceEvent const* pHovered{};
+
+		for (auto&& Event : rgEvents)
+		{
+			if (Event.m_Thread >= rgflLaneTop.size())
+				continue;
+
+			auto x0 = fnX(Event.m_Begin);
+			auto x1 = fnX(Event.m_End);
+
+			if (x1 < flLeft || x0 > flRight)
+				continue;
+
+			x0 = std::max(x0, flLeft);
+			x1 = std::clamp(x1, x0 + 1.f, flRight);
+
+			auto const y0 = vecOrigin.y + rgflLaneTop[Event.m_Thread] + LANE_HEADER + Event.m_Depth * ROW_HEIGHT;
+			auto const y1 = y0 + ROW_HEIGHT - 1.f;
+
+			// Same name, same color, across lanes and snapshots.
+			auto const iHash = std::hash<std::string_view>{}(Event.m_Name);
+			auto const Color = ImColor::HSV((float)(iHash % 360) / 360.f, 0.45f, 0.75f);
+
+			pDrawList->AddRectFilled({ x0, y0 }, { x1, y1 }, Color);
+
+			if (x1 - x0 > 24.f)
+			{
+				pDrawList->PushClipRect({ x0, y0 }, { x1, y1 }, true);
+				pDrawList->AddText({ x0 + 3.f, y0 + 2.f }, IM_COL32_BLACK, Event.m_Name.data(), Event.m_Name.data() + Event.m_Name.size());
+				pDrawList->PopClipRect();
+			}
+
+			if (ImGui::IsItemHovered() && io.MousePos.x >= x0 && io.MousePos.x < x1 && io.MousePos.y >= y0 && io.MousePos.y < y1)
+				pHovered = &Event;
+		}
+
+		if (pHovered)
+		{
+			ImGui::BeginTooltip();
+			ImGui::Text("%.*s", (int)pHovered->m_Name.size(), pHovered->m_Name.data());
+			if (!pHovered->m_Detail.empty())
+				ImGui::TextUnformatted(pHovered->m_Detail.c_str());
+			ImGui::Text("%.3f ms, at %.3f ms", (pHovered->m_End - pHovered->m_Begin) / 1e6, pHovered->m_Begin / 1e6);
+			ImGui::TextDisabled("%.*s", (int)UTIL_LogCategoryName(pHovered->m_Category).size(), UTIL_LogCategoryName(pHovered->m_Category).data());
+			ImGui::EndTooltip();
+		}
+
+		ImGui::EndChild();
+		return bMoved;
+	}
+
+	static void SummaryTable(std::span<CTraceEvent const> rgEvents) noexcept
+	{
+		// Zone names are literals, so equal names usually share the pointer. Compare the text anyway.
+		std::vector<CZoneSummary> rgSummary{};
+
+		for (auto&& Event : rgEvents)
+		{
+			auto it = std::ranges::find(rgSummary, Event.m_Name, &CZoneSummary::m_Name);
+			if (it == rgSummary.end())
+				it = rgSummary.insert(it, CZoneSummary{ .m_Name = Event.m_Name });
+
+			auto const flMs = (Event.m_End - Event.m_Begin) / 1e6;
+			++it->m_Count;
+			it->m_TotalMs += flMs;
+			it->m_MaxMs = std::max(it->m_MaxMs, flMs);
+		}
+
+		std::ranges::sort(rgSummary, std::ranges::greater{}, &CZoneSummary::m_TotalMs);
+
+		if (ImGui::BeginTable("##Summary", 5, ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+		{
+			ImGui::TableSetupScrollFreeze(0, 1);
+			ImGui::TableSetupColumn("Zone");
+			ImGui::TableSetupColumn("Count");
+			ImGui::TableSetupColumn("Total (ms)");
+			ImGui::TableSetupColumn("Mean (ms)");
+			ImGui::TableSetupColumn("Max (ms)");
+			ImGui::TableHeadersRow();
+
+			for (auto&& Summary : rgSummary)
+			{
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(Summary.m_Name.data(), Summary.m_Name.data() + Summary.m_Name.size());
+				ImGui::TableNextColumn();
+				ImGui::Text("%zu", Summary.m_Count);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", Summary.m_TotalMs);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", Summary.m_TotalMs / Summary.m_Count);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", Summary.m_MaxMs);
+			}
+
+			ImGui::EndTable();
+		}
+	}
+
+	void Profiler() noexcept
+	{
+		static std::vector<CTraceEvent> rgEvents{};
+		static std::vector<CTraceThread> rgThreads{};
+		static double flLastSnapshot = -1.0;
+		static bool bLive = false;
+		static bool bFit = true;
+		static bool bUserView = false;	// Zoomed or panned by hand, live refreshes keep the view until Fit is pressed.
+		static double flViewBegin{}, flViewEnd{};	// Milliseconds since the tracer started.
+		static std::string szStatus{};
+
+		if (!ImGui::Begin("Profiler"))
+		{
+			ImGui::End();
+			return;
+		}
+
+		bool bRecording = UTIL_TraceEnabled();
+		if (ImGui::Checkbox("Record", &bRecording))
+			UTIL_TraceSetEnabled(bRecording);
+
+		ImGui::SameLine();
+		ImGui::Checkbox("Live", &bLive);
+		ImGui::SameLine();
+		auto const bSnapshot = ImGui::Button("Snapshot");
+		ImGui::SameLine();
+		if (ImGui::Button("Fit"))
+		{
+			bFit = true;
+			bUserView = false;
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Clear"))
+		{
+			UTIL_TraceClear();
+			rgEvents.clear();
+		}
+
+		ImGui::SameLine();
+		if (ImGui::Button("Save trace.json"))
+		{
+			auto const Result = UTIL_TraceWriteChrome("trace.json");
+			szStatus = Result ? std::format("{} zones written to trace.json", *Result) : Result.error();
+		}
+
+		if (!szStatus.empty())
+		{
+			ImGui::SameLine();
+			ImGui::TextUnformatted(szStatus.c_str());
+		}
+
+		// Taking a snapshot copies every zone, twice a second is plenty.
+		if (bSnapshot || flLastSnapshot < 0 || (bLive && ImGui::GetTime() - flLastSnapshot > 0.5))
+		{
+			UTIL_TraceSnapshot(&rgEvents, &rgThreads);
+			flLastSnapshot = ImGui::GetTime();
+			bFit |= bLive && !bUserView;
+		}
+
+		if (rgEvents.empty())
+		{
+			ImGui::TextDisabled("No zone recorded.");
+			ImGui::End();
+			return;
+		}
+
+		if (std::exchange(bFit, false))
+		{
+			flViewBegin = rgEvents.front().m_Begin / 1e6;
+			flViewEnd = std::ranges::max(rgEvents, {}, &CTraceEvent::m_End).m_End / 1e6;
+		}
+
+		ImGui::Text("%zu zones, view %.3f ms to %.3f ms. Wheel to zoom, drag to pan.", rgEvents.size(), flViewBegin, flViewEnd);
+
+		if (ImGui::BeginTabBar("##ProfilerTabs"))
+		{
+			if (ImGui::BeginTabItem("Flame"))
+			{
+				bUserView |= FlameView(rgEvents, rgThreads, &flViewBegin, &flViewEnd);
+				ImGui::EndTabItem();
+			}
+
+			if (ImGui::BeginTabItem("Summary"))
+			{
+				SummaryTable(rgEvents);
+				ImGui::EndTabItem();
+			}
+
+			ImGui::EndTabBar();
+		}
+
+		ImGui::End();
+	}
+}
@@ -0,0 +1,93 @@
+#include <imgui.h>
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.PBS.Query;
+
+namespace Window
+{
+	void Query() noexcept
+	{
+		if (!ImGui::Begin("Query"))
+		{
+			ImGui::End();
+			return;
+		}
+
+		using namespace Database::PBS;
+
+		static char szQuery[512]{ "species where type has WATER and bst > 500 order by speed desc" };
+		static std::expected<CQueryResult, std::string> Result{ std::unexpect, "" };
+
+		bool bRun = ImGui::InputText("##Query", szQuery, std::size(szQuery), ImGuiInputTextFlags_EnterReturnsTrue);
+		ImGui::SameLine();
+		bRun |= ImGui::Button("Run");
+
+		if (bRun)
+			Result = RunQuery(szQuery);
+
+		if (!Result)
+		{
+			if (!Result.error().empty())
+				ImGui::TextColored({ 1, 0.4f, 0.4f, 1 }, "%s", Result.error().c_str());
+
+			ImGui::End();
+			return;
+		}
+
+		ImGui::TextWrapped("Plan: %s", Result->m_Plan.c_str());
+		ImGui::Text("%zu rows, compiled in %.3f ms, executed in %.3f ms",
+			Result->m_Rows.size(), Result->m_CompileTime.count(), Result->m_ExecuteTime.count());
+		ImGui::Separator();
+
+		auto const iColumns = 3 + (int)Result->m_Projection.size();
+
+		if (ImGui::BeginTable("QueryResult", iColumns, ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+		{
+			ImGui::TableSetupScrollFreeze(0, 1);
+			ImGui::TableSetupColumn("Id");
+			ImGui::TableSetupColumn("Form");
+			ImGui::TableSetupColumn("Name");
+			for (auto&& Field : Result->m_Projection)
+				ImGui::TableSetupColumn(FieldName(Field).data());
+			ImGui::TableHeadersRow();
+
+			ImGuiListClipper Clipper{};
+			Clipper.Begin((int)Result->m_Rows.size());
+
+			while (Clipper.Step())
+			{
+				for (int i = Clipper.DisplayStart; i < Clipper.DisplayEnd; ++i)
+				{
+					auto const iRow = Result->m_Rows[i];
+					auto const& Spec = Species.m_Records[iRow];
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(Spec.m_Id.data(), Spec.m_Id.data() + Spec.m_Id.size());
+					ImGui::TableNextColumn();
+					ImGui::Text("%d", (int)Spec.m_FormId);
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(Spec.m_Name.data(), Spec.m_Name.data() + Spec.m_Name.size());
+
+					for (auto&& Field : Result->m_Projection)
+					{
+						ImGui::TableNextColumn();
+						ImGui::Text("%u", FieldValue(Field, iRow));
+					}
+				}
+			}
+
+			ImGui::EndTable();
+		}
+
+		ImGui::End();
+	}
+}
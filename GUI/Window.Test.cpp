@@ -9,6 +9,9 @@
 import std.compat;
 #endif
 
+import UtlLog;
+import UtlMemory;
+
 import GL.Painter;
 import GL.Canvas;
 import GL.Shader;
@@ -123,7 +126,7 @@ namespace TestWindow
 		// Load texture array
 		auto result = LoadTextureArrayFromFile(LR"(G:\GameTools\Image\Ecchi Version Showcase 12-23-2023\Graphics\Tilesets\pkmnh_overworld_2x.png)", 256, false);
 		if (!result.has_value()) {
-			std::println("Failed to load texture array");
+			UTIL_LogError(ELogCategory::Render, "Failed to load texture array");
 			return;
 		}
 
@@ -263,6 +266,7 @@ namespace TestWindow
 	void Cleanup() noexcept
 	{
 		if (m_TextureArrayId != 0) {
+			UTIL_GpuMemoryRelease(EGpuMemory::Textures, m_TextureArrayId);
 			glDeleteTextures(1, &m_TextureArrayId);
 			m_TextureArrayId = 0;
 		}
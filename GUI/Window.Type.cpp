@@ -10,7 +10,7 @@ import std.compat;
 #endif
 
 
-import Database.Raw.PBS;
+import Database.PBS;
 import GL.Canvas;
 import GL.GameMap;
 import Game.Map;
@@ -60,44 +60,32 @@ void Window::TypeInfo() noexcept
 	static auto const TypeIconTexId{ std::get<0>(*TypeIcons) };
 	static auto const TypeIconTotalWidth{ (float)std::get<1>(*TypeIcons) };
 	static auto const TypeIconTotalHeight{ (float)std::get<2>(*TypeIcons) };
-	static auto const TypeIconPerHeight{ (float)(TypeIconTotalHeight / PBS::Types.size()) };
+
+	using namespace Database::PBS;
+
+	static auto const TypeIconPerHeight{ (float)(TypeIconTotalHeight / Types.size()) };
 
 	static std::vector const TypeInUse{ std::from_range,
-		PBS::Types
-		| std::views::values
-		| std::views::filter(std::not_fn(&PokemonType::m_IsPseudoType))
-		| std::views::transform([](auto& a) static noexcept { return std::addressof(a); })
+		Types
+		| std::views::filter(std::not_fn(&CPokemonType::m_IsPseudoType))
+		| std::views::transform([](auto& a) static noexcept { return Types.HandleOf(a); })
 	};
 
-	static auto const rgfl{
-		[]
+	static constexpr auto fnRelationText =
+		[](std::uint8_t iEffectiveness) static noexcept -> std::string_view
 		{
-			std::vector<std::string_view> ret{};
-			ret.resize(TypeInUse.size() * TypeInUse.size(), "neutral");
-
-			std::mdspan<decltype(ret)::value_type, std::dextents<size_t, 2>> const TypeChart{
-				ret.data(), TypeInUse.size(), TypeInUse.size()
-			};
-
-			for (int i = 0; i < std::ssize(TypeInUse); ++i)
+			switch (iEffectiveness)
 			{
-				for (int j = 0; j < std::ssize(TypeInUse); ++j)
-				{
-					if (std::ranges::contains(TypeInUse[i]->Weaknesses(), TypeInUse[j]))	// [i] is weak to [j]
-						TypeChart[i, j] = "weak";
-					if (std::ranges::contains(TypeInUse[i]->Immunities(), TypeInUse[j]))	// [i] is immu to [j]
-						TypeChart[i, j] = "immune";
-					if (std::ranges::contains(TypeInUse[i]->Resistances(), TypeInUse[j]))	// [i] is resi to [j]
-						TypeChart[i, j] = "resisting";
-				}
+			case 0:
+				return "immune";
+			case EFFECTIVENESS_NORMAL / 2:
+				return "resisting";
+			case EFFECTIVENESS_NORMAL * 2:
+				return "weak";
+			default:
+				return "neutral";
 			}
-
-			return ret;
-		}()
-	};
-	static std::mdspan<decltype(rgfl)::value_type const, std::dextents<size_t, 2>> const TypeChart{
-		rgfl.data(), TypeInUse.size(), TypeInUse.size()
-	};
+		};
 
 	if (ImGui::Begin("Type Chart"))
 	{
@@ -106,8 +94,10 @@ void Window::TypeInfo() noexcept
 			ImGui::TableSetupScrollFreeze(1, 1);
 			ImGui::TableNextRow();
 
-			for (auto&& [idx, pType] : std::views::enumerate(TypeInUse))
+			for (auto&& [idx, hType] : std::views::enumerate(TypeInUse))
 			{
+				auto const pType = &Types[hType];
+
 				ImGui::TableSetColumnIndex((int)idx + 1);
 				ImGui::Image(
 					TypeIconTexId,
@@ -121,16 +111,16 @@ void Window::TypeInfo() noexcept
 					ImGui::TextUnformatted("[Attacker]");
 
 					auto const fnPrintRelation =
-						[&](const char* szSepText, std::string_view szRelText) noexcept
+						[&](const char* szSepText, std::uint8_t iEffectiveness) noexcept
 						{
 							bool bAny{};
 
 							ImGui::SeparatorText(szSepText);
-							for (int i = 0; i < TypeChart.extent(1); ++i)
+							for (auto&& hDef : TypeInUse)
 							{
-								if (TypeChart[i, idx] == szRelText)
+								if (TypeChart.Effectiveness(hType, hDef) == iEffectiveness)
 								{
-									ImGui::TextUnformatted(TypeInUse[i]->m_Name.data());
+									ImGui::TextUnformatted(Types[hDef].m_Name.data());
 									bAny = true;
 								}
 							}
@@ -138,9 +128,9 @@ void Window::TypeInfo() noexcept
 								ImGui::TextUnformatted("(NONE)");
 						};
 
-					fnPrintRelation("Effective", "weak");
-					fnPrintRelation("Uneffective", "resisting");
-					fnPrintRelation("Deals no damage", "immune");
+					fnPrintRelation("Effective", EFFECTIVENESS_NORMAL * 2);
+					fnPrintRelation("Uneffective", EFFECTIVENESS_NORMAL / 2);
+					fnPrintRelation("Deals no damage", 0);
 
 					ImGui::EndTooltip();
 				}
@@ -148,7 +138,9 @@ void Window::TypeInfo() noexcept
 
 			for (int row = 0; row < std::ssize(TypeInUse); row++)
 			{
-				[[maybe_unused]] Imgui_ID_RAII RAII_1(TypeInUse[row]);
+				auto const hRow = TypeInUse[row];
+				auto const pRow = &Types[hRow];
+				[[maybe_unused]] Imgui_ID_RAII RAII_1(pRow);
 
 				ImGui::TableNextRow();
 
@@ -156,8 +148,8 @@ void Window::TypeInfo() noexcept
 				ImGui::Image(
 					TypeIconTexId,
 					{ TypeIconTotalWidth, TypeIconPerHeight },
-					{ 0, (TypeInUse[row]->m_IconPosition * TypeIconPerHeight) / TypeIconTotalHeight },
-					{ 1, ((TypeInUse[row]->m_IconPosition + 1) * TypeIconPerHeight) / TypeIconTotalHeight }
+					{ 0, (pRow->m_IconPosition * TypeIconPerHeight) / TypeIconTotalHeight },
+					{ 1, ((pRow->m_IconPosition + 1) * TypeIconPerHeight) / TypeIconTotalHeight }
 				);
 
 				if (ImGui::BeginItemTooltip())
@@ -165,16 +157,16 @@ void Window::TypeInfo() noexcept
 					ImGui::TextUnformatted("[Defender]");
 
 					auto const fnPrintRelation =
-						[&](const char* szSepText, std::string_view szRelText) noexcept
+						[&](const char* szSepText, std::uint8_t iEffectiveness) noexcept
 						{
 							bool bAny{};
 
 							ImGui::SeparatorText(szSepText);
-							for (int j = 0; j < TypeChart.extent(0); ++j)
+							for (auto&& hAtk : TypeInUse)
 							{
-								if (TypeChart[row, j] == szRelText)
+								if (TypeChart.Effectiveness(hAtk, hRow) == iEffectiveness)
 								{
-									ImGui::TextUnformatted(TypeInUse[j]->m_Name.data());
+									ImGui::TextUnformatted(Types[hAtk].m_Name.data());
 									bAny = true;
 								}
 							}
@@ -182,19 +174,21 @@ void Window::TypeInfo() noexcept
 								ImGui::TextUnformatted("(NONE)");
 						};
 
-					fnPrintRelation("Weak to", "weak");
-					fnPrintRelation("Resists", "resisting");
-					fnPrintRelation("Immune to", "immune");
+					fnPrintRelation("Weak to", EFFECTIVENESS_NORMAL * 2);
+					fnPrintRelation("Resists", EFFECTIVENESS_NORMAL / 2);
+					fnPrintRelation("Immune to", 0);
 
 					ImGui::EndTooltip();
 				}
 
 				for (int column = 0; column < std::ssize(TypeInUse); column++)
 				{
-					[[maybe_unused]] Imgui_ID_RAII RAII_2(TypeInUse[column]);
+					auto const hColumn = TypeInUse[column];
+					[[maybe_unused]] Imgui_ID_RAII RAII_2(&Types[hColumn]);
 					ImGui::TableSetColumnIndex(column + 1);
 
-					std::string_view const& TypeMatch = TypeChart[row, column];
+					// Row is the defender, column is the attacker.
+					auto const TypeMatch = fnRelationText(TypeChart.Effectiveness(hColumn, hRow));
 					if (TypeMatch != "neutral")
 					{
 						ImGui::TextUnformatted(TypeMatch.data());
@@ -202,7 +196,7 @@ void Window::TypeInfo() noexcept
 						if (ImGui::BeginItemTooltip())
 						{
 							ImGui::TextUnformatted(
-								std::format("{} is {} to {}", TypeInUse[row]->m_Name, TypeMatch, TypeInUse[column]->m_Name).c_str()
+								std::format("{} is {} to {}", pRow->m_Name, TypeMatch, Types[hColumn].m_Name).c_str()
 							);
 							ImGui::EndTooltip();
 						}
@@ -0,0 +1,441 @@
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import Database.Export;
+import Database.PBS;
+import Database.RX;
+import Ruby.Deserializer;
+
+using namespace Database::PBS;
+using namespace Database::RX;
+
+namespace Database::Export
+{
+	inline constexpr std::size_t FLUSH_THRESHOLD = 1 << 20;
+
+	// Table payloads are written as they are in memory, which is the layout of .rxdata.
+	static_assert(std::endian::native == std::endian::little);
+
+	struct CJsonWriter final
+	{
+		std::ofstream* m_pFile{};
+		std::string* m_pBuffer{};
+		ETableEncoding m_TableEncoding{};
+		std::uint64_t m_Written{};
+
+		void Raw(char c) noexcept { m_pBuffer->push_back(c); }
+		void Raw(std::string_view sz) noexcept { m_pBuffer->append(sz); }
+
+		void Flush() noexcept
+		{
+			m_pFile->write(m_pBuffer->data(), std::ssize(*m_pBuffer));
+			m_Written += m_pBuffer->size();
+			m_pBuffer->clear();
+		}
+
+		// Between records only, a single record is never split.
+		void MaybeFlush() noexcept
+		{
+			if (m_pBuffer->size() >= FLUSH_THRESHOLD)
+				Flush();
+		}
+
+		void String(std::string_view sz) noexcept
+		{
+			auto& Buffer = *m_pBuffer;
+			Buffer.push_back('"');
+
+			// Nearly every PBS string is plain, copy whole runs between the characters that need escaping.
+			auto itRun = sz.begin();
+
+			for (auto it = sz.begin(); it != sz.end(); ++it)
+			{
+				auto const c = static_cast<unsigned char>(*it);
+
+				if (c >= 0x20 && c != '"' && c != '\\') [[likely]]
+					continue;
+
+				Buffer.append(itRun, it);
+				itRun = it + 1;
+
+				switch (c)
+				{
+				case '"': Buffer.append(R"(\")"); break;
+				case '\\': Buffer.append(R"(\\)"); break;
+				case '\n': Buffer.append(R"(\n)"); break;
+				case '\r': Buffer.append(R"(\r)"); break;
+				case '\t': Buffer.append(R"(\t)"); break;
+				default: std::format_to(std::back_inserter(Buffer), "\\u{:04x}", c); break;
+				}
+			}
+
+			Buffer.append(itRun, sz.end());
+			Buffer.push_back('"');
+		}
+
+		template <typename T>
+		void Number(T num) noexcept
+		{
+			char szNumber[32];
+			auto const [ptr, ec] = std::to_chars(std::begin(szNumber), std::end(szNumber), num);
+			m_pBuffer->append(szNumber, ptr);
+		}
+
+		void Base64(std::span<std::byte const> rgBytes) noexcept
+		{
+			static constexpr std::string_view ALPHABET{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+
+			auto const iOffset = m_pBuffer->size();
+			auto const iLength = (rgBytes.size() + 2) / 3 * 4;
+
+			m_pBuffer->resize_and_overwrite(iOffset + iLength,
+				[&](char* pBuffer, std::size_t iSize) noexcept
+				{
+					auto p = pBuffer + iOffset;
+					std::size_t i = 0;
+
+					for (; i + 3 <= rgBytes.size(); i += 3)
+					{
+						auto const iBits = (std::uint32_t)rgBytes[i] << 16 | (std::uint32_t)rgBytes[i + 1] << 8 | (std::uint32_t)rgBytes[i + 2];
+
+						*p++ = ALPHABET[iBits >> 18 & 0x3F];
+						*p++ = ALPHABET[iBits >> 12 & 0x3F];
+						*p++ = ALPHABET[iBits >> 6 & 0x3F];
+						*p++ = ALPHABET[iBits & 0x3F];
+					}
+
+					if (auto const iRest = rgBytes.size() - i; iRest)
+					{
+						auto const iBits = (std::uint32_t)rgBytes[i] << 16 | (iRest == 2 ? (std::uint32_t)rgBytes[i + 1] << 8 : 0u);
+
+						*p++ = ALPHABET[iBits >> 18 & 0x3F];
+						*p++ = ALPHABET[iBits >> 12 & 0x3F];
+						*p++ = iRest == 2 ? ALPHABET[iBits >> 6 & 0x3F] : '=';
+						*p++ = '=';
+					}
+
+					return iSize;
+				}
+			);
+		}
+
+		// References are written as the id of the record, null if unresolved.
+		template <typename R>
+		void Value(THandle<R> hRecord) noexcept
+		{
+			R const* pRecord{};
+
+			if constexpr (std::is_same_v<R, CPokemonType>)
+				pRecord = Types.At(hRecord);
+			else if constexpr (std::is_same_v<R, CPokemonMove>)
+				pRecord = Moves.At(hRecord);
+			else if constexpr (std::is_same_v<R, CPokemonAbility>)
+				pRecord = Abilities.At(hRecord);
+			else if constexpr (std::is_same_v<R, CPokemonItem>)
+				pRecord = Items.At(hRecord);
+			else if constexpr (std::is_same_v<R, CPokemonSpecies>)
+				pRecord = Species.At(hRecord);
+			else
+				static_assert(false, "Unknown record table");
+
+			if (pRecord)
+				String(pRecord->m_Id);
+			else
+				Raw("null");
+		}
+
+		void Value(CPokemonEvolution const& Evo) noexcept
+		{
+			Raw(R"({"Species":)");
+			String(Evo.m_Species);
+			Raw(R"(,"Method":)");
+			String(Evo.m_Method);
+			Raw(R"(,"Parameter":)");
+			String(Evo.m_Parameter);
+			Raw('}');
+		}
+
+		void Value(Ruby::Deserializer::Table const& Table) noexcept
+		{
+			std::format_to(std::back_inserter(*m_pBuffer), R"({{"x_size":{},"y_size":{},"z_size":{},)", Table.x_size, Table.y_size, Table.z_size);
+
+			if (m_TableEncoding == ETableEncoding::Base64)
+			{
+				Raw(R"("encoding":"base64-int16le","data":")");
+				Base64(std::as_bytes(std::span{ Table.data }));
+				Raw(R"("})");
+			}
+			else
+			{
+				Raw(R"("data":)");
+				Value(Table.data);
+				Raw('}');
+			}
+		}
+
+		template <typename T>
+		void Value(T const& val) noexcept
+		{
+			if constexpr (std::is_same_v<T, bool>)
+				Raw(val ? "true" : "false");
+			else if constexpr (std::is_enum_v<T>)
+				Number(std::to_underlying(val));
+			else if constexpr (std::integral<T>)
+				Number(val);
+			else if constexpr (std::floating_point<T>)
+			{
+				if (std::isfinite(val))
+					Number(val);
+				else
+					Raw("null");
+			}
+			else if constexpr (std::convertible_to<T const&, std::string_view>)
+				String(val);
+			else if constexpr (requires { val.first; val.second; })
+			{
+				Raw('[');
+				Value(val.first);
+				Raw(',');
+				Value(val.second);
+				Raw(']');
+			}
+			else if constexpr (std::ranges::range<T const>)
+			{
+				Raw('[');
+
+				for (bool bFirst = true; auto&& elem : val)
+				{
+					if (!std::exchange(bFirst, false))
+						Raw(',');
+
+					Value(elem);
+				}
+
+				Raw(']');
+			}
+			else
+				static_assert(false, "No JSON representation");
+		}
+	};
+
+	// A column of the output. The key is written as is, it is never escaped.
+	template <typename T>
+	struct CFieldDesc final
+	{
+		std::string_view m_Key{};
+		void (*m_pfnWrite)(CJsonWriter&, T const&) noexcept {};
+	};
+
+	// Keys are the names used by the source files: PBS keys for PBS tables, Ruby instance variables for RX tables.
+	// Enums are written as their underlying value.
+#define FIELD(key)	CFieldDesc<record_t>{ #key, [](CJsonWriter& Writer, record_t const& Rec) static noexcept { Writer.Value(Rec.m_##key); } }
+#define FIELD_OF_SECOND(key)	CFieldDesc<record_t>{ #key, [](CJsonWriter& Writer, record_t const& Rec) static noexcept { Writer.Value(Rec.second.m_##key); } }
+
+	inline constexpr auto TYPE_FIELDS = [] static noexcept
+	{
+		using record_t = CPokemonType;
+		return std::array{
+			FIELD(Id), FIELD(Name), FIELD(IconPosition), FIELD(IsSpecialType), FIELD(IsPseudoType), FIELD(Flags),
+			FIELD(Weaknesses), FIELD(Resistances), FIELD(Immunities),
+		};
+	}();
+
+	inline constexpr auto MOVE_FIELDS = [] static noexcept
+	{
+		using record_t = CPokemonMove;
+		return std::array{
+			FIELD(Id), FIELD(Name), FIELD(Type), FIELD(Category), FIELD(Power), FIELD(Accuracy), FIELD(TotalPP), FIELD(Priority), FIELD(EffectChance),
+			FIELD(Target), FIELD(FunctionCode), FIELD(Flags), FIELD(Description),
+		};
+	}();
+
+	inline constexpr auto ABILITY_FIELDS = [] static noexcept
+	{
+		using record_t = CPokemonAbility;
+		return std::array{ FIELD(Id), FIELD(Name), FIELD(Description), FIELD(Flags), };
+	}();
+
+	inline constexpr auto ITEM_FIELDS = [] static noexcept
+	{
+		using record_t = CPokemonItem;
+		return std::array{
+			FIELD(Id), FIELD(Name), FIELD(NamePlural), FIELD(PortionName), FIELD(PortionNamePlural), FIELD(Pocket), FIELD(BPPrice), FIELD(Price), FIELD(SellPrice),
+			FIELD(FieldUse), FIELD(BattleUse), FIELD(Flags), FIELD(Consumable), FIELD(ShowQuantity), FIELD(Move), FIELD(Description),
+		};
+	}();
+
+	inline constexpr auto SPECIES_FIELDS = [] static noexcept
+	{
+		using record_t = CPokemonSpecies;
+		return std::array{
+			FIELD(Id), FIELD(FormId), FIELD(Name), FIELD(FormName), FIELD(Types), FIELD(BaseStats), FIELD(BaseExp), FIELD(CatchRate), FIELD(Happiness),
+			FIELD(Generation), FIELD(HatchSteps), FIELD(GenderRatio), FIELD(GrowthRate), FIELD(EVs), FIELD(Abilities), FIELD(HiddenAbilities),
+			FIELD(Moves), FIELD(TutorMoves), FIELD(EggMoves), FIELD(EggGroups), FIELD(Incense), FIELD(Offspring), FIELD(Height), FIELD(Weight),
+			FIELD(Color), FIELD(Shape), FIELD(Habitat), FIELD(Category), FIELD(Pokedex), FIELD(Flags),
+			FIELD(WildItemCommon), FIELD(WildItemUncommon), FIELD(WildItemRare), FIELD(Evolutions), FIELD(NationalDex),
+		};
+	}();
+
+	inline constexpr auto TILESET_FIELDS = [] static noexcept
+	{
+		using record_t = Tileset;
+		return std::array{
+			FIELD(id), FIELD(name), FIELD(tileset_name), FIELD(autotile_names), FIELD(panorama_name), FIELD(panorama_hue),
+			FIELD(fog_name), FIELD(fog_hue), FIELD(fog_opacity), FIELD(fog_blend_type), FIELD(fog_zoom), FIELD(fog_sx), FIELD(fog_sy),
+			FIELD(battleback_name), FIELD(passages), FIELD(priorities), FIELD(terrain_tags),
+		};
+	}();
+
+	inline constexpr auto MAP_INFO_FIELDS = [] static noexcept
+	{
+		using record_t = std::pair<std::int32_t const, MapInfo>;
+		return std::array{
+			CFieldDesc<record_t>{ "id", [](CJsonWriter& Writer, record_t const& Rec) static noexcept { Writer.Value(Rec.first); } },
+			FIELD_OF_SECOND(name), FIELD_OF_SECOND(parent_id), FIELD_OF_SECOND(order), FIELD_OF_SECOND(expanded), FIELD_OF_SECOND(scroll_x), FIELD_OF_SECOND(scroll_y),
+		};
+	}();
+
+	inline constexpr auto MAP_FIELDS = [] static noexcept
+	{
+		using record_t = MapDatum;
+		return std::array{ FIELD(id), FIELD(tileset_id), FIELD(width), FIELD(height), FIELD(autoplay_bgm), FIELD(autoplay_bgs), FIELD(data), };
+	}();
+
+#undef FIELD
+#undef FIELD_OF_SECOND
+
+	template <typename T, std::size_t N>
+	static auto WriteTable(CJsonWriter& Writer, std::ranges::input_range auto const& rgRecords, std::array<CFieldDesc<T>, N> const& rgFields, EFormat Format) noexcept -> std::size_t
+	{
+		std::size_t iCount{};
+
+		if (Format == EFormat::Json)
+			Writer.Raw("[\n");
+
+		for (auto&& Record : rgRecords)
+		{
+			if (Format == EFormat::Json && iCount)
+				Writer.Raw(",\n");
+
+			Writer.Raw('{');
+
+			for (bool bFirst = true; auto&& Field : rgFields)
+			{
+				if (!std::exchange(bFirst, false))
+					Writer.Raw(',');
+
+				Writer.Raw('"');
+				Writer.Raw(Field.m_Key);
+				Writer.Raw(R"(":)");
+				Field.m_pfnWrite(Writer, Record);
+			}
+
+			Writer.Raw('}');
+
+			if (Format == EFormat::JsonLines)
+				Writer.Raw('\n');
+
+			++iCount;
+			Writer.MaybeFlush();
+		}
+
+		if (Format == EFormat::Json)
+			Writer.Raw(iCount ? "\n]\n" : "]\n");
+
+		return iCount;
+	}
+
+	auto ExportTable(ETable Table, std::filesystem::path const& File, COptions Options) noexcept -> std::expected<CExportStat, std::string>
+	{
+		auto const t0 = std::chrono::high_resolution_clock::now();
+
+		// Kept per thread, so the capacity survives between tables and calls.
+		thread_local std::string t_Buffer{};
+		t_Buffer.clear();
+		t_Buffer.reserve(FLUSH_THRESHOLD * 2);
+
+		// Unbuffered, the writer already hands over chunks of FLUSH_THRESHOLD. Must be set before open().
+		std::ofstream Stream{};
+		Stream.rdbuf()->pubsetbuf(nullptr, 0);
+		Stream.open(File, std::ios::binary | std::ios::trunc);
+
+		if (!Stream)
+			return std::unexpected(std::format("Cannot open '{}' for writing", File.u8string()));
+
+		CJsonWriter Writer{ &Stream, &t_Buffer, Options.m_TableEncoding };
+		std::size_t iRecords{};
+
+		switch (Table)
+		{
+		case ETable::Types:
+			iRecords = WriteTable(Writer, Types, TYPE_FIELDS, Options.m_Format);
+			break;
+		case ETable::Moves:
+			iRecords = WriteTable(Writer, Moves, MOVE_FIELDS, Options.m_Format);
+			break;
+		case ETable::Abilities:
+			iRecords = WriteTable(Writer, Abilities, ABILITY_FIELDS, Options.m_Format);
+			break;
+		case ETable::Items:
+			iRecords = WriteTable(Writer, Items, ITEM_FIELDS, Options.m_Format);
+			break;
+		case ETable::Species:
+			iRecords = WriteTable(Writer, Species, SPECIES_FIELDS, Options.m_Format);
+			break;
+		case ETable::Tilesets:
+			iRecords = WriteTable(Writer, Tilesets, TILESET_FIELDS, Options.m_Format);
+			break;
+		case ETable::MapInfos:
+			iRecords = WriteTable(Writer, MapMetaInfos, MAP_INFO_FIELDS, Options.m_Format);
+			break;
+		case ETable::Maps:
+			iRecords = WriteTable(Writer, MapData, MAP_FIELDS, Options.m_Format);
+			break;
+
+		default:
+			return std::unexpected(std::format("Unknown table {}", std::to_underlying(Table)));
+		}
+
+		Writer.Flush();
+		Stream.close();
+
+		if (Stream.fail())
+			return std::unexpected(std::format("Failed to write '{}'", File.u8string()));
+
+		return CExportStat{
+			.m_Table = Table,
+			.m_Path = File,
+			.m_Records = iRecords,
+			.m_Bytes = Writer.m_Written,
+			.m_Time = std::chrono::high_resolution_clock::now() - t0,
+		};
+	}
+
+	auto ExportTables(std::span<ETable const> rgTables, std::filesystem::path const& Folder, COptions Options) noexcept -> std::vector<std::expected<CExportStat, std::string>>
+	{
+		std::vector<std::expected<CExportStat, std::string>> ret(rgTables.size());
+
+		if (std::error_code ec{}; !std::filesystem::create_directories(Folder, ec) && ec)
+		{
+			std::ranges::fill(ret, std::unexpected(std::format("Cannot create '{}': {}", Folder.u8string(), ec.message())));
+			return ret;
+		}
+
+		auto const szExtension = Options.m_Format == EFormat::Json ? ".json" : ".jsonl";
+
+		// Tables are read-only here and every task owns its file and its buffer.
+		std::transform(std::execution::par, rgTables.begin(), rgTables.end(), ret.begin(),
+			[&](ETable Table) noexcept
+			{
+				return ExportTable(Table, Folder / std::format("{}{}", TableName(Table), szExtension), Options);
+			}
+		);
+
+		return ret;
+	}
+}
@@ -0,0 +1,72 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module Database.Export;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+// Streams Database::PBS and Database::RX to JSON without building a document in memory.
+// Every table is described by a list of fields, records are formatted one by one into a reusable buffer that is written out in large chunks.
+
+export namespace Database::Export
+{
+	enum struct EFormat : std::uint8_t
+	{
+		Json,		// One array per file.
+		JsonLines,	// One object per line.
+	};
+
+	// How RPG Maker Table payloads, e.g. MapDatum::m_data, are written.
+	enum struct ETableEncoding : std::uint8_t
+	{
+		Base64,		// The int16 little endian data as one string, about 2.7 bytes per tile.
+		Array,		// Plain numbers, readable but several times larger.
+	};
+
+	enum struct ETable : std::uint8_t { Types, Moves, Abilities, Items, Species, Tilesets, MapInfos, Maps, COUNT, };
+
+	[[nodiscard]] constexpr auto TableName(ETable Table) noexcept -> std::string_view
+	{
+		constexpr std::array NAMES{ "types", "moves", "abilities", "items", "species", "tilesets", "map_infos", "maps" };
+		return NAMES[(std::size_t)Table];
+	}
+
+	[[nodiscard]] constexpr auto TableFromName(std::string_view sz) noexcept -> std::optional<ETable>
+	{
+		for (std::size_t i = 0; i < (std::size_t)ETable::COUNT; ++i)
+		{
+			if (TableName((ETable)i) == sz)
+				return (ETable)i;
+		}
+
+		return std::nullopt;
+	}
+
+	struct COptions final
+	{
+		EFormat m_Format{ EFormat::Json };
+		ETableEncoding m_TableEncoding{ ETableEncoding::Base64 };
+	};
+
+	struct CExportStat final
+	{
+		ETable m_Table{};
+		std::filesystem::path m_Path{};
+		std::size_t m_Records{};
+		std::uint64_t m_Bytes{};
+		std::chrono::duration<double, std::milli> m_Time{};
+	};
+
+	// Overwrites File. PBS tables require Database::PBS::Build(), RX tables require Database::RX::Load().
+	[[nodiscard]] extern "C++" auto ExportTable(ETable Table, std::filesystem::path const& File, COptions Options) noexcept -> std::expected<CExportStat, std::string>;
+
+	// One task and one file per table, named after TableName() with .json or .jsonl, in Folder. Results are in the order of rgTables.
+	[[nodiscard]] extern "C++" auto ExportTables(std::span<ETable const> rgTables, std::filesystem::path const& Folder, COptions Options) noexcept -> std::vector<std::expected<CExportStat, std::string>>;
+}
@@ -0,0 +1,242 @@
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.PBS.Breeding;
+import Database.PBS.Columnar;
+import Database.PBS.Learnset;
+import Database.Raw.PBS;
+
+
+namespace Database::PBS
+{
+	auto MakeBreedingTable(std::span<EGenderRatio const> rgGenderRatios, std::span<std::uint32_t const> rgiEggGroups,
+		std::uint32_t iUndiscovered, std::uint32_t iDitto) noexcept -> CBreedingTable
+	{
+		auto const iCount = std::min(rgGenderRatios.size(), rgiEggGroups.size());
+
+		CBreedingTable ret{ .m_Count = iCount, .m_WordsPerRow = (iCount + 63) / 64 };
+		ret.m_Compatible.resize(iCount * ret.m_WordsPerRow);
+		ret.m_EggGroups.assign_range(rgiEggGroups.first(iCount));
+		ret.m_CanBeFather = CSelection::None(iCount);
+		ret.m_CanBeMother = CSelection::None(iCount);
+
+		for (auto&& Group : ret.m_GroupMembers)
+			Group = CSelection::None(iCount);
+
+		std::vector<bool> rgbMale(iCount), rgbFemale(iCount), rgbBarren(iCount);
+
+		for (std::size_t i = 0; i < iCount; ++i)
+		{
+			auto const Ratio = rgGenderRatios[i];
+			auto const iGroups = rgiEggGroups[i];
+
+			rgbMale[i] = Ratio != EGenderRatio::AlwaysFemale && Ratio != EGenderRatio::Genderless;
+			rgbFemale[i] = Ratio != EGenderRatio::AlwaysMale && Ratio != EGenderRatio::Genderless;
+			rgbBarren[i] = iGroups == 0 || (iGroups & iUndiscovered);
+
+			if (rgbBarren[i])
+				continue;
+
+			for (auto iBits = iGroups; iBits != 0; iBits &= iBits - 1)
+				ret.m_GroupMembers[std::countr_zero(iBits)].Set(i);
+
+			if (rgbMale[i] && !(iGroups & iDitto))
+				ret.m_CanBeFather.Set(i);
+			if (rgbFemale[i] && !(iGroups & iDitto))
+				ret.m_CanBeMother.Set(i);
+		}
+
+		std::vector<std::size_t> rgiRows(iCount);
+		std::iota(rgiRows.begin(), rgiRows.end(), std::size_t{});
+
+		std::for_each(std::execution::par, rgiRows.begin(), rgiRows.end(),
+			[&](std::size_t a) noexcept
+			{
+				if (rgbBarren[a])
+					return;
+
+				auto const pRow = ret.m_Compatible.data() + a * ret.m_WordsPerRow;
+				auto const bDittoA = (rgiEggGroups[a] & iDitto) != 0;
+
+				for (std::size_t b = 0; b < iCount; ++b)
+				{
+					if (rgbBarren[b])
+						continue;
+
+					auto const bDittoB = (rgiEggGroups[b] & iDitto) != 0;
+					bool bCompatible{};
+
+					if (bDittoA || bDittoB)
+						bCompatible = bDittoA != bDittoB;	// Ditto breeds with anything but itself.
+					else
+					{
+						bCompatible = (rgiEggGroups[a] & rgiEggGroups[b]) != 0
+							&& ((rgbMale[a] && rgbFemale[b]) || (rgbFemale[a] && rgbMale[b]));
+					}
+
+					if (bCompatible)
+						pRow[b / 64] |= 1ull << (b % 64);
+				}
+			}
+		);
+
+		return ret;
+	}
+
+	void BuildBreedingTable() noexcept
+	{
+		auto const& Cols = SpeciesColumns;
+
+		std::vector const rgGenderRatios{ std::from_range, Species.m_Records | std::views::transform(&CPokemonSpecies::m_GenderRatio) };
+		Breeding = MakeBreedingTable(rgGenderRatios, Cols.m_EggGroups, Cols.EggGroupBit("Undiscovered"), Cols.EggGroupBit("Ditto"));
+	}
+
+	// Direct: level up or tutor. Egg: has it as an egg move, therefore can receive it from a father of its own.
+	static void CollectLearners(MoveHandle hMove, CSelection* pDirect, CSelection* pEgg) noexcept
+	{
+		*pDirect = CSelection::None(Breeding.m_Count);
+		*pEgg = CSelection::None(Breeding.m_Count);
+
+		for (auto&& Entry : Learnsets.Learners(hMove))
+		{
+			if (Entry.m_Method == ELearnMethod::Egg)
+				pEgg->Set(Entry.m_Species.m_Index);
+			else
+				pDirect->Set(Entry.m_Species.m_Index);
+		}
+	}
+
+	// Breadth first from the target, one layer per generation of fathers.
+	// Each layer is resolved with egg group bitmaps instead of pairwise checks.
+	[[nodiscard]] static auto SearchChain(SpeciesHandle hTarget, CSelection const& Direct, CSelection const& Egg) noexcept -> std::optional<std::vector<SpeciesHandle>>
+	{
+		if (Direct.Test(hTarget.m_Index))
+			return std::vector<SpeciesHandle>{};
+
+		// The target hatches from a mother of its own species, so does every link after the first father.
+		if (!Egg.Test(hTarget.m_Index) || !Breeding.m_CanBeMother.Test(hTarget.m_Index))
+			return std::nullopt;
+
+		auto const iCount = Breeding.m_Count;
+
+		std::vector<std::uint16_t> rgiParent(iCount, SpeciesHandle::INVALID);
+		std::vector<std::uint16_t> rgiFrontier{ hTarget.m_Index };
+		auto Visited = CSelection::None(iCount);
+		Visited.Set(hTarget.m_Index);
+
+		while (!rgiFrontier.empty())
+		{
+			auto Candidates = CSelection::None(iCount);
+
+			for (auto&& iSpecies : rgiFrontier)
+			{
+				for (auto iBits = Breeding.m_EggGroups[iSpecies]; iBits != 0; iBits &= iBits - 1)
+					Candidates |= Breeding.m_GroupMembers[std::countr_zero(iBits)];
+			}
+
+			Candidates &= Breeding.m_CanBeFather;
+			Candidates &= ~Visited;
+
+			std::vector<std::uint16_t> rgiNext{};
+			std::optional<std::uint16_t> iFound{};
+
+			Candidates.ForEach(
+				[&](std::size_t i) noexcept
+				{
+					// Any member of the current layer that can breed with i will do. The layer only holds species that can be
+					// female and i can be male, so that is a male i with a female of the layer.
+					for (auto&& iChild : rgiFrontier)
+					{
+						if (Breeding.CanBreed(SpeciesHandle{ static_cast<std::uint16_t>(i) }, SpeciesHandle{ iChild }))
+						{
+							rgiParent[i] = iChild;
+							break;
+						}
+					}
+
+					// Not visited yet: a later layer may still hold a mother for it.
+					if (rgiParent[i] == SpeciesHandle::INVALID)
+						return;
+
+					Visited.Set(i);
+
+					if (!iFound && Direct.Test(i))
+						iFound = static_cast<std::uint16_t>(i);
+					else if (Egg.Test(i) && Breeding.m_CanBeMother.Test(i))
+						rgiNext.push_back(static_cast<std::uint16_t>(i));
+				}
+			);
+
+			if (iFound)
+			{
+				std::vector<SpeciesHandle> ret{};
+
+				for (auto i = *iFound; i != hTarget.m_Index; i = rgiParent[i])
+					ret.push_back(SpeciesHandle{ i });
+
+				return ret;
+			}
+
+			rgiFrontier = std::move(rgiNext);
+		}
+
+		return std::nullopt;
+	}
+
+	auto FindEggMoveChain(SpeciesHandle hTarget, MoveHandle hMove) noexcept -> std::optional<std::vector<SpeciesHandle>>
+	{
+		if (hTarget.m_Index >= Breeding.m_Count || !Moves.At(hMove))
+			return std::nullopt;
+
+		CSelection Direct{}, Egg{};
+		CollectLearners(hMove, &Direct, &Egg);
+
+		return SearchChain(hTarget, Direct, Egg);
+	}
+
+	auto FindEggMoveChain(SpeciesHandle hTarget, CSelection const& Direct, CSelection const& Egg) noexcept -> std::optional<std::vector<SpeciesHandle>>
+	{
+		if (hTarget.m_Index >= Breeding.m_Count || Direct.m_Size != Breeding.m_Count || Egg.m_Size != Breeding.m_Count)
+			return std::nullopt;
+
+		return SearchChain(hTarget, Direct, Egg);
+	}
+
+	auto EggMoveReachability(CSelection const& Targets) noexcept -> std::vector<CEggMoveReach>
+	{
+		auto const rgiTargets = Targets.Indices();
+		std::vector<std::vector<CEggMoveReach>> rgPerTarget(rgiTargets.size());
+
+		std::transform(std::execution::par, rgiTargets.begin(), rgiTargets.end(), rgPerTarget.begin(),
+			[](std::uint16_t iTarget) noexcept
+			{
+				std::vector<CEggMoveReach> ret{};
+				CSelection Direct{}, Egg{};
+
+				for (auto&& hMove : Species.m_Records[iTarget].m_EggMoves)
+				{
+					CollectLearners(hMove, &Direct, &Egg);
+					auto const Chain = SearchChain(SpeciesHandle{ iTarget }, Direct, Egg);
+
+					ret.push_back(
+						CEggMoveReach{
+							.m_Species = SpeciesHandle{ iTarget },
+							.m_Move = hMove,
+							.m_ChainLength = Chain ? static_cast<std::uint8_t>(std::min<std::size_t>(Chain->size(), CEggMoveReach::UNREACHABLE - 1)) : CEggMoveReach::UNREACHABLE,
+						}
+					);
+				}
+
+				return ret;
+			}
+		);
+
+		return rgPerTarget | std::views::join | std::ranges::to<std::vector>();
+	}
+}
@@ -0,0 +1,71 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module Database.PBS.Breeding;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.PBS.Columnar;
+import Database.Raw.PBS;
+
+export namespace Database::PBS
+{
+	// Rows are species handles, same as the species columns.
+	struct CBreedingTable final
+	{
+		std::size_t m_Count{};
+		std::size_t m_WordsPerRow{};
+		std::vector<std::uint64_t> m_Compatible{};	// Species x species bit matrix, [a * m_WordsPerRow + b / 64].
+		std::vector<std::uint32_t> m_EggGroups{};	// Same bits as SpeciesColumns.m_EggGroups, the searches only read this table.
+
+		std::array<CSelection, 32> m_GroupMembers{};	// Per egg group bit of SpeciesColumns.m_EggGroups.
+		CSelection m_CanBeFather{};	// Can be male, is not Ditto and not Undiscovered. Only the father passes egg moves.
+		CSelection m_CanBeMother{};	// Can be female and is not Undiscovered.
+
+		[[nodiscard]] inline bool CanBreed(SpeciesHandle a, SpeciesHandle b) const noexcept
+		{
+			return (m_Compatible[a.m_Index * m_WordsPerRow + b.m_Index / 64] >> (b.m_Index % 64)) & 1;
+		}
+
+		[[nodiscard]] inline auto Partners(SpeciesHandle hSpecies) const noexcept -> std::span<std::uint64_t const>
+		{
+			return std::span{ m_Compatible }.subspan(hSpecies.m_Index * m_WordsPerRow, m_WordsPerRow);
+		}
+	};
+
+	inline CBreedingTable Breeding;
+
+	// Fathers in passing order: the first one learns the move by itself, the last one breeds with the target's mother.
+	// Every father is male, every species after the first one is also hatched from a female of its own, and so is the target.
+	// Empty if the target can get the move without breeding at all; nullopt if it cannot get it by breeding.
+	[[nodiscard]] extern "C++" auto FindEggMoveChain(SpeciesHandle hTarget, MoveHandle hMove) noexcept -> std::optional<std::vector<SpeciesHandle>>;
+
+	// Same as above, with the species that learn the move directly and those that have it as an egg move.
+	[[nodiscard]] extern "C++" auto FindEggMoveChain(SpeciesHandle hTarget, CSelection const& Direct, CSelection const& Egg) noexcept -> std::optional<std::vector<SpeciesHandle>>;
+
+	struct CEggMoveReach final
+	{
+		SpeciesHandle m_Species{};
+		MoveHandle m_Move{};
+		std::uint8_t m_ChainLength{};	// Number of fathers, UNREACHABLE if there is no chain.
+
+		static constexpr std::uint8_t UNREACHABLE = 0xFF;
+	};
+
+	// Every egg move of every selected species, searched in parallel across species.
+	[[nodiscard]] extern "C++" auto EggMoveReachability(CSelection const& Targets) noexcept -> std::vector<CEggMoveReach>;
+
+	// One entry per species. The bits of the two egg groups are those of rgiEggGroups, 0 if the game has no such group.
+	[[nodiscard]] extern "C++" auto MakeBreedingTable(std::span<EGenderRatio const> rgGenderRatios, std::span<std::uint32_t const> rgiEggGroups,
+		std::uint32_t iUndiscovered, std::uint32_t iDitto) noexcept -> CBreedingTable;
+
+	extern "C++" void BuildBreedingTable() noexcept;
+}
@@ -0,0 +1,514 @@
+module;
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HYDROGENIUM_SSE2 1
+#endif
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module Database.PBS.Columnar;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+import UtlLog;
+import UtlString;
+import Database.PBS;
+
+// Row i of every column is Database::PBS::Species.m_Records[i], i.e. the row index is the species handle.
+
+export namespace Database::PBS
+{
+	// Same order as BaseStats in pokemon.txt
+	enum EStat : std::uint8_t { Stat_HP, Stat_Attack, Stat_Defense, Stat_Speed, Stat_SpAtk, Stat_SpDef, Stat_COUNT };
+
+	enum struct ECompare : std::uint8_t { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+	inline constexpr std::uint8_t NO_TYPE = 0xFF;
+
+	struct CSpeciesColumns final
+	{
+		std::size_t m_Count{};
+
+		std::array<std::vector<std::uint8_t>, Stat_COUNT> m_BaseStats{};
+		std::vector<std::uint16_t> m_BST{};
+		std::vector<std::uint8_t> m_CatchRate{};
+		std::vector<std::uint16_t> m_BaseExp{};
+		std::vector<std::uint8_t> m_Generation{};
+		std::vector<std::uint8_t> m_Type1{};	// Type handle index.
+		std::vector<std::uint8_t> m_Type2{};	// Same as m_Type1 for single-typed species.
+		std::vector<std::uint32_t> m_EggGroups{};	// Bit i is set if the species is in m_EggGroupNames[i].
+
+		std::vector<std::string_view> m_EggGroupNames{};	// At most 32, in order of first appearance.
+
+		[[nodiscard]] auto EggGroupBit(std::string_view szEggGroup) const noexcept -> std::uint32_t
+		{
+			if (auto const it = std::ranges::find(m_EggGroupNames, szEggGroup); it != m_EggGroupNames.cend())
+				return 1u << (it - m_EggGroupNames.cbegin());
+
+			return 0;
+		}
+	};
+
+	inline CSpeciesColumns SpeciesColumns;
+
+	// One bit per row. Bits past m_Size are always zero.
+	struct CSelection final
+	{
+		std::vector<std::uint64_t> m_Bits{};
+		std::size_t m_Size{};
+
+		[[nodiscard]] static auto None(std::size_t iSize) noexcept -> CSelection
+		{
+			return CSelection{ .m_Bits = std::vector<std::uint64_t>((iSize + 63) / 64, 0), .m_Size = iSize };
+		}
+
+		[[nodiscard]] static auto All(std::size_t iSize) noexcept -> CSelection
+		{
+			auto ret = CSelection{ .m_Bits = std::vector<std::uint64_t>((iSize + 63) / 64, ~0ull), .m_Size = iSize };
+			ret.ClearTail();
+			return ret;
+		}
+
+		inline void ClearTail() noexcept
+		{
+			if (auto const iRem = m_Size % 64; iRem != 0 && !m_Bits.empty())
+				m_Bits.back() &= (1ull << iRem) - 1;
+		}
+
+		[[nodiscard]] inline auto Test(std::size_t i) const noexcept -> bool { return (m_Bits[i / 64] >> (i % 64)) & 1; }
+		inline void Set(std::size_t i) noexcept { m_Bits[i / 64] |= 1ull << (i % 64); }
+
+		[[nodiscard]] auto Count() const noexcept -> std::size_t
+		{
+			std::size_t ret{};
+			for (auto&& iWord : m_Bits)
+				ret += std::popcount(iWord);
+			return ret;
+		}
+
+		CSelection& operator&=(CSelection const& rhs) noexcept
+		{
+			for (auto&& [lhs, r] : std::views::zip(m_Bits, rhs.m_Bits))
+				lhs &= r;
+			return *this;
+		}
+
+		CSelection& operator|=(CSelection const& rhs) noexcept
+		{
+			for (auto&& [lhs, r] : std::views::zip(m_Bits, rhs.m_Bits))
+				lhs |= r;
+			return *this;
+		}
+
+		[[nodiscard]] auto operator~() const noexcept -> CSelection
+		{
+			auto ret = *this;
+			for (auto&& iWord : ret.m_Bits)
+				iWord = ~iWord;
+			ret.ClearTail();
+			return ret;
+		}
+
+		template <typename F>
+		void ForEach(F&& fn) const noexcept
+		{
+			for (auto&& [iWordIndex, iWord] : std::views::enumerate(m_Bits))
+			{
+				for (auto iBits = iWord; iBits != 0; iBits &= iBits - 1)
+					fn(static_cast<std::size_t>(iWordIndex) * 64 + std::countr_zero(iBits));
+			}
+		}
+
+		[[nodiscard]] auto Indices() const noexcept -> std::vector<std::uint16_t>
+		{
+			std::vector<std::uint16_t> ret{};
+			ret.reserve(Count());
+			ForEach([&](std::size_t i) noexcept { ret.push_back(static_cast<std::uint16_t>(i)); });
+			return ret;
+		}
+	};
+
+	[[nodiscard]] inline auto operator&(CSelection lhs, CSelection const& rhs) noexcept -> CSelection { lhs &= rhs; return lhs; }
+	[[nodiscard]] inline auto operator|(CSelection lhs, CSelection const& rhs) noexcept -> CSelection { lhs |= rhs; return lhs; }
+
+	struct CAggregate final
+	{
+		std::size_t m_Count{};
+		std::uint64_t m_Sum{};
+		std::uint32_t m_Min{ std::numeric_limits<std::uint32_t>::max() };
+		std::uint32_t m_Max{};
+
+		[[nodiscard]] inline auto Mean() const noexcept -> double { return m_Count ? (double)m_Sum / (double)m_Count : 0.0; }
+
+		inline void Add(std::uint32_t iValue) noexcept
+		{
+			++m_Count;
+			m_Sum += iValue;
+			m_Min = std::min(m_Min, iValue);
+			m_Max = std::max(m_Max, iValue);
+		}
+	};
+}
+
+namespace Database::PBS
+{
+	template <ECompare Op, typename T>
+	[[nodiscard]] inline constexpr bool CompareScalar(T lhs, T rhs) noexcept
+	{
+		if constexpr (Op == ECompare::Equal) return lhs == rhs;
+		else if constexpr (Op == ECompare::NotEqual) return lhs != rhs;
+		else if constexpr (Op == ECompare::Less) return lhs < rhs;
+		else if constexpr (Op == ECompare::LessEqual) return lhs <= rhs;
+		else if constexpr (Op == ECompare::Greater) return lhs > rhs;
+		else return lhs >= rhs;
+	}
+
+#ifdef HYDROGENIUM_SSE2
+	// SSE2 only has signed compares. Flip the sign bit of both sides to get the unsigned order.
+	// Returns lanes in the 0/-1 form, byte or word wide depending on T.
+	template <ECompare Op, typename T>
+	[[nodiscard]] inline auto CompareLanes(__m128i lhs, __m128i rhs) noexcept -> __m128i
+	{
+		static_assert(sizeof(T) == 1 || sizeof(T) == 2);
+
+		auto const bias = sizeof(T) == 1 ? _mm_set1_epi8((char)0x80) : _mm_set1_epi16((short)0x8000);
+		lhs = _mm_xor_si128(lhs, bias);
+		rhs = _mm_xor_si128(rhs, bias);
+
+		auto const fnGt = [](__m128i a, __m128i b) static noexcept { if constexpr (sizeof(T) == 1) return _mm_cmpgt_epi8(a, b); else return _mm_cmpgt_epi16(a, b); };
+		auto const fnEq = [](__m128i a, __m128i b) static noexcept { if constexpr (sizeof(T) == 1) return _mm_cmpeq_epi8(a, b); else return _mm_cmpeq_epi16(a, b); };
+		auto const AllOnes = _mm_set1_epi32(-1);
+
+		if constexpr (Op == ECompare::Equal) return fnEq(lhs, rhs);
+		else if constexpr (Op == ECompare::NotEqual) return _mm_xor_si128(fnEq(lhs, rhs), AllOnes);
+		else if constexpr (Op == ECompare::Less) return fnGt(rhs, lhs);
+		else if constexpr (Op == ECompare::LessEqual) return _mm_xor_si128(fnGt(lhs, rhs), AllOnes);
+		else if constexpr (Op == ECompare::Greater) return fnGt(lhs, rhs);
+		else return _mm_xor_si128(fnGt(rhs, lhs), AllOnes);
+	}
+
+	// 64 rows into one selection word.
+	template <ECompare Op, typename T>
+	[[nodiscard]] inline auto CompareBlock64(T const* lhs, T const* rhs, bool bRhsIsScalar) noexcept -> std::uint64_t
+	{
+		static constexpr auto LANES = 16 / sizeof(T);
+
+		auto const Scalar = sizeof(T) == 1 ? _mm_set1_epi8((char)*rhs) : _mm_set1_epi16((short)*rhs);
+		std::uint64_t ret{};
+
+		for (std::size_t i = 0; i < 64; i += 16)
+		{
+			std::uint32_t iMask{};
+
+			if constexpr (sizeof(T) == 1)
+			{
+				auto const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(lhs + i));
+				auto const b = bRhsIsScalar ? Scalar : _mm_loadu_si128(reinterpret_cast<__m128i const*>(rhs + i));
+				iMask = (std::uint32_t)_mm_movemask_epi8(CompareLanes<Op, T>(a, b));
+			}
+			else
+			{
+				auto const a0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(lhs + i));
+				auto const a1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(lhs + i + LANES));
+				auto const b0 = bRhsIsScalar ? Scalar : _mm_loadu_si128(reinterpret_cast<__m128i const*>(rhs + i));
+				auto const b1 = bRhsIsScalar ? Scalar : _mm_loadu_si128(reinterpret_cast<__m128i const*>(rhs + i + LANES));
+
+				// 0/-1 words saturate into 0/-1 bytes.
+				iMask = (std::uint32_t)_mm_movemask_epi8(_mm_packs_epi16(CompareLanes<Op, T>(a0, b0), CompareLanes<Op, T>(a1, b1)));
+			}
+
+			ret |= (std::uint64_t)iMask << i;
+		}
+
+		return ret;
+	}
+#endif
+
+	template <ECompare Op, typename T>
+	[[nodiscard]] auto FilterImpl(std::span<T const> lhs, T const* rhs, bool bRhsIsScalar) noexcept -> CSelection
+	{
+		auto ret = CSelection::None(lhs.size());
+		std::size_t i = 0;
+
+#ifdef HYDROGENIUM_SSE2
+		for (; i + 64 <= lhs.size(); i += 64)
+			ret.m_Bits[i / 64] = CompareBlock64<Op, T>(lhs.data() + i, bRhsIsScalar ? rhs : rhs + i, bRhsIsScalar);
+#endif
+
+		for (; i < lhs.size(); ++i)
+		{
+			if (CompareScalar<Op>(lhs[i], bRhsIsScalar ? *rhs : rhs[i]))
+				ret.Set(i);
+		}
+
+		return ret;
+	}
+
+	template <typename T>
+	[[nodiscard]] auto FilterDispatch(std::span<T const> lhs, T const* rhs, bool bRhsIsScalar, ECompare Op) noexcept -> CSelection
+	{
+		switch (Op)
+		{
+		case ECompare::Equal:			return FilterImpl<ECompare::Equal>(lhs, rhs, bRhsIsScalar);
+		case ECompare::NotEqual:		return FilterImpl<ECompare::NotEqual>(lhs, rhs, bRhsIsScalar);
+		case ECompare::Less:			return FilterImpl<ECompare::Less>(lhs, rhs, bRhsIsScalar);
+		case ECompare::LessEqual:		return FilterImpl<ECompare::LessEqual>(lhs, rhs, bRhsIsScalar);
+		case ECompare::Greater:			return FilterImpl<ECompare::Greater>(lhs, rhs, bRhsIsScalar);
+		case ECompare::GreaterEqual:	return FilterImpl<ECompare::GreaterEqual>(lhs, rhs, bRhsIsScalar);
+		}
+
+		std::unreachable();
+	}
+}
+
+export namespace Database::PBS
+{
+	// Rows where Column[i] <Op> Value.
+	[[nodiscard]] inline auto Filter(std::span<std::uint8_t const> Column, ECompare Op, std::uint8_t Value) noexcept -> CSelection
+	{
+		return FilterDispatch(Column, &Value, true, Op);
+	}
+
+	[[nodiscard]] inline auto Filter(std::span<std::uint16_t const> Column, ECompare Op, std::uint16_t Value) noexcept -> CSelection
+	{
+		return FilterDispatch(Column, &Value, true, Op);
+	}
+
+	// Rows where lhs[i] <Op> rhs[i].
+	[[nodiscard]] inline auto Filter(std::span<std::uint8_t const> lhs, ECompare Op, std::span<std::uint8_t const> rhs) noexcept -> CSelection
+	{
+		return FilterDispatch(lhs, rhs.data(), false, Op);
+	}
+
+	[[nodiscard]] inline auto Filter(std::span<std::uint16_t const> lhs, ECompare Op, std::span<std::uint16_t const> rhs) noexcept -> CSelection
+	{
+		return FilterDispatch(lhs, rhs.data(), false, Op);
+	}
+
+	// Rows where (Column[i] & iMask) != 0.
+	[[nodiscard]] inline auto FilterAnyBits(std::span<std::uint32_t const> Column, std::uint32_t iMask) noexcept -> CSelection
+	{
+		auto ret = CSelection::None(Column.size());
+
+		for (std::size_t i = 0; i < Column.size(); ++i)
+			ret.m_Bits[i / 64] |= (std::uint64_t)((Column[i] & iMask) != 0) << (i % 64);
+
+		return ret;
+	}
+
+	// Species having the type in either slot. None for an invalid handle, which would otherwise truncate into NO_TYPE.
+	[[nodiscard]] inline auto FilterType(TypeHandle hType) noexcept -> CSelection
+	{
+		if (!hType || hType.m_Index >= NO_TYPE) [[unlikely]]
+			return CSelection::None(SpeciesColumns.m_Count);
+
+		auto const iType = static_cast<std::uint8_t>(hType.m_Index);
+
+		return Filter(SpeciesColumns.m_Type1, ECompare::Equal, iType)
+			| Filter(SpeciesColumns.m_Type2, ECompare::Equal, iType);
+	}
+
+	template <typename T>
+	[[nodiscard]] auto Aggregate(std::span<T const> Column, CSelection const& Selection) noexcept -> CAggregate
+	{
+		CAggregate ret{};
+
+		for (auto&& [iWordIndex, iWord] : std::views::enumerate(Selection.m_Bits))
+		{
+			auto const iBase = static_cast<std::size_t>(iWordIndex) * 64;
+
+#ifdef HYDROGENIUM_SSE2
+			if constexpr (sizeof(T) == 1)
+			{
+				// Dense block, sum with SAD against zero.
+				if (iWord == ~0ull)
+				{
+					auto Acc = _mm_setzero_si128();
+					auto Lo = _mm_set1_epi8((char)0xFF), Hi = _mm_setzero_si128();
+
+					for (std::size_t i = 0; i < 64; i += 16)
+					{
+						auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(Column.data() + iBase + i));
+						Acc = _mm_add_epi64(Acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+						Lo = _mm_min_epu8(Lo, v);
+						Hi = _mm_max_epu8(Hi, v);
+					}
+
+					alignas(16) std::uint8_t rgLo[16], rgHi[16];
+					_mm_store_si128(reinterpret_cast<__m128i*>(rgLo), Lo);
+					_mm_store_si128(reinterpret_cast<__m128i*>(rgHi), Hi);
+
+					ret.m_Count += 64;
+					ret.m_Sum += (std::uint64_t)_mm_cvtsi128_si32(Acc) + (std::uint64_t)_mm_cvtsi128_si32(_mm_srli_si128(Acc, 8));
+					ret.m_Min = std::min<std::uint32_t>(ret.m_Min, std::ranges::min(rgLo));
+					ret.m_Max = std::max<std::uint32_t>(ret.m_Max, std::ranges::max(rgHi));
+					continue;
+				}
+			}
+#endif
+
+			for (auto iBits = iWord; iBits != 0; iBits &= iBits - 1)
+				ret.Add(Column[iBase + std::countr_zero(iBits)]);
+		}
+
+		return ret;
+	}
+
+	// Dense group-by: result[k] aggregates the selected rows with Keys[i] == k.
+	template <typename T, typename K>
+	[[nodiscard]] auto AggregateBy(std::span<T const> Column, std::span<K const> Keys, CSelection const& Selection) noexcept -> std::vector<CAggregate>
+	{
+		std::vector<CAggregate> ret{};
+
+		Selection.ForEach(
+			[&](std::size_t i) noexcept
+			{
+				auto const iKey = static_cast<std::size_t>(Keys[i]);
+
+				if (iKey >= ret.size())
+					ret.resize(iKey + 1);
+
+				ret[iKey].Add(Column[i]);
+			}
+		);
+
+		return ret;
+	}
+
+	// Group-by with types as the inner key: result[iOuterKey * Types.size() + iType].
+	// Dual-typed species count towards both of their types.
+	template <typename T, typename K>
+	[[nodiscard]] auto AggregateByType(std::span<T const> Column, std::span<K const> OuterKeys, CSelection const& Selection) noexcept -> std::vector<CAggregate>
+	{
+		std::vector<CAggregate> ret{};
+		auto const iTypeCount = Types.size();
+
+		Selection.ForEach(
+			[&](std::size_t i) noexcept
+			{
+				auto const iOuter = OuterKeys.empty() ? 0 : static_cast<std::size_t>(OuterKeys[i]);
+				auto const fnAdd = [&](std::uint8_t iType) noexcept
+				{
+					if (iType == NO_TYPE)
+						return;
+
+					auto const iKey = iOuter * iTypeCount + iType;
+
+					if (iKey >= ret.size())
+						ret.resize(iKey + 1);
+
+					ret[iKey].Add(Column[i]);
+				};
+
+				fnAdd(SpeciesColumns.m_Type1[i]);
+
+				if (SpeciesColumns.m_Type2[i] != SpeciesColumns.m_Type1[i])
+					fnAdd(SpeciesColumns.m_Type2[i]);
+			}
+		);
+
+		return ret;
+	}
+
+	// Stable LSD radix sort of the selected rows by Column, returning row indices.
+	template <typename T>
+	[[nodiscard]] auto ArgSort(std::span<T const> Column, CSelection const& Selection, bool bDescending = false) noexcept -> std::vector<std::uint16_t>
+	{
+		static_assert(sizeof(T) <= 2);
+
+		auto rgRows = Selection.Indices();
+		std::vector<std::uint16_t> rgScratch(rgRows.size());
+
+		for (std::size_t iShift = 0; iShift < sizeof(T) * 8; iShift += 8)
+		{
+			std::array<std::uint32_t, 257> rgOffsets{};
+
+			auto const fnDigit = [&](std::uint16_t iRow) noexcept -> std::size_t
+			{
+				auto const iDigit = (static_cast<std::size_t>(Column[iRow]) >> iShift) & 0xFF;
+				return bDescending ? 0xFF - iDigit : iDigit;
+			};
+
+			for (auto&& iRow : rgRows)
+				++rgOffsets[fnDigit(iRow) + 1];
+
+			for (std::size_t i = 1; i < rgOffsets.size(); ++i)
+				rgOffsets[i] += rgOffsets[i - 1];
+
+			for (auto&& iRow : rgRows)
+				rgScratch[rgOffsets[fnDigit(iRow)]++] = iRow;
+
+			rgRows.swap(rgScratch);
+		}
+
+		return rgRows;
+	}
+
+	void BuildSpeciesColumns() noexcept
+	{
+		CSpeciesColumns ret{};
+		auto const iCount = Species.size();
+
+		ret.m_Count = iCount;
+
+		for (auto&& Column : ret.m_BaseStats)
+			Column.resize(iCount);
+
+		ret.m_BST.resize(iCount);
+		ret.m_CatchRate.resize(iCount);
+		ret.m_BaseExp.resize(iCount);
+		ret.m_Generation.resize(iCount);
+		ret.m_Type1.resize(iCount, NO_TYPE);
+		ret.m_Type2.resize(iCount, NO_TYPE);
+		ret.m_EggGroups.resize(iCount);
+
+		for (auto&& [i, Spec] : std::views::enumerate(Species))
+		{
+			std::uint16_t iTotal{};
+
+			for (int iStat = 0; iStat < Stat_COUNT; ++iStat)
+			{
+				ret.m_BaseStats[iStat][i] = Spec.m_BaseStats[iStat];
+				iTotal += Spec.m_BaseStats[iStat];
+			}
+
+			ret.m_BST[i] = iTotal;
+			ret.m_CatchRate[i] = Spec.m_CatchRate;
+			ret.m_BaseExp[i] = Spec.m_BaseExp;
+			ret.m_Generation[i] = Spec.m_Generation;
+
+			if (!Spec.m_Types.empty())
+			{
+				ret.m_Type1[i] = static_cast<std::uint8_t>(Spec.m_Types.front().m_Index);
+				ret.m_Type2[i] = static_cast<std::uint8_t>(Spec.m_Types.back().m_Index);
+			}
+
+			for (auto&& szEggGroup : Spec.m_EggGroups)
+			{
+				auto it = std::ranges::find(ret.m_EggGroupNames, szEggGroup);
+
+				if (it == ret.m_EggGroupNames.end())
+				{
+					if (ret.m_EggGroupNames.size() >= 32) [[unlikely]]
+					{
+						UTIL_LogWarning(ELogCategory::Database, "[{}] More than 32 egg groups, '{}' is not indexed.", __FUNCTION__, szEggGroup);
+						continue;
+					}
+
+					it = ret.m_EggGroupNames.insert(it, szEggGroup);
+				}
+
+				ret.m_EggGroups[i] |= 1u << (it - ret.m_EggGroupNames.begin());
+			}
+		}
+
+		SpeciesColumns = std::move(ret);
+	}
+}
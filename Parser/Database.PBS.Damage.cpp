@@ -0,0 +1,304 @@
+#include <assert.h>
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.PBS.Columnar;
+import Database.PBS.Damage;
+import Database.Raw.PBS;
+
+
+namespace Database::PBS
+{
+	// Everything about the defenders that does not depend on the attacker, computed once per run.
+	struct CPreparedDefenders final
+	{
+		std::vector<std::uint16_t> m_Rows{};
+		std::vector<std::uint16_t> m_HP{};
+		std::vector<double> m_DefenseRcp{};	// 1 / (50 * Defense), see the damage formula.
+		std::vector<double> m_SpDefRcp{};	// Same as above.
+		std::vector<std::vector<std::uint32_t>> m_Effectiveness{};	// [Attacking type][Defender], in units of EFFECTIVENESS_NORMAL.
+	};
+
+	[[nodiscard]] static auto CalcHP(std::uint32_t iBase, CDamageAssumptions const& Assumptions) noexcept -> std::uint32_t
+	{
+		if (iBase == 1)	// Shedinja
+			return 1;
+
+		return (2 * iBase + Assumptions.m_IV + Assumptions.m_EV / 4) * Assumptions.m_Level / 100 + Assumptions.m_Level + 10;
+	}
+
+	[[nodiscard]] static auto CalcStat(std::uint32_t iBase, std::int8_t iNature, CDamageAssumptions const& Assumptions) noexcept -> std::uint32_t
+	{
+		auto const iRaw = (2 * iBase + Assumptions.m_IV + Assumptions.m_EV / 4) * Assumptions.m_Level / 100 + 5;
+		return iRaw * (10 + iNature) / 10;
+	}
+
+	[[nodiscard]] static auto PrepareDefenders(std::span<std::uint16_t const> rgiDefenders, CDamageAssumptions const& Assumptions) noexcept -> CPreparedDefenders
+	{
+		auto const& Cols = SpeciesColumns;
+		auto const iCount = rgiDefenders.size();
+
+		CPreparedDefenders ret{};
+		ret.m_Rows.assign_range(rgiDefenders);
+		ret.m_HP.resize(iCount);
+		ret.m_DefenseRcp.resize(iCount);
+		ret.m_SpDefRcp.resize(iCount);
+
+		for (auto&& [i, iRow] : std::views::enumerate(rgiDefenders))
+		{
+			ret.m_HP[i] = static_cast<std::uint16_t>(CalcHP(Cols.m_BaseStats[Stat_HP][iRow], Assumptions));
+			ret.m_DefenseRcp[i] = 1.0 / (50.0 * CalcStat(Cols.m_BaseStats[Stat_Defense][iRow], Assumptions.m_DefenderNature, Assumptions));
+			ret.m_SpDefRcp[i] = 1.0 / (50.0 * CalcStat(Cols.m_BaseStats[Stat_SpDef][iRow], Assumptions.m_DefenderNature, Assumptions));
+		}
+
+		// Transpose the dual type profiles so the inner loop reads one contiguous row per move.
+		ret.m_Effectiveness.resize(TypeChart.m_Count);
+
+		for (auto&& [iAtkType, Row] : std::views::enumerate(ret.m_Effectiveness))
+		{
+			Row.resize(iCount);
+
+			for (auto&& [i, iRow] : std::views::enumerate(rgiDefenders))
+			{
+				if (Cols.m_Type1[iRow] == NO_TYPE) [[unlikely]]
+				{
+					Row[i] = EFFECTIVENESS_NORMAL;
+					continue;
+				}
+
+				Row[i] = TypeChart.Effectiveness(
+					TypeHandle{ static_cast<std::uint16_t>(iAtkType) },
+					TypeHandle{ Cols.m_Type1[iRow] },
+					TypeHandle{ Cols.m_Type2[iRow] }
+				);
+			}
+		}
+
+		return ret;
+	}
+
+	auto DamagingMovesOf(SpeciesHandle hSpecies) noexcept -> std::vector<MoveHandle>
+	{
+		auto const pSpecies = Species.At(hSpecies);
+		if (pSpecies == nullptr)
+			return {};
+
+		std::vector<MoveHandle> ret{};
+		ret.reserve(pSpecies->m_Moves.size() + pSpecies->m_TutorMoves.size() + pSpecies->m_EggMoves.size());
+
+		for (auto&& [iLevel, hMove] : pSpecies->m_Moves)
+			ret.push_back(hMove);
+
+		ret.append_range(pSpecies->m_TutorMoves);
+		ret.append_range(pSpecies->m_EggMoves);
+
+		std::erase_if(ret,
+			[](MoveHandle hMove) static noexcept
+			{
+				auto const pMove = Moves.At(hMove);
+				return pMove == nullptr || pMove->m_Category == EMoveCategory::Status || pMove->m_Power <= 1 || !pMove->m_Type;
+			}
+		);
+
+		std::ranges::sort(ret);
+		auto const [itFirst, itLast] = std::ranges::unique(ret);
+		ret.erase(itFirst, itLast);
+
+		return ret;
+	}
+
+	// floor(K / D) as floor(K * (1 / D) + RECIPROCAL_BIAS), exact while D < 2^19 and the quotient < 2^25, which the
+	// smallest D of 50 * 4 guarantees for any 32-bit K. The two roundings are then off by less than 2^-26, a quotient
+	// that is not whole falls at least 1 / D > 2^-19 short of the next integer: the bias lifts a whole quotient that
+	// rounded down, and pushes no other one past an integer.
+	inline constexpr double RECIPROCAL_BIAS = 0x1p-20;
+
+	[[nodiscard]] static auto ComputeBlock(SpeciesHandle hAttacker, CPreparedDefenders const& Defenders, CDamageAssumptions const& Assumptions) noexcept -> CDamageBlock
+	{
+		auto const& Cols = SpeciesColumns;
+		auto const iRow = hAttacker.m_Index;
+		auto const iDefenders = Defenders.m_Rows.size();
+
+		CDamageBlock ret{ .m_Attacker = hAttacker, .m_Moves = DamagingMovesOf(hAttacker) };
+		ret.m_Min.resize(ret.m_Moves.size() * iDefenders);
+		ret.m_Max.resize(ret.m_Moves.size() * iDefenders);
+
+		auto const iAttack = CalcStat(Cols.m_BaseStats[Stat_Attack][iRow], Assumptions.m_AttackerNature, Assumptions);
+		auto const iSpAtk = CalcStat(Cols.m_BaseStats[Stat_SpAtk][iRow], Assumptions.m_AttackerNature, Assumptions);
+		auto const iLevelFactor = 2u * Assumptions.m_Level / 5 + 2;
+
+		for (auto&& [iMove, hMove] : std::views::enumerate(ret.m_Moves))
+		{
+			auto const& Move = Moves[hMove];
+			auto const bPhysical = Move.m_Category == EMoveCategory::Physical;
+			auto const bSTAB = Assumptions.m_STAB && (Move.m_Type.m_Index == Cols.m_Type1[iRow] || Move.m_Type.m_Index == Cols.m_Type2[iRow]);
+
+			// floor(floor(K / D) / 50) == floor(K / (50 * D)), which is why the reciprocals are of 50 times the stat.
+			// K tops out around 2^23, the products below stay well within 32 bits.
+			std::uint32_t const iK = iLevelFactor * Move.m_Power * (bPhysical ? iAttack : iSpAtk);
+			std::uint32_t const iSTAB = bSTAB ? 3 : 2;	// Halves, floor(x * 1.5) == x * 3 / 2.
+			auto const flK = static_cast<double>(iK);
+
+			auto const pRcp = bPhysical ? Defenders.m_DefenseRcp.data() : Defenders.m_SpDefRcp.data();
+			auto const pEff = Defenders.m_Effectiveness[Move.m_Type.m_Index].data();
+			auto const pMin = ret.m_Min.data() + iMove * iDefenders;
+			auto const pMax = ret.m_Max.data() + iMove * iDefenders;
+
+			// Branch free and without a single variable division, so that it vectorizes: x86 has no SIMD integer division,
+			// the one by the defending stat is a multiplication by its reciprocal and those by constants turn into ones too.
+			// The quotient fits in an int32, the conversion SSE2 has.
+			for (std::size_t i = 0; i < iDefenders; ++i)
+			{
+				auto const iBase = static_cast<std::uint32_t>(static_cast<std::int32_t>(flK * pRcp[i] + RECIPROCAL_BIAS)) + 2;
+				auto const iFloor = static_cast<std::uint32_t>(pEff[i] != 0);	// Anything that is not immune takes at least 1.
+
+				auto const iMin = std::max(iBase * 85 / 100 * iSTAB / 2 * pEff[i] / EFFECTIVENESS_NORMAL, iFloor);
+				auto const iMax = std::max(iBase * iSTAB / 2 * pEff[i] / EFFECTIVENESS_NORMAL, iFloor);
+
+				pMin[i] = static_cast<std::uint16_t>(std::min(iMin, 65535u));
+				pMax[i] = static_cast<std::uint16_t>(std::min(iMax, 65535u));
+			}
+		}
+
+		return ret;
+	}
+
+	auto ComputeDamageBlock(SpeciesHandle hAttacker, std::span<std::uint16_t const> rgiDefenders, CDamageAssumptions const& Assumptions) noexcept -> CDamageBlock
+	{
+		return ComputeBlock(hAttacker, PrepareDefenders(rgiDefenders, Assumptions), Assumptions);
+	}
+
+	// The binary format is documented as little endian and written straight from memory.
+	static_assert(std::endian::native == std::endian::little, "Damage matrix files are only written on little endian hosts.");
+
+	template <typename T>
+	static void WritePod(std::ofstream& f, T const& Value) noexcept
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		f.write(reinterpret_cast<char const*>(std::addressof(Value)), sizeof(T));
+	}
+
+	template <typename T>
+	static void WriteSpan(std::ofstream& f, std::span<T const> rg) noexcept
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		f.write(reinterpret_cast<char const*>(rg.data()), rg.size_bytes());
+	}
+
+	static void WriteBlockBinary(std::ofstream& f, CDamageBlock const& Block, std::size_t iDefenders) noexcept
+	{
+		WritePod(f, Block.m_Attacker.m_Index);
+		WritePod(f, static_cast<std::uint16_t>(Block.m_Moves.size()));
+
+		for (auto&& hMove : Block.m_Moves)
+			WritePod(f, hMove.m_Index);
+
+		// Interleave here rather than in the compute loop, the loop is happier with two flat arrays.
+		std::vector<std::uint16_t> rgiPairs(Block.m_Min.size() * 2);
+		for (std::size_t i = 0; i < Block.m_Min.size(); ++i)
+		{
+			rgiPairs[i * 2 + 0] = Block.m_Min[i];
+			rgiPairs[i * 2 + 1] = Block.m_Max[i];
+		}
+
+		assert(Block.m_Min.size() == Block.m_Moves.size() * iDefenders);
+		WriteSpan(f, std::span<std::uint16_t const>{ rgiPairs });
+	}
+
+	static void WriteBlockCSV(std::ofstream& f, CDamageBlock const& Block, CPreparedDefenders const& Defenders, std::string* pBuffer) noexcept
+	{
+		auto const iDefenders = Defenders.m_Rows.size();
+		auto const& Attacker = Species[Block.m_Attacker];
+
+		pBuffer->clear();
+
+		for (auto&& [iMove, hMove] : std::views::enumerate(Block.m_Moves))
+		{
+			auto const& Move = Moves[hMove];
+
+			for (std::size_t i = 0; i < iDefenders; ++i)
+			{
+				auto const& Defender = Species.m_Records[Defenders.m_Rows[i]];
+				auto const iMin = Block.m_Min[iMove * iDefenders + i], iMax = Block.m_Max[iMove * iDefenders + i];
+				auto const fHP = (double)Defenders.m_HP[i];
+
+				std::format_to(std::back_inserter(*pBuffer), "{},{},{},{},{},{},{},{:.1f},{:.1f}\n",
+					Attacker.m_Id, Attacker.m_FormId, Move.m_Id, Defender.m_Id, Defender.m_FormId,
+					iMin, iMax, iMin * 100.0 / fHP, iMax * 100.0 / fHP
+				);
+			}
+		}
+
+		f.write(pBuffer->data(), pBuffer->size());
+	}
+
+	auto WriteDamageMatrix(
+		std::filesystem::path const& Path, EDamageFormat Format, CDamageAssumptions const& Assumptions,
+		CSelection const& Attackers, CSelection const& Defenders) noexcept -> std::expected<std::size_t, std::string_view>
+	{
+		if (Species.empty() || SpeciesColumns.m_Count != Species.size() || TypeChart.m_Count != Types.size())
+			return std::unexpected("Database not built");
+
+		std::ofstream f{ Path, std::ios::binary | std::ios::trunc };
+		if (!f)
+			return std::unexpected("Failed to open output file");
+
+		auto const rgiAttackers = Attackers.Indices();
+		auto const rgiDefenders = Defenders.Indices();
+		auto const Prepared = PrepareDefenders(rgiDefenders, Assumptions);
+
+		if (Format == EDamageFormat::Binary)
+		{
+			WritePod(f, CDamageFileHeader{
+				.m_Level = Assumptions.m_Level,
+				.m_IV = Assumptions.m_IV,
+				.m_EV = Assumptions.m_EV,
+				.m_AttackerNature = Assumptions.m_AttackerNature,
+				.m_DefenderNature = Assumptions.m_DefenderNature,
+				.m_STAB = Assumptions.m_STAB,
+				.m_AttackerCount = static_cast<std::uint32_t>(rgiAttackers.size()),
+				.m_DefenderCount = static_cast<std::uint32_t>(rgiDefenders.size()),
+			});
+			WriteSpan(f, std::span<std::uint16_t const>{ rgiDefenders });
+		}
+		else
+		{
+			static constexpr std::string_view CSV_HEADER{ "attacker,attacker_form,move,defender,defender_form,min,max,min_percent,max_percent\n" };
+			f.write(CSV_HEADER.data(), CSV_HEADER.size());
+		}
+
+		// Several blocks per worker in each chunk, enough to amortize the fork-join while keeping only one chunk in memory.
+		auto const iChunkSize = std::max<std::size_t>(1, std::thread::hardware_concurrency()) * 8;
+		std::vector<CDamageBlock> rgBlocks{};
+		std::string szBuffer{};
+
+		for (auto&& Chunk : rgiAttackers | std::views::chunk(iChunkSize))
+		{
+			rgBlocks.resize(Chunk.size());
+
+			std::transform(std::execution::par, Chunk.begin(), Chunk.end(), rgBlocks.begin(),
+				[&](std::uint16_t iRow) noexcept { return ComputeBlock(SpeciesHandle{ iRow }, Prepared, Assumptions); }
+			);
+
+			for (auto&& Block : rgBlocks)
+			{
+				if (Format == EDamageFormat::Binary)
+					WriteBlockBinary(f, Block, rgiDefenders.size());
+				else
+					WriteBlockCSV(f, Block, Prepared, &szBuffer);
+			}
+
+			if (!f)
+				return std::unexpected("Failed to write output file");
+		}
+
+		return rgiAttackers.size();
+	}
+}
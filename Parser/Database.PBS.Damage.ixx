@@ -0,0 +1,74 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module Database.PBS.Damage;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.PBS.Columnar;
+
+export namespace Database::PBS
+{
+	// Applied to every attacker and every defender alike.
+	struct CDamageAssumptions final
+	{
+		std::uint8_t m_Level{ 50 };
+		std::uint8_t m_IV{ 31 };
+		std::uint8_t m_EV{ 0 };	// Per stat, 0 to 252.
+		std::int8_t m_AttackerNature{ 0 };	// -1, 0 or +1 on the attacking stat in use.
+		std::int8_t m_DefenderNature{ 0 };	// -1, 0 or +1 on the defending stat in use.
+		bool m_STAB{ true };
+	};
+
+	enum struct EDamageFormat : std::uint8_t { Binary, CSV, };
+
+	// Damage roll of every damaging move an attacker can learn against every defender.
+	// Flat layout: [Move * Defenders.size() + Defender], m_Min is the 85% roll and m_Max the 100% roll.
+	struct CDamageBlock final
+	{
+		SpeciesHandle m_Attacker{};
+		std::vector<MoveHandle> m_Moves{};
+		std::vector<std::uint16_t> m_Min{};
+		std::vector<std::uint16_t> m_Max{};
+	};
+
+	// Binary output layout, all little endian:
+	//   CDamageFileHeader
+	//   u16 defender handles[m_DefenderCount]
+	//   per attacker: u16 attacker handle, u16 move count, u16 move handles[move count],
+	//                 then { u16 min, u16 max }[move count][m_DefenderCount]
+	struct CDamageFileHeader final
+	{
+		std::array<char, 4> m_Magic{ 'P', 'D', 'M', 'G' };
+		std::uint16_t m_Version{ 1 };
+		std::uint8_t m_Level{};
+		std::uint8_t m_IV{};
+		std::uint8_t m_EV{};
+		std::int8_t m_AttackerNature{};
+		std::int8_t m_DefenderNature{};
+		std::uint8_t m_STAB{};
+		std::uint32_t m_AttackerCount{};
+		std::uint32_t m_DefenderCount{};
+	};
+
+	static_assert(std::is_trivially_copyable_v<CDamageFileHeader> && sizeof(CDamageFileHeader) == 20);
+
+	// Damaging moves from level up, tutor and egg move lists. Fixed and variable power moves (power <= 1) are skipped.
+	[[nodiscard]] extern "C++" auto DamagingMovesOf(SpeciesHandle hSpecies) noexcept -> std::vector<MoveHandle>;
+
+	[[nodiscard]] extern "C++" auto ComputeDamageBlock(SpeciesHandle hAttacker, std::span<std::uint16_t const> rgiDefenders, CDamageAssumptions const& Assumptions) noexcept -> CDamageBlock;
+
+	// Attackers are processed in parallel chunks, each chunk is written out before the next one starts.
+	// Returns the number of attackers written.
+	[[nodiscard]] extern "C++" auto WriteDamageMatrix(
+		std::filesystem::path const& Path, EDamageFormat Format, CDamageAssumptions const& Assumptions,
+		CSelection const& Attackers, CSelection const& Defenders) noexcept -> std::expected<std::size_t, std::string_view>;
+}
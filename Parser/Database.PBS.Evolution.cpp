@@ -0,0 +1,195 @@
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.PBS.Evolution;
+import Database.Raw.PBS;
+
+
+namespace Database::PBS
+{
+	[[nodiscard]] static auto FindSet(std::vector<std::uint16_t>* prgiParent, std::uint16_t i) noexcept -> std::uint16_t
+	{
+		auto& rgiParent = *prgiParent;
+
+		while (rgiParent[i] != i)
+		{
+			rgiParent[i] = rgiParent[rgiParent[i]];
+			i = rgiParent[i];
+		}
+
+		return i;
+	}
+
+	static void Unite(std::vector<std::uint16_t>* prgiParent, std::uint16_t a, std::uint16_t b) noexcept
+	{
+		a = FindSet(prgiParent, a);
+		b = FindSet(prgiParent, b);
+
+		if (a != b)
+			(*prgiParent)[std::max(a, b)] = std::min(a, b);
+	}
+
+	void BuildEvolutionGraph() noexcept
+	{
+		auto const iCount = Species.size();
+		CEvolutionGraph ret{};
+
+		// Forward edges, already grouped by source because species are visited in handle order.
+
+		ret.m_ForwardOffsets.reserve(iCount + 1);
+		ret.m_ForwardOffsets.push_back(0);
+
+		for (auto&& Spec : Species)
+		{
+			auto const hFrom = Species.HandleOf(Spec);
+
+			for (auto&& Evo : Spec.m_Evolutions)
+			{
+				if (!Evo.m_Target)	// Reported during linking.
+					continue;
+
+				ret.m_Edges.push_back(
+					CEvolutionEdge{
+						.m_From = hFrom,
+						.m_To = Evo.m_Target,
+						.m_Method = Evo.m_MethodType,
+						.m_ParamType = Evo.m_ParamType,
+						.m_ParamValue = Evo.m_ParamValue,
+					}
+				);
+			}
+
+			ret.m_ForwardOffsets.push_back(static_cast<std::uint32_t>(ret.m_Edges.size()));
+		}
+
+		// Backward edges, counting sort by target.
+
+		ret.m_BackwardOffsets.resize(iCount + 1);
+		for (auto&& Edge : ret.m_Edges)
+			++ret.m_BackwardOffsets[Edge.m_To.m_Index + 1];
+
+		std::inclusive_scan(ret.m_BackwardOffsets.begin(), ret.m_BackwardOffsets.end(), ret.m_BackwardOffsets.begin());
+		ret.m_BackwardEdges.resize(ret.m_Edges.size());
+
+		{
+			auto rgiCursor = ret.m_BackwardOffsets;
+			for (auto&& [iEdge, Edge] : std::views::enumerate(ret.m_Edges))
+				ret.m_BackwardEdges[rgiCursor[Edge.m_To.m_Index]++] = static_cast<std::uint32_t>(iEdge);
+		}
+
+		// Families are the connected components, with alternate forms glued to their base form.
+
+		std::vector<std::uint16_t> rgiParent(iCount);
+		std::iota(rgiParent.begin(), rgiParent.end(), std::uint16_t{});
+
+		for (auto&& Edge : ret.m_Edges)
+			Unite(&rgiParent, Edge.m_From.m_Index, Edge.m_To.m_Index);
+		for (auto&& Spec : Species)
+			Unite(&rgiParent, Species.HandleOf(Spec).m_Index, Spec.m_BaseForm.m_Index);
+
+		// Root: a base form nothing evolves into, preferably one that evolves into something. Lowest handle wins ties.
+		auto const fnRootScore = [&](std::uint16_t i) noexcept -> int
+		{
+			auto const bNoPrevo = ret.m_BackwardOffsets[i] == ret.m_BackwardOffsets[i + 1];
+			auto const bHasEvo = ret.m_ForwardOffsets[i] != ret.m_ForwardOffsets[i + 1];
+			auto const bBaseForm = Species.m_Records[i].m_FormId == 0;
+
+			return (bNoPrevo ? 4 : 0) + (bBaseForm ? 2 : 0) + (bHasEvo ? 1 : 0);
+		};
+
+		std::vector<std::uint16_t> rgiComponentRoot(iCount, SpeciesHandle::INVALID);
+		for (std::uint16_t i = 0; i < iCount; ++i)
+		{
+			auto& iBest = rgiComponentRoot[FindSet(&rgiParent, i)];
+
+			if (iBest == SpeciesHandle::INVALID || fnRootScore(i) > fnRootScore(iBest))
+				iBest = i;
+		}
+
+		ret.m_FamilyOf.resize(iCount, SpeciesHandle::INVALID);
+		ret.m_FamilyOffsets.push_back(0);
+		ret.m_FamilyMembers.reserve(iCount);
+
+		std::vector<bool> rgbVisited(iCount);
+
+		for (std::uint16_t i = 0; i < iCount; ++i)
+		{
+			if (FindSet(&rgiParent, i) != i)
+				continue;
+
+			auto const iFamily = static_cast<std::uint16_t>(ret.m_FamilyRoots.size());
+			auto const iFirst = ret.m_FamilyMembers.size();
+			SpeciesHandle const hRoot{ rgiComponentRoot[i] };
+
+			ret.m_FamilyRoots.push_back(hRoot);
+
+			auto const fnVisit = [&](SpeciesHandle h) noexcept
+			{
+				if (rgbVisited[h.m_Index])
+					return;
+
+				rgbVisited[h.m_Index] = true;
+				ret.m_FamilyOf[h.m_Index] = iFamily;
+				ret.m_FamilyMembers.push_back(h);
+			};
+
+			// Breadth first from the root. Alternate forms are listed right after their base form.
+			fnVisit(hRoot);
+
+			for (auto iCursor = iFirst; iCursor < ret.m_FamilyMembers.size(); ++iCursor)
+			{
+				auto const hCur = ret.m_FamilyMembers[iCursor];
+
+				for (auto&& Form : FormsOf(hCur))
+					fnVisit(Species.HandleOf(Form));
+				for (auto&& Edge : ret.EvolvesInto(hCur))
+					fnVisit(Edge.m_To);
+			}
+
+			// Whatever only reaches the family backwards, e.g. a second pre-evolution.
+			for (std::uint16_t j = i; j < iCount; ++j)
+			{
+				if (!rgbVisited[j] && FindSet(&rgiParent, j) == i)
+					fnVisit(SpeciesHandle{ j });
+			}
+
+			ret.m_FamilyOffsets.push_back(static_cast<std::uint32_t>(ret.m_FamilyMembers.size()));
+		}
+
+		// Descendants, forward edges only.
+
+		ret.m_DescendantOffsets.reserve(iCount + 1);
+		ret.m_DescendantOffsets.push_back(0);
+
+		for (std::uint16_t i = 0; i < iCount; ++i)
+		{
+			auto const iFirst = ret.m_Descendants.size();
+
+			auto const fnAdd = [&](SpeciesHandle hTarget) noexcept
+			{
+				// Several methods into the same target, or malformed data that loops.
+				if (hTarget.m_Index != i && !std::ranges::contains(std::span{ ret.m_Descendants }.subspan(iFirst), hTarget))
+					ret.m_Descendants.push_back(hTarget);
+			};
+
+			for (auto&& Edge : ret.EvolvesInto(SpeciesHandle{ i }))
+				fnAdd(Edge.m_To);
+
+			for (auto iCursor = iFirst; iCursor < ret.m_Descendants.size(); ++iCursor)
+			{
+				for (auto&& Edge : ret.EvolvesInto(ret.m_Descendants[iCursor]))
+					fnAdd(Edge.m_To);
+			}
+
+			ret.m_DescendantOffsets.push_back(static_cast<std::uint32_t>(ret.m_Descendants.size()));
+		}
+
+		Evolutions = std::move(ret);
+	}
+}
@@ -0,0 +1,95 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module Database.PBS.Evolution;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.Raw.PBS;
+
+export namespace Database::PBS
+{
+	struct CEvolutionEdge final
+	{
+		SpeciesHandle m_From{};
+		SpeciesHandle m_To{};	// Base form of the target species.
+		EEvolutionMethod m_Method{};
+		EEvolutionParam m_ParamType{};
+		std::int32_t m_ParamValue{};
+	};
+
+	// Evolution DAG over every species form, in CSR form.
+	// Nodes are species handles, edges are stored once and sorted by m_From.
+	struct CEvolutionGraph final
+	{
+		std::vector<CEvolutionEdge> m_Edges{};
+		std::vector<std::uint32_t> m_ForwardOffsets{};	// Species.size() + 1, into m_Edges.
+		std::vector<std::uint32_t> m_BackwardOffsets{};	// Species.size() + 1, into m_BackwardEdges.
+		std::vector<std::uint32_t> m_BackwardEdges{};	// Edge indices, grouped by m_To.
+
+		std::vector<std::uint16_t> m_FamilyOf{};		// Per node, family index.
+		std::vector<SpeciesHandle> m_FamilyRoots{};		// Per family.
+		std::vector<std::uint32_t> m_FamilyOffsets{};	// Family count + 1, into m_FamilyMembers.
+		std::vector<SpeciesHandle> m_FamilyMembers{};	// Each family in breadth first order, root first.
+		std::vector<std::uint32_t> m_DescendantOffsets{};	// Species.size() + 1, into m_Descendants.
+		std::vector<SpeciesHandle> m_Descendants{};
+
+		[[nodiscard]] inline auto EvolvesInto(SpeciesHandle hSpecies) const noexcept -> std::span<CEvolutionEdge const>
+		{
+			return std::span{ m_Edges }.subspan(m_ForwardOffsets[hSpecies.m_Index], m_ForwardOffsets[hSpecies.m_Index + 1] - m_ForwardOffsets[hSpecies.m_Index]);
+		}
+
+		// Indices into m_Edges.
+		[[nodiscard]] inline auto EvolvesFrom(SpeciesHandle hSpecies) const noexcept -> std::span<std::uint32_t const>
+		{
+			return std::span{ m_BackwardEdges }.subspan(m_BackwardOffsets[hSpecies.m_Index], m_BackwardOffsets[hSpecies.m_Index + 1] - m_BackwardOffsets[hSpecies.m_Index]);
+		}
+
+		[[nodiscard]] inline auto FamilyRoot(SpeciesHandle hSpecies) const noexcept -> SpeciesHandle { return m_FamilyRoots[m_FamilyOf[hSpecies.m_Index]]; }
+
+		// The whole family hSpecies belongs to, root first.
+		[[nodiscard]] inline auto Chain(SpeciesHandle hSpecies) const noexcept -> std::span<SpeciesHandle const>
+		{
+			auto const iFamily = m_FamilyOf[hSpecies.m_Index];
+			return std::span{ m_FamilyMembers }.subspan(m_FamilyOffsets[iFamily], m_FamilyOffsets[iFamily + 1] - m_FamilyOffsets[iFamily]);
+		}
+
+		[[nodiscard]] inline auto Descendants(SpeciesHandle hSpecies) const noexcept -> std::span<SpeciesHandle const>
+		{
+			return std::span{ m_Descendants }.subspan(m_DescendantOffsets[hSpecies.m_Index], m_DescendantOffsets[hSpecies.m_Index + 1] - m_DescendantOffsets[hSpecies.m_Index]);
+		}
+
+		// Roots of every family with at least one edge satisfying fnPred. One pass over the edges.
+		template <typename F>
+		[[nodiscard]] auto FamiliesWhere(F&& fnPred) const noexcept -> std::vector<SpeciesHandle>
+		{
+			std::vector<bool> rgbHit(m_FamilyRoots.size());
+			std::vector<SpeciesHandle> ret{};
+
+			for (auto&& Edge : m_Edges)
+			{
+				auto const iFamily = m_FamilyOf[Edge.m_From.m_Index];
+
+				if (!rgbHit[iFamily] && fnPred(Edge))
+				{
+					rgbHit[iFamily] = true;
+					ret.push_back(m_FamilyRoots[iFamily]);
+				}
+			}
+
+			return ret;
+		}
+	};
+
+	inline CEvolutionGraph Evolutions;
+
+	extern "C++" void BuildEvolutionGraph() noexcept;
+}
@@ -0,0 +1,129 @@
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.PBS.Learnset;
+
+
+namespace Database::PBS
+{
+	using LearnPair = std::pair<MoveHandle, CLearnEntry>;
+
+	[[nodiscard]] static auto CollectOwn(CPokemonSpecies const& Spec) noexcept -> std::vector<LearnPair>
+	{
+		auto const hSpecies = Species.HandleOf(Spec);
+		auto const iFormId = static_cast<std::uint8_t>(Spec.m_FormId);
+
+		std::vector<LearnPair> ret{};
+		ret.reserve(Spec.m_Moves.size() + Spec.m_TutorMoves.size() + Spec.m_EggMoves.size());
+
+		for (auto&& [iLevel, hMove] : Spec.m_Moves)
+			ret.emplace_back(hMove, CLearnEntry{ hSpecies, iFormId, ELearnMethod::LevelUp, static_cast<std::int16_t>(iLevel) });
+		for (auto&& hMove : Spec.m_TutorMoves)
+			ret.emplace_back(hMove, CLearnEntry{ hSpecies, iFormId, ELearnMethod::Tutor });
+		for (auto&& hMove : Spec.m_EggMoves)
+			ret.emplace_back(hMove, CLearnEntry{ hSpecies, iFormId, ELearnMethod::Egg });
+
+		return ret;
+	}
+
+	// Counting sort by move. Species are visited in handle order, so entries of a move come out ordered by species.
+	[[nodiscard]] static auto Compress(std::span<std::vector<LearnPair> const> rgPerSpecies) noexcept -> CLearnsetIndex
+	{
+		CLearnsetIndex ret{};
+		ret.m_Offsets.resize(Moves.size() + 1);
+
+		for (auto&& rgPairs : rgPerSpecies)
+		{
+			for (auto&& [hMove, Entry] : rgPairs)
+				++ret.m_Offsets[hMove.m_Index + 1];
+		}
+
+		std::inclusive_scan(ret.m_Offsets.begin(), ret.m_Offsets.end(), ret.m_Offsets.begin());
+		ret.m_Entries.resize(ret.m_Offsets.back());
+
+		auto rgiCursor = ret.m_Offsets;
+		for (auto&& rgPairs : rgPerSpecies)
+		{
+			for (auto&& [hMove, Entry] : rgPairs)
+				ret.m_Entries[rgiCursor[hMove.m_Index]++] = Entry;
+		}
+
+		return ret;
+	}
+
+	void BuildLearnsetIndex() noexcept
+	{
+		auto const iCount = Species.size();
+
+		// Unresolved moves were dropped during linking, so every handle here is valid.
+		std::vector<std::vector<LearnPair>> rgOwn(iCount);
+		std::transform(std::execution::par, Species.begin(), Species.end(), rgOwn.begin(), &CollectOwn);
+
+		Learnsets = Compress(rgOwn);
+
+		// Direct pre-evolutions of every form. Evolutions point to the base form of the target,
+		// every form of the target inherits from the evolving record.
+		std::vector<std::vector<SpeciesHandle>> rgPrevos(iCount);
+		for (auto&& Spec : Species)
+		{
+			for (auto&& Evo : Spec.m_Evolutions)
+			{
+				for (auto&& Form : FormsOf(Evo.m_Target))
+					rgPrevos[Species.HandleOf(Form).m_Index].push_back(Species.HandleOf(Spec));
+			}
+		}
+
+		std::vector<std::vector<LearnPair>> rgExpanded(iCount);
+		std::vector<std::uint16_t> rgiIndices(iCount);
+		std::iota(rgiIndices.begin(), rgiIndices.end(), std::uint16_t{});
+
+		std::for_each(std::execution::par, rgiIndices.begin(), rgiIndices.end(),
+			[&](std::uint16_t iSpecies) noexcept
+			{
+				auto& rgPairs = rgExpanded[iSpecies];
+				rgPairs = rgOwn[iSpecies];
+
+				std::vector<MoveHandle> rgKnown{ std::from_range, rgPairs | std::views::keys };
+				std::ranges::sort(rgKnown);
+
+				std::vector<std::uint16_t> rgiVisited{ iSpecies };
+				std::vector<SpeciesHandle> rgQueue{ rgPrevos[iSpecies] };
+
+				// Breadth first, so the closest pre-evolution wins.
+				for (std::size_t i = 0; i < rgQueue.size(); ++i)
+				{
+					auto const hPrevo = rgQueue[i];
+
+					if (std::ranges::contains(rgiVisited, hPrevo.m_Index))	// Malformed data can loop.
+						continue;
+
+					rgiVisited.push_back(hPrevo.m_Index);
+					rgQueue.append_range(rgPrevos[hPrevo.m_Index]);
+
+					for (auto&& [hMove, Entry] : rgOwn[hPrevo.m_Index])
+					{
+						if (std::ranges::binary_search(rgKnown, hMove))
+							continue;
+
+						auto& [_, Inherited] = rgPairs.emplace_back(hMove, Entry);
+						Inherited.m_Species = SpeciesHandle{ iSpecies };
+						Inherited.m_FormId = static_cast<std::uint8_t>(Species.m_Records[iSpecies].m_FormId);
+						Inherited.m_InheritedFrom = hPrevo;
+					}
+
+					// A move learnt by several pre-evolutions is only reported once.
+					rgKnown.append_range(rgPairs | std::views::drop(rgKnown.size()) | std::views::keys);
+					std::ranges::sort(rgKnown);
+				}
+			}
+		);
+
+		LearnsetsWithPrevos = Compress(rgExpanded);
+	}
+}
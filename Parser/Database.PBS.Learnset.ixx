@@ -0,0 +1,60 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module Database.PBS.Learnset;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+import Database.PBS;
+
+export namespace Database::PBS
+{
+	enum struct ELearnMethod : std::uint8_t { LevelUp, Tutor, Egg, };
+
+	struct CLearnEntry final
+	{
+		SpeciesHandle m_Species{};
+		std::uint8_t m_FormId{};
+		ELearnMethod m_Method{};
+		std::int16_t m_Level{};	// Only meaningful for LevelUp. 0 means 'learnt upon evolution'.
+		SpeciesHandle m_InheritedFrom{};	// Valid if the move comes from a pre-evolution instead of the species itself.
+	};
+
+	static_assert(std::is_trivially_copyable_v<CLearnEntry> && sizeof(CLearnEntry) == 8);
+
+	// Move -> learners, in CSR form. Entries of a move are contiguous and ordered by species handle.
+	// Everything is handle based, so the index stays valid as long as the tables it was built from.
+	// Not persisted: the linked tables themselves are rebuilt from the PBS at every Build(), and so is this.
+	struct CLearnsetIndex final
+	{
+		std::vector<std::uint32_t> m_Offsets{};	// Moves.size() + 1 entries.
+		std::vector<CLearnEntry> m_Entries{};
+
+		[[nodiscard]] inline auto Learners(MoveHandle hMove) const noexcept -> std::span<CLearnEntry const>
+		{
+			if (hMove.m_Index + 1u >= m_Offsets.size())
+				return {};
+
+			return std::span{ m_Entries }.subspan(m_Offsets[hMove.m_Index], m_Offsets[hMove.m_Index + 1] - m_Offsets[hMove.m_Index]);
+		}
+
+		[[nodiscard]] inline auto Learners(std::string_view szMove) const noexcept { return Learners(Moves.Find(szMove)); }
+
+		[[nodiscard]] inline auto empty() const noexcept { return m_Entries.empty(); }
+	};
+
+	// Own learnset only.
+	inline CLearnsetIndex Learnsets;
+
+	// Own learnset, plus whatever the pre-evolutions learn and the species does not.
+	inline CLearnsetIndex LearnsetsWithPrevos;
+
+	extern "C++" void BuildLearnsetIndex() noexcept;
+}
@@ -0,0 +1,739 @@
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.PBS.Columnar;
+import Database.PBS.Learnset;
+import Database.PBS.Query;
+
+
+namespace Database::PBS
+{
+	[[nodiscard]] static bool IEquals(std::string_view lhs, std::string_view rhs) noexcept
+	{
+		return std::ranges::equal(lhs, rhs, {},
+			[](char c) static noexcept { return std::tolower(static_cast<unsigned char>(c)); },
+			[](char c) static noexcept { return std::tolower(static_cast<unsigned char>(c)); }
+		);
+	}
+
+	static constexpr std::array<std::pair<std::string_view, EQueryField>, 17> FIELD_NAMES
+	{
+		std::pair{ "hp", EQueryField::HP },
+		{ "attack", EQueryField::Attack }, { "atk", EQueryField::Attack },
+		{ "defense", EQueryField::Defense }, { "def", EQueryField::Defense },
+		{ "speed", EQueryField::Speed }, { "spe", EQueryField::Speed },
+		{ "spatk", EQueryField::SpAtk }, { "spa", EQueryField::SpAtk },
+		{ "spdef", EQueryField::SpDef }, { "spd", EQueryField::SpDef },
+		{ "bst", EQueryField::BST },
+		{ "catchrate", EQueryField::CatchRate },
+		{ "baseexp", EQueryField::BaseExp },
+		{ "generation", EQueryField::Generation }, { "gen", EQueryField::Generation },
+		{ "total", EQueryField::BST },
+	};
+
+	auto FieldName(EQueryField Field) noexcept -> std::string_view
+	{
+		// First entry of each field is its canonical name.
+		if (auto const it = std::ranges::find(FIELD_NAMES, Field, &decltype(FIELD_NAMES)::value_type::second); it != FIELD_NAMES.cend())
+			return it->first;
+
+		return "?";
+	}
+
+	[[nodiscard]] static auto FieldOf(std::string_view szName) noexcept -> std::optional<EQueryField>
+	{
+		for (auto&& [szField, Field] : FIELD_NAMES)
+		{
+			if (IEquals(szField, szName))
+				return Field;
+		}
+
+		return std::nullopt;
+	}
+
+	// Either width, never both.
+	struct CColumnRef final
+	{
+		std::span<std::uint8_t const> m_u8{};
+		std::span<std::uint16_t const> m_u16{};
+	};
+
+	[[nodiscard]] static auto ColumnOf(EQueryField Field) noexcept -> CColumnRef
+	{
+		auto const& Cols = SpeciesColumns;
+
+		switch (Field)
+		{
+		case EQueryField::HP: case EQueryField::Attack: case EQueryField::Defense:
+		case EQueryField::Speed: case EQueryField::SpAtk: case EQueryField::SpDef:
+			return { .m_u8 = Cols.m_BaseStats[(std::size_t)Field] };
+		case EQueryField::BST:
+			return { .m_u16 = Cols.m_BST };
+		case EQueryField::CatchRate:
+			return { .m_u8 = Cols.m_CatchRate };
+		case EQueryField::BaseExp:
+			return { .m_u16 = Cols.m_BaseExp };
+		case EQueryField::Generation:
+			return { .m_u8 = Cols.m_Generation };
+		default:
+			std::unreachable();
+		}
+	}
+
+	auto FieldValue(EQueryField Field, std::uint16_t iRow) noexcept -> std::uint32_t
+	{
+		auto const Col = ColumnOf(Field);
+		return Col.m_u8.empty() ? Col.m_u16[iRow] : Col.m_u8[iRow];
+	}
+
+	// Tokenizer
+
+	struct CToken final
+	{
+		enum EKind : std::uint8_t { End, Ident, Number, Compare, LParen, RParen, } m_Kind{};
+		std::string_view m_Text{};
+		std::size_t m_Pos{};
+	};
+
+	[[nodiscard]] static auto Tokenize(std::string_view sz) noexcept -> std::expected<std::vector<CToken>, std::string>
+	{
+		std::vector<CToken> ret{};
+
+		for (std::size_t i = 0; i < sz.size();)
+		{
+			auto const c = static_cast<unsigned char>(sz[i]);
+
+			if (std::isspace(c))
+			{
+				++i;
+				continue;
+			}
+
+			auto const iStart = i;
+
+			if (std::isalpha(c) || c == '_')
+			{
+				while (i < sz.size() && (std::isalnum(static_cast<unsigned char>(sz[i])) || sz[i] == '_'))
+					++i;
+				ret.emplace_back(CToken::Ident, sz.substr(iStart, i - iStart), iStart);
+			}
+			else if (std::isdigit(c))
+			{
+				while (i < sz.size() && std::isdigit(static_cast<unsigned char>(sz[i])))
+					++i;
+				ret.emplace_back(CToken::Number, sz.substr(iStart, i - iStart), iStart);
+			}
+			else if (c == '(' || c == ')')
+			{
+				ret.emplace_back(c == '(' ? CToken::LParen : CToken::RParen, sz.substr(i++, 1), iStart);
+			}
+			else if (c == '=' || c == '!' || c == '<' || c == '>')
+			{
+				i += (i + 1 < sz.size() && sz[i + 1] == '=') ? 2 : 1;
+
+				if (sz.substr(iStart, i - iStart) == "!")
+					return std::unexpected(std::format("Unexpected '!' at {}", iStart));
+
+				ret.emplace_back(CToken::Compare, sz.substr(iStart, i - iStart), iStart);
+			}
+			else
+				return std::unexpected(std::format("Unexpected '{}' at {}", (char)c, iStart));
+		}
+
+		ret.emplace_back(CToken::End, std::string_view{}, sz.size());
+		return ret;
+	}
+
+	[[nodiscard]] static auto CompareOf(std::string_view sz) noexcept -> ECompare
+	{
+		if (sz == "=" || sz == "==") return ECompare::Equal;
+		if (sz == "!=") return ECompare::NotEqual;
+		if (sz == "<") return ECompare::Less;
+		if (sz == "<=") return ECompare::LessEqual;
+		if (sz == ">") return ECompare::Greater;
+		return ECompare::GreaterEqual;
+	}
+
+	[[nodiscard]] static auto CompareText(ECompare Op) noexcept -> std::string_view
+	{
+		static constexpr std::array TEXT{ "==", "!=", "<", "<=", ">", ">=" };
+		return TEXT[(std::size_t)Op];
+	}
+
+	// Parser, recursive descent straight into plan nodes.
+
+	struct CQueryParser final
+	{
+		std::span<CToken const> m_Tokens{};
+		std::size_t m_Cursor{};
+		CCompiledQuery* m_pOut{};
+
+		using Result = std::expected<std::uint16_t, std::string>;
+
+		[[nodiscard]] auto Peek() const noexcept -> CToken const& { return m_Tokens[m_Cursor]; }
+		auto Next() noexcept -> CToken const& { return m_Tokens[m_Cursor < m_Tokens.size() - 1 ? m_Cursor++ : m_Cursor]; }
+
+		[[nodiscard]] bool Accept(std::string_view szKeyword) noexcept
+		{
+			if (Peek().m_Kind == CToken::Ident && IEquals(Peek().m_Text, szKeyword))
+			{
+				++m_Cursor;
+				return true;
+			}
+
+			return false;
+		}
+
+		[[nodiscard]] auto Error(std::string_view szExpected) const noexcept -> std::unexpected<std::string>
+		{
+			auto const& Tok = Peek();
+			return std::unexpected(std::format("Expected {} at {}, got '{}'", szExpected, Tok.m_Pos, Tok.m_Kind == CToken::End ? "end of query" : Tok.m_Text));
+		}
+
+		auto Emit(CPlanNode&& Node) noexcept -> std::uint16_t
+		{
+			m_pOut->m_Nodes.push_back(std::move(Node));
+			return static_cast<std::uint16_t>(m_pOut->m_Nodes.size() - 1);
+		}
+
+		void Mention(EQueryField Field) noexcept
+		{
+			if (!std::ranges::contains(m_pOut->m_Projection, Field))
+				m_pOut->m_Projection.push_back(Field);
+		}
+
+		auto ParseOr() noexcept -> Result
+		{
+			auto lhs = ParseAnd();
+
+			while (lhs && Accept("or"))
+			{
+				auto const rhs = ParseAnd();
+				if (!rhs)
+					return rhs;
+
+				lhs = Emit({ .m_Op = EPlanOp::Or, .m_Left = *lhs, .m_Right = *rhs });
+			}
+
+			return lhs;
+		}
+
+		auto ParseAnd() noexcept -> Result
+		{
+			auto lhs = ParseUnary();
+
+			while (lhs && Accept("and"))
+			{
+				auto const rhs = ParseUnary();
+				if (!rhs)
+					return rhs;
+
+				lhs = Emit({ .m_Op = EPlanOp::And, .m_Left = *lhs, .m_Right = *rhs });
+			}
+
+			return lhs;
+		}
+
+		auto ParseUnary() noexcept -> Result
+		{
+			if (Accept("not"))
+			{
+				auto const Operand = ParseUnary();
+				if (!Operand)
+					return Operand;
+
+				return Emit({ .m_Op = EPlanOp::Not, .m_Left = *Operand });
+			}
+
+			if (Peek().m_Kind == CToken::LParen)
+			{
+				Next();
+
+				auto const Inner = ParseOr();
+				if (!Inner)
+					return Inner;
+
+				if (Peek().m_Kind != CToken::RParen)
+					return Error("')'");
+
+				Next();
+				return Inner;
+			}
+
+			return ParsePredicate();
+		}
+
+		auto ParseHas(EPlanOp Op) noexcept -> Result
+		{
+			if (!Accept("has"))
+				return Error("'has'");
+			if (Peek().m_Kind != CToken::Ident)
+				return Error("an identifier");
+
+			auto const& Tok = Next();
+			std::string szUpper{ Tok.m_Text };
+			std::ranges::transform(szUpper, szUpper.begin(), [](char c) static noexcept { return (char)std::toupper(static_cast<unsigned char>(c)); });
+
+			CPlanNode Node{ .m_Op = Op, .m_Text{ Tok.m_Text } };
+
+			switch (Op)
+			{
+			case EPlanOp::TypeIndex:
+				if (auto const hType = Types.Find(szUpper); hType)
+					Node.m_Value = hType.m_Index;
+				else
+					return std::unexpected(std::format("Unknown type '{}' at {}", Tok.m_Text, Tok.m_Pos));
+				break;
+
+			case EPlanOp::EggGroupIndex:
+				for (auto&& [iBit, szGroup] : std::views::enumerate(SpeciesColumns.m_EggGroupNames))
+				{
+					if (IEquals(szGroup, Tok.m_Text))
+						Node.m_Value = 1u << iBit;
+				}
+
+				if (Node.m_Value == 0)
+					return std::unexpected(std::format("Unknown egg group '{}' at {}", Tok.m_Text, Tok.m_Pos));
+				break;
+
+			default:
+				break;
+			}
+
+			return Emit(std::move(Node));
+		}
+
+		auto ParsePredicate() noexcept -> Result
+		{
+			if (Accept("type"))
+				return ParseHas(EPlanOp::TypeIndex);
+			if (Accept("egggroup"))
+				return ParseHas(EPlanOp::EggGroupIndex);
+			if (Accept("flag"))
+				return ParseHas(EPlanOp::FlagIndex);
+
+			if (Accept("learns"))
+			{
+				if (Peek().m_Kind != CToken::Ident)
+					return Error("a move");
+
+				auto const& Tok = Next();
+				std::string szUpper{ Tok.m_Text };
+				std::ranges::transform(szUpper, szUpper.begin(), [](char c) static noexcept { return (char)std::toupper(static_cast<unsigned char>(c)); });
+
+				auto const hMove = Moves.Find(szUpper);
+				if (!hMove)
+					return std::unexpected(std::format("Unknown move '{}' at {}", Tok.m_Text, Tok.m_Pos));
+
+				return Emit({ .m_Op = EPlanOp::LearnsetIndex, .m_Value = hMove.m_Index, .m_Text{ Tok.m_Text } });
+			}
+
+			if (Peek().m_Kind != CToken::Ident)
+				return Error("a predicate");
+
+			auto const& FieldTok = Next();
+			auto const Lhs = FieldOf(FieldTok.m_Text);
+			if (!Lhs)
+				return std::unexpected(std::format("Unknown field '{}' at {}", FieldTok.m_Text, FieldTok.m_Pos));
+
+			Mention(*Lhs);
+
+			if (Peek().m_Kind != CToken::Compare)
+				return Error("a comparison");
+
+			auto const Op = CompareOf(Next().m_Text);
+
+			if (Peek().m_Kind == CToken::Number)
+			{
+				auto const& Tok = Next();
+				std::uint32_t iValue{};
+
+				auto const pEnd = Tok.m_Text.data() + Tok.m_Text.size();
+
+				if (auto const [ptr, ec] = std::from_chars(Tok.m_Text.data(), pEnd, iValue); ec != std::errc{} || ptr != pEnd)
+					return std::unexpected(std::format("Number out of range at {}", Tok.m_Pos));
+
+				return Emit({ .m_Op = EPlanOp::CompareScalar, .m_Compare = Op, .m_Lhs = *Lhs, .m_Value = iValue });
+			}
+
+			if (Peek().m_Kind == CToken::Ident)
+			{
+				auto const& Tok = Next();
+				auto const Rhs = FieldOf(Tok.m_Text);
+				if (!Rhs)
+					return std::unexpected(std::format("Unknown field '{}' at {}", Tok.m_Text, Tok.m_Pos));
+
+				Mention(*Rhs);
+				return Emit({ .m_Op = EPlanOp::CompareColumn, .m_Compare = Op, .m_Lhs = *Lhs, .m_Rhs = *Rhs });
+			}
+
+			return Error("a number or a field");
+		}
+	};
+
+	// Optimizer
+
+	// Rough cost, index scans are cheaper and usually more selective than column scans.
+	[[nodiscard]] static auto CostOf(CCompiledQuery const& Q, std::uint16_t i) noexcept -> std::uint32_t
+	{
+		auto const& Node = Q.m_Nodes[i];
+
+		switch (Node.m_Op)
+		{
+		case EPlanOp::All: case EPlanOp::None:
+			return 0;
+		case EPlanOp::LearnsetIndex: case EPlanOp::FlagIndex:
+			return 1;
+		case EPlanOp::TypeIndex: case EPlanOp::EggGroupIndex:
+			return 2;
+		case EPlanOp::CompareScalar:
+			return 3;
+		case EPlanOp::CompareColumn:
+			return 4;
+		case EPlanOp::Not:
+			return CostOf(Q, Node.m_Left) + 1;
+		default:
+			return CostOf(Q, Node.m_Left) + CostOf(Q, Node.m_Right) + 1;
+		}
+	}
+
+	static void Optimize(CCompiledQuery* pQuery, std::uint16_t i) noexcept
+	{
+		auto& Node = pQuery->m_Nodes[i];
+
+		switch (Node.m_Op)
+		{
+		case EPlanOp::CompareScalar:
+			// Fold comparisons that can never or always hold on a byte column.
+			if (!ColumnOf(Node.m_Lhs).m_u8.empty() && Node.m_Value > 0xFF)
+			{
+				auto const bAlways = Node.m_Compare == ECompare::NotEqual || Node.m_Compare == ECompare::Less || Node.m_Compare == ECompare::LessEqual;
+				Node.m_Op = bAlways ? EPlanOp::All : EPlanOp::None;
+			}
+			else if (!ColumnOf(Node.m_Lhs).m_u16.empty() && Node.m_Value > 0xFFFF)
+			{
+				auto const bAlways = Node.m_Compare == ECompare::NotEqual || Node.m_Compare == ECompare::Less || Node.m_Compare == ECompare::LessEqual;
+				Node.m_Op = bAlways ? EPlanOp::All : EPlanOp::None;
+			}
+			break;
+
+		case EPlanOp::Not:
+			Optimize(pQuery, Node.m_Left);
+			break;
+
+		case EPlanOp::And:
+		case EPlanOp::Or:
+		{
+			Optimize(pQuery, Node.m_Left);
+			Optimize(pQuery, pQuery->m_Nodes[i].m_Right);
+
+			// Cheap side first, so it can short-circuit the expensive one.
+			auto& Self = pQuery->m_Nodes[i];
+			if (CostOf(*pQuery, Self.m_Right) < CostOf(*pQuery, Self.m_Left))
+				std::swap(Self.m_Left, Self.m_Right);
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+
+	auto CompileQuery(std::string_view szQuery) noexcept -> std::expected<CCompiledQuery, std::string>
+	{
+		auto const Tokens = Tokenize(szQuery);
+		if (!Tokens)
+			return std::unexpected(Tokens.error());
+
+		CCompiledQuery ret{};
+		CQueryParser Parser{ .m_Tokens = *Tokens, .m_pOut = &ret };
+
+		if (!Parser.Accept("species"))
+			return Parser.Error("'species'");
+
+		if (Parser.Accept("where"))
+		{
+			auto const Root = Parser.ParseOr();
+			if (!Root)
+				return std::unexpected(Root.error());
+
+			ret.m_Root = *Root;
+		}
+		else
+			ret.m_Root = Parser.Emit({ .m_Op = EPlanOp::All });
+
+		if (Parser.Accept("order"))
+		{
+			if (!Parser.Accept("by"))
+				return Parser.Error("'by'");
+			if (Parser.Peek().m_Kind != CToken::Ident)
+				return Parser.Error("a field");
+
+			auto const& Tok = Parser.Next();
+			ret.m_OrderBy = FieldOf(Tok.m_Text);
+			if (!ret.m_OrderBy)
+				return std::unexpected(std::format("Unknown field '{}' at {}", Tok.m_Text, Tok.m_Pos));
+
+			Parser.Mention(*ret.m_OrderBy);
+
+			if (Parser.Accept("desc"))
+				ret.m_Descending = true;
+			else
+				std::ignore = Parser.Accept("asc");
+		}
+
+		if (Parser.Accept("limit"))
+		{
+			if (Parser.Peek().m_Kind != CToken::Number)
+				return Parser.Error("a number");
+
+			auto const& Tok = Parser.Next();
+			auto const pEnd = Tok.m_Text.data() + Tok.m_Text.size();
+
+			if (auto const [ptr, ec] = std::from_chars(Tok.m_Text.data(), pEnd, ret.m_Limit); ec != std::errc{} || ptr != pEnd)
+				return std::unexpected(std::format("Invalid limit '{}' at {}", Tok.m_Text, Tok.m_Pos));
+		}
+
+		if (Parser.Peek().m_Kind != CToken::End)
+			return Parser.Error("end of query");
+
+		Optimize(&ret, ret.m_Root);
+		return ret;
+	}
+
+	// Execution
+
+	// Flag bitsets are built on first use and dropped whenever the species table is rebuilt.
+	[[nodiscard]] static auto FlagSelection(std::string_view szFlag) noexcept -> CSelection
+	{
+		static std::mutex Mutex{};
+		static std::map<std::string, CSelection, std::less<>> Index{};
+		static std::optional<std::uint64_t> iBuiltGeneration{};
+
+		std::scoped_lock Lock{ Mutex };
+
+		if (iBuiltGeneration != BuildGeneration)
+		{
+			Index.clear();
+			iBuiltGeneration = BuildGeneration;
+
+			auto const iBuiltCount = Species.size();
+
+			for (auto&& [iRow, Spec] : std::views::enumerate(Species))
+			{
+				for (auto&& szName : Spec.m_Flags)
+				{
+					auto [it, bNew] = Index.try_emplace(szName);
+					if (bNew)
+						it->second = CSelection::None(iBuiltCount);
+
+					it->second.Set(iRow);
+				}
+			}
+		}
+
+		for (auto&& [szName, Selection] : Index)
+		{
+			if (IEquals(szName, szFlag))
+				return Selection;
+		}
+
+		return CSelection::None(Species.size());
+	}
+
+	[[nodiscard]] static auto Widen(std::span<std::uint8_t const> Column) noexcept -> std::vector<std::uint16_t>
+	{
+		return { Column.begin(), Column.end() };
+	}
+
+	[[nodiscard]] static auto Evaluate(CCompiledQuery const& Q, std::uint16_t i) noexcept -> CSelection
+	{
+		auto const& Node = Q.m_Nodes[i];
+		auto const iCount = SpeciesColumns.m_Count;
+
+		switch (Node.m_Op)
+		{
+		case EPlanOp::All:
+			return CSelection::All(iCount);
+
+		case EPlanOp::None:
+			return CSelection::None(iCount);
+
+		case EPlanOp::CompareScalar:
+		{
+			auto const Col = ColumnOf(Node.m_Lhs);
+
+			if (!Col.m_u8.empty())
+				return Filter(Col.m_u8, Node.m_Compare, static_cast<std::uint8_t>(Node.m_Value));
+
+			return Filter(Col.m_u16, Node.m_Compare, static_cast<std::uint16_t>(Node.m_Value));
+		}
+
+		case EPlanOp::CompareColumn:
+		{
+			auto const Lhs = ColumnOf(Node.m_Lhs), Rhs = ColumnOf(Node.m_Rhs);
+
+			if (!Lhs.m_u8.empty() && !Rhs.m_u8.empty())
+				return Filter(Lhs.m_u8, Node.m_Compare, Rhs.m_u8);
+			if (!Lhs.m_u16.empty() && !Rhs.m_u16.empty())
+				return Filter(Lhs.m_u16, Node.m_Compare, Rhs.m_u16);
+
+			// Mixed widths, widen the byte column.
+			auto const rgiWide = Widen(Lhs.m_u8.empty() ? Rhs.m_u8 : Lhs.m_u8);
+			if (Lhs.m_u8.empty())
+				return Filter(Lhs.m_u16, Node.m_Compare, std::span<std::uint16_t const>{ rgiWide });
+			else
+				return Filter(std::span<std::uint16_t const>{ rgiWide }, Node.m_Compare, Rhs.m_u16);
+		}
+
+		case EPlanOp::TypeIndex:
+			return FilterType(TypeHandle{ static_cast<std::uint16_t>(Node.m_Value) });
+
+		case EPlanOp::EggGroupIndex:
+			return FilterAnyBits(SpeciesColumns.m_EggGroups, Node.m_Value);
+
+		case EPlanOp::FlagIndex:
+			return FlagSelection(Node.m_Text);
+
+		case EPlanOp::LearnsetIndex:
+		{
+			auto ret = CSelection::None(iCount);
+
+			for (auto&& Entry : Learnsets.Learners(MoveHandle{ static_cast<std::uint16_t>(Node.m_Value) }))
+				ret.Set(Entry.m_Species.m_Index);
+
+			return ret;
+		}
+
+		case EPlanOp::And:
+		{
+			auto ret = Evaluate(Q, Node.m_Left);
+			if (ret.Count() == 0)
+				return ret;
+
+			ret &= Evaluate(Q, Node.m_Right);
+			return ret;
+		}
+
+		case EPlanOp::Or:
+		{
+			auto ret = Evaluate(Q, Node.m_Left);
+			if (ret.Count() == iCount)
+				return ret;
+
+			ret |= Evaluate(Q, Node.m_Right);
+			return ret;
+		}
+
+		case EPlanOp::Not:
+			return ~Evaluate(Q, Node.m_Left);
+
+		default:
+			std::unreachable();
+		}
+	}
+
+	auto ExecuteQuery(CCompiledQuery const& Query) noexcept -> std::vector<std::uint16_t>
+	{
+		if (SpeciesColumns.m_Count == 0 || Query.m_Nodes.empty())
+			return {};
+
+		auto const Selection = Evaluate(Query, Query.m_Root);
+		std::vector<std::uint16_t> ret{};
+
+		if (Query.m_OrderBy)
+		{
+			auto const Col = ColumnOf(*Query.m_OrderBy);
+
+			ret = Col.m_u8.empty()
+				? ArgSort(Col.m_u16, Selection, Query.m_Descending)
+				: ArgSort(Col.m_u8, Selection, Query.m_Descending);
+		}
+		else
+			ret = Selection.Indices();
+
+		if (ret.size() > Query.m_Limit)
+			ret.resize(Query.m_Limit);
+
+		return ret;
+	}
+
+	static void ExplainNode(CCompiledQuery const& Q, std::uint16_t i, std::string* pOut) noexcept
+	{
+		auto const& Node = Q.m_Nodes[i];
+		auto const Out = std::back_inserter(*pOut);
+
+		switch (Node.m_Op)
+		{
+		case EPlanOp::All: std::format_to(Out, "All"); break;
+		case EPlanOp::None: std::format_to(Out, "None"); break;
+		case EPlanOp::CompareScalar: std::format_to(Out, "ColumnScan[{} {} {}]", FieldName(Node.m_Lhs), CompareText(Node.m_Compare), Node.m_Value); break;
+		case EPlanOp::CompareColumn: std::format_to(Out, "ColumnScan[{} {} {}]", FieldName(Node.m_Lhs), CompareText(Node.m_Compare), FieldName(Node.m_Rhs)); break;
+		case EPlanOp::TypeIndex: std::format_to(Out, "IndexScan[type has {}]", Node.m_Text); break;
+		case EPlanOp::EggGroupIndex: std::format_to(Out, "IndexScan[egggroup has {}]", Node.m_Text); break;
+		case EPlanOp::FlagIndex: std::format_to(Out, "IndexScan[flag has {}]", Node.m_Text); break;
+		case EPlanOp::LearnsetIndex: std::format_to(Out, "IndexScan[learns {}]", Node.m_Text); break;
+
+		case EPlanOp::Not:
+			std::format_to(Out, "Not(");
+			ExplainNode(Q, Node.m_Left, pOut);
+			std::format_to(Out, ")");
+			break;
+
+		case EPlanOp::And:
+		case EPlanOp::Or:
+			std::format_to(Out, "{}(", Node.m_Op == EPlanOp::And ? "And" : "Or");
+			ExplainNode(Q, Node.m_Left, pOut);
+			std::format_to(Out, ", ");
+			ExplainNode(Q, Node.m_Right, pOut);
+			std::format_to(Out, ")");
+			break;
+
+		default:
+			std::unreachable();
+		}
+	}
+
+	auto CCompiledQuery::Explain() const noexcept -> std::string
+	{
+		std::string ret{};
+
+		if (!m_Nodes.empty())
+			ExplainNode(*this, m_Root, &ret);
+
+		if (m_OrderBy)
+			std::format_to(std::back_inserter(ret), " -> RadixSort[{} {}]", FieldName(*m_OrderBy), m_Descending ? "desc" : "asc");
+		if (m_Limit != std::numeric_limits<std::size_t>::max())
+			std::format_to(std::back_inserter(ret), " -> Limit[{}]", m_Limit);
+
+		return ret;
+	}
+
+	auto RunQuery(std::string_view szQuery) noexcept -> std::expected<CQueryResult, std::string>
+	{
+		using Clock = std::chrono::high_resolution_clock;
+
+		auto const t0 = Clock::now();
+		auto const Query = CompileQuery(szQuery);
+		auto const t1 = Clock::now();
+
+		if (!Query)
+			return std::unexpected(Query.error());
+
+		CQueryResult ret{ .m_Rows = ExecuteQuery(*Query) };
+		auto const t2 = Clock::now();
+
+		ret.m_Projection = Query->m_Projection;
+		ret.m_CompileTime = t1 - t0;
+		ret.m_ExecuteTime = t2 - t1;
+		ret.m_Plan = Query->Explain();
+
+		return ret;
+	}
+}
@@ -0,0 +1,96 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module Database.PBS.Query;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.PBS.Columnar;
+
+// Grammar, keywords are case insensitive:
+//
+//   query     := 'species' [ 'where' or ] [ 'order' 'by' field [ 'asc' | 'desc' ] ] [ 'limit' number ]
+//   or        := and { 'or' and }
+//   and       := unary { 'and' unary }
+//   unary     := 'not' unary | '(' or ')' | predicate
+//   predicate := field cmp ( number | field )
+//              | 'type' 'has' ID | 'egggroup' 'has' ID | 'flag' 'has' ID | 'learns' ID
+//   cmp       := '=' | '==' | '!=' | '<' | '<=' | '>' | '>='
+//   field     := hp | attack | defense | speed | spatk | spdef | bst | catchrate | baseexp | generation
+//
+// e.g. species where type has WATER and bst > 500 order by speed desc
+
+export namespace Database::PBS
+{
+	enum struct EQueryField : std::uint8_t
+	{
+		HP, Attack, Defense, Speed, SpAtk, SpDef,	// Same order as EStat.
+		BST, CatchRate, BaseExp, Generation,
+		COUNT,
+	};
+
+	enum struct EPlanOp : std::uint8_t
+	{
+		All,
+		None,
+		CompareScalar,	// Column scan.
+		CompareColumn,	// Column scan.
+		TypeIndex,		// Index scan over the type columns.
+		EggGroupIndex,	// Index scan over the egg group bitmasks.
+		FlagIndex,		// Index scan over the flag bitsets.
+		LearnsetIndex,	// Index scan over the reverse learnset.
+		And,
+		Or,
+		Not,
+	};
+
+	struct CPlanNode final
+	{
+		EPlanOp m_Op{};
+		ECompare m_Compare{};
+		EQueryField m_Lhs{};
+		EQueryField m_Rhs{};
+		std::uint32_t m_Value{};	// Scalar, type handle, egg group mask or move handle.
+		std::string m_Text{};		// Flag name, and the source text for Explain().
+		std::uint16_t m_Left{};		// Children, indices into m_Nodes.
+		std::uint16_t m_Right{};
+	};
+
+	struct CCompiledQuery final
+	{
+		std::vector<CPlanNode> m_Nodes{};
+		std::uint16_t m_Root{};
+		std::optional<EQueryField> m_OrderBy{};
+		bool m_Descending{};
+		std::size_t m_Limit{ std::numeric_limits<std::size_t>::max() };
+		std::vector<EQueryField> m_Projection{};	// Every field the query mentions, in order of appearance.
+
+		[[nodiscard]] auto Explain() const noexcept -> std::string;
+	};
+
+	struct CQueryResult final
+	{
+		std::vector<std::uint16_t> m_Rows{};	// Species handles.
+		std::vector<EQueryField> m_Projection{};
+		std::chrono::duration<double, std::milli> m_CompileTime{};
+		std::chrono::duration<double, std::milli> m_ExecuteTime{};
+		std::string m_Plan{};
+	};
+
+	[[nodiscard]] extern "C++" auto FieldName(EQueryField Field) noexcept -> std::string_view;
+	[[nodiscard]] extern "C++" auto FieldValue(EQueryField Field, std::uint16_t iRow) noexcept -> std::uint32_t;
+
+	[[nodiscard]] extern "C++" auto CompileQuery(std::string_view szQuery) noexcept -> std::expected<CCompiledQuery, std::string>;
+	[[nodiscard]] extern "C++" auto ExecuteQuery(CCompiledQuery const& Query) noexcept -> std::vector<std::uint16_t>;
+
+	// Compile and execute, with timings.
+	[[nodiscard]] extern "C++" auto RunQuery(std::string_view szQuery) noexcept -> std::expected<CQueryResult, std::string>;
+}
@@ -0,0 +1,283 @@
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.PBS.Search;
+
+
+namespace Database::PBS
+{
+	// Lowercase ASCII alphanumerics, everything else in ASCII becomes a single space. UTF-8 passes through.
+	// Padded with one space on both ends so that word boundaries form their own trigrams.
+	[[nodiscard]] static auto Normalize(std::string_view sz) noexcept -> std::string
+	{
+		std::string ret{ ' ' };
+		ret.reserve(sz.size() + 2);
+
+		for (auto&& c : sz)
+		{
+			auto const uc = static_cast<unsigned char>(c);
+
+			if (uc >= 0x80 || std::isalnum(uc))
+				ret.push_back(uc < 0x80 ? static_cast<char>(std::tolower(uc)) : c);
+			else if (ret.back() != ' ')
+				ret.push_back(' ');
+		}
+
+		if (ret.back() != ' ')
+			ret.push_back(' ');
+
+		return ret;
+	}
+
+	template <typename F>
+	static void ForEachTrigram(std::string_view szNormalized, F&& fn) noexcept
+	{
+		for (std::size_t i = 0; i + 3 <= szNormalized.size(); ++i)
+		{
+			fn(static_cast<std::uint32_t>(
+				(static_cast<unsigned char>(szNormalized[i]) << 16)
+				| (static_cast<unsigned char>(szNormalized[i + 1]) << 8)
+				| static_cast<unsigned char>(szNormalized[i + 2])
+			));
+		}
+	}
+
+	// What gets indexed, per table. fnEmit(ESearchField, std::string_view).
+
+	static void EmitFields(CPokemonSpecies const& Rec, auto&& fnEmit) noexcept
+	{
+		fnEmit(Field_Id, Rec.m_Id);
+		fnEmit(Field_Name, Rec.m_Name);
+		fnEmit(Field_Name, Rec.m_FormName);
+		fnEmit(Field_Description, Rec.m_Category);
+		fnEmit(Field_Description, Rec.m_Pokedex);
+		for (auto&& szFlag : Rec.m_Flags)
+			fnEmit(Field_Flag, szFlag);
+	}
+
+	static void EmitFields(CPokemonMove const& Rec, auto&& fnEmit) noexcept
+	{
+		fnEmit(Field_Id, Rec.m_Id);
+		fnEmit(Field_Name, Rec.m_Name);
+		fnEmit(Field_Description, Rec.m_Description);
+		for (auto&& szFlag : Rec.m_Flags)
+			fnEmit(Field_Flag, szFlag);
+	}
+
+	static void EmitFields(CPokemonAbility const& Rec, auto&& fnEmit) noexcept
+	{
+		fnEmit(Field_Id, Rec.m_Id);
+		fnEmit(Field_Name, Rec.m_Name);
+		fnEmit(Field_Description, Rec.m_Description);
+		for (auto&& szFlag : Rec.m_Flags)
+			fnEmit(Field_Flag, szFlag);
+	}
+
+	static void EmitFields(CPokemonItem const& Rec, auto&& fnEmit) noexcept
+	{
+		fnEmit(Field_Id, Rec.m_Id);
+		fnEmit(Field_Name, Rec.m_Name);
+		fnEmit(Field_Name, Rec.m_NamePlural);
+		fnEmit(Field_Description, Rec.m_Description);
+		for (auto&& szFlag : Rec.m_Flags)
+			fnEmit(Field_Flag, szFlag);
+	}
+
+	template <typename T>
+	[[nodiscard]] static auto HashContent(CRecordTable<T> const& Table) noexcept -> std::uint64_t
+	{
+		// FNV-1a
+		std::uint64_t iHash = 0xcbf29ce484222325ull;
+		auto const fnMix = [&](std::uint8_t b) noexcept { iHash = (iHash ^ b) * 0x100000001b3ull; };
+
+		for (auto&& Rec : Table)
+		{
+			EmitFields(Rec,
+				[&](std::uint8_t iField, std::string_view sz) noexcept
+				{
+					fnMix(iField);
+					for (auto&& c : sz)
+						fnMix(static_cast<std::uint8_t>(c));
+				}
+			);
+			fnMix(0xFF);	// Record separator, moving a string to the next record must change the hash.
+		}
+
+		return iHash;
+	}
+
+	template <typename T>
+	[[nodiscard]] static auto BuildSegment(ERecordKind Kind, CRecordTable<T> const& Table, std::uint64_t iHash) noexcept -> CSearchSegment
+	{
+		struct CTuple final { std::uint32_t m_Trigram; std::uint16_t m_Record; std::uint8_t m_Fields; };
+
+		CSearchSegment ret{ .m_Kind = Kind, .m_ContentHash = iHash, .m_RecordCount = Table.size() };
+		ret.m_Names.reserve(Table.size());
+
+		std::vector<CTuple> rgTuples{};
+
+		for (auto&& [iRecord, Rec] : std::views::enumerate(Table))
+		{
+			std::string szNames{};
+
+			EmitFields(Rec,
+				[&](std::uint8_t iField, std::string_view sz) noexcept
+				{
+					auto const szNormalized = Normalize(sz);
+
+					ForEachTrigram(szNormalized,
+						[&](std::uint32_t iTrigram) noexcept { rgTuples.emplace_back(iTrigram, static_cast<std::uint16_t>(iRecord), iField); }
+					);
+
+					if (iField & (Field_Id | Field_Name))
+						szNames += szNormalized;
+				}
+			);
+
+			ret.m_Names.push_back(std::move(szNames));
+		}
+
+		std::ranges::sort(rgTuples, {}, [](CTuple const& t) static noexcept { return std::pair{ t.m_Trigram, t.m_Record }; });
+
+		// Merge duplicates, OR the field bits together.
+		for (auto&& Tuple : rgTuples)
+		{
+			if (!ret.m_Trigrams.empty() && ret.m_Trigrams.back() == Tuple.m_Trigram)
+			{
+				if (auto& Last = ret.m_Postings.back(); Last.m_Record == Tuple.m_Record)
+				{
+					Last.m_Fields |= Tuple.m_Fields;
+					continue;
+				}
+			}
+			else
+			{
+				ret.m_Trigrams.push_back(Tuple.m_Trigram);
+				ret.m_Offsets.push_back(static_cast<std::uint32_t>(ret.m_Postings.size()));
+			}
+
+			ret.m_Postings.push_back(CPosting{ Tuple.m_Record, Tuple.m_Fields });
+		}
+
+		ret.m_Offsets.push_back(static_cast<std::uint32_t>(ret.m_Postings.size()));
+		return ret;
+	}
+
+	auto RebuildSearchIndex() noexcept -> std::size_t
+	{
+		std::atomic<std::size_t> iRebuilt{};
+
+		auto const fnRefresh = [&]<typename T>(ERecordKind Kind, CRecordTable<T> const& Table) noexcept
+		{
+			auto& Segment = SearchIndex.m_Segments[(std::size_t)Kind];
+			auto const iHash = HashContent(Table);
+
+			if (Segment.m_ContentHash == iHash && Segment.m_RecordCount == Table.size() && !Segment.m_Offsets.empty())
+				return;
+
+			Segment = BuildSegment(Kind, Table, iHash);
+			++iRebuilt;
+		};
+
+		std::array const rgKinds{ ERecordKind::Species, ERecordKind::Move, ERecordKind::Ability, ERecordKind::Item };
+
+		// Each task only touches its own segment.
+		std::for_each(std::execution::par, rgKinds.begin(), rgKinds.end(),
+			[&](ERecordKind Kind) noexcept
+			{
+				switch (Kind)
+				{
+				case ERecordKind::Species: fnRefresh(Kind, Species); break;
+				case ERecordKind::Move: fnRefresh(Kind, Moves); break;
+				case ERecordKind::Ability: fnRefresh(Kind, Abilities); break;
+				case ERecordKind::Item: fnRefresh(Kind, Items); break;
+				default: std::unreachable();
+				}
+			}
+		);
+
+		return iRebuilt;
+	}
+
+	[[nodiscard]] static constexpr auto FieldWeight(std::uint8_t bitsFields) noexcept -> float
+	{
+		if (bitsFields & (Field_Id | Field_Name))
+			return 3.f;
+		if (bitsFields & Field_Description)
+			return 1.f;
+		if (bitsFields & Field_Flag)
+			return 1.f;
+
+		return 0.f;
+	}
+
+	auto Search(std::string_view szQuery, std::size_t iLimit, std::uint8_t bitsKinds) noexcept -> std::vector<CSearchHit>
+	{
+		auto const szNormalized = Normalize(szQuery);
+		auto const szTrimmed = std::string_view{ szNormalized }.substr(1, szNormalized.size() >= 2 ? szNormalized.size() - 2 : 0);
+
+		if (szTrimmed.empty())
+			return {};
+
+		std::vector<std::uint32_t> rgiTrigrams{};
+		ForEachTrigram(szNormalized, [&](std::uint32_t i) noexcept { rgiTrigrams.push_back(i); });
+		std::ranges::sort(rgiTrigrams);
+		auto const [itFirst, itLast] = std::ranges::unique(rgiTrigrams);
+		rgiTrigrams.erase(itFirst, itLast);
+
+		// At least a third of the query has to be there, otherwise it's noise.
+		auto const iMinMatched = std::max<std::size_t>(1, (rgiTrigrams.size() + 2) / 3);
+		auto const flNorm = 1.f / (3.f * rgiTrigrams.size());
+
+		std::vector<CSearchHit> ret{};
+		std::vector<float> rgflScore{};
+		std::vector<std::uint16_t> rgiMatched{};
+		std::vector<std::uint16_t> rgiTouched{};
+
+		for (auto&& Segment : SearchIndex.m_Segments)
+		{
+			if (!(bitsKinds & (1u << (unsigned)Segment.m_Kind)) || Segment.m_RecordCount == 0)
+				continue;
+
+			rgflScore.assign(Segment.m_RecordCount, 0.f);
+			rgiMatched.assign(Segment.m_RecordCount, 0);
+			rgiTouched.clear();
+
+			for (auto&& iTrigram : rgiTrigrams)
+			{
+				for (auto&& Posting : Segment.Postings(iTrigram))
+				{
+					if (rgiMatched[Posting.m_Record]++ == 0)
+						rgiTouched.push_back(Posting.m_Record);
+
+					rgflScore[Posting.m_Record] += FieldWeight(Posting.m_Fields);
+				}
+			}
+
+			for (auto&& iRecord : rgiTouched)
+			{
+				if (rgiMatched[iRecord] < iMinMatched)
+					continue;
+
+				auto flScore = rgflScore[iRecord] * flNorm;
+
+				if (auto const pos = Segment.m_Names[iRecord].find(szTrimmed); pos != std::string::npos)
+					flScore += Segment.m_Names[iRecord][pos - 1] == ' ' ? 1.5f : 1.f;	// Word prefix beats substring. Names start with a space.
+
+				ret.push_back(CSearchHit{ Segment.m_Kind, iRecord, flScore });
+			}
+		}
+
+		auto const itMid = ret.begin() + std::min(iLimit, ret.size());
+		std::ranges::partial_sort(ret, itMid, std::ranges::greater{}, &CSearchHit::m_Score);
+		ret.erase(itMid, ret.end());
+
+		return ret;
+	}
+}
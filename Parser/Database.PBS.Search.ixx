@@ -0,0 +1,80 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module Database.PBS.Search;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+import Database.PBS;
+
+export namespace Database::PBS
+{
+	enum struct ERecordKind : std::uint8_t { Species, Move, Ability, Item, COUNT, };
+
+	// Bits of CPosting::m_Fields.
+	enum ESearchField : std::uint8_t
+	{
+		Field_Id = 1 << 0,
+		Field_Name = 1 << 1,
+		Field_Description = 1 << 2,	// Move, ability and item descriptions, Pokedex entries and species categories.
+		Field_Flag = 1 << 3,
+	};
+
+	struct CPosting final
+	{
+		std::uint16_t m_Record{};	// Handle index in the table of the segment.
+		std::uint8_t m_Fields{};
+	};
+
+	// Inverted trigram index over one table. Trigrams are 3 lowercase bytes packed into the low 24 bits.
+	struct CSearchSegment final
+	{
+		ERecordKind m_Kind{};
+		std::uint64_t m_ContentHash{};	// Of every indexed string, decides whether a rebuild is needed.
+		std::size_t m_RecordCount{};
+
+		std::vector<std::uint32_t> m_Trigrams{};	// Sorted.
+		std::vector<std::uint32_t> m_Offsets{};		// m_Trigrams.size() + 1, into m_Postings.
+		std::vector<CPosting> m_Postings{};			// Sorted by record within a trigram.
+		std::vector<std::string> m_Names{};			// Normalized id and name per record, for the substring bonus.
+
+		[[nodiscard]] auto Postings(std::uint32_t iTrigram) const noexcept -> std::span<CPosting const>
+		{
+			auto const it = std::ranges::lower_bound(m_Trigrams, iTrigram);
+			if (it == m_Trigrams.cend() || *it != iTrigram)
+				return {};
+
+			auto const i = it - m_Trigrams.cbegin();
+			return std::span{ m_Postings }.subspan(m_Offsets[i], m_Offsets[i + 1] - m_Offsets[i]);
+		}
+	};
+
+	struct CSearchHit final
+	{
+		ERecordKind m_Kind{};
+		std::uint16_t m_Record{};
+		float m_Score{};
+	};
+
+	struct CSearchIndex final
+	{
+		std::array<CSearchSegment, (std::size_t)ERecordKind::COUNT> m_Segments{};
+	};
+
+	inline CSearchIndex SearchIndex;
+
+	// Rebuilds only the segments whose content changed since the last call, in parallel.
+	// Returns the number of rebuilt segments.
+	extern "C++" auto RebuildSearchIndex() noexcept -> std::size_t;
+
+	// Ranked by trigram overlap weighted by field, with a bonus for substring and prefix matches of the name.
+	// Typos cost a few trigrams instead of the whole match.
+	[[nodiscard]] extern "C++" auto Search(std::string_view szQuery, std::size_t iLimit = 50, std::uint8_t bitsKinds = 0xFF) noexcept -> std::vector<CSearchHit>;
+}
@@ -6,74 +6,63 @@
 import std.compat;
 #endif
 
+import UtlLog;
+import UtlMemory;
+import UtlTrace;
 import UtlString;
 
 import Database.PBS;
+import Database.PBS.Breeding;
+import Database.PBS.Columnar;
+import Database.PBS.Evolution;
+import Database.PBS.Learnset;
+import Database.PBS.Search;
+import Database.PBS.Validation;
 import Database.Raw.PBS;
 
 #define PORT_SIMPLE(key)			m_##key{ Raw.m_##key }
 #define PORT_ENUM(key, def, ...)	m_##key{ EnumDeserialize<__VA_ARGS__>(Raw.m_##key).value_or(def) }
-#define PORT_CLASS(key, lib)		m_##key{ std::addressof(lib.at(Raw.m_##key)) }
-#define PORT_COLL(key, lib, Class) \
-			m_##key{																															\
-				std::from_range,																												\
-				Raw.m_##key																														\
-				| std::views::transform(																										\
-					[](auto&& a) static noexcept																								\
-					{																															\
-						auto it = lib.find(a);																									\
-																																				\
-						if (it != lib.cend())																									\
-							return std::addressof(it->second);																					\
-						else																													\
-						{																														\
-							std::println("[{}::`ctor] Assumed class '{}' referenced but cannot linked.", typeid(Class).name(), a);				\
-							return (decltype(std::addressof(it->second)))nullptr;																\
-						}																														\
-					}																															\
-				)																																\
-			}
-#define PORT_OPTIONAL(key, lib) 	m_##key{ Raw.m_##key.empty() ? nullptr : std::addressof(lib.at(Raw.m_##key)) }
+#define PORT_CLASS(key, lib)		m_##key{ lib.Find(Raw.m_##key) }
+#define PORT_COLL(key, lib)			m_##key{ LinkAll(lib, Raw.m_##key) }
+#define PORT_OPTIONAL(key, lib) 	m_##key{ Raw.m_##key.empty() ? decltype(m_##key){} : lib.Find(Raw.m_##key) }
 #define PORT_LOC_OWNED(key)			m_##key{ std::from_range, Raw.m_##key | std::views::transform([](auto&& a) static noexcept { return decltype(m_##key)::value_type{std::forward<decltype(a)>(a) }; }) }
 
 
 
 // #UPDATE_AT_CPP26 reflecion
+// Unqualified name of an enumerator, recovered from the signature of this very function.
+template <auto EnumValue>
+[[nodiscard]] consteval auto EnumValueName() noexcept -> std::string_view
+{
+#ifdef _MSC_VER
+	// auto __cdecl EnumValueName<EMoveCategory::Physical>(void) noexcept
+	std::string_view const FuncSigText{ __FUNCSIG__ };
+	auto const pos1 = FuncSigText.rfind(">(");
+	auto const pos0 = FuncSigText.rfind('<', pos1) + 1;
+#else
+	// GCC:   ... [with auto EnumValue = EMoveCategory::Physical; ...]
+	// Clang: ... [EnumValue = EMoveCategory::Physical]
+	std::string_view const FuncSigText{ __PRETTY_FUNCTION__ };
+	auto const pos0 = FuncSigText.find("EnumValue = ") + 12;
+	auto const pos1 = FuncSigText.find_first_of(";]", pos0);
+#endif
+	auto const Qualified = FuncSigText.substr(pos0, pos1 - pos0);
+	auto const scope_resolution_pos = Qualified.rfind("::");
+
+	return scope_resolution_pos == std::string_view::npos ? Qualified : Qualified.substr(scope_resolution_pos + 2);
+}
+
 template <auto FirstEnumValue, auto... RestEnumValues>
 [[nodiscard]] constexpr auto EnumDeserialize(std::string_view sz) noexcept// -> std::optional<decltype(FirstEnumValue)>
 {
 	static_assert(std::conjunction_v<std::is_enum<decltype(FirstEnumValue)>, std::is_same<decltype(FirstEnumValue), decltype(RestEnumValues)>...>);
 
-	static constexpr std::string_view FuncSigText{ __FUNCSIG__ };
-	static constexpr auto pos0 = FuncSigText.find_first_of('<') + 1, pos1 = FuncSigText.find_first_of('>');
-	static constexpr auto TemplateArgsText = FuncSigText.substr(pos0, pos1 - pos0);
-	static constexpr auto TemplateArgsSplited = []()
-	{
-		std::array<std::string_view, sizeof...(RestEnumValues) + 1> res;
-		size_t posLast = 0, posCur = 0, idx = 0;
-		while ((posCur = TemplateArgsText.find_first_of(',', posLast)) != std::string_view::npos)
-		{
-			res[idx++] = TemplateArgsText.substr(posLast, posCur - posLast);
-			posLast = posCur + 1;
-		}
-		res[idx] = TemplateArgsText.substr(posLast);
-		return res;
-	}();
-	static constexpr std::array Candidates{ FirstEnumValue, RestEnumValues... };
-
 	std::optional<decltype(FirstEnumValue)> result{ std::nullopt };
 
-	for (auto&& [idx, text] : std::views::enumerate(TemplateArgsSplited))
+	[&]<auto... Values>() noexcept
 	{
-		auto const scope_resolution_pos = text.find("::");
-		auto const identifier = scope_resolution_pos == std::string_view::npos ? text : text.substr(scope_resolution_pos + 2);
-
-		if (identifier == sz)
-		{
-			result = Candidates[idx];
-			break;
-		}
-	}
+		std::ignore = ((EnumValueName<Values>() == sz ? (result = Values, true) : false) || ...);
+	}.template operator()<FirstEnumValue, RestEnumValues...>();
 
 	return result;
 }
@@ -82,22 +71,50 @@ template <auto FirstEnumValue, auto... RestEnumValues>
 
 namespace Database::PBS
 {
+	// Unresolved names are dropped. ValidateRaw() reports them, with their location.
 	template <typename T>
-	[[nodiscard]] auto BuildFromRaw(auto&& Source) noexcept -> std::map<std::string_view, T, sv_less_t>
+	[[nodiscard]] auto LinkAll(CRecordTable<T> const& Lib, std::span<std::string const> rgszNames) noexcept -> std::vector<THandle<T>>
 	{
-		std::map<std::string_view, T, sv_less_t> ret{};
+		std::vector<THandle<T>> ret{};
+		ret.reserve(rgszNames.size());
+
+		for (auto&& szName : rgszNames)
+		{
+			if (auto const hRecord = Lib.Find(szName); hRecord)
+				ret.push_back(hRecord);
+		}
+
+		return ret;
+	}
+
+	template <typename T>
+	void SortNameIndex(CRecordTable<T>* pTable) noexcept
+	{
+		std::ranges::sort(pTable->m_NameIndex, sv_less_t{}, &decltype(pTable->m_NameIndex)::value_type::first);
+	}
+
+	template <typename T>
+	[[nodiscard]] auto BuildFromRaw(auto&& Source) noexcept -> CRecordTable<T>
+	{
+		CRecordTable<T> ret{};
+		ret.m_Records.reserve(Source.size());
+		ret.m_NameIndex.reserve(Source.size());
 
 		for (auto&& [NameId, RawData] : Source)
 		{
-			auto&& [it, bNew] = ret.try_emplace(
-				NameId,
-				RawData
-			);
+			if (ret.m_Records.size() >= THandle<T>::INVALID) [[unlikely]]
+			{
+				UTIL_LogWarning(ELogCategory::Database, "[{}] Too many records, '{}' and the rest are ignored.", __FUNCTION__, NameId);
+				break;
+			}
 
-			if (!bNew) [[unlikely]]
-				std::println("[{}] Duplicated id name '{}', the later is ignored.", __FUNCTION__, NameId);
+			auto& Record = ret.m_Records.emplace_back(RawData);
+			Record.m_Id = NameId;
+
+			ret.m_NameIndex.emplace_back(NameId, THandle<T>{ static_cast<std::uint16_t>(ret.m_Records.size() - 1) });
 		}
 
+		SortNameIndex(&ret);
 		return ret;
 	}
 
@@ -110,33 +127,54 @@ namespace Database::PBS
 
 	}
 
-	[[nodiscard]] auto BuildPokemonTypes() noexcept -> decltype(BuildFromRaw<CPokemonType>(::PBS::Types))
+	[[nodiscard]] auto BuildPokemonTypes() noexcept -> CRecordTable<CPokemonType>
 	{
 		auto ret = BuildFromRaw<CPokemonType>(::PBS::Types);
 
-		// Link references.
+		// Link references. The table is not published yet, so resolve against the local one.
 
-		for (auto&& [NameId, Type] : ret)
+		for (auto&& Type : ret.m_Records)
 		{
-			auto const fnLinker =
-				[&](std::vector<struct CPokemonType const*> CPokemonType::* lhs, std::vector<std::string> PokemonType::* rhs) noexcept
-				{
-					for (auto&& TypeName : Type.m_Raw->*rhs)
-					{
-						try
-						{
-							(Type.*lhs).push_back(&ret.at(TypeName));
-						}
-						catch (...)
-						{
-							std::println("[BuildPokemonTypes] Assumed type '{}' referenced in type '{}' but has no definition.", TypeName, NameId);
-						}
-					}
-				};
+			Type.m_Weaknesses = LinkAll(ret, Type.m_Raw->m_Weaknesses);
+			Type.m_Resistances = LinkAll(ret, Type.m_Raw->m_Resistances);
+			Type.m_Immunities = LinkAll(ret, Type.m_Raw->m_Immunities);
+		}
+
+		return ret;
+	}
+
+	[[nodiscard]] auto BuildTypeChart(CRecordTable<CPokemonType> const& Lib) noexcept -> CTypeChart
+	{
+		CTypeChart ret{ .m_Count = Lib.size() };
+		auto const N = ret.m_Count;
 
-			fnLinker(&CPokemonType::m_Weaknesses, &PokemonType::m_Weaknesses);
-			fnLinker(&CPokemonType::m_Resistances, &PokemonType::m_Resistances);
-			fnLinker(&CPokemonType::m_Immunities, &PokemonType::m_Immunities);
+		ret.m_Matrix.resize(N * N, EFFECTIVENESS_NORMAL);
+
+		// Same precedence as Essentials: immunity, then weakness, then resistance.
+		for (auto&& [iDef, Type] : std::views::enumerate(Lib.m_Records))
+		{
+			for (auto&& hAtk : Type.m_Resistances)
+				ret.m_Matrix[hAtk.m_Index * N + iDef] = EFFECTIVENESS_NORMAL / 2;
+			for (auto&& hAtk : Type.m_Weaknesses)
+				ret.m_Matrix[hAtk.m_Index * N + iDef] = EFFECTIVENESS_NORMAL * 2;
+			for (auto&& hAtk : Type.m_Immunities)
+				ret.m_Matrix[hAtk.m_Index * N + iDef] = 0;
+		}
+
+		ret.m_DualProfile.resize(N * N * N);
+
+		for (std::size_t iDef1 = 0; iDef1 < N; ++iDef1)
+		{
+			for (std::size_t iDef2 = 0; iDef2 < N; ++iDef2)
+			{
+				auto const pProfile = ret.m_DualProfile.data() + (iDef1 * N + iDef2) * N;
+
+				for (std::size_t iAtk = 0; iAtk < N; ++iAtk)
+				{
+					auto const a = ret.m_Matrix[iAtk * N + iDef1], b = ret.m_Matrix[iAtk * N + iDef2];
+					pProfile[iAtk] = iDef1 == iDef2 ? a : static_cast<std::uint8_t>(a * b / EFFECTIVENESS_NORMAL);
+				}
+			}
 		}
 
 		return ret;
@@ -182,7 +220,7 @@ namespace Database::PBS
 
 	CPokemonSpecies::CPokemonSpecies(::PokemonSpecies const& Raw) noexcept
 		: PORT_SIMPLE(Name), PORT_SIMPLE(FormName),
-		PORT_COLL(Types, Types, CPokemonSpecies),
+		PORT_COLL(Types, Types),
 		PORT_SIMPLE(BaseStats), PORT_SIMPLE(BaseExp), PORT_SIMPLE(CatchRate), PORT_SIMPLE(Happiness), PORT_SIMPLE(Generation), PORT_SIMPLE(HatchSteps),
 		PORT_ENUM(GenderRatio, EGenderRatio::Female50Percent,
 			EGenderRatio::AlwaysMale, EGenderRatio::FemaleOneEighth, EGenderRatio::Female25Percent, EGenderRatio::Female50Percent,
@@ -191,83 +229,144 @@ namespace Database::PBS
 			EGrowthRate::Fast, EGrowthRate::Medium, EGrowthRate::Slow, EGrowthRate::MediumFast,
 			EGrowthRate::Parabolic, EGrowthRate::MediumSlow, EGrowthRate::Erratic, EGrowthRate::Fluctuating),
 		PORT_SIMPLE(EVs),
-		PORT_COLL(Abilities, Abilities, CPokemonSpecies), PORT_COLL(HiddenAbilities, Abilities, CPokemonSpecies),
-		PORT_COLL(TutorMoves, Moves, CPokemonSpecies), PORT_COLL(EggMoves, Moves, CPokemonSpecies),
-		PORT_SIMPLE(EggGroups), PORT_OPTIONAL(Incense, Items), PORT_SIMPLE(Offspring),
+		PORT_COLL(Abilities, Abilities), PORT_COLL(HiddenAbilities, Abilities),
+		PORT_COLL(TutorMoves, Moves), PORT_COLL(EggMoves, Moves),
+		PORT_SIMPLE(EggGroups), PORT_OPTIONAL(Incense, Items),
 		PORT_SIMPLE(Height), PORT_SIMPLE(Weight), PORT_SIMPLE(Color), PORT_SIMPLE(Shape), PORT_SIMPLE(Habitat), PORT_SIMPLE(Category), PORT_SIMPLE(Pokedex),
 		PORT_SIMPLE(Flags), PORT_OPTIONAL(WildItemCommon, Items), PORT_OPTIONAL(WildItemUncommon, Items), PORT_OPTIONAL(WildItemRare, Items), PORT_SIMPLE(NationalDex),
 		m_Raw{ &Raw }
 	{
-		// Convert Moves array to level-move pairs with pointers
+		// Convert Moves array to level-move pairs with handles
+		m_Moves.reserve(Raw.m_Moves.size());
+
 		for (auto&& [Level, MoveName] : Raw.m_Moves)
 		{
-			try
-			{
-				m_Moves.emplace_back(Level, &Moves.at(MoveName));
-			}
-			catch (...)
+			if (auto const hMove = Moves.Find(MoveName); hMove)
+				m_Moves.emplace_back(Level, hMove);
+		}
+	}
+
+	[[nodiscard]] auto ParseEvolutionMethod(std::string_view szMethod) noexcept -> EEvolutionMethod
+	{
+		using enum EEvolutionMethod;
+
+		return EnumDeserialize<
+			Level, LevelMale, LevelFemale, LevelDay, LevelNight, LevelMorning, LevelAfternoon, LevelEvening,
+			LevelNoWeather, LevelSun, LevelRain, LevelSnow, LevelSandstorm, LevelCycling, LevelSurfing, LevelDiving,
+			LevelDarkness, LevelDarkInParty, AttackGreater, AtkDefEqual, DefenseGreater, Silcoon, Cascoon, Ninjask, Shedinja,
+			Happiness, HappinessMale, HappinessFemale, HappinessDay, HappinessNight, HappinessMove, HappinessMoveType, HappinessHoldItem, MaxHappiness,
+			Beauty, HoldItem, HoldItemMale, HoldItemFemale, DayHoldItem, NightHoldItem, HoldItemHappiness, HasMove, HasMoveType, HasInParty,
+			Location, LocationFlag, Region, Item, ItemMale, ItemFemale, ItemDay, ItemNight, ItemHappiness,
+			Trade, TradeMale, TradeFemale, TradeDay, TradeNight, TradeItem, TradeSpecies,
+			BattleDealCriticalHit, Event, EventAfterDamageTaken
+		>(szMethod).value_or(Unknown);
+	}
+
+	// Species parameters are resolved against the unpublished species table, the rest are already published.
+	void LinkEvolutionParam(CPokemonEvolution* pEvo, CRecordTable<CPokemonSpecies> const& SpeciesLib) noexcept
+	{
+		auto const fnAssign = [&](auto hRecord) noexcept
+		{
+			if (hRecord)
 			{
-				std::println("[CPokemonSpecies] Assumed move '{}' referenced in species '{}' but has no definition.", MoveName, Raw.m_Name);
+				pEvo->m_ParamType = EvolutionParamOf(pEvo->m_MethodType);
+				pEvo->m_ParamValue = hRecord.m_Index;
 			}
+		};
+
+		switch (EvolutionParamOf(pEvo->m_MethodType))
+		{
+		case EEvolutionParam::Integer:
+			pEvo->m_ParamType = EEvolutionParam::Integer;
+			pEvo->m_ParamValue = UTIL_StrToNum<std::int32_t>(pEvo->m_Parameter);
+			break;
+
+		case EEvolutionParam::Item:
+			fnAssign(Items.Find(pEvo->m_Parameter));
+			break;
+
+		case EEvolutionParam::Move:
+			fnAssign(Moves.Find(pEvo->m_Parameter));
+			break;
+
+		case EEvolutionParam::Type:
+			fnAssign(Types.Find(pEvo->m_Parameter));
+			break;
+
+		case EEvolutionParam::Species:
+			fnAssign(SpeciesLib.Find(pEvo->m_Parameter));
+			break;
+
+		case EEvolutionParam::String:
+			pEvo->m_ParamType = EEvolutionParam::String;	// Read it from m_Parameter.
+			break;
+
+		default:
+			break;
 		}
 	}
 
-	[[nodiscard]] auto BuildPokemonSpecies() noexcept
+	[[nodiscard]] auto BuildPokemonSpecies() noexcept -> CRecordTable<CPokemonSpecies>
 	{
-		//auto ret = BuildFromRaw<CPokemonSpecies>(::PBS::Species);
+		CRecordTable<CPokemonSpecies> ret{};
+
+		std::size_t iTotalForms{};
+		for (auto&& FormsMap : ::PBS::Forms | std::views::values)
+			iTotalForms += FormsMap.size();
 
-		std::map<
-			std::string_view,
-			std::map<int, CPokemonSpecies, std::less<>>,
-			sv_less_t
-		> ret{};
+		ret.m_Records.reserve(iTotalForms);
+		ret.m_NameIndex.reserve(::PBS::Forms.size());
 
 		for (auto&& [NameId, FormsMap] : ::PBS::Forms)
 		{
-			auto&& [it, bNew] = ret.try_emplace(NameId);
-
-			if (!bNew) [[unlikely]]
-				std::println("[{}] Duplicated id name '{}', the later is ignored.", __FUNCTION__, NameId);
-			else
+			if (ret.m_Records.size() + FormsMap.size() >= SpeciesHandle::INVALID) [[unlikely]]
 			{
-				auto& FormsMapOut = it->second;
+				UTIL_LogWarning(ELogCategory::Database, "[{}] Too many species forms, '{}' and the rest are ignored.", __FUNCTION__, NameId);
+				break;
+			}
 
-				for (auto&& [iId, Form] : FormsMap)
-				{
-					auto&& [it2, bNew2] = FormsMapOut.try_emplace(
-						iId,
-						Form
-					);
-				}
+			SpeciesHandle const hBaseForm{ static_cast<std::uint16_t>(ret.m_Records.size()) };
+
+			for (auto&& [iId, Form] : FormsMap)
+			{
+				auto& Record = ret.m_Records.emplace_back(Form);
+				Record.m_Id = NameId;
+				Record.m_FormId = iId;
+				Record.m_BaseForm = hBaseForm;
+				Record.m_FormCount = static_cast<std::uint16_t>(FormsMap.size());
 			}
+
+			ret.m_NameIndex.emplace_back(NameId, hBaseForm);
 		}
 
-		// Link references.
+		SortNameIndex(&ret);
 
-		for (auto&& [NameId, FormMap] : ret)
+		// Link references. The table is not published yet, so resolve against the local one.
+
+		for (auto&& Spec : ret.m_Records)
 		{
-			for (auto&& [iId, Spec] : FormMap)
-			{
-				// Evolutions
+			// Evolutions
 
-				for (auto&& Evo : Spec.m_Raw->m_Evolutions)
-				{
-					try
-					{
-						Spec.m_Evolutions.push_back(
-							CPokemonEvolution{
-								.m_Species{ Evo.m_Species },
-								.m_Method{ Evo.m_Method },
-								.m_Parameter{ Evo.m_Parameter },
-							}
-						);
-					}
-					catch (...)
-					{
-						std::println("[BuildPokemonSpecies] Assumed species '{}' referenced in evolution of species '{}' but has no definition.", Evo.m_Species, NameId);
+			Spec.m_Evolutions.reserve(Spec.m_Raw->m_Evolutions.size());
+
+			for (auto&& Evo : Spec.m_Raw->m_Evolutions)
+			{
+				auto& Linked = Spec.m_Evolutions.emplace_back(
+					CPokemonEvolution{
+						.m_Species{ Evo.m_Species },
+						.m_Method{ Evo.m_Method },
+						.m_Parameter{ Evo.m_Parameter },
+						.m_Target{ ret.Find(Evo.m_Species) },
+						.m_MethodType{ ParseEvolutionMethod(Evo.m_Method) },
 					}
-				}
+				);
+
+				LinkEvolutionParam(&Linked, ret);
 			}
+
+			// Offspring
+
+			Spec.m_Offspring = LinkAll(ret, Spec.m_Raw->m_Offspring);
 		}
 
 		return ret;
@@ -275,10 +374,36 @@ namespace Database::PBS
 
 	void Build() noexcept
 	{
-		Types = BuildPokemonTypes();
-		Moves = BuildFromRaw<CPokemonMove>(::PBS::Moves);
-		Abilities = BuildFromRaw<CPokemonAbility>(::PBS::Abilities);
-		Items = BuildFromRaw<CPokemonItem>(::PBS::Items);
-		Species = BuildPokemonSpecies();
+		CTraceZone Zone{ "Build", ELogCategory::Database };
+		CMemoryScope MemoryScope{ EMemoryTag::LinkedPbs };
+		BuildTimings.clear();
+		++BuildGeneration;
+
+		// Stage names double as trace zone names, literals only.
+		auto const fnStage = [](std::string_view szStage, auto&& fn) noexcept
+		{
+			CTraceZone StageZone{ szStage, ELogCategory::Database };
+			auto const t0 = std::chrono::high_resolution_clock::now();
+			fn();
+			BuildTimings.emplace_back(szStage, std::chrono::high_resolution_clock::now() - t0);
+		};
+
+		fnStage("Validate", [] static noexcept { Diagnostics = ValidateRaw(); });
+
+		if (!Diagnostics.empty())
+			UTIL_LogWarning(ELogCategory::Database, "[{}] {} broken references in PBS, found in {:.2f} ms.", __FUNCTION__, Diagnostics.size(), BuildTimings.back().m_Time.count());
+
+		fnStage("Types", [] static noexcept { Types = BuildPokemonTypes(); TypeChart = BuildTypeChart(Types); });
+		fnStage("Moves", [] static noexcept { Moves = BuildFromRaw<CPokemonMove>(::PBS::Moves); });
+		fnStage("Abilities", [] static noexcept { Abilities = BuildFromRaw<CPokemonAbility>(::PBS::Abilities); });
+		fnStage("Items", [] static noexcept { Items = BuildFromRaw<CPokemonItem>(::PBS::Items); });
+		fnStage("Species", [] static noexcept { Species = BuildPokemonSpecies(); });
+
+		// Derived tables, must come after all records are linked.
+		fnStage("Columns", &BuildSpeciesColumns);
+		fnStage("Evolutions", &BuildEvolutionGraph);
+		fnStage("Learnsets", &BuildLearnsetIndex);
+		fnStage("Breeding", &BuildBreedingTable);
+		fnStage("Search", [] static noexcept { RebuildSearchIndex(); });
 	}
 }
@@ -0,0 +1,241 @@
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.PBS.Validation;
+import Database.Raw.PBS;
+
+
+namespace Database::PBS
+{
+	struct CReporter final
+	{
+		std::vector<CDiagnostic>* m_pOut{};
+		std::string_view m_File{};
+		std::string_view m_Section{};
+
+		void operator()(ESeverity Severity, std::string_view szKey, std::string_view szValue, std::string_view szProblem) const noexcept
+		{
+			m_pOut->push_back(
+				CDiagnostic{
+					.m_Severity = Severity,
+					.m_File = m_File,
+					.m_Section{ m_Section },
+					.m_Key = szKey,
+					.m_Value{ szValue },
+					.m_Problem = szProblem,
+				}
+			);
+		}
+	};
+
+	static void Expect(CReporter const& Report, auto const& Lib, std::string_view szKey, std::string_view szValue, std::string_view szProblem) noexcept
+	{
+		if (!Lib.contains(szValue)) [[unlikely]]
+			Report(ESeverity::Error, szKey, szValue, szProblem);
+	}
+
+	[[nodiscard]] static auto ValidateTypes() noexcept -> std::vector<CDiagnostic>
+	{
+		std::vector<CDiagnostic> ret{};
+
+		for (auto&& [szId, Type] : ::PBS::Types)
+		{
+			CReporter const Report{ &ret, "types.txt", szId };
+
+			for (auto&& sz : Type.m_Weaknesses)
+				Expect(Report, ::PBS::Types, "Weaknesses", sz, "unknown type");
+			for (auto&& sz : Type.m_Resistances)
+				Expect(Report, ::PBS::Types, "Resistances", sz, "unknown type");
+			for (auto&& sz : Type.m_Immunities)
+				Expect(Report, ::PBS::Types, "Immunities", sz, "unknown type");
+		}
+
+		return ret;
+	}
+
+	[[nodiscard]] static auto ValidateMoves() noexcept -> std::vector<CDiagnostic>
+	{
+		std::vector<CDiagnostic> ret{};
+
+		for (auto&& [szId, Move] : ::PBS::Moves)
+			Expect(CReporter{ &ret, "moves.txt", szId }, ::PBS::Types, "Type", Move.m_Type, "unknown type");
+
+		return ret;
+	}
+
+	[[nodiscard]] static auto ValidateItems() noexcept -> std::vector<CDiagnostic>
+	{
+		std::vector<CDiagnostic> ret{};
+
+		for (auto&& [szId, Item] : ::PBS::Items)
+		{
+			if (!Item.m_Move.empty())
+				Expect(CReporter{ &ret, "items.txt", szId }, ::PBS::Moves, "Move", Item.m_Move, "unknown move");
+		}
+
+		return ret;
+	}
+
+	// pBase is null for the base form. Forms inherit every key they don't override, and those were already reported on the base form.
+	static void ValidateSpecies(CReporter const& Report, ::PokemonSpecies const& Spec, ::PokemonSpecies const* pBase) noexcept
+	{
+		auto const fnList = [&]<typename T>(T PokemonSpecies::* pMember, std::string_view szKey, auto const& Lib, std::string_view szProblem) noexcept
+		{
+			if (pBase && Spec.*pMember == pBase->*pMember)
+				return;
+
+			for (auto&& sz : Spec.*pMember)
+				Expect(Report, Lib, szKey, sz, szProblem);
+		};
+
+		auto const fnOptional = [&](std::string PokemonSpecies::* pMember, std::string_view szKey, auto const& Lib, std::string_view szProblem) noexcept
+		{
+			if ((pBase && Spec.*pMember == pBase->*pMember) || (Spec.*pMember).empty())
+				return;
+
+			Expect(Report, Lib, szKey, Spec.*pMember, szProblem);
+		};
+
+		fnList(&::PokemonSpecies::m_Types, "Types", ::PBS::Types, "unknown type");
+		fnList(&::PokemonSpecies::m_Abilities, "Abilities", ::PBS::Abilities, "unknown ability");
+		fnList(&::PokemonSpecies::m_HiddenAbilities, "HiddenAbilities", ::PBS::Abilities, "unknown ability");
+		fnList(&::PokemonSpecies::m_TutorMoves, "TutorMoves", ::PBS::Moves, "unknown move");
+		fnList(&::PokemonSpecies::m_EggMoves, "EggMoves", ::PBS::Moves, "unknown move");
+		fnList(&::PokemonSpecies::m_Offspring, "Offspring", ::PBS::Species, "unknown species");
+
+		fnOptional(&::PokemonSpecies::m_Incense, "Incense", ::PBS::Items, "unknown item");
+		fnOptional(&::PokemonSpecies::m_WildItemCommon, "WildItemCommon", ::PBS::Items, "unknown item");
+		fnOptional(&::PokemonSpecies::m_WildItemUncommon, "WildItemUncommon", ::PBS::Items, "unknown item");
+		fnOptional(&::PokemonSpecies::m_WildItemRare, "WildItemRare", ::PBS::Items, "unknown item");
+
+		if (!pBase || Spec.m_Moves != pBase->m_Moves)
+		{
+			for (auto&& szMove : Spec.m_Moves | std::views::elements<1>)
+				Expect(Report, ::PBS::Moves, "Moves", szMove, "unknown move");
+		}
+
+		static constexpr auto fnSameEvolution = [](auto const& lhs, auto const& rhs) static noexcept
+		{
+			return lhs.m_Species == rhs.m_Species && lhs.m_Method == rhs.m_Method && lhs.m_Parameter == rhs.m_Parameter;
+		};
+
+		if (pBase && std::ranges::equal(Spec.m_Evolutions, pBase->m_Evolutions, fnSameEvolution))
+			return;
+
+		for (auto&& Evo : Spec.m_Evolutions)
+		{
+			Expect(Report, ::PBS::Species, "Evolutions", Evo.m_Species, "unknown species");
+
+			auto const Method = ParseEvolutionMethod(Evo.m_Method);
+
+			switch (EvolutionParamOf(Method))
+			{
+			case EEvolutionParam::Integer:
+			{
+				std::int32_t iValue{};
+				auto const [ptr, ec] = std::from_chars(Evo.m_Parameter.data(), Evo.m_Parameter.data() + Evo.m_Parameter.size(), iValue);
+
+				if (!Evo.m_Parameter.empty() && (ec != std::errc{} || ptr != Evo.m_Parameter.data() + Evo.m_Parameter.size()))
+					Report(ESeverity::Warning, "Evolutions", Evo.m_Parameter, "parameter is not an integer");
+				break;
+			}
+
+			case EEvolutionParam::Item:
+				Expect(Report, ::PBS::Items, "Evolutions", Evo.m_Parameter, "unknown item");
+				break;
+			case EEvolutionParam::Move:
+				Expect(Report, ::PBS::Moves, "Evolutions", Evo.m_Parameter, "unknown move");
+				break;
+			case EEvolutionParam::Type:
+				Expect(Report, ::PBS::Types, "Evolutions", Evo.m_Parameter, "unknown type");
+				break;
+			case EEvolutionParam::Species:
+				Expect(Report, ::PBS::Species, "Evolutions", Evo.m_Parameter, "unknown species");
+				break;
+
+			default:
+				if (Method == EEvolutionMethod::Unknown)
+					Report(ESeverity::Warning, "Evolutions", Evo.m_Method, "unknown evolution method");
+				break;
+			}
+		}
+	}
+
+	[[nodiscard]] static auto ValidateAllSpecies() noexcept -> std::vector<CDiagnostic>
+	{
+		// ::PBS::Forms holds every species as form 0, plus the forms from pokemon_forms.txt.
+		std::vector<std::pair<std::string_view, std::map<int, ::PokemonSpecies, std::less<>> const*>> rgFamilies{};
+		rgFamilies.reserve(::PBS::Forms.size());
+
+		for (auto&& [szId, FormsMap] : ::PBS::Forms)
+			rgFamilies.emplace_back(szId, &FormsMap);
+
+		std::vector<std::vector<CDiagnostic>> rgPerSpecies(rgFamilies.size());
+
+		std::transform(std::execution::par, rgFamilies.begin(), rgFamilies.end(), rgPerSpecies.begin(),
+			[](auto const& Family) noexcept
+			{
+				std::vector<CDiagnostic> ret{};
+				auto&& [szId, pForms] = Family;
+				auto const itBase = pForms->find(0);
+				auto const pBase = itBase != pForms->cend() ? &itBase->second : nullptr;
+
+				for (auto&& [iForm, Form] : *pForms)
+				{
+					if (iForm == 0)
+						ValidateSpecies(CReporter{ &ret, "pokemon.txt", szId }, Form, nullptr);
+					else
+					{
+						auto const szSection = std::format("{},{}", szId, iForm);
+						ValidateSpecies(CReporter{ &ret, "pokemon_forms.txt", szSection }, Form, pBase);
+					}
+				}
+
+				return ret;
+			}
+		);
+
+		return rgPerSpecies | std::views::join | std::ranges::to<std::vector>();
+	}
+
+	// The loader leaves these out of ::PBS::Forms, so ValidateAllSpecies never sees them.
+	[[nodiscard]] static auto ValidateOrphanForms() noexcept -> std::vector<CDiagnostic>
+	{
+		std::vector<CDiagnostic> ret{};
+
+		for (auto&& szSection : ::PBS::OrphanForms)
+		{
+			auto const szBase = std::string_view{ szSection }.substr(0, szSection.find(','));
+			CReporter{ &ret, "pokemon_forms.txt", szSection }(ESeverity::Error, "Id", szBase, "unknown base species");
+		}
+
+		return ret;
+	}
+
+	auto ValidateRaw() noexcept -> std::vector<CDiagnostic>
+	{
+		using fnValidator_t = auto (*)() noexcept -> std::vector<CDiagnostic>;
+		static constexpr std::array<fnValidator_t, 5> rgfnValidators{ &ValidateTypes, &ValidateMoves, &ValidateItems, &ValidateAllSpecies, &ValidateOrphanForms };
+
+		// Tables are read-only here, every task owns its output.
+		std::array<std::vector<CDiagnostic>, rgfnValidators.size()> rgResults{};
+
+		std::transform(std::execution::par, rgfnValidators.begin(), rgfnValidators.end(), rgResults.begin(),
+			[](fnValidator_t pfn) static noexcept { return pfn(); }
+		);
+
+		auto ret = rgResults | std::views::join | std::ranges::to<std::vector>();
+
+		std::ranges::stable_sort(ret, {},
+			[](CDiagnostic const& Diag) static noexcept { return std::tie(Diag.m_File, Diag.m_Section, Diag.m_Key); }
+		);
+
+		return ret;
+	}
+}
@@ -0,0 +1,42 @@
+module;
+
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#endif
+
+export module Database.PBS.Validation;
+
+#ifndef __INTELLISENSE__
+import std.compat;
+#endif
+
+export namespace Database::PBS
+{
+	enum struct ESeverity : std::uint8_t { Warning, Error, };
+
+	// One broken reference in the raw PBS tables, located down to the key.
+	struct CDiagnostic final
+	{
+		ESeverity m_Severity{};
+		std::string_view m_File{};		// e.g. "pokemon_forms.txt"
+		std::string m_Section{};		// e.g. "PIKACHU,1", as written between the brackets.
+		std::string_view m_Key{};		// e.g. "Evolutions"
+		std::string m_Value{};			// The offending value.
+		std::string_view m_Problem{};	// e.g. "unknown move"
+
+		[[nodiscard]] auto Describe() const noexcept -> std::string
+		{
+			return std::format("{}: {} [{}] {}: {} '{}'",
+				m_Severity == ESeverity::Error ? "error" : "warning", m_File, m_Section, m_Key, m_Problem, m_Value);
+		}
+	};
+
+	// Of the last Build().
+	inline std::vector<CDiagnostic> Diagnostics;
+
+	// Checks every cross reference of ::PBS, one task per table. Does not touch Database::PBS, so it may run before Build().
+	// Sorted by file, section and key.
+	[[nodiscard]] extern "C++" auto ValidateRaw() noexcept -> std::vector<CDiagnostic>;
+}
@@ -19,16 +19,83 @@ import Database.Raw.PBS;
 
 export namespace Database::PBS
 {
+	// Index into one of the dense tables below.
+	// Stable between two Build() calls, therefore safe to store and to serialize.
+	template <typename T>
+	struct THandle final
+	{
+		static constexpr std::uint16_t INVALID = 0xFFFF;
+
+		std::uint16_t m_Index{ INVALID };
+
+		[[nodiscard]] inline constexpr explicit operator bool() const noexcept { return m_Index != INVALID; }
+		[[nodiscard]] inline constexpr auto operator<=>(THandle const&) const noexcept = default;
+	};
+
+	struct CPokemonType;
+	struct CPokemonMove;
+	struct CPokemonAbility;
+	struct CPokemonItem;
+	struct CPokemonSpecies;
+
+	using TypeHandle = THandle<CPokemonType>;
+	using MoveHandle = THandle<CPokemonMove>;
+	using AbilityHandle = THandle<CPokemonAbility>;
+	using ItemHandle = THandle<CPokemonItem>;
+	using SpeciesHandle = THandle<CPokemonSpecies>;
+
+	// Records are kept contiguous, the name index is a sorted side table for string lookups.
+	template <typename T>
+	struct CRecordTable final
+	{
+		using handle_type = THandle<T>;
+
+		std::vector<T> m_Records{};
+		std::vector<std::pair<std::string_view, handle_type>> m_NameIndex{};	// Sorted by name.
+
+		[[nodiscard]] auto Find(std::string_view szName) const noexcept -> handle_type
+		{
+			auto const it = std::ranges::lower_bound(m_NameIndex, szName, sv_less_t{}, &decltype(m_NameIndex)::value_type::first);
+
+			if (it != m_NameIndex.cend() && it->first == szName)
+				return it->second;
+
+			return {};
+		}
+
+		[[nodiscard]] auto At(handle_type hRecord) const noexcept -> T const*
+		{
+			if (hRecord.m_Index < m_Records.size())
+				return std::addressof(m_Records[hRecord.m_Index]);
+
+			return nullptr;
+		}
+
+		[[nodiscard]] auto HandleOf(T const& Record) const noexcept -> handle_type
+		{
+			return { static_cast<std::uint16_t>(std::addressof(Record) - m_Records.data()) };
+		}
+
+		[[nodiscard]] inline auto operator[](handle_type hRecord) const noexcept -> T const& { return m_Records[hRecord.m_Index]; }
+		[[nodiscard]] inline auto operator[](std::string_view szName) const noexcept -> T const* { return At(Find(szName)); }
+
+		[[nodiscard]] inline auto begin() const noexcept { return m_Records.cbegin(); }
+		[[nodiscard]] inline auto end() const noexcept { return m_Records.cend(); }
+		[[nodiscard]] inline auto size() const noexcept { return m_Records.size(); }
+		[[nodiscard]] inline auto empty() const noexcept { return m_Records.empty(); }
+	};
+
 	struct CPokemonType final
 	{
+		std::string_view m_Id{};
 		std::string_view m_Name{ "Unnamed" };
 		std::uint8_t m_IconPosition{ 0 };
 		bool m_IsSpecialType{ false };
 		bool m_IsPseudoType{ false };
 		std::span<std::string const> m_Flags{};
-		std::vector<struct CPokemonType const*> m_Weaknesses{};
-		std::vector<struct CPokemonType const*> m_Resistances{};
-		std::vector<struct CPokemonType const*> m_Immunities{};
+		std::vector<TypeHandle> m_Weaknesses{};
+		std::vector<TypeHandle> m_Resistances{};
+		std::vector<TypeHandle> m_Immunities{};
 
 		// Extra
 
@@ -37,18 +104,54 @@ export namespace Database::PBS
 		CPokemonType(::PokemonType const& Raw) noexcept;
 
 		CPokemonType(CPokemonType const&) noexcept = delete;
-		CPokemonType(CPokemonType&&) noexcept = delete;
+		CPokemonType(CPokemonType&&) noexcept = default;
 		CPokemonType& operator=(CPokemonType const&) = delete;
-		CPokemonType& operator=(CPokemonType&&) = delete;
+		CPokemonType& operator=(CPokemonType&&) noexcept = default;
 		~CPokemonType() noexcept = default;
 	};
 
-	inline std::map<std::string_view, CPokemonType, sv_less_t> Types;
+	inline CRecordTable<CPokemonType> Types;
+
+	// Fixed point multipliers, 4 stands for x1. Single type: 0, 2, 4, 8. Dual type: 0, 1, 2, 4, 8, 16.
+	inline constexpr std::uint8_t EFFECTIVENESS_NORMAL = 4;
+
+	// Dense type chart over Types, indexed by type handle.
+	// A single typed defender is expressed as (Def, Def), the same convention as the species columns.
+	struct CTypeChart final
+	{
+		std::size_t m_Count{};
+		std::vector<std::uint8_t> m_Matrix{};		// [Atk * N + Def]
+		std::vector<std::uint8_t> m_DualProfile{};	// [(Def1 * N + Def2) * N + Atk], every attacker against every type combination.
+
+		[[nodiscard]] inline auto Effectiveness(TypeHandle hAtk, TypeHandle hDef) const noexcept -> std::uint8_t
+		{
+			assert(hAtk.m_Index < m_Count && hDef.m_Index < m_Count);
+			return m_Matrix[hAtk.m_Index * m_Count + hDef.m_Index];
+		}
+
+		[[nodiscard]] inline auto Effectiveness(TypeHandle hAtk, TypeHandle hDef1, TypeHandle hDef2) const noexcept -> std::uint8_t
+		{
+			assert(hAtk.m_Index < m_Count && hDef1.m_Index < m_Count && hDef2.m_Index < m_Count);
+			return m_DualProfile[(hDef1.m_Index * m_Count + hDef2.m_Index) * m_Count + hAtk.m_Index];
+		}
+
+		// How every attacking type fares against this combination, indexed by attacker handle.
+		[[nodiscard]] inline auto Profile(TypeHandle hDef1, TypeHandle hDef2) const noexcept -> std::span<std::uint8_t const>
+		{
+			assert(hDef1.m_Index < m_Count && hDef2.m_Index < m_Count);
+			return { m_DualProfile.data() + (hDef1.m_Index * m_Count + hDef2.m_Index) * m_Count, m_Count };
+		}
+
+		[[nodiscard]] inline auto Profile(TypeHandle hDef) const noexcept { return Profile(hDef, hDef); }
+	};
+
+	inline CTypeChart TypeChart;
 
 	struct CPokemonMove final
 	{
+		std::string_view m_Id{};
 		std::string_view m_Name{ "Unnamed" };
-		CPokemonType const* m_Type{ nullptr };
+		TypeHandle m_Type{};
 
 		EMoveCategory m_Category{ EMoveCategory::Status };
 
@@ -73,10 +176,11 @@ export namespace Database::PBS
 		~CPokemonMove() noexcept = default;
 	};
 
-	inline std::map<std::string_view, CPokemonMove, sv_less_t> Moves;
+	inline CRecordTable<CPokemonMove> Moves;
 
 	struct CPokemonAbility final
 	{
+		std::string_view m_Id{};
 		std::string_view m_Name{ "Unnamed" };
 		std::string_view m_Description{ "???" };
 		std::span<std::string const> m_Flags{};
@@ -91,10 +195,11 @@ export namespace Database::PBS
 		constexpr ~CPokemonAbility() noexcept = default;
 	};
 
-	inline std::map<std::string_view, CPokemonAbility, sv_less_t> Abilities;
+	inline CRecordTable<CPokemonAbility> Abilities;
 
 	struct CPokemonItem final
 	{
+		std::string_view m_Id{};
 		std::string_view m_Name{ "Unnamed" };
 		std::string_view m_NamePlural{ "Unnamed" };
 		std::string_view m_PortionName{};
@@ -113,7 +218,7 @@ export namespace Database::PBS
 		bool m_Consumable{ /*false if a Key Item, TM or HM, and true otherwise*/ GetDefault() };
 		bool m_ShowQuantity{ /*false if a Key Item, TM or HM, and true otherwise*/ GetDefault() };
 
-		CPokemonMove const* m_Move{ nullptr };
+		MoveHandle m_Move{};
 
 		std::string_view m_Description{ "???" };
 
@@ -136,20 +241,92 @@ export namespace Database::PBS
 		constexpr ~CPokemonItem() noexcept = default;
 	};
 
-	inline std::map<std::string_view, CPokemonItem, sv_less_t> Items;
+	inline CRecordTable<CPokemonItem> Items;
+
+	enum struct EEvolutionParam : std::uint8_t { None, Integer, Item, Move, Type, Species, String, };
+
+	// EEvolutionMethod::Unknown if not recognized.
+	[[nodiscard]] extern "C++" auto ParseEvolutionMethod(std::string_view szMethod) noexcept -> EEvolutionMethod;
+
+	[[nodiscard]] constexpr auto EvolutionParamOf(EEvolutionMethod Method) noexcept -> EEvolutionParam
+	{
+		using enum EEvolutionMethod;
+
+		switch (Method)
+		{
+		case Level: case LevelMale: case LevelFemale: case LevelDay: case LevelNight: case LevelMorning: case LevelAfternoon: case LevelEvening:
+		case LevelNoWeather: case LevelSun: case LevelRain: case LevelSnow: case LevelSandstorm: case LevelCycling: case LevelSurfing: case LevelDiving:
+		case LevelDarkness: case LevelDarkInParty: case AttackGreater: case AtkDefEqual: case DefenseGreater:
+		case Silcoon: case Cascoon: case Ninjask: case Shedinja:
+		case Beauty: case Location: case Region: case BattleDealCriticalHit: case Event: case EventAfterDamageTaken:
+			return EEvolutionParam::Integer;
+
+		case HappinessHoldItem: case HoldItem: case HoldItemMale: case HoldItemFemale: case DayHoldItem: case NightHoldItem: case HoldItemHappiness:
+		case Item: case ItemMale: case ItemFemale: case ItemDay: case ItemNight: case ItemHappiness: case TradeItem:
+			return EEvolutionParam::Item;
+
+		case HappinessMove: case HasMove:
+			return EEvolutionParam::Move;
+
+		case HappinessMoveType: case HasMoveType:
+			return EEvolutionParam::Type;
+
+		case HasInParty: case TradeSpecies:
+			return EEvolutionParam::Species;
+
+		case LocationFlag:
+			return EEvolutionParam::String;
+
+		default:
+			return EEvolutionParam::None;
+		}
+	}
+
+	[[nodiscard]] constexpr bool IsTradeEvolution(EEvolutionMethod Method) noexcept
+	{
+		using enum EEvolutionMethod;
+		return Method >= Trade && Method <= TradeSpecies;
+	}
 
 	struct CPokemonEvolution final
 	{
 		std::string_view m_Species{};
 		std::string_view m_Method{};
 		std::string_view m_Parameter{};
+
+		SpeciesHandle m_Target{};	// Base form of m_Species.
+
+		EEvolutionMethod m_MethodType{ EEvolutionMethod::Unknown };
+		EEvolutionParam m_ParamType{ EEvolutionParam::None };
+		std::int32_t m_ParamValue{};	// The number itself, or the handle index, depending on m_ParamType.
+
+		[[nodiscard]] inline auto Integer() const noexcept -> std::optional<std::int32_t> { if (m_ParamType == EEvolutionParam::Integer) return m_ParamValue; return std::nullopt; }
+		[[nodiscard]] inline auto Item() const noexcept -> ItemHandle { return HandleIf<ItemHandle>(EEvolutionParam::Item); }
+		[[nodiscard]] inline auto Move() const noexcept -> MoveHandle { return HandleIf<MoveHandle>(EEvolutionParam::Move); }
+		[[nodiscard]] inline auto Type() const noexcept -> TypeHandle { return HandleIf<TypeHandle>(EEvolutionParam::Type); }
+		[[nodiscard]] inline auto Species() const noexcept -> SpeciesHandle { return HandleIf<SpeciesHandle>(EEvolutionParam::Species); }
+
+	private:
+		template <typename H>
+		[[nodiscard]] inline auto HandleIf(EEvolutionParam Expected) const noexcept -> H
+		{
+			if (m_ParamType == Expected)
+				return H{ static_cast<std::uint16_t>(m_ParamValue) };
+
+			return {};
+		}
 	};
 
 	struct CPokemonSpecies final
 	{
+		std::string_view m_Id{};
+		int m_FormId{};
+		SpeciesHandle m_BaseForm{};	// Forms of the same species are stored next to each other, starting from the base form.
+		std::uint16_t m_FormCount{ 1 };
+
 		std::string_view m_Name{ "Unnamed" };
 		std::string_view m_FormName{ "" };
-		std::vector<CPokemonType const*> m_Types{ std::addressof(Types.find("NORMAL")->second) };
+		std::vector<TypeHandle> m_Types{ Types.Find("NORMAL") };
 
 		std::span<std::uint8_t const, 6> m_BaseStats;	// 1, 1, 1, 1, 1, 1 
 		std::uint16_t m_BaseExp{ 100 };
@@ -165,17 +342,17 @@ export namespace Database::PBS
 
 		std::span<std::pair<std::string, std::int_fast16_t> const> m_EVs{};
 
-		std::vector<CPokemonAbility const*> m_Abilities{};
-		std::vector<CPokemonAbility const*> m_HiddenAbilities{};
+		std::vector<AbilityHandle> m_Abilities{};
+		std::vector<AbilityHandle> m_HiddenAbilities{};
 
-		std::vector<std::pair<std::int_fast16_t, CPokemonMove const*>> m_Moves{};
-		std::vector<CPokemonMove const*> m_TutorMoves{};
-		std::vector<CPokemonMove const*> m_EggMoves{};
+		std::vector<std::pair<std::int_fast16_t, MoveHandle>> m_Moves{};
+		std::vector<MoveHandle> m_TutorMoves{};
+		std::vector<MoveHandle> m_EggMoves{};
 
 		std::span<std::string const> m_EggGroups{};	// "Undiscovered"
-		CPokemonItem const* m_Incense{};
+		ItemHandle m_Incense{};
 
-		std::span<std::string const> m_Offspring{};	// Keep the string, just check them in dict when needed
+		std::vector<SpeciesHandle> m_Offspring{};	// Base forms.
 
 		float m_Height{ .1f }, m_Weight{ .1f };
 		std::string_view m_Color{ "Red" };
@@ -186,9 +363,9 @@ export namespace Database::PBS
 
 		std::span<std::string const> m_Flags{};
 
-		CPokemonItem const* m_WildItemCommon{};
-		CPokemonItem const* m_WildItemUncommon{};
-		CPokemonItem const* m_WildItemRare{};
+		ItemHandle m_WildItemCommon{};
+		ItemHandle m_WildItemUncommon{};
+		ItemHandle m_WildItemRare{};
 
 		std::vector<CPokemonEvolution> m_Evolutions{};
 
@@ -201,17 +378,47 @@ export namespace Database::PBS
 		CPokemonSpecies(::PokemonSpecies const& Raw) noexcept;
 
 		CPokemonSpecies(CPokemonSpecies const&) noexcept = delete;
-		CPokemonSpecies(CPokemonSpecies&&) noexcept = delete;
+		CPokemonSpecies(CPokemonSpecies&&) noexcept = default;
 		CPokemonSpecies& operator=(CPokemonSpecies const&) = delete;
-		CPokemonSpecies& operator=(CPokemonSpecies&&) noexcept = delete;
+		CPokemonSpecies& operator=(CPokemonSpecies&&) noexcept = default;
 		~CPokemonSpecies() noexcept = default;
 	};
 
-	inline std::map<
-		std::string_view,
-		std::map<int, CPokemonSpecies, std::less<>>,
-		sv_less_t
-	> Species;
+	// Every form of every species, one record each. The name index only points to the base forms.
+	inline CRecordTable<CPokemonSpecies> Species;
+
+	// All forms of the species that hSpecies belongs to, base form first.
+	[[nodiscard]] inline auto FormsOf(SpeciesHandle hSpecies) noexcept -> std::span<CPokemonSpecies const>
+	{
+		if (auto const pSpecies = Species.At(hSpecies); pSpecies != nullptr)
+			return { Species.At(pSpecies->m_BaseForm), pSpecies->m_FormCount };
+
+		return {};
+	}
+
+	[[nodiscard]] inline auto FindForm(std::string_view szSpecies, int iForm) noexcept -> SpeciesHandle
+	{
+		for (auto&& Form : FormsOf(Species.Find(szSpecies)))
+		{
+			if (Form.m_FormId == iForm)
+				return Species.HandleOf(Form);
+		}
+
+		return {};
+	}
+
+	struct CStageTime final
+	{
+		std::string_view m_Stage{};
+		std::chrono::duration<double, std::milli> m_Time{};
+	};
+
+	// Of the last Build(), in order of execution.
+	inline std::vector<CStageTime> BuildTimings;
+
+	// Bumped by every Build(). Caches of anything derived from the tables compare it rather than addresses, a rebuild
+	// may well land in the same allocation.
+	inline std::uint64_t BuildGeneration{};
 
 	extern "C++" void Build() noexcept;
 }
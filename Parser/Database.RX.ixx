@@ -14,6 +14,10 @@ export module Database.RX;
 import std.compat;
 #endif
 
+import UtlLog;
+import UtlMemory;
+import UtlTrace;
+
 import Ruby.Deserializer;
 
 // #UPDATE_AT_CPP26 reflection
@@ -117,10 +121,13 @@ namespace Database::RX
 	};
 }
 
-static [[nodiscard]] inline auto ReadTileset(std::filesystem::path const& GameRootPath) noexcept
+[[nodiscard]] static inline auto ReadTileset(std::filesystem::path const& GameRootPath) noexcept
 {
+	auto const Path = GameRootPath / L"Data/Tilesets.rxdata";
+	CTraceZone Zone{ "Reader", ELogCategory::Database, Path };
+
 	std::ifstream file;
-	file.open(GameRootPath / L"Data/Tilesets.rxdata", std::ios::binary);
+	file.open(Path, std::ios::binary);
 
 	// Verify Version
 	char version[2]{};
@@ -146,10 +153,13 @@ static [[nodiscard]] inline auto ReadTileset(std::filesystem::path const& GameRo
 	return res;
 }
 
-static [[nodiscard]] inline auto ReadMapInfo(std::filesystem::path const& GameRootPath) noexcept
+[[nodiscard]] static inline auto ReadMapInfo(std::filesystem::path const& GameRootPath) noexcept
 {
+	auto const Path = GameRootPath / L"Data/MapInfos.rxdata";
+	CTraceZone Zone{ "Reader", ELogCategory::Database, Path };
+
 	std::ifstream file;
-	file.open(GameRootPath / L"Data/MapInfos.rxdata", std::ios::binary);
+	file.open(Path, std::ios::binary);
 
 	// Verify Version
 	char version[2]{};
@@ -195,7 +205,7 @@ namespace Database::RX
 	export inline decltype(ReadMapInfo({})) MapMetaInfos;
 }
 
-static [[nodiscard]] inline auto ReadMapData(std::filesystem::path const& GameRootPath) noexcept
+[[nodiscard]] static inline auto ReadMapData(std::filesystem::path const& GameRootPath) noexcept
 {
 	std::vector<Database::RX::MapDatum> ret{};
 	ret.reserve(Database::RX::MapMetaInfos.size() + 1);	// Keep address stable.
@@ -209,10 +219,11 @@ static [[nodiscard]] inline auto ReadMapData(std::filesystem::path const& GameRo
 
 		if (!std::filesystem::exists(Path))
 		{
-			std::println("Map file 'Map{:0>3}.rxdata' does not exist, skipping...", index);
+			UTIL_LogWarning(ELogCategory::Database, "Map file 'Map{:0>3}.rxdata' does not exist, skipping...", index);
 			continue;
 		}
 
+		CTraceZone Zone{ "Reader", ELogCategory::Database, Path };
 		std::ifstream file{ Path.c_str(), std::ios::binary };
 
 		// Verify Version
@@ -237,7 +248,7 @@ static [[nodiscard]] inline auto ReadMapData(std::filesystem::path const& GameRo
 		}
 		else
 		{
-			std::println("Map file 'Map{:0>3}.rxdata' does not contain a valid MapData object, skipping...", index);
+			UTIL_LogWarning(ELogCategory::Database, "Map file 'Map{:0>3}.rxdata' does not contain a valid MapData object, skipping...", index);
 		}
 	}
 
@@ -253,6 +264,9 @@ namespace Database::RX
 {
 	export void Load(std::filesystem::path const& GameRootPath) noexcept
 	{
+		CTraceZone Zone{ "RX::Load", ELogCategory::Database };
+		CMemoryScope MemoryScope{ EMemoryTag::RxDatabase };
+
 		Tilesets = ReadTileset(GameRootPath);
 		MapMetaInfos = ReadMapInfo(GameRootPath);
 		MapData = ReadMapData(GameRootPath);
@@ -12,6 +12,9 @@ import std;
 #endif
 
 import UtlFile;
+import UtlLog;
+import UtlMemory;
+import UtlTrace;
 import UtlString;
 
 
@@ -425,6 +428,75 @@ export enum struct EGrowthRate : std::uint8_t
 	Fluctuating,
 };
 
+// Same names as GameData::Evolution in Essentials.
+export enum struct EEvolutionMethod : std::uint8_t
+{
+	Unknown,
+	Level,
+	LevelMale,
+	LevelFemale,
+	LevelDay,
+	LevelNight,
+	LevelMorning,
+	LevelAfternoon,
+	LevelEvening,
+	LevelNoWeather,
+	LevelSun,
+	LevelRain,
+	LevelSnow,
+	LevelSandstorm,
+	LevelCycling,
+	LevelSurfing,
+	LevelDiving,
+	LevelDarkness,
+	LevelDarkInParty,
+	AttackGreater,
+	AtkDefEqual,
+	DefenseGreater,
+	Silcoon,
+	Cascoon,
+	Ninjask,
+	Shedinja,
+	Happiness,
+	HappinessMale,
+	HappinessFemale,
+	HappinessDay,
+	HappinessNight,
+	HappinessMove,
+	HappinessMoveType,
+	HappinessHoldItem,
+	MaxHappiness,
+	Beauty,
+	HoldItem,
+	HoldItemMale,
+	HoldItemFemale,
+	DayHoldItem,
+	NightHoldItem,
+	HoldItemHappiness,
+	HasMove,
+	HasMoveType,
+	HasInParty,
+	Location,
+	LocationFlag,
+	Region,
+	Item,
+	ItemMale,
+	ItemFemale,
+	ItemDay,
+	ItemNight,
+	ItemHappiness,
+	Trade,
+	TradeMale,
+	TradeFemale,
+	TradeDay,
+	TradeNight,
+	TradeItem,
+	TradeSpecies,
+	BattleDealCriticalHit,
+	Event,
+	EventAfterDamageTaken,
+};
+
 export struct PokemonSpecies
 {
 	std::string m_Name{ "Unnamed" };
@@ -732,12 +804,17 @@ export struct PokemonBerryPlants
 
 namespace PBS
 {
+	// Sections of pokemon_forms.txt whose base species is not in pokemon.txt, e.g. "PIKACHU,1". They are left out of Forms.
+	export inline std::vector<std::string> OrphanForms;
+
 	namespace detail
 	{
 		template <typename T, size_t N>
 		void Load(std::filesystem::path const& PbsFolder, wchar_t const (&fileName)[N], decltype(IniFile::Factory<T>({}))* output) noexcept
 		{
 			auto const File = PbsFolder / fileName;
+			CTraceZone Zone{ "PBS file", ELogCategory::Database, File };
+
 			auto [buf, iBufLen] = UTIL_LoadFile(File);
 			auto bufView = std::string_view{ buf.get(), iBufLen };
 
@@ -750,6 +827,8 @@ namespace PBS
 		auto LoadForms(std::filesystem::path const& PbsFolder) noexcept
 		{
 			auto const File = PbsFolder / L"pokemon_forms.txt";
+			CTraceZone Zone{ "PBS file", ELogCategory::Database, File };
+
 			auto [buf, iBufLen] = UTIL_LoadFile(File);
 			auto bufView = std::string_view{ buf.get(), iBufLen };
 
@@ -771,6 +850,8 @@ namespace PBS
 				ret[id].try_emplace(0, base);
 			}
 
+			OrphanForms.clear();
+
 			for (auto&& IniEntry : Config.m_Entries)
 			{
 				std::string_view const sz{ IniEntry.m_Id };
@@ -781,7 +862,7 @@ namespace PBS
 
 					if (formId == 0) [[unlikely]]
 					{
-						std::println("[pokemon_forms.txt] Form ID 0 is reserved for base forms. Entry '{}' ignored.", sz);
+						UTIL_LogWarning(ELogCategory::Database, "[pokemon_forms.txt] Form ID 0 is reserved for base forms. Entry '{}' ignored.", sz);
 						continue;
 					}
 
@@ -795,14 +876,20 @@ namespace PBS
 
 						if (!bNew)
 						{
-							std::println("[pokemon_forms.txt] Duplicate form ID detected: Entry '{}' ignored.", sz);
+							UTIL_LogWarning(ELogCategory::Database, "[pokemon_forms.txt] Duplicate form ID detected: Entry '{}' ignored.", sz);
 							continue;
 						}
 					}
+					else
+					{
+						UTIL_LogWarning(ELogCategory::Database, "[pokemon_forms.txt] Base species not found in pokemon.txt: Entry '{}' ignored.", sz);
+						OrphanForms.emplace_back(sz);
+						continue;
+					}
 				}
 				else
 				{
-					std::println("[pokemon_forms.txt] Bad form ID format: Expected '[BASE,ID]' but '{}' received.", sz);
+					UTIL_LogWarning(ELogCategory::Database, "[pokemon_forms.txt] Bad form ID format: Expected '[BASE,ID]' but '{}' received.", sz);
 					continue;
 				}
 			}
@@ -815,6 +902,8 @@ namespace PBS
 
 	export void Load(std::filesystem::path const& GameRootFolder) noexcept
 	{
+		CTraceZone Zone{ "PBS::Load", ELogCategory::Database };
+		CMemoryScope MemoryScope{ EMemoryTag::RawPbs };
 		auto const PbsFolder = GameRootFolder / L"PBS/";
 
 		detail::Load<PokemonType>(PbsFolder, L"types.txt", &::PBS::Types);
@@ -0,0 +1,830 @@
+#ifdef __INTELLISENSE__
+#include <__msvc_all_public_headers.hpp>
+#undef min
+#undef max
+#else
+import std.compat;
+#endif
+
+import Database.PBS;
+import Database.PBS.Breeding;
+import Database.PBS.Columnar;
+import Database.PBS.Damage;
+import Database.PBS.Query;
+import Database.PBS.Search;
+import Database.PBS.Validation;
+import Database.Raw.PBS;
+import Image.Autotile;
+import Image.Decode;
+
+// Checks on synthetic data, no game involved. Each case builds whatever tables it needs and overwrites them freely,
+// selftest runs in its own process.
+
+// stb_image is not linked here, nothing in the selftest is decoded by it.
+void FreeDecodedPixels(std::uint8_t* p) noexcept
+{
+	std::free(p);
+}
+
+namespace Selftest
+{
+	using Result_t = std::expected<void, std::string>;
+
+	struct CCase final
+	{
+		std::string_view m_Name{};
+		Result_t(*m_pfn)() noexcept {};
+	};
+
+	[[nodiscard]] static auto SelectionOf(std::size_t iSize, std::initializer_list<std::size_t> rgiRows) noexcept -> Database::PBS::CSelection
+	{
+		auto ret = Database::PBS::CSelection::None(iSize);
+
+		for (auto&& i : rgiRows)
+			ret.Set(i);
+
+		return ret;
+	}
+
+	[[nodiscard]] static auto DescribeChain(std::optional<std::vector<Database::PBS::SpeciesHandle>> const& Chain) noexcept -> std::string
+	{
+		if (!Chain)
+			return "no chain";
+
+		std::string ret{ "[" };
+
+		for (auto&& hFather : *Chain)
+			std::format_to(std::back_inserter(ret), "{}{}", ret.size() > 1 ? ", " : "", hFather.m_Index);
+
+		return ret + "]";
+	}
+
+#pragma region Egg move chains
+
+	// Egg group bits of the synthetic breeding tables below.
+	static constexpr std::uint32_t EGG_FIELD = 1u << 0;
+	static constexpr std::uint32_t EGG_WATER = 1u << 1;
+	static constexpr std::uint32_t EGG_UNDISCOVERED = 1u << 2;
+	static constexpr std::uint32_t EGG_DITTO = 1u << 3;
+
+	// 0: target, Field. 1: Field and Water, female only. 2: Field, genderless. 3: Water, learns the move by itself.
+	// 4: Field and Water, the only way from 3 to 0. 5: Field, male only.
+	static void MakeEggChainTable(EGenderRatio Species4) noexcept
+	{
+		static constexpr std::array rgiEggGroups{
+			EGG_FIELD, EGG_FIELD | EGG_WATER, EGG_FIELD, EGG_WATER, EGG_FIELD | EGG_WATER, EGG_FIELD,
+		};
+
+		std::array const rgGenderRatios{
+			EGenderRatio::Female50Percent, EGenderRatio::AlwaysFemale, EGenderRatio::Genderless,
+			EGenderRatio::Female50Percent, Species4, EGenderRatio::AlwaysMale,
+		};
+
+		Database::PBS::Breeding = Database::PBS::MakeBreedingTable(rgGenderRatios, rgiEggGroups, EGG_UNDISCOVERED, EGG_DITTO);
+	}
+
+	[[nodiscard]] static auto ExpectChain(std::uint16_t iTarget, Database::PBS::CSelection const& Direct, Database::PBS::CSelection const& Egg,
+		std::optional<std::vector<std::uint16_t>> const& Expected) noexcept -> Result_t
+	{
+		auto const Chain = Database::PBS::FindEggMoveChain(Database::PBS::SpeciesHandle{ iTarget }, Direct, Egg);
+
+		auto const bMatch = Chain.has_value() == Expected.has_value()
+			&& (!Chain || std::ranges::equal(*Chain, *Expected, {}, &Database::PBS::SpeciesHandle::m_Index));
+
+		if (!bMatch)
+		{
+			std::optional<std::vector<Database::PBS::SpeciesHandle>> ExpectedChain{};
+
+			if (Expected)
+				ExpectedChain.emplace(std::from_range, *Expected | std::views::transform([](std::uint16_t i) static noexcept { return Database::PBS::SpeciesHandle{ i }; }));
+
+			return std::unexpected(std::format("got {}, expected {}", DescribeChain(Chain), DescribeChain(ExpectedChain)));
+		}
+
+		return {};
+	}
+
+	static auto EggChainDirect() noexcept -> Result_t
+	{
+		MakeEggChainTable(EGenderRatio::Female50Percent);
+		return ExpectChain(0, SelectionOf(6, { 0 }), SelectionOf(6, {}), std::vector<std::uint16_t>{});
+	}
+
+	static auto EggChainTwoFathers() noexcept -> Result_t
+	{
+		MakeEggChainTable(EGenderRatio::Female50Percent);
+		return ExpectChain(0, SelectionOf(6, { 3 }), SelectionOf(6, { 0, 4 }), std::vector<std::uint16_t>{ 3, 4 });
+	}
+
+	// 1 could receive the move from 3, but cannot pass it on.
+	static auto EggChainFemaleOnlyLink() noexcept -> Result_t
+	{
+		MakeEggChainTable(EGenderRatio::Female50Percent);
+		return ExpectChain(0, SelectionOf(6, { 3 }), SelectionOf(6, { 0, 1 }), std::nullopt);
+	}
+
+	// 4 could pass the move to 0, but no female 4 exists to receive it from 3.
+	static auto EggChainMaleOnlyLink() noexcept -> Result_t
+	{
+		MakeEggChainTable(EGenderRatio::AlwaysMale);
+		return ExpectChain(0, SelectionOf(6, { 3 }), SelectionOf(6, { 0, 4 }), std::nullopt);
+	}
+
+	static auto EggChainGenderlessTarget() noexcept -> Result_t
+	{
+		MakeEggChainTable(EGenderRatio::Female50Percent);
+		return ExpectChain(2, SelectionOf(6, { 5 }), SelectionOf(6, { 2 }), std::nullopt);
+	}
+
+#pragma endregion Egg move chains
+
+#pragma region Species queries
+
+	// Six species, only HP, Speed and the generation set. BST is their sum.
+	static void MakeQueryColumns() noexcept
+	{
+		static constexpr std::array<std::uint8_t, 6> rgiHP{ 50, 120, 200, 80, 150, 10 };
+		static constexpr std::array<std::uint8_t, 6> rgiSpeed{ 90, 30, 40, 80, 150, 5 };
+		static constexpr std::array<std::uint8_t, 6> rgiGeneration{ 1, 1, 2, 2, 3, 3 };
+
+		Database::PBS::CSpeciesColumns Cols{ .m_Count = rgiHP.size() };
+
+		for (auto&& Column : Cols.m_BaseStats)
+			Column.assign(Cols.m_Count, 0);
+
+		Cols.m_BaseStats[Database::PBS::Stat_HP].assign_range(rgiHP);
+		Cols.m_BaseStats[Database::PBS::Stat_Speed].assign_range(rgiSpeed);
+		Cols.m_BST.assign_range(std::views::zip_transform([](std::uint8_t a, std::uint8_t b) static noexcept { return (std::uint16_t)(a + b); }, rgiHP, rgiSpeed));
+		Cols.m_CatchRate.assign(Cols.m_Count, 45);
+		Cols.m_BaseExp.assign(Cols.m_Count, 64);
+		Cols.m_Generation.assign_range(rgiGeneration);
+		Cols.m_Type1.assign(Cols.m_Count, Database::PBS::NO_TYPE);
+		Cols.m_Type2.assign(Cols.m_Count, Database::PBS::NO_TYPE);
+		Cols.m_EggGroups.assign(Cols.m_Count, 0);
+
+		Database::PBS::SpeciesColumns = std::move(Cols);
+	}
+
+	// Rows in the order the query returns them.
+	[[nodiscard]] static auto ExpectQueryRows(std::string_view szQuery, std::vector<std::uint16_t> const& rgiExpected) noexcept -> Result_t
+	{
+		MakeQueryColumns();
+
+		auto const Query = Database::PBS::CompileQuery(szQuery);
+
+		if (!Query)
+			return std::unexpected(std::format("'{}' failed to compile: {}", szQuery, Query.error()));
+
+		if (auto const rgiRows = Database::PBS::ExecuteQuery(*Query); rgiRows != rgiExpected)
+			return std::unexpected(std::format("'{}' returned {}, expected {}, plan {}", szQuery, rgiRows, rgiExpected, Query->Explain()));
+
+		return {};
+	}
+
+	[[nodiscard]] static auto ExpectQueryPlan(std::string_view szQuery, std::string_view szPlan) noexcept -> Result_t
+	{
+		MakeQueryColumns();
+
+		auto const Query = Database::PBS::CompileQuery(szQuery);
+
+		if (!Query)
+			return std::unexpected(std::format("'{}' failed to compile: {}", szQuery, Query.error()));
+
+		if (auto const szGot = Query->Explain(); szGot != szPlan)
+			return std::unexpected(std::format("'{}' planned as {}, expected {}", szQuery, szGot, szPlan));
+
+		return {};
+	}
+
+	[[nodiscard]] static auto ExpectQueryError(std::string_view szQuery, std::string_view szError) noexcept -> Result_t
+	{
+		MakeQueryColumns();
+
+		auto const Query = Database::PBS::CompileQuery(szQuery);
+
+		if (Query)
+			return std::unexpected(std::format("'{}' compiled to {}", szQuery, Query->Explain()));
+
+		if (Query.error() != szError)
+			return std::unexpected(std::format("'{}' failed with \"{}\", expected \"{}\"", szQuery, Query.error(), szError));
+
+		return {};
+	}
+
+	static auto QueryConjunction() noexcept -> Result_t
+	{
+		return ExpectQueryRows("species where hp > 100 and speed < 50", { 1, 2 });
+	}
+
+	// Read as hp < 60 or (hp > 100 and speed > 100). The other grouping would only give 4.
+	static auto QueryPrecedence() noexcept -> Result_t
+	{
+		return ExpectQueryRows("species where hp < 60 or hp > 100 and speed > 100", { 0, 4, 5 });
+	}
+
+	static auto QueryNotOrderLimit() noexcept -> Result_t
+	{
+		return ExpectQueryRows("species where not (gen = 1) order by hp desc limit 3", { 2, 4, 3 });
+	}
+
+	static auto QueryColumnCompare() noexcept -> Result_t
+	{
+		return ExpectQueryRows("SPECIES WHERE Speed >= HP", { 0, 3, 4 });
+	}
+
+	// A byte column never exceeds 255, a word column never exceeds 65535.
+	static auto QueryFoldConstants() noexcept -> Result_t
+	{
+		if (auto const Result = ExpectQueryPlan("species where hp > 300", "None"); !Result)
+			return Result;
+		if (auto const Result = ExpectQueryRows("species where hp > 300", {}); !Result)
+			return Result;
+		if (auto const Result = ExpectQueryPlan("species where bst <= 70000", "All"); !Result)
+			return Result;
+
+		return ExpectQueryRows("species where bst <= 70000", { 0, 1, 2, 3, 4, 5 });
+	}
+
+	// The scalar scan is cheaper than the column against column one, it goes first.
+	static auto QueryReorder() noexcept -> Result_t
+	{
+		return ExpectQueryPlan("species where hp > speed and hp > 1", "And(ColumnScan[hp > 1], ColumnScan[hp > speed])");
+	}
+
+	static auto QueryMalformed() noexcept -> Result_t
+	{
+		if (auto const Result = ExpectQueryError("species where hp >", "Expected a number or a field at 18, got 'end of query'"); !Result)
+			return Result;
+		if (auto const Result = ExpectQueryError("species where hp ! 3", "Unexpected '!' at 17"); !Result)
+			return Result;
+		if (auto const Result = ExpectQueryError("species where foo > 3", "Unknown field 'foo' at 14"); !Result)
+			return Result;
+
+		return ExpectQueryError("species where (hp > 1", "Expected ')' at 21, got 'end of query'");
+	}
+
+#pragma endregion Species queries
+
+#pragma region Columnar filters
+
+	// Biased towards the values around the sign bit, where the SSE2 path flips to unsigned order.
+	template <typename T>
+	[[nodiscard]] static auto MakeFilterColumn(std::size_t iCount, std::uint32_t iSeed) noexcept -> std::vector<T>
+	{
+		static constexpr auto MAX = std::numeric_limits<T>::max();
+		static constexpr std::array<T, 6> rgEdges{ 0, 1, MAX / 2, MAX / 2 + 1, MAX - 1, MAX };
+
+		std::vector<T> ret(iCount);
+
+		for (auto&& Value : ret)
+		{
+			iSeed = iSeed * 1664525u + 1013904223u;
+			Value = (iSeed >> 28) < rgEdges.size() ? rgEdges[iSeed >> 28] : static_cast<T>(iSeed >> 8);
+		}
+
+		return ret;
+	}
+
+	template <typename T>
+	[[nodiscard]] static constexpr auto CompareReference(T lhs, Database::PBS::ECompare Op, T rhs) noexcept -> bool
+	{
+		using enum Database::PBS::ECompare;
+
+		switch (Op)
+		{
+		case Equal:			return lhs == rhs;
+		case NotEqual:		return lhs != rhs;
+		case Less:			return lhs < rhs;
+		case LessEqual:		return lhs <= rhs;
+		case Greater:		return lhs > rhs;
+		case GreaterEqual:	return lhs >= rhs;
+		}
+
+		std::unreachable();
+	}
+
+	// Row by row against a plain loop, past the tail of the last word too.
+	template <typename T>
+	[[nodiscard]] static auto ExpectFilterRows(std::span<T const> lhs, Database::PBS::ECompare Op, std::span<T const> rhs, bool bRhsIsScalar) noexcept -> Result_t
+	{
+		auto const Selection = bRhsIsScalar ? Database::PBS::Filter(lhs, Op, rhs[0]) : Database::PBS::Filter(lhs, Op, rhs);
+		auto const szWhat = std::format("{}-bit {} rows, op {}, {} rhs", sizeof(T) * 8, lhs.size(), std::to_underlying(Op), bRhsIsScalar ? "scalar" : "column");
+
+		if (Selection.m_Size != lhs.size() || Selection.m_Bits.size() != (lhs.size() + 63) / 64)
+			return std::unexpected(std::format("{}: selection of {} rows in {} words", szWhat, Selection.m_Size, Selection.m_Bits.size()));
+
+		std::size_t iExpected{};
+
+		for (std::size_t i = 0; i < lhs.size(); ++i)
+		{
+			auto const bExpected = CompareReference(lhs[i], Op, bRhsIsScalar ? rhs[0] : rhs[i]);
+			iExpected += bExpected;
+
+			if (Selection.Test(i) != bExpected)
+				return std::unexpected(std::format("{}: row {} ({} vs {}) is {}, expected {}", szWhat, i, lhs[i], bRhsIsScalar ? rhs[0] : rhs[i], !bExpected, bExpected));
+		}
+
+		if (auto const iCount = Selection.Count(); iCount != iExpected)
+			return std::unexpected(std::format("{}: {} bits set, {} rows match", szWhat, iCount, iExpected));
+
+		return {};
+	}
+
+	// Lengths around the 16-lane and 64-row blocks, so the scalar tail runs with and without full blocks before it.
+	template <typename T>
+	[[nodiscard]] static auto FilterMatchesReference() noexcept -> Result_t
+	{
+		using enum Database::PBS::ECompare;
+
+		static constexpr std::array<std::size_t, 11> rgiLengths{ 0, 1, 15, 16, 63, 64, 65, 127, 128, 130, 200 };
+		static constexpr std::array rgOps{ Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+		for (auto&& iLength : rgiLengths)
+		{
+			auto const lhs = MakeFilterColumn<T>(iLength, 1);
+			auto const rhs = MakeFilterColumn<T>(std::max<std::size_t>(iLength, 1), 2);
+
+			for (auto&& Op : rgOps)
+			{
+				if (auto const Result = ExpectFilterRows<T>(lhs, Op, rhs, false); !Result)
+					return Result;
+
+				for (auto&& Value : MakeFilterColumn<T>(8, 3))
+				{
+					if (auto const Result = ExpectFilterRows<T>(lhs, Op, std::span{ &Value, 1 }, true); !Result)
+						return Result;
+				}
+			}
+		}
+
+		return {};
+	}
+
+	static auto FilterU8() noexcept -> Result_t
+	{
+		return FilterMatchesReference<std::uint8_t>();
+	}
+
+	static auto FilterU16() noexcept -> Result_t
+	{
+		return FilterMatchesReference<std::uint16_t>();
+	}
+
+	// The type columns hold NO_TYPE for missing types, an invalid handle must not match them.
+	static auto FilterTypeInvalidHandle() noexcept -> Result_t
+	{
+		MakeQueryColumns();
+		Database::PBS::SpeciesColumns.m_Type1[2] = 0;
+		Database::PBS::SpeciesColumns.m_Type2[4] = 0;
+
+		for (auto&& iIndex : { Database::PBS::TypeHandle::INVALID, (std::uint16_t)Database::PBS::NO_TYPE, (std::uint16_t)0x1FF })
+		{
+			if (auto const iCount = Database::PBS::FilterType({ .m_Index = iIndex }).Count(); iCount != 0)
+				return std::unexpected(std::format("type handle {:#x} matched {} rows", iIndex, iCount));
+		}
+
+		if (auto const rgiRows = Database::PBS::FilterType({ .m_Index = 0 }).Indices(); rgiRows != std::vector<std::uint16_t>{ 2, 4 })
+			return std::unexpected(std::format("type 0 matched {}, expected [2, 4]", rgiRows));
+
+		return {};
+	}
+
+#pragma endregion Columnar filters
+
+#pragma region Damage matrix
+
+	// Types 0: Normal, 1: Water, 2: Ghost. Species 0: Water, the attacker, 100 in every base stat. 1: Normal, 100.
+	// 2: Ghost, 50. 3: Water and Ghost, 150. Moves 0: Normal physical 40, 1: Water special 90, 2: Ghost special 80,
+	// 3: status, 4: power 1, 5: Normal physical 75, a whole quotient against species 1.
+	static void MakeDamageTables() noexcept
+	{
+		static constexpr std::array<std::array<std::uint8_t, 3>, 3> rgrgiChart{ { { 4, 4, 0 }, { 4, 2, 4 }, { 0, 4, 8 } } };	// [Atk][Def]
+		static constexpr std::array<std::array<std::uint8_t, 2>, 4> rgrgiTypes{ { { 1, 1 }, { 0, 0 }, { 2, 2 }, { 1, 2 } } };
+		static constexpr std::array<std::uint8_t, 4> rgiBaseStats{ 100, 100, 50, 150 };
+		static constexpr std::array<std::tuple<std::uint16_t, EMoveCategory, std::uint16_t>, 6> rgMoves{ {
+			{ 0, EMoveCategory::Physical, 40 }, { 1, EMoveCategory::Special, 90 }, { 2, EMoveCategory::Special, 80 },
+			{ 0, EMoveCategory::Status, 0 }, { 0, EMoveCategory::Physical, 1 }, { 0, EMoveCategory::Physical, 75 },
+		} };
+
+		// The records keep views into their raw entries.
+		static ::PokemonMove const RawMove{};
+		static std::array<::PokemonSpecies, 4> rgRawSpecies{};
+
+		Database::PBS::TypeChart = { .m_Count = rgrgiChart.size() };
+		Database::PBS::TypeChart.m_Matrix.assign_range(rgrgiChart | std::views::join);
+
+		// Same rule as BuildTypeChart.
+		for (std::size_t iDef1 = 0; iDef1 < rgrgiChart.size(); ++iDef1)
+		{
+			for (std::size_t iDef2 = 0; iDef2 < rgrgiChart.size(); ++iDef2)
+			{
+				for (std::size_t iAtk = 0; iAtk < rgrgiChart.size(); ++iAtk)
+				{
+					auto const a = rgrgiChart[iAtk][iDef1], b = rgrgiChart[iAtk][iDef2];
+					Database::PBS::TypeChart.m_DualProfile.push_back(iDef1 == iDef2 ? a : static_cast<std::uint8_t>(a * b / Database::PBS::EFFECTIVENESS_NORMAL));
+				}
+			}
+		}
+
+		Database::PBS::Moves = {};
+
+		for (auto&& [iType, Category, iPower] : rgMoves)
+		{
+			auto& Move = Database::PBS::Moves.m_Records.emplace_back(RawMove);
+			Move.m_Type = { iType };
+			Move.m_Category = Category;
+			Move.m_Power = iPower;
+		}
+
+		Database::PBS::Species = {};
+		Database::PBS::CSpeciesColumns Cols{ .m_Count = rgRawSpecies.size() };
+
+		for (auto&& Column : Cols.m_BaseStats)
+			Column.assign_range(rgiBaseStats);
+
+		for (auto&& [Raw, iBaseStat] : std::views::zip(rgRawSpecies, rgiBaseStats))
+		{
+			Raw.m_BaseStats.fill(iBaseStat);
+			Database::PBS::Species.m_Records.emplace_back(Raw);
+		}
+
+		for (std::uint16_t i = 0; i < rgMoves.size(); ++i)
+			Database::PBS::Species.m_Records[0].m_TutorMoves.push_back({ i });
+
+		Cols.m_Type1.assign_range(rgrgiTypes | std::views::elements<0>);
+		Cols.m_Type2.assign_range(rgrgiTypes | std::views::elements<1>);
+
+		Database::PBS::SpeciesColumns = std::move(Cols);
+	}
+
+	// Species 0 against 1, 2 and 3. rgExpected is { min, max } per move, then per defender.
+	[[nodiscard]] static auto ExpectDamage(Database::PBS::CDamageAssumptions const& Assumptions, std::vector<std::pair<std::uint16_t, std::uint16_t>> const& rgExpected) noexcept -> Result_t
+	{
+		static constexpr std::array<std::uint16_t, 3> rgiDefenders{ 1, 2, 3 };
+		static constexpr std::array<std::uint16_t, 4> rgiMoves{ 0, 1, 2, 5 };	// Status and power 1 are skipped.
+
+		MakeDamageTables();
+
+		auto const Block = Database::PBS::ComputeDamageBlock(Database::PBS::SpeciesHandle{ 0 }, rgiDefenders, Assumptions);
+
+		if (!std::ranges::equal(Block.m_Moves, rgiMoves, {}, &Database::PBS::MoveHandle::m_Index))
+			return std::unexpected(std::format("moves {}, expected {}", Block.m_Moves | std::views::transform(&Database::PBS::MoveHandle::m_Index), rgiMoves));
+
+		std::vector const rgGot{ std::from_range, std::views::zip(Block.m_Min, Block.m_Max) | std::views::transform([](auto&& Roll) static noexcept { return std::pair{ std::get<0>(Roll), std::get<1>(Roll) }; }) };
+
+		if (rgGot != rgExpected)
+			return std::unexpected(std::format("rolls {}, expected {}", rgGot, rgExpected));
+
+		return {};
+	}
+
+	// Level 50, 31 IVs, no EVs, neutral natures, with STAB. Immune defenders take 0.
+	static auto DamageKnownValues() noexcept -> Result_t
+	{
+		return ExpectDamage({}, {
+			{ 16, 19 }, { 0, 0 }, { 0, 0 },
+			{ 51, 61 }, { 87, 103 }, { 18, 21 },
+			{ 0, 0 }, { 104, 124 }, { 44, 52 },
+			{ 29, 35 }, { 0, 0 }, { 0, 0 },
+		});
+	}
+
+	static auto DamageAssumptions() noexcept -> Result_t
+	{
+		return ExpectDamage({ .m_Level = 100, .m_EV = 252, .m_AttackerNature = 1, .m_DefenderNature = -1, .m_STAB = false }, {
+			{ 35, 42 }, { 0, 0 }, { 0, 0 },
+			{ 79, 94 }, { 119, 140 }, { 30, 35 },
+			{ 0, 0 }, { 212, 250 }, { 106, 126 },
+			{ 66, 78 }, { 0, 0 }, { 0, 0 },
+		});
+	}
+
+#pragma endregion Damage matrix
+
+#pragma region Raw PBS validation
+
+	// A scratch game whose PBS folder has one type, one move, and the given species and forms. Everything else is missing,
+	// which loads as an empty table.
+	[[nodiscard]] static auto LoadValidationGame(std::string_view szPokemon, std::string_view szForms) noexcept -> bool
+	{
+		auto const Root = std::filesystem::temp_directory_path() / "ParserTest.Selftest";
+		std::error_code ec{};
+
+		std::filesystem::remove_all(Root, ec);
+		std::filesystem::create_directories(Root / "PBS", ec);
+
+		if (ec)
+			return false;
+
+		std::array<std::pair<std::string_view, std::string_view>, 4> const rgFiles{ {
+			{ "types.txt", "[NORMAL]\nName = Normal\n" },
+			{ "moves.txt", "[TACKLE]\nName = Tackle\nType = NORMAL\nCategory = Physical\nPower = 40\n" },
+			{ "pokemon.txt", szPokemon },
+			{ "pokemon_forms.txt", szForms },
+		} };
+
+		for (auto&& [szFile, szContent] : rgFiles)
+		{
+			std::ofstream f{ Root / "PBS" / szFile, std::ios::binary | std::ios::trunc };
+			f.write(szContent.data(), (std::streamsize)szContent.size());
+
+			if (!f)
+				return false;
+		}
+
+		::PBS::Load(Root);
+		return true;
+	}
+
+	// Everything ValidateRaw reports, in its order.
+	[[nodiscard]] static auto ExpectDiagnostics(std::string_view szPokemon, std::string_view szForms, std::vector<Database::PBS::CDiagnostic> const& rgExpected) noexcept -> Result_t
+	{
+		if (!LoadValidationGame(szPokemon, szForms))
+			return std::unexpected("failed to write the scratch PBS folder");
+
+		static constexpr auto fnFields = [](Database::PBS::CDiagnostic const& Diag) static noexcept
+		{
+			return std::tie(Diag.m_Severity, Diag.m_File, Diag.m_Section, Diag.m_Key, Diag.m_Value, Diag.m_Problem);
+		};
+
+		if (auto const rgGot = Database::PBS::ValidateRaw(); !std::ranges::equal(rgGot, rgExpected, {}, fnFields, fnFields))
+		{
+			return std::unexpected(std::format("got {}, expected {}",
+				rgGot | std::views::transform(&Database::PBS::CDiagnostic::Describe), rgExpected | std::views::transform(&Database::PBS::CDiagnostic::Describe)));
+		}
+
+		return {};
+	}
+
+	static auto ValidationUnknownLearnsetMove() noexcept -> Result_t
+	{
+		using enum Database::PBS::ESeverity;
+
+		return ExpectDiagnostics(
+			"[BULBASAUR]\nName = Bulbasaur\nMoves = 1,TACKLE,7,LEECHSEED\n",
+			"",
+			{ { Error, "pokemon.txt", "BULBASAUR", "Moves", "LEECHSEED", "unknown move" } }
+		);
+	}
+
+	// Reported in the order the evolutions are written.
+	static auto ValidationBadEvolutionParameter() noexcept -> Result_t
+	{
+		using enum Database::PBS::ESeverity;
+
+		return ExpectDiagnostics(
+			"[BULBASAUR]\nName = Bulbasaur\nEvolutions = IVYSAUR,Level,sixteen,IVYSAUR,Item,LEAFSTONE\n[IVYSAUR]\nName = Ivysaur\n",
+			"",
+			{
+				{ Warning, "pokemon.txt", "BULBASAUR", "Evolutions", "sixteen", "parameter is not an integer" },
+				{ Error, "pokemon.txt", "BULBASAUR", "Evolutions", "LEAFSTONE", "unknown item" },
+			}
+		);
+	}
+
+	// Form 1 inherits the broken learnset and is not blamed for it again, form 2 replaces it with a broken one of its own.
+	static auto ValidationFormOverride() noexcept -> Result_t
+	{
+		using enum Database::PBS::ESeverity;
+
+		return ExpectDiagnostics(
+			"[PIKACHU]\nName = Pikachu\nMoves = 1,THUNDERSHOCK\n",
+			"[PIKACHU,1]\nFormName = Cosplay\n[PIKACHU,2]\nFormName = Partner\nMoves = 1,TACKLE,5,ZIPPYZAP\n",
+			{
+				{ Error, "pokemon.txt", "PIKACHU", "Moves", "THUNDERSHOCK", "unknown move" },
+				{ Error, "pokemon_forms.txt", "PIKACHU,2", "Moves", "ZIPPYZAP", "unknown move" },
+			}
+		);
+	}
+
+	static auto ValidationMissingBaseSpecies() noexcept -> Result_t
+	{
+		using enum Database::PBS::ESeverity;
+
+		return ExpectDiagnostics(
+			"[PIKACHU]\nName = Pikachu\n",
+			"[PIKACHU,1]\nFormName = Cosplay\n[RAICHU,1]\nFormName = Alola\n",
+			{ { Error, "pokemon_forms.txt", "RAICHU,1", "Id", "RAICHU", "unknown base species" } }
+		);
+	}
+
+#pragma endregion Raw PBS validation
+
+#pragma region Trigram search
+
+	// 0: Levitate, 1: Swift Swim, 2: Sturdy. The cases only search the ability segment.
+	static void MakeSearchTables() noexcept
+	{
+		static constexpr std::array<std::array<std::string_view, 3>, 3> rgszAbilities{ {
+			{ "LEVITATE", "Levitate", "Gives full immunity to all Ground-type moves." },
+			{ "SWIFTSWIM", "Swift Swim", "Boosts the Speed stat in rain." },
+			{ "STURDY", "Sturdy", "It cannot be knocked out with one hit." },
+		} };
+
+		Database::PBS::Abilities = {};
+
+		for (auto&& [szId, szName, szDescription] : rgszAbilities)
+		{
+			auto& Ability = Database::PBS::Abilities.m_Records.emplace_back();
+			Ability.m_Id = szId;
+			Ability.m_Name = szName;
+			Ability.m_Description = szDescription;
+		}
+
+		Database::PBS::RebuildSearchIndex();
+	}
+
+	// Records of the hits, best first.
+	[[nodiscard]] static auto ExpectSearch(std::string_view szQuery, std::vector<std::uint16_t> const& rgiExpected) noexcept -> Result_t
+	{
+		MakeSearchTables();
+
+		auto const rgHits = Database::PBS::Search(szQuery, 50, 1u << (unsigned)Database::PBS::ERecordKind::Ability);
+		std::vector const rgiRecords{ std::from_range, rgHits | std::views::transform(&Database::PBS::CSearchHit::m_Record) };
+
+		if (rgiRecords != rgiExpected)
+			return std::unexpected(std::format("'{}' found {}, expected {}", szQuery, rgiRecords, rgiExpected));
+
+		return {};
+	}
+
+	static auto SearchSubstring() noexcept -> Result_t
+	{
+		return ExpectSearch("swim", { 1 });
+	}
+
+	static auto SearchMiss() noexcept -> Result_t
+	{
+		return ExpectSearch("xyzzy", {});
+	}
+
+	// Two characters still make the trigrams of a word boundary, " le" and "le ". Blank makes none.
+	static auto SearchShortQuery() noexcept -> Result_t
+	{
+		if (auto const Result = ExpectSearch("le", { 0 }); !Result)
+			return Result;
+
+		return ExpectSearch("  ", {});
+	}
+
+	static auto SearchCaseFolded() noexcept -> Result_t
+	{
+		if (auto const Result = ExpectSearch("STURDY", { 2 }); !Result)
+			return Result;
+
+		return ExpectSearch("LeViTaTe", { 0 });
+	}
+
+#pragma endregion Trigram search
+
+#pragma region Autotile expansion
+
+	// R is the component index in the source (row * 6 + column), G the pixel in the component (y * 16 + x), B the frame.
+	[[nodiscard]] static auto MakeAutotileSource(int iFrames) noexcept -> CDecodedImage
+	{
+		auto const iWidth = AUTOTILE_SOURCE_WIDTH * iFrames;
+		auto pPixels = std::make_shared_for_overwrite<std::uint8_t[]>((std::size_t)iWidth * AUTOTILE_SOURCE_HEIGHT * 4);
+
+		for (int y = 0; y < AUTOTILE_SOURCE_HEIGHT; ++y)
+		{
+			for (int x = 0; x < iWidth; ++x)
+			{
+				auto const p = pPixels.get() + ((std::size_t)y * iWidth + x) * 4;
+				auto const xInFrame = x % AUTOTILE_SOURCE_WIDTH;
+
+				p[0] = (std::uint8_t)(y / 16 * 6 + xInFrame / 16);
+				p[1] = (std::uint8_t)(y % 16 * 16 + xInFrame % 16);
+				p[2] = (std::uint8_t)(x / AUTOTILE_SOURCE_WIDTH);
+				p[3] = 0xFF;
+			}
+		}
+
+		CDecodedImage ret{ .m_Path = "synthetic", .m_pMappedPixels = pPixels.get(), .m_Width = iWidth, .m_Height = AUTOTILE_SOURCE_HEIGHT };
+		ret.m_pMapping = std::move(pPixels);
+
+		return ret;
+	}
+
+	// Every pixel of every shape of every frame, against the component AUTOTILE_SHAPE_INFO names for it.
+	[[nodiscard]] static auto ExpectAutotileSheets(int iFrames) noexcept -> Result_t
+	{
+		auto const Sheets = ExpandAutotile(MakeAutotileSource(iFrames));
+
+		if (!Sheets)
+			return std::unexpected(std::format("rejected: {}", Sheets.error()));
+
+		if (Sheets->m_Width != AUTOTILE_SHEET_WIDTH || Sheets->m_Height != AUTOTILE_SHEET_HEIGHT * iFrames)
+			return std::unexpected(std::format("got {}x{}, expected {}x{}", Sheets->m_Width, Sheets->m_Height, AUTOTILE_SHEET_WIDTH, AUTOTILE_SHEET_HEIGHT * iFrames));
+
+		for (int iFrame = 0; iFrame < iFrames; ++iFrame)
+		{
+			for (auto&& [iShape, Shape] : std::views::enumerate(AUTOTILE_SHAPE_INFO))
+			{
+				for (auto&& [iComp, CompUV] : std::views::enumerate(Shape))
+				{
+					auto const xTile = (int)(iShape % AUTOTILE_SHEET_COLUMNS) * 32 + (int)(iComp % 2) * 16;
+					auto const yTile = (iFrame * AUTOTILE_SHEET_ROWS + (int)(iShape / AUTOTILE_SHEET_COLUMNS)) * 32 + (int)(iComp / 2) * 16;
+
+					for (int y = 0; y < 16; ++y)
+					{
+						for (int x = 0; x < 16; ++x)
+						{
+							auto const p = Sheets->Data() + ((std::size_t)(yTile + y) * Sheets->m_Width + xTile + x) * 4;
+							std::array const rgExpected{ CompUV[1] * 6 + CompUV[0], y * 16 + x, iFrame, 0xFF };
+
+							if (!std::ranges::equal(std::span{ p, 4 }, rgExpected))
+							{
+								return std::unexpected(std::format("frame {} shape {} component {} pixel ({}, {}): got {}, expected {}",
+									iFrame, iShape, iComp, x, y, std::span{ p, 4 }, rgExpected
+								));
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return {};
+	}
+
+	static auto AutotileSingleFrame() noexcept -> Result_t
+	{
+		return ExpectAutotileSheets(1);
+	}
+
+	static auto AutotileAnimated() noexcept -> Result_t
+	{
+		return ExpectAutotileSheets(4);
+	}
+
+	static auto AutotileRejectsBadSize() noexcept -> Result_t
+	{
+		auto Source = MakeAutotileSource(1);
+		Source.m_Height = AUTOTILE_SOURCE_HEIGHT / 2;
+
+		if (auto const Sheets = ExpandAutotile(Source); Sheets)
+			return std::unexpected("a 96x64 source was expanded");
+
+		return {};
+	}
+
+#pragma endregion Autotile expansion
+
+	static constexpr std::array CASES{
+		CCase{ "eggchain.direct", &EggChainDirect },
+		CCase{ "eggchain.two-fathers", &EggChainTwoFathers },
+		CCase{ "eggchain.female-only-link", &EggChainFemaleOnlyLink },
+		CCase{ "eggchain.male-only-link", &EggChainMaleOnlyLink },
+		CCase{ "eggchain.genderless-target", &EggChainGenderlessTarget },
+		CCase{ "query.conjunction", &QueryConjunction },
+		CCase{ "query.precedence", &QueryPrecedence },
+		CCase{ "query.not-order-limit", &QueryNotOrderLimit },
+		CCase{ "query.column-compare", &QueryColumnCompare },
+		CCase{ "query.fold-constants", &QueryFoldConstants },
+		CCase{ "query.reorder", &QueryReorder },
+		CCase{ "query.malformed", &QueryMalformed },
+		CCase{ "filter.u8", &FilterU8 },
+		CCase{ "filter.u16", &FilterU16 },
+		CCase{ "filter.type-invalid-handle", &FilterTypeInvalidHandle },
+		CCase{ "damage.known-values", &DamageKnownValues },
+		CCase{ "damage.assumptions", &DamageAssumptions },
+		CCase{ "validation.unknown-learnset-move", &ValidationUnknownLearnsetMove },
+		CCase{ "validation.bad-evolution-parameter", &ValidationBadEvolutionParameter },
+		CCase{ "validation.form-override", &ValidationFormOverride },
+		CCase{ "validation.missing-base-species", &ValidationMissingBaseSpecies },
+		CCase{ "search.substring", &SearchSubstring },
+		CCase{ "search.miss", &SearchMiss },
+		CCase{ "search.short-query", &SearchShortQuery },
+		CCase{ "search.case-folded", &SearchCaseFolded },
+		CCase{ "autotile.single-frame", &AutotileSingleFrame },
+		CCase{ "autotile.animated", &AutotileAnimated },
+		CCase{ "autotile.rejects-bad-size", &AutotileRejectsBadSize },
+	};
+
+	int Run(std::span<char* const> rgszFilters) noexcept
+	{
+		std::size_t iRun{}, iFailed{};
+
+		for (auto&& Case : CASES)
+		{
+			if (!rgszFilters.empty()
+				&& std::ranges::none_of(rgszFilters, [&](std::string_view szFilter) noexcept { return Case.m_Name.contains(szFilter); }))
+			{
+				continue;
+			}
+
+			++iRun;
+
+			if (auto const Result = Case.m_pfn(); Result)
+				std::println("PASS {}", Case.m_Name);
+			else
+			{
+				std::println("FAIL {}: {}", Case.m_Name, Result.error());
+				++iFailed;
+			}
+		}
+
+		std::println("{} passed, {} failed.", iRun - iFailed, iFailed);
+		return iFailed ? 1 : 0;
+	}
+}
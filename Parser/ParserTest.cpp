@@ -29,86 +29,652 @@ Database.PBS.<Name> - Reorganized data from PBS txt files. - NO GL INVOLVED!
 import std.compat;
 #endif
 
+import UtlLog;
+import UtlMemory;
+import UtlTrace;
+
+import Database.Export;
 import Database.PBS;
+import Database.PBS.Breeding;
+import Database.PBS.Columnar;
+import Database.PBS.Damage;
+import Database.PBS.Evolution;
+import Database.PBS.Learnset;
+import Database.PBS.Query;
+import Database.PBS.Search;
+import Database.PBS.Validation;
 import Database.RX;
 import Database.Raw.PBS;
 
 import Game.Path;
 
+// Headless, no GL context involved. Meant to be run in batch over many games.
 
-int main(int argc, char* argv[]) noexcept
+namespace Selftest
+{
+	// Implemented in ParserTest.Selftest.cpp. Needs no game, runs every case whose name contains one of the filters.
+	extern int Run(std::span<char* const> rgszFilters) noexcept;
+}
+
+enum EExitCode : int
+{
+	Exit_Success = 0,
+	Exit_Failure = 1,	// The command ran but found problems, or its argument was not found.
+	Exit_Usage = 2,
+	Exit_BadGamePath = 3,
+};
+
+using Clock = std::chrono::high_resolution_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+static constexpr std::string_view USAGE = R"(Usage: ParserTest <command> <game path> [arguments] [--trace=<file>]
+       ParserTest selftest [filter...]
+
+Commands:
+  load                 Parse and build everything, print per-stage timings.
+  validate             List broken references. Fails if there is any error.
+  query "<query>"      Run a species query, e.g. "species where type has WATER and bst > 500 order by speed desc".
+  dump <table> [id]    Print types, moves, abilities, items, species or typechart. Fails if id is not found.
+  bench [iterations]   Rebuild the database repeatedly, print min/median/max per stage. 10 iterations by default.
+  stats                Record counts, index sizes, live and peak memory per subsystem.
+  export <folder> [json|jsonl] [base64|array]
+                       Write every PBS and RX table to its own file, in parallel. Json and base64 by default.
+  damage <file> [binary|csv] [level=<n>] [attackers="<query>"] [defenders="<query>"]
+                       Write the damage roll of every damaging move of each attacker against each defender.
+                       Binary, level 50 and every species by default.
+  eggchain <species> <move>
+                       Print the fathers that pass an egg move down to the species. Fails if there is no such chain.
+
+selftest runs the built-in checks on synthetic data, no game path is needed.
+
+--trace=<file> records every zone of the run and writes it as Chrome trace JSON, for chrome://tracing or ui.perfetto.dev.
+
+Exit codes: 0 success, 1 command failed, 2 bad usage, 3 bad game path.
+)";
+
+struct CLoadTimes final
+{
+	Milliseconds m_PBS{};
+	Milliseconds m_RX{};
+	Milliseconds m_Total{};
+};
+
+[[nodiscard]] static auto LoadGame() noexcept -> CLoadTimes
 {
-	if (argc == 2)
+	CLoadTimes ret{};
+	auto const t0 = Clock::now();
+
 	{
-		std::filesystem::path Candidate{ argv[1] };
+		std::jthread thread_LoadRxData{
+			[&ret] noexcept
+			{
+				UTIL_TraceSetThreadName("Load RX");
+				auto const t = Clock::now();
+				Database::RX::Load(PokemonEssentials::GamePath);
+				ret.m_RX = Clock::now() - t;
+			}
+		};
 
-		if (std::filesystem::exists(Candidate) && std::filesystem::is_directory(Candidate))
-			PokemonEssentials::AssignGamePath(std::move(Candidate));
+		PBS::Load(PokemonEssentials::GamePath);
+		ret.m_PBS = Clock::now() - t0;
 	}
-	else
+
+	Database::PBS::Build();
+	ret.m_Total = Clock::now() - t0;
+
+	UTIL_LogFlush();	// Keep the load warnings above the output.
+	return ret;
+}
+
+using namespace Database::PBS;
+
+static int CmdLoad(CLoadTimes const& Times, std::span<char* const>) noexcept
+{
+	std::println("{:<12} {:>10.3f} ms", "Parse PBS", Times.m_PBS.count());
+	std::println("{:<12} {:>10.3f} ms   (in parallel)", "Parse RX", Times.m_RX.count());
+
+	for (auto&& [szStage, Time] : BuildTimings)
+		std::println("{:<12} {:>10.3f} ms", szStage, Time.count());
+
+	std::println("{:<12} {:>10.3f} ms", "Total", Times.m_Total.count());
+	std::println("{} types, {} moves, {} abilities, {} items, {} species and forms, {} maps.",
+		Types.size(), Moves.size(), Abilities.size(), Items.size(), Species.size(), Database::RX::MapData.size());
+
+	return Exit_Success;
+}
+
+static int CmdValidate(CLoadTimes const&, std::span<char* const>) noexcept
+{
+	for (auto&& Diag : Diagnostics)
+		std::println("{}", Diag.Describe());
+
+	auto const iErrors = std::ranges::count(Diagnostics, ESeverity::Error, &CDiagnostic::m_Severity);
+	std::println("{} errors, {} warnings.", iErrors, std::ssize(Diagnostics) - iErrors);
+
+	return iErrors ? Exit_Failure : Exit_Success;
+}
+
+static int CmdQuery(CLoadTimes const&, std::span<char* const> rgszArgs) noexcept
+{
+	if (rgszArgs.empty())
 	{
-		std::println("Default game path is used: '{}'", PokemonEssentials::GamePath.u8string());
+		std::print("{}", USAGE);
+		return Exit_Usage;
 	}
 
-	std::jthread thread_LoadRxData{ [] static noexcept { Database::RX::Load(PokemonEssentials::GamePath); } };
-	PBS::Load(PokemonEssentials::GamePath);
-	thread_LoadRxData.join();
+	auto const Result = RunQuery(rgszArgs[0]);
 
-	Database::PBS::Build();
+	if (!Result)
+	{
+		std::println("Query error: {}", Result.error());
+		return Exit_Failure;
+	}
+
+	for (auto&& iRow : Result->m_Rows)
+	{
+		auto const& Spec = Species.m_Records[iRow];
+		std::print("{:<16} {:>2} {:<16}", Spec.m_Id, Spec.m_FormId, Spec.m_Name);
+
+		for (auto&& Field : Result->m_Projection)
+			std::print(" {}={}", FieldName(Field), FieldValue(Field, iRow));
+
+		std::print("\n");
+	}
+
+	std::println("Plan: {}", Result->m_Plan);
+	std::println("{} rows, compile {:.3f} ms, execute {:.3f} ms", Result->m_Rows.size(), Result->m_CompileTime.count(), Result->m_ExecuteTime.count());
 
+	return Exit_Success;
+}
+
+static void DumpTypeChart() noexcept
+{
 	std::vector const TypeInUse{ std::from_range,
-		PBS::Types
-		| std::views::values
-		| std::views::filter(std::not_fn(&PokemonType::m_IsPseudoType))
-		| std::views::transform([](auto& a) static noexcept { return std::addressof(a); })
+		Types
+		| std::views::filter(std::not_fn(&CPokemonType::m_IsPseudoType))
+		| std::views::transform([](auto& a) static noexcept { return Types.HandleOf(a); })
 	};
 
+	if (TypeInUse.empty())
+		return;
+
 	auto const iMaxLength =
-		std::ranges::max(TypeInUse, {}, [](PokemonType* ty) { return ty->m_Name.length(); })->m_Name.length();
+		std::ranges::max(TypeInUse | std::views::transform([](TypeHandle h) static noexcept { return Types[h].m_Name.length(); }));
 
 	static constexpr auto TRUNC = 4;
 	std::print("|{0:^{1}}", "", iMaxLength + 2);
 
-	std::vector<std::string_view> rgfl{};
-	rgfl.resize(TypeInUse.size() * TypeInUse.size(), "1");
+	for (auto&& hType : TypeInUse)
+	{
+		std::string_view szDisplay{ Types[hType].m_Name };
+		if (szDisplay.length() > TRUNC)
+			szDisplay.remove_suffix(szDisplay.size() - TRUNC);
+
+		std::print("| {0:^{1}} ", szDisplay, TRUNC);
+	}
+	std::print("|\n");
+
+	// Row is the defender, column is the attacker.
+	for (auto&& hDef : TypeInUse)
+	{
+		std::print("| {0:^{1}} ", Types[hDef].m_Name, iMaxLength);
+		for (auto&& hAtk : TypeInUse)
+		{
+			switch (TypeChart.Effectiveness(hAtk, hDef))
+			{
+			case EFFECTIVENESS_NORMAL:
+				std::print("| {0:^{1}} ", "", TRUNC);
+				break;
+			case EFFECTIVENESS_NORMAL * 2:
+				std::print("| {0:^{1}} ", "2", TRUNC);
+				break;
+			case EFFECTIVENESS_NORMAL / 2:
+				std::print("| {0:^{1}} ", u8"½", TRUNC);
+				break;
+			case 0:
+				std::print("| {0:^{1}} ", "0", TRUNC);
+				break;
+			default:
+				std::unreachable();
+			}
+		}
+		std::print("|\n");
+	}
+}
+
+static int CmdDump(CLoadTimes const&, std::span<char* const> rgszArgs) noexcept
+{
+	if (rgszArgs.empty())
+	{
+		std::print("{}", USAGE);
+		return Exit_Usage;
+	}
+
+	std::string_view const szTable{ rgszArgs[0] };
+	std::string_view const szId{ rgszArgs.size() >= 2 ? rgszArgs[1] : "" };
+	std::size_t iPrinted{};
 
-	std::mdspan<std::string_view, std::dextents<size_t, 2>> const TypeChart{ rgfl.data(), TypeInUse.size(), TypeInUse.size() };
+	auto const fnWanted = [&](std::string_view sz) noexcept
+	{
+		auto const bWanted = szId.empty() || sz == szId;
+		iPrinted += bWanted;
+		return bWanted;
+	};
+
+	auto const fnTypeName = [](TypeHandle hType) static noexcept -> std::string_view
+	{
+		auto const pType = Types.At(hType);
+		return pType ? pType->m_Id : "-";
+	};
 
-	for (int i = 0; i < std::ssize(TypeInUse); ++i)
+	if (szTable == "typechart")
 	{
-		for (int j = 0; j < std::ssize(TypeInUse); ++j)
+		DumpTypeChart();
+		return Exit_Success;
+	}
+	else if (szTable == "types")
+	{
+		for (auto&& Type : Types)
 		{
-			if (std::ranges::contains(TypeInUse[i]->Weaknesses(), TypeInUse[j]))	// [i] is weak to [j]
-				TypeChart[i, j] = "2";
-			if (std::ranges::contains(TypeInUse[i]->Immunities(), TypeInUse[j]))	// [i] is immu to [j]
-				TypeChart[i, j] = "0";
-			if (std::ranges::contains(TypeInUse[i]->Resistances(), TypeInUse[j]))	// [i] is resi to [j]
-				TypeChart[i, j] = u8"½";
+			if (fnWanted(Type.m_Id))
+				std::println("{:<12} {:<12} {}{}", Type.m_Id, Type.m_Name, Type.m_IsSpecialType ? "special" : "physical", Type.m_IsPseudoType ? ", pseudo" : "");
 		}
 	}
+	else if (szTable == "moves")
+	{
+		static constexpr std::array CATEGORIES{ "Physical", "Special", "Status" };
 
-	for (auto&& ptr : TypeInUse)
+		for (auto&& Move : Moves)
+		{
+			if (fnWanted(Move.m_Id))
+			{
+				std::println("{:<20} {:<20} {:<10} {:<8} pow {:>3} acc {:>3} pp {:>2}",
+					Move.m_Id, Move.m_Name, fnTypeName(Move.m_Type), CATEGORIES[(std::size_t)Move.m_Category], Move.m_Power, Move.m_Accuracy, Move.m_TotalPP);
+			}
+		}
+	}
+	else if (szTable == "abilities")
 	{
-		std::string_view szDisplay{ ptr->m_Name };
-		if (szDisplay.length() > TRUNC)
-			szDisplay.remove_suffix(szDisplay.size() - TRUNC);
+		for (auto&& Ability : Abilities)
+		{
+			if (fnWanted(Ability.m_Id))
+				std::println("{:<20} {:<20} {}", Ability.m_Id, Ability.m_Name, Ability.m_Description);
+		}
+	}
+	else if (szTable == "items")
+	{
+		for (auto&& Item : Items)
+		{
+			if (fnWanted(Item.m_Id))
+				std::println("{:<20} {:<20} pocket {} price {}", Item.m_Id, Item.m_Name, Item.m_Pocket, Item.m_Price);
+		}
+	}
+	else if (szTable == "species")
+	{
+		for (auto&& Spec : Species)
+		{
+			if (!fnWanted(Spec.m_Id))
+				continue;
 
-		std::print("| {0:^{1}} ", szDisplay, TRUNC);
+			auto const iBST = std::ranges::fold_left(Spec.m_BaseStats, 0, std::plus<>{});
+
+			std::print("{:<16} {:>2} {:<16} {:<20}", Spec.m_Id, Spec.m_FormId, Spec.m_Name, Spec.m_FormName);
+			for (auto&& hType : Spec.m_Types)
+				std::print(" {}", fnTypeName(hType));
+			std::println(" bst {}", iBST);
+		}
 	}
-	std::print("|\n");
+	else
+	{
+		std::print("{}", USAGE);
+		return Exit_Usage;
+	}
+
+	return iPrinted ? Exit_Success : Exit_Failure;
+}
 
-	for (auto&& [idx, ptr] : std::views::enumerate(TypeInUse))
+static int CmdBench(CLoadTimes const&, std::span<char* const> rgszArgs) noexcept
+{
+	std::size_t iIterations = 10;
+
+	if (!rgszArgs.empty())
 	{
-		std::print("| {0:^{1}} ", ptr->m_Name, iMaxLength);
-		for (size_t j = 0; j < TypeChart.extent(1); ++j)
+		std::string_view const sz{ rgszArgs[0] };
+
+		if (std::from_chars(sz.data(), sz.data() + sz.size(), iIterations).ec != std::errc{} || iIterations == 0)
 		{
-			if (TypeChart[idx, j] == "1")
-				std::print("| {0:^{1}} ", "", TRUNC);
-			else
-				std::print("| {0:^{1}} ", TypeChart[idx, j], TRUNC);
+			std::print("{}", USAGE);
+			return Exit_Usage;
 		}
-		std::print("|\n");
 	}
+
+	// The first Build() already happened while loading, so every sample below is warm.
+	std::vector<std::vector<Milliseconds>> rgStageSamples(BuildTimings.size());
+	std::vector<Milliseconds> rgTotals{};
+
+	for (std::size_t i = 0; i < iIterations; ++i)
+	{
+		auto const t0 = Clock::now();
+		Build();
+		rgTotals.emplace_back(Clock::now() - t0);
+
+		for (auto&& [Samples, Stage] : std::views::zip(rgStageSamples, BuildTimings))
+			Samples.push_back(Stage.m_Time);
+	}
+
+	UTIL_LogFlush();
+
+	auto const fnReport = [](std::string_view szName, std::vector<Milliseconds>& rgSamples) noexcept
+	{
+		std::ranges::sort(rgSamples);
+		std::println("{:<12} min {:>9.3f}  median {:>9.3f}  max {:>9.3f} ms",
+			szName, rgSamples.front().count(), rgSamples[rgSamples.size() / 2].count(), rgSamples.back().count());
+	};
+
+	std::println("{} iterations. Search only rebuilds changed segments, so it measures hashing here.", iIterations);
+
+	for (auto&& [Samples, Stage] : std::views::zip(rgStageSamples, BuildTimings))
+		fnReport(Stage.m_Stage, Samples);
+
+	fnReport("Total", rgTotals);
+	return Exit_Success;
+}
+
+static int CmdStats(CLoadTimes const&, std::span<char* const>) noexcept
+{
+	static constexpr std::array SEGMENT_NAMES{ "species", "moves", "abilities", "items" };
+
+	std::println("{:<24} {}", "Types", Types.size());
+	std::println("{:<24} {}", "Moves", Moves.size());
+	std::println("{:<24} {}", "Abilities", Abilities.size());
+	std::println("{:<24} {}", "Items", Items.size());
+	std::println("{:<24} {}", "Species", Species.m_NameIndex.size());
+	std::println("{:<24} {}", "Species and forms", Species.size());
+	std::println("{:<24} {}", "Egg groups", SpeciesColumns.m_EggGroupNames.size());
+	std::println("{:<24} {}", "Evolution edges", Evolutions.m_Edges.size());
+	std::println("{:<24} {}", "Evolution families", Evolutions.m_FamilyRoots.size());
+	std::println("{:<24} {}", "Learnset entries", Learnsets.m_Entries.size());
+	std::println("{:<24} {}", "  with pre-evolutions", LearnsetsWithPrevos.m_Entries.size());
+
+	for (auto&& Segment : SearchIndex.m_Segments)
+	{
+		std::println("{:<24} {} trigrams, {} postings", std::format("Search index, {}", SEGMENT_NAMES[(std::size_t)Segment.m_Kind]),
+			Segment.m_Trigrams.size(), Segment.m_Postings.size());
+	}
+
+	std::println("{:<24} {}", "Tilesets", Database::RX::Tilesets.size());
+	std::println("{:<24} {}", "Maps", Database::RX::MapData.size());
+	std::println("{:<24} {}", "Broken references", Diagnostics.size());
+
+	// Peaks cover the load done by this very process.
+	std::println("");
+	std::println("{:<24} {:>12} {:>12} {:>12}", "Memory", "Live", "Peak", "Allocations");
+
+	for (std::size_t i = 0; i < (std::size_t)EMemoryTag::COUNT; ++i)
+	{
+		auto const Stat = UTIL_MemoryStat((EMemoryTag)i);
+		std::println("{:<24} {:>12} {:>12} {:>12}", UTIL_MemoryTagName((EMemoryTag)i),
+			UTIL_MemoryFormatBytes(Stat.m_Live), UTIL_MemoryFormatBytes(Stat.m_Peak), Stat.m_Allocations);
+	}
+
+	return Exit_Success;
+}
+
+static int CmdExport(CLoadTimes const&, std::span<char* const> rgszArgs) noexcept
+{
+	using namespace Database::Export;
+
+	if (rgszArgs.empty())
+	{
+		std::print("{}", USAGE);
+		return Exit_Usage;
+	}
+
+	COptions Options{};
+
+	for (std::string_view const szOption : rgszArgs.subspan(1))
+	{
+		if (szOption == "json")
+			Options.m_Format = EFormat::Json;
+		else if (szOption == "jsonl")
+			Options.m_Format = EFormat::JsonLines;
+		else if (szOption == "base64")
+			Options.m_TableEncoding = ETableEncoding::Base64;
+		else if (szOption == "array")
+			Options.m_TableEncoding = ETableEncoding::Array;
+		else
+		{
+			std::print("{}", USAGE);
+			return Exit_Usage;
+		}
+	}
+
+	static constexpr auto ALL_TABLES = [] static noexcept
+	{
+		std::array<ETable, (std::size_t)ETable::COUNT> ret{};
+		for (std::size_t i = 0; i < ret.size(); ++i)
+			ret[i] = (ETable)i;
+		return ret;
+	}();
+
+	auto const t0 = Clock::now();
+	auto const rgResults = ExportTables(ALL_TABLES, rgszArgs[0], Options);
+	Milliseconds const Elapsed = Clock::now() - t0;
+
+	std::uint64_t iTotalBytes{};
+	int iExitCode = Exit_Success;
+
+	for (auto&& Result : rgResults)
+	{
+		if (!Result)
+		{
+			std::println("Export error: {}", Result.error());
+			iExitCode = Exit_Failure;
+			continue;
+		}
+
+		iTotalBytes += Result->m_Bytes;
+		std::println("{:<12} {:>6} records {:>12} bytes {:>10.3f} ms  {}",
+			TableName(Result->m_Table), Result->m_Records, Result->m_Bytes, Result->m_Time.count(), Result->m_Path.u8string());
+	}
+
+	std::println("{} bytes in {:.3f} ms, {:.1f} MiB/s", iTotalBytes, Elapsed.count(), iTotalBytes / 1048576.0 / (Elapsed.count() / 1000.0));
+	return iExitCode;
+}
+
+// Rows of a species query as a selection, for the commands that take a set of species.
+[[nodiscard]] static auto SelectSpecies(std::string_view szQuery) noexcept -> std::expected<CSelection, std::string>
+{
+	auto const Result = RunQuery(szQuery);
+
+	if (!Result)
+		return std::unexpected(Result.error());
+
+	auto ret = CSelection::None(Species.size());
+
+	for (auto&& iRow : Result->m_Rows)
+		ret.Set(iRow);
+
+	return ret;
+}
+
+static int CmdDamage(CLoadTimes const&, std::span<char* const> rgszArgs) noexcept
+{
+	if (rgszArgs.empty())
+	{
+		std::print("{}", USAGE);
+		return Exit_Usage;
+	}
+
+	auto Format = EDamageFormat::Binary;
+	CDamageAssumptions Assumptions{};
+	auto Attackers = CSelection::All(Species.size());
+	auto Defenders = CSelection::All(Species.size());
+
+	for (std::string_view const szOption : rgszArgs.subspan(1))
+	{
+		if (szOption == "binary")
+			Format = EDamageFormat::Binary;
+		else if (szOption == "csv")
+			Format = EDamageFormat::CSV;
+		else if (szOption.starts_with("level="))
+		{
+			auto const szValue = szOption.substr(6);
+			auto const [ptr, ec] = std::from_chars(szValue.data(), szValue.data() + szValue.size(), Assumptions.m_Level);
+
+			if (ec != std::errc{} || ptr != szValue.data() + szValue.size() || Assumptions.m_Level == 0 || Assumptions.m_Level > 100)
+			{
+				std::print("{}", USAGE);
+				return Exit_Usage;
+			}
+		}
+		else if (szOption.starts_with("attackers=") || szOption.starts_with("defenders="))
+		{
+			auto Selection = SelectSpecies(szOption.substr(10));
+
+			if (!Selection)
+			{
+				std::println("Query error: {}", Selection.error());
+				return Exit_Failure;
+			}
+
+			(szOption.starts_with("attackers=") ? Attackers : Defenders) = std::move(*Selection);
+		}
+		else
+		{
+			std::print("{}", USAGE);
+			return Exit_Usage;
+		}
+	}
+
+	auto const t0 = Clock::now();
+	auto const Result = WriteDamageMatrix(rgszArgs[0], Format, Assumptions, Attackers, Defenders);
+	Milliseconds const Elapsed = Clock::now() - t0;
+
+	if (!Result)
+	{
+		std::println("Damage error: {}", Result.error());
+		return Exit_Failure;
+	}
+
+	std::println("{} attackers against {} defenders written to '{}' in {:.3f} ms.", *Result, Defenders.Count(), rgszArgs[0], Elapsed.count());
+	return Exit_Success;
+}
+
+static int CmdEggChain(CLoadTimes const&, std::span<char* const> rgszArgs) noexcept
+{
+	if (rgszArgs.size() < 2)
+	{
+		std::print("{}", USAGE);
+		return Exit_Usage;
+	}
+
+	auto const hTarget = Species.Find(rgszArgs[0]);
+	auto const hMove = Moves.Find(rgszArgs[1]);
+
+	if (!hTarget || !hMove)
+	{
+		std::println("Unknown species '{}' or move '{}'.", rgszArgs[0], rgszArgs[1]);
+		return Exit_Failure;
+	}
+
+	auto const& Target = Species[hTarget];
+	auto const& Move = Moves[hMove];
+	auto const Chain = FindEggMoveChain(hTarget, hMove);
+
+	if (!Chain)
+	{
+		std::println("{} cannot get {} by breeding.", Target.m_Name, Move.m_Name);
+		return Exit_Failure;
+	}
+
+	if (Chain->empty())
+	{
+		std::println("{} learns {} by itself.", Target.m_Name, Move.m_Name);
+		return Exit_Success;
+	}
+
+	for (auto&& hFather : *Chain)
+		std::print("{} -> ", Species[hFather].m_Name);
+
+	std::println("{}, {} generations.", Target.m_Name, Chain->size());
+	return Exit_Success;
+}
+
+int main(int argc, char* argv[]) noexcept
+{
+	using fnCommand_t = int (*)(CLoadTimes const&, std::span<char* const>) noexcept;
+
+	static constexpr std::array<std::pair<std::string_view, fnCommand_t>, 9> COMMANDS
+	{{
+		{ "load", &CmdLoad },
+		{ "validate", &CmdValidate },
+		{ "query", &CmdQuery },
+		{ "dump", &CmdDump },
+		{ "bench", &CmdBench },
+		{ "stats", &CmdStats },
+		{ "export", &CmdExport },
+		{ "damage", &CmdDamage },
+		{ "eggchain", &CmdEggChain },
+	}};
+
+	// Options may appear anywhere, they are removed before the command sees its arguments.
+	std::vector<char*> rgszArgs{ argv, argv + argc };
+	std::string_view szTraceFile{};
+
+	if (auto const it = std::ranges::find_if(rgszArgs, [](std::string_view sz) static noexcept { return sz.starts_with("--trace="); }); it != rgszArgs.end())
+	{
+		szTraceFile = std::string_view{ *it }.substr(8);
+		rgszArgs.erase(it);
+
+		if (szTraceFile.empty())
+		{
+			std::print("{}", USAGE);
+			return Exit_Usage;
+		}
+	}
+
+	if (rgszArgs.size() >= 2 && std::string_view{ rgszArgs[1] } == "selftest")
+		return Selftest::Run(std::span{ rgszArgs }.subspan(2));
+
+	if (rgszArgs.size() < 3)
+	{
+		std::print("{}", USAGE);
+		return Exit_Usage;
+	}
+
+	if (!szTraceFile.empty())
+	{
+		UTIL_TraceSetEnabled(true);
+		UTIL_TraceSetThreadName("Main");
+	}
+
+	auto const itCommand = std::ranges::find(COMMANDS, std::string_view{ rgszArgs[1] }, &decltype(COMMANDS)::value_type::first);
+
+	if (itCommand == COMMANDS.cend())
+	{
+		std::print("{}", USAGE);
+		return Exit_Usage;
+	}
+
+	if (!PokemonEssentials::AssignGamePath(rgszArgs[2]))
+	{
+		UTIL_LogFlush();
+		return Exit_BadGamePath;
+	}
+
+	auto const Times = LoadGame();
+	auto const iExitCode = itCommand->second(Times, std::span{ rgszArgs }.subspan(3));
+
+	if (!szTraceFile.empty())
+	{
+		if (auto const Result = UTIL_TraceWriteChrome(szTraceFile); Result)
+			std::println("{} zones written to '{}'.", *Result, szTraceFile);
+		else
+			std::println("Trace error: {}", Result.error());
+	}
+
+	return iExitCode;
 }
 
 // Run program: Ctrl + F5 or Debug > Start Without Debugging menu
@@ -6,12 +6,16 @@ import std.compat;
 #undef max
 #endif
 
+import UtlMemory;
 import UtlString;
 import Ruby.Deserializer;
 
 
 std::any Ruby::Deserializer::Reader::parse()
 {
+	// Only the buffers filled straight from the stream count as Marshal. Containers built around them (arrays, hashes,
+	// objects) keep the tag of the caller, RX::Load tags them as RX database.
+
 	char const cTypeSymbol = (char)m_file->get();
 	if (m_file->eof())
 		throw std::runtime_error("Unexpected EOF");
@@ -107,8 +111,12 @@ std::any Ruby::Deserializer::Reader::parse()
 		return read_fixnum();
 	case 'f':    // Float
 	{
-		auto str = std::string(read_fixnum(), '\0');
-		m_file->read(str.data(), str.length());
+		std::string str{};
+		{
+			CMemoryScope MemoryScope{ EMemoryTag::Marshal };
+			str.resize(read_fixnum());
+			m_file->read(str.data(), str.length());
+		}
 
 		double v;
 		if (str.compare("nan") == 0)
@@ -129,6 +137,7 @@ std::any Ruby::Deserializer::Reader::parse()
 		auto len = read_fixnum();
 
 		//char data[len * 2];
+		CMemoryScope MemoryScope{ EMemoryTag::Marshal };
 		auto data = std::make_unique<char[]>(len * 2);
 		m_file->read(data.get(), len * 2);
 
@@ -139,8 +148,12 @@ std::any Ruby::Deserializer::Reader::parse()
 	case '"':    // String
 	{
 		auto const len = read_fixnum();
-		auto str = std::string(len, '\0');
-		m_file->read(str.data(), len);
+		std::string str{};
+		{
+			CMemoryScope MemoryScope{ EMemoryTag::Marshal };
+			str.resize(len);
+			m_file->read(str.data(), len);
+		}
 
 		auto& strref_any = m_object_cache.emplace_back(std::move(str));
 		auto& strref = *std::any_cast<std::string>(&strref_any);
@@ -235,9 +248,12 @@ std::any Ruby::Deserializer::Reader::parse()
 			std::int32_t size;
 			m_file->read((char*)&size, sizeof(std::int32_t));
 
-			table.data.resize(size);
-			for (std::int32_t i = 0; i < size; i++)
-				m_file->read((char*)&table.data[i], sizeof(std::int16_t));
+			{
+				CMemoryScope MemoryScope{ EMemoryTag::Marshal };
+				table.data.resize(size);
+				for (std::int32_t i = 0; i < size; i++)
+					m_file->read((char*)&table.data[i], sizeof(std::int16_t));
+			}
 
 			return &table;
 		}
@@ -309,8 +325,11 @@ std::any Ruby::Deserializer::Reader::parse()
 		std::vector<std::uint8_t> arr;
 		std::int32_t len = read_fixnum();
 
-		arr.resize(len);
-		m_file->read((char*)arr.data(), len);
+		{
+			CMemoryScope MemoryScope{ EMemoryTag::Marshal };
+			arr.resize(len);
+			m_file->read((char*)arr.data(), len);
+		}
 
 		auto& arrref = m_symbol_cache.emplace_back(std::move(arr));
 		return &arrref;
@@ -1,5 +1,15 @@
+import UtlMemory;
+
+// Decoded pixels and stb scratch buffers are counted as image decode memory.
+#define STBI_MALLOC(sz)			UTIL_MemoryAlloc(sz, 16, EMemoryTag::ImageDecode)
+#define STBI_REALLOC(p, newsz)	UTIL_MemoryRealloc(p, newsz, EMemoryTag::ImageDecode)
+#define STBI_FREE(p)			UTIL_MemoryFree(p)
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
+
+#define STB_DXT_IMPLEMENTATION
+#include "stb_dxt.h"